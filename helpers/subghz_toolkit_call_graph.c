@@ -0,0 +1,233 @@
+#include "subghz_toolkit_call_graph.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct SubGhzToolkitCallGraph
+{
+    SubGhzToolkitFunctionCache *cache;
+    SubGhzToolkitCodeAt code_at;
+    void *context;
+    size_t max_nodes;
+    size_t dropped;
+
+    SubGhzToolkitCallNode *nodes;
+    size_t node_count;
+    size_t node_capacity;
+    uint32_t *node_slots; // node index + 1 by address, 0 is empty
+    uint32_t node_slot_count;
+
+    SubGhzToolkitCallEdge *edges;
+    size_t edge_count;
+    size_t edge_capacity;
+
+    uint16_t *pending; // nodes found but not yet scanned
+    size_t pending_count;
+    size_t pending_capacity;
+};
+
+static uint32_t subghz_toolkit_call_graph_hash(uint32_t key)
+{
+    return key * 2654435761u;
+}
+
+static void *subghz_toolkit_call_graph_grow(void *array, size_t *capacity, size_t element_size)
+{
+    *capacity = *capacity ? *capacity * 2 : 64;
+    return realloc(array, *capacity * element_size);
+}
+
+static void subghz_toolkit_call_graph_rehash_nodes(SubGhzToolkitCallGraph *graph, uint32_t slot_count)
+{
+    free(graph->node_slots);
+    graph->node_slots = calloc(slot_count, sizeof(uint32_t));
+    graph->node_slot_count = slot_count;
+
+    for (size_t i = 0; i < graph->node_count; i++)
+    {
+        uint32_t slot = subghz_toolkit_call_graph_hash(graph->nodes[i].address >> 1) & (slot_count - 1);
+        while (graph->node_slots[slot])
+            slot = (slot + 1) & (slot_count - 1);
+        graph->node_slots[slot] = i + 1;
+    }
+}
+
+static uint32_t *subghz_toolkit_call_graph_node_slot(const SubGhzToolkitCallGraph *graph, uint32_t address)
+{
+    uint32_t slot = subghz_toolkit_call_graph_hash(address >> 1) & (graph->node_slot_count - 1);
+    while (graph->node_slots[slot] && graph->nodes[graph->node_slots[slot] - 1].address != address)
+        slot = (slot + 1) & (graph->node_slot_count - 1);
+    return &graph->node_slots[slot];
+}
+
+// Index of the node at `address`, added and queued for scanning if new. -1 when the graph is full.
+static int32_t subghz_toolkit_call_graph_node_index(SubGhzToolkitCallGraph *graph, uint32_t address)
+{
+    uint32_t *slot = subghz_toolkit_call_graph_node_slot(graph, address);
+    if (*slot)
+        return *slot - 1;
+    if (graph->node_count == graph->max_nodes)
+    {
+        graph->dropped++;
+        return -1;
+    }
+
+    if (graph->node_count == graph->node_capacity)
+        graph->nodes = subghz_toolkit_call_graph_grow(graph->nodes, &graph->node_capacity, sizeof(SubGhzToolkitCallNode));
+    if (graph->pending_count == graph->pending_capacity)
+        graph->pending = subghz_toolkit_call_graph_grow(graph->pending, &graph->pending_capacity, sizeof(uint16_t));
+
+    size_t index = graph->node_count++;
+    SubGhzToolkitCallNode *node = &graph->nodes[index];
+    memset(node, 0, sizeof(*node));
+    node->address = address;
+    node->owner = SUBGHZ_TOOLKIT_FUNCTION_NO_OWNER;
+    *slot = index + 1;
+    graph->pending[graph->pending_count++] = index;
+
+    // Load factor at most 50%
+    if (graph->node_count * 2 > graph->node_slot_count)
+        subghz_toolkit_call_graph_rehash_nodes(graph, graph->node_slot_count * 2);
+
+    return index;
+}
+
+// Each node is scanned once, so its outgoing edges are contiguous from `first`
+// and duplicates only need checking against those
+static void subghz_toolkit_call_graph_add_edge(SubGhzToolkitCallGraph *graph, size_t first, uint16_t from, uint16_t to, bool tail)
+{
+    for (size_t i = first; i < graph->edge_count; i++)
+    {
+        if (graph->edges[i].to == to)
+            return;
+    }
+
+    if (graph->edge_count == graph->edge_capacity)
+        graph->edges = subghz_toolkit_call_graph_grow(graph->edges, &graph->edge_capacity, sizeof(SubGhzToolkitCallEdge));
+
+    graph->edges[graph->edge_count++] = (SubGhzToolkitCallEdge){.from = from, .to = to, .tail = tail};
+    graph->nodes[to].fan_in++;
+}
+
+static void subghz_toolkit_call_graph_scan(SubGhzToolkitCallGraph *graph, uint16_t index)
+{
+    uint32_t address = graph->nodes[index].address;
+    size_t size = 0;
+    const uint8_t *code = graph->code_at(graph->context, address, &size);
+    if (!code)
+    {
+        graph->nodes[index].flags |= SUBGHZ_TOOLKIT_CALL_NODE_FLAG_EXTERNAL;
+        return;
+    }
+
+    // Copied: the cache entry moves when the cache grows
+    SubGhzToolkitFunction function = *subghz_toolkit_function_cache_get(
+        graph->cache, code, size, address, SUBGHZ_TOOLKIT_FUNCTION_NO_OWNER, 0, NULL);
+    graph->nodes[index].size = function.size;
+
+    size_t first_edge = graph->edge_count;
+    SubGhzToolkitFunctionCursor cursor = {0};
+    SubGhzToolkitThumbInsn insn;
+    while (subghz_toolkit_function_next(code, &function, &cursor, &insn))
+    {
+        bool tail = false;
+        switch (insn.op)
+        {
+        case SubGhzToolkitThumbOpBl:
+            break;
+        case SubGhzToolkitThumbOpB:
+        case SubGhzToolkitThumbOpBCond:
+            // Branches within the function are control flow, not calls
+            if (insn.target >= address && insn.target < address + function.code_size)
+                continue;
+            tail = true;
+            break;
+        case SubGhzToolkitThumbOpBlx:
+            graph->nodes[index].indirect++;
+            continue;
+        default:
+            continue;
+        }
+
+        int32_t target = subghz_toolkit_call_graph_node_index(graph, insn.target);
+        if (target >= 0)
+            subghz_toolkit_call_graph_add_edge(graph, first_edge, index, target, tail);
+    }
+}
+
+SubGhzToolkitCallGraph *subghz_toolkit_call_graph_alloc(
+    SubGhzToolkitFunctionCache *cache, SubGhzToolkitCodeAt code_at, void *context, size_t max_nodes)
+{
+    SubGhzToolkitCallGraph *graph = malloc(sizeof(SubGhzToolkitCallGraph));
+    memset(graph, 0, sizeof(*graph));
+    graph->cache = cache;
+    graph->code_at = code_at;
+    graph->context = context;
+    graph->max_nodes = max_nodes < SUBGHZ_TOOLKIT_CALL_GRAPH_MAX_NODES ? max_nodes : SUBGHZ_TOOLKIT_CALL_GRAPH_MAX_NODES;
+    subghz_toolkit_call_graph_rehash_nodes(graph, 128);
+    return graph;
+}
+
+void subghz_toolkit_call_graph_free(SubGhzToolkitCallGraph *graph)
+{
+    if (!graph)
+        return;
+    free(graph->nodes);
+    free(graph->node_slots);
+    free(graph->edges);
+    free(graph->pending);
+    free(graph);
+}
+
+size_t subghz_toolkit_call_graph_add_root(SubGhzToolkitCallGraph *graph, uint32_t address, uint16_t owner, uint8_t label)
+{
+    int32_t index = subghz_toolkit_call_graph_node_index(graph, address);
+    if (index < 0)
+        return SIZE_MAX;
+
+    SubGhzToolkitCallNode *node = &graph->nodes[index];
+    if (!(node->flags & SUBGHZ_TOOLKIT_CALL_NODE_FLAG_ROOT))
+    {
+        node->flags |= SUBGHZ_TOOLKIT_CALL_NODE_FLAG_ROOT;
+        node->owner = owner;
+        node->label = label;
+    }
+    node->roots++;
+
+    // Depth first from the explicit stack, so deep call chains cannot overflow the thread stack
+    while (graph->pending_count)
+        subghz_toolkit_call_graph_scan(graph, graph->pending[--graph->pending_count]);
+
+    return index;
+}
+
+size_t subghz_toolkit_call_graph_node_count(const SubGhzToolkitCallGraph *graph)
+{
+    return graph->node_count;
+}
+
+const SubGhzToolkitCallNode *subghz_toolkit_call_graph_node(const SubGhzToolkitCallGraph *graph, size_t i)
+{
+    return i < graph->node_count ? &graph->nodes[i] : NULL;
+}
+
+int32_t subghz_toolkit_call_graph_find(const SubGhzToolkitCallGraph *graph, uint32_t address)
+{
+    uint32_t index = *subghz_toolkit_call_graph_node_slot(graph, address);
+    return (int32_t)index - 1;
+}
+
+size_t subghz_toolkit_call_graph_edge_count(const SubGhzToolkitCallGraph *graph)
+{
+    return graph->edge_count;
+}
+
+const SubGhzToolkitCallEdge *subghz_toolkit_call_graph_edge(const SubGhzToolkitCallGraph *graph, size_t i)
+{
+    return i < graph->edge_count ? &graph->edges[i] : NULL;
+}
+
+size_t subghz_toolkit_call_graph_dropped(const SubGhzToolkitCallGraph *graph)
+{
+    return graph->dropped;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_function.h"
+
+// Static call graph over Thumb code.
+//
+// Roots are entry points (the protocol decoder/encoder pointers). Each new
+// function is bounded through the function cache and scanned for BL and for
+// B leaving the function (tail calls); every target becomes a node and is
+// explored once, tracked by an address hash set. Edges are deduplicated, so a
+// node's fan-in counts distinct callers. Memory is 16 bytes per node, 2 per
+// pending node, 4 per hash slot (2 to 4 slots per node, the set doubles at
+// half full) and 6 per edge. Indirect calls (BLX register) cannot be followed
+// and are only counted.
+
+#define SUBGHZ_TOOLKIT_CALL_NODE_FLAG_ROOT (1u << 0)
+#define SUBGHZ_TOOLKIT_CALL_NODE_FLAG_EXTERNAL (1u << 1) // not readable code, not followed
+
+typedef struct
+{
+    uint32_t address;
+    uint16_t size; // 0 for external nodes
+    uint16_t fan_in; // distinct callers
+    uint16_t roots; // entry point pointers leading here directly
+    uint16_t indirect; // BLX register calls made
+    uint16_t owner; // caller defined id of the first root, SUBGHZ_TOOLKIT_FUNCTION_NO_OWNER otherwise
+    uint8_t label;
+    uint8_t flags; // SUBGHZ_TOOLKIT_CALL_NODE_FLAG_*
+} SubGhzToolkitCallNode;
+
+typedef struct
+{
+    uint16_t from; // node indices
+    uint16_t to;
+    bool tail; // B instead of BL
+} SubGhzToolkitCallEdge;
+
+typedef struct SubGhzToolkitCallGraph SubGhzToolkitCallGraph;
+
+#define SUBGHZ_TOOLKIT_CALL_GRAPH_MAX_NODES 0xFFFF // node indices are 16 bit
+
+/** Functions are bounded through `cache`, which stays owned by the caller. At most `max_nodes` are kept. */
+SubGhzToolkitCallGraph *subghz_toolkit_call_graph_alloc(
+    SubGhzToolkitFunctionCache *cache, SubGhzToolkitCodeAt code_at, void *context, size_t max_nodes);
+
+void subghz_toolkit_call_graph_free(SubGhzToolkitCallGraph *graph);
+
+/** Add an entry point and explore everything it reaches. Returns its node index, SIZE_MAX when the graph is full. */
+size_t subghz_toolkit_call_graph_add_root(SubGhzToolkitCallGraph *graph, uint32_t address, uint16_t owner, uint8_t label);
+
+size_t subghz_toolkit_call_graph_node_count(const SubGhzToolkitCallGraph *graph);
+
+const SubGhzToolkitCallNode *subghz_toolkit_call_graph_node(const SubGhzToolkitCallGraph *graph, size_t i);
+
+/** Node index of `address`, or -1 */
+int32_t subghz_toolkit_call_graph_find(const SubGhzToolkitCallGraph *graph, uint32_t address);
+
+size_t subghz_toolkit_call_graph_edge_count(const SubGhzToolkitCallGraph *graph);
+
+/** Edges in discovery order */
+const SubGhzToolkitCallEdge *subghz_toolkit_call_graph_edge(const SubGhzToolkitCallGraph *graph, size_t i);
+
+/** Call targets dropped because the node limit was reached */
+size_t subghz_toolkit_call_graph_dropped(const SubGhzToolkitCallGraph *graph);
@@ -0,0 +1,259 @@
+#include "subghz_toolkit_capture.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SUBGHZ_TOOLKIT_CAPTURE_LEVEL_BIT 0x80000000u
+#define SUBGHZ_TOOLKIT_CAPTURE_PREFIX_SIZE (sizeof(SUBGHZ_TOOLKIT_RAW_PREFIX) - 1)
+// Room for a line prefix, one value and the newline that may end the line
+#define SUBGHZ_TOOLKIT_CAPTURE_PULSE_RESERVE (SUBGHZ_TOOLKIT_CAPTURE_PREFIX_SIZE + SUBGHZ_TOOLKIT_RAW_VALUE_SIZE + 1)
+
+struct SubGhzToolkitCapture
+{
+    // Ring: level in the top bit, duration below. head belongs to the producer, tail to the consumer.
+    uint32_t *ring;
+    uint32_t ring_mask;
+    _Atomic uint32_t head;
+    _Atomic uint32_t tail;
+    _Atomic uint32_t overflows;
+
+    // Blocks: full[i] is set by the consumer and cleared by the writer
+    uint8_t *blocks[2];
+    size_t block_size;
+    size_t sizes[2];
+    atomic_bool full[2];
+    atomic_bool finished;
+
+    // Consumer
+    uint8_t fill;
+    bool owned; // the consumer may write into blocks[fill]
+    size_t fill_size;
+    uint16_t line_values;
+    SubGhzToolkitRawPulseCallback tap;
+    void *tap_context;
+
+    // Writer
+    uint8_t write;
+
+    SubGhzToolkitCaptureStats stats;
+};
+
+SubGhzToolkitCapture *subghz_toolkit_capture_alloc(size_t ring_size, size_t block_size)
+{
+    SubGhzToolkitCapture *capture = malloc(sizeof(SubGhzToolkitCapture));
+    memset(capture, 0, sizeof(*capture));
+
+    capture->ring = malloc(ring_size * sizeof(uint32_t));
+    capture->ring_mask = (uint32_t)ring_size - 1;
+    atomic_init(&capture->head, 0);
+    atomic_init(&capture->tail, 0);
+    atomic_init(&capture->overflows, 0);
+
+    capture->block_size = block_size;
+    for (size_t i = 0; i < 2; i++)
+    {
+        capture->blocks[i] = malloc(block_size);
+        atomic_init(&capture->full[i], false);
+    }
+    atomic_init(&capture->finished, false);
+    capture->owned = true;
+
+    return capture;
+}
+
+void subghz_toolkit_capture_free(SubGhzToolkitCapture *capture)
+{
+    free(capture->blocks[0]);
+    free(capture->blocks[1]);
+    free(capture->ring);
+    free(capture);
+}
+
+void subghz_toolkit_capture_set_tap(SubGhzToolkitCapture *capture, SubGhzToolkitRawPulseCallback callback, void *context)
+{
+    capture->tap = callback;
+    capture->tap_context = context;
+}
+
+bool subghz_toolkit_capture_push(SubGhzToolkitCapture *capture, bool level, uint32_t duration)
+{
+    uint32_t head = atomic_load_explicit(&capture->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&capture->tail, memory_order_acquire);
+
+    if (head - tail > capture->ring_mask)
+    {
+        atomic_store_explicit(
+            &capture->overflows, atomic_load_explicit(&capture->overflows, memory_order_relaxed) + 1, memory_order_relaxed);
+        return false;
+    }
+
+    duration &= ~SUBGHZ_TOOLKIT_CAPTURE_LEVEL_BIT;
+    capture->ring[head & capture->ring_mask] = level ? duration | SUBGHZ_TOOLKIT_CAPTURE_LEVEL_BIT : duration;
+    atomic_store_explicit(&capture->head, head + 1, memory_order_release);
+    return true;
+}
+
+size_t subghz_toolkit_capture_pending(SubGhzToolkitCapture *capture)
+{
+    uint32_t head = atomic_load_explicit(&capture->head, memory_order_acquire);
+    return head - atomic_load_explicit(&capture->tail, memory_order_acquire);
+}
+
+static void subghz_toolkit_capture_publish(SubGhzToolkitCapture *capture)
+{
+    capture->sizes[capture->fill] = capture->fill_size;
+    atomic_store_explicit(&capture->full[capture->fill], true, memory_order_release);
+    capture->fill ^= 1;
+    capture->fill_size = 0;
+    capture->owned = false;
+}
+
+static bool subghz_toolkit_capture_own(SubGhzToolkitCapture *capture)
+{
+    if (!capture->owned && !atomic_load_explicit(&capture->full[capture->fill], memory_order_acquire))
+        capture->owned = true;
+    return capture->owned;
+}
+
+// Make sure the current block has room for one more pulse, switching blocks when it is full
+static bool subghz_toolkit_capture_reserve(SubGhzToolkitCapture *capture)
+{
+    if (!subghz_toolkit_capture_own(capture))
+        return false;
+    if (capture->block_size - capture->fill_size >= SUBGHZ_TOOLKIT_CAPTURE_PULSE_RESERVE)
+        return true;
+
+    subghz_toolkit_capture_publish(capture);
+    return subghz_toolkit_capture_own(capture);
+}
+
+size_t subghz_toolkit_capture_drain(SubGhzToolkitCapture *capture)
+{
+    uint32_t head = atomic_load_explicit(&capture->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&capture->tail, memory_order_relaxed);
+    size_t drained = 0;
+
+    if (head - tail > capture->stats.ring_peak)
+        capture->stats.ring_peak = head - tail;
+
+    while (tail != head)
+    {
+        if (!subghz_toolkit_capture_reserve(capture))
+        {
+            capture->stats.stalls++;
+            break;
+        }
+
+        uint32_t entry = capture->ring[tail & capture->ring_mask];
+        uint32_t duration = entry & ~SUBGHZ_TOOLKIT_CAPTURE_LEVEL_BIT;
+        uint8_t *out = capture->blocks[capture->fill] + capture->fill_size;
+        size_t length = 0;
+
+        if (!capture->line_values)
+        {
+            memcpy(out, SUBGHZ_TOOLKIT_RAW_PREFIX, SUBGHZ_TOOLKIT_CAPTURE_PREFIX_SIZE);
+            length = SUBGHZ_TOOLKIT_CAPTURE_PREFIX_SIZE;
+        }
+        length += subghz_toolkit_raw_format_value((char *)out + length, entry & SUBGHZ_TOOLKIT_CAPTURE_LEVEL_BIT, duration);
+        if (++capture->line_values == SUBGHZ_TOOLKIT_RAW_LINE_VALUES)
+        {
+            out[length++] = '\n';
+            capture->line_values = 0;
+        }
+
+        capture->fill_size += length;
+        capture->stats.bytes += length;
+        capture->stats.duration_us += duration;
+        if (capture->tap)
+            capture->tap(capture->tap_context, entry & SUBGHZ_TOOLKIT_CAPTURE_LEVEL_BIT, duration);
+        tail++;
+        drained++;
+    }
+
+    atomic_store_explicit(&capture->tail, tail, memory_order_release);
+    capture->stats.pulses += drained;
+    return drained;
+}
+
+void subghz_toolkit_capture_finish(SubGhzToolkitCapture *capture)
+{
+    // A block only goes to the writer once the next pulse needs room, so the last pulse is in an owned block
+    if (subghz_toolkit_capture_own(capture))
+    {
+        if (capture->line_values)
+        {
+            capture->blocks[capture->fill][capture->fill_size++] = '\n';
+            capture->stats.bytes++;
+            capture->line_values = 0;
+        }
+        if (capture->fill_size)
+            subghz_toolkit_capture_publish(capture);
+    }
+    atomic_store_explicit(&capture->finished, true, memory_order_release);
+}
+
+bool subghz_toolkit_capture_next_block(SubGhzToolkitCapture *capture, const uint8_t **data, size_t *size)
+{
+    if (!atomic_load_explicit(&capture->full[capture->write], memory_order_acquire))
+        return false;
+
+    *data = capture->blocks[capture->write];
+    *size = capture->sizes[capture->write];
+    return true;
+}
+
+void subghz_toolkit_capture_block_done(SubGhzToolkitCapture *capture, uint32_t elapsed_ms)
+{
+    capture->stats.blocks++;
+    capture->stats.write_ms += elapsed_ms;
+    if (elapsed_ms > capture->stats.write_ms_max)
+        capture->stats.write_ms_max = elapsed_ms;
+
+    atomic_store_explicit(&capture->full[capture->write], false, memory_order_release);
+    capture->write ^= 1;
+}
+
+bool subghz_toolkit_capture_is_flushed(SubGhzToolkitCapture *capture)
+{
+    return atomic_load_explicit(&capture->finished, memory_order_acquire) &&
+           !atomic_load_explicit(&capture->full[0], memory_order_acquire) &&
+           !atomic_load_explicit(&capture->full[1], memory_order_acquire);
+}
+
+const SubGhzToolkitCaptureStats *subghz_toolkit_capture_get_stats(SubGhzToolkitCapture *capture)
+{
+    capture->stats.overflows = atomic_load_explicit(&capture->overflows, memory_order_relaxed);
+    return &capture->stats;
+}
+
+void subghz_toolkit_capture_write_report(SubGhzToolkitWriter *writer, SubGhzToolkitCapture *capture, uint32_t elapsed_ms)
+{
+    const SubGhzToolkitCaptureStats *stats = subghz_toolkit_capture_get_stats(capture);
+    uint32_t pulses_per_sec = elapsed_ms ? (uint32_t)((uint64_t)stats->pulses * 1000 / elapsed_ms) : 0;
+    uint32_t bytes_per_sec = elapsed_ms ? (uint32_t)(stats->bytes * 1000 / elapsed_ms) : 0;
+
+    subghz_toolkit_writer_printf(writer,
+                                 "Capture Statistics:\n"
+                                 "  Pulses:           %lu\n"
+                                 "  Dropped:          %lu (ring full)\n"
+                                 "  Ring peak:        %lu of %lu pulses\n"
+                                 "  Writer stalls:    %lu\n"
+                                 "  Signal length:    %lu ms\n"
+                                 "  RAW written:      %lu bytes in %lu blocks\n"
+                                 "  Block writes:     %lu ms total, %lu ms max\n"
+                                 "  Sustained:        %lu pulses/s, %lu B/s over %lu ms\n",
+                                 (unsigned long)stats->pulses,
+                                 (unsigned long)stats->overflows,
+                                 (unsigned long)stats->ring_peak,
+                                 (unsigned long)(capture->ring_mask + 1),
+                                 (unsigned long)stats->stalls,
+                                 (unsigned long)(stats->duration_us / 1000),
+                                 (unsigned long)stats->bytes,
+                                 (unsigned long)stats->blocks,
+                                 (unsigned long)stats->write_ms,
+                                 (unsigned long)stats->write_ms_max,
+                                 (unsigned long)pulses_per_sec,
+                                 (unsigned long)bytes_per_sec,
+                                 (unsigned long)elapsed_ms);
+}
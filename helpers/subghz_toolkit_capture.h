@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_raw.h"
+#include "subghz_toolkit_writer.h"
+
+// Capture pipeline for (level, duration) pulses:
+//
+//   source --push()--> ring --drain()--> block A | block B --next_block()--> SD
+//
+// The ring is single producer / single consumer and lock free, so push() can
+// run in the radio interrupt while drain() runs on a consumer thread. drain()
+// formats pulses as RAW_Data lines (see subghz_toolkit_raw.h) into one block
+// while a writer thread stores the other one. Nothing allocates or blocks
+// after alloc(); when the ring is full push() drops the pulse and counts it,
+// when both blocks wait for the writer drain() leaves pulses in the ring.
+// Analyses of the live signal hook in with a tap, which sees every pulse
+// drain() takes from the ring, on the consumer thread.
+
+#define SUBGHZ_TOOLKIT_CAPTURE_RING_SIZE 2048 // pulses, power of two
+#define SUBGHZ_TOOLKIT_CAPTURE_BLOCK_SIZE 4096 // bytes, a multiple of the SD sector
+
+typedef struct SubGhzToolkitCapture SubGhzToolkitCapture;
+
+// Where pulses come from: the radio on the Flipper, a RAW file replay on the host.
+// start() begins calling subghz_toolkit_capture_push() from the source's own
+// context (interrupt, timer or thread) until stop().
+typedef struct
+{
+    const char *name;
+    bool (*start)(void *context, SubGhzToolkitCapture *capture);
+    void (*stop)(void *context);
+    bool (*is_done)(void *context); // NULL for sources that never run out, such as the radio
+    void *context;
+} SubGhzToolkitCaptureSource;
+
+typedef struct
+{
+    uint32_t pulses;      // drained from the ring
+    uint32_t overflows;   // dropped by push() on a full ring
+    uint32_t ring_peak;   // most pulses waiting in the ring at once
+    uint32_t stalls;      // drains cut short with both blocks waiting for the writer
+    uint32_t blocks;      // blocks written
+    uint32_t write_ms;    // total time spent in block writes
+    uint32_t write_ms_max;
+    uint64_t bytes;       // RAW text produced
+    uint64_t duration_us; // sum of pulse durations, the length of the signal
+} SubGhzToolkitCaptureStats;
+
+/** `ring_size` pulses (power of two), two blocks of `block_size` bytes */
+SubGhzToolkitCapture *subghz_toolkit_capture_alloc(size_t ring_size, size_t block_size);
+
+void subghz_toolkit_capture_free(SubGhzToolkitCapture *capture);
+
+/** Consumer: hand every drained pulse to `callback` as well, NULL to remove */
+void subghz_toolkit_capture_set_tap(SubGhzToolkitCapture *capture, SubGhzToolkitRawPulseCallback callback, void *context);
+
+/** Producer: queue a pulse. False when the ring is full and the pulse was dropped. */
+bool subghz_toolkit_capture_push(SubGhzToolkitCapture *capture, bool level, uint32_t duration);
+
+/** Consumer: move queued pulses into the current block. Returns the pulses drained. */
+size_t subghz_toolkit_capture_drain(SubGhzToolkitCapture *capture);
+
+/** Pulses still queued in the ring, from either side */
+size_t subghz_toolkit_capture_pending(SubGhzToolkitCapture *capture);
+
+/** Consumer, after the last drain(): end the RAW line and hand over the partly filled block */
+void subghz_toolkit_capture_finish(SubGhzToolkitCapture *capture);
+
+/** Writer: the next full block, false if there is none yet */
+bool subghz_toolkit_capture_next_block(SubGhzToolkitCapture *capture, const uint8_t **data, size_t *size);
+
+/** Writer: the block from next_block() is stored and can be refilled, `elapsed_ms` is how long that took */
+void subghz_toolkit_capture_block_done(SubGhzToolkitCapture *capture, uint32_t elapsed_ms);
+
+/** Writer: finish() was called and every block has been written */
+bool subghz_toolkit_capture_is_flushed(SubGhzToolkitCapture *capture);
+
+const SubGhzToolkitCaptureStats *subghz_toolkit_capture_get_stats(SubGhzToolkitCapture *capture);
+
+/** Counters and sustained rates of a capture that ran for `elapsed_ms` */
+void subghz_toolkit_capture_write_report(SubGhzToolkitWriter *writer, SubGhzToolkitCapture *capture, uint32_t elapsed_ms);
@@ -0,0 +1,463 @@
+#include "subghz_toolkit_classify.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SUBGHZ_TOOLKIT_CLASSIFY_LEVEL_BIT 0x8000u
+#define SUBGHZ_TOOLKIT_CLASSIFY_GAP 0x7FFFu
+#define SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE 8 // longer pulses inside a frame count as 8 te
+#define SUBGHZ_TOOLKIT_CLASSIFY_GAP_MULTIPLE 16 // a low this many te long ends a frame
+#define SUBGHZ_TOOLKIT_CLASSIFY_MIN_PULSES 16
+#define SUBGHZ_TOOLKIT_CLASSIFY_MIN_SYMBOL 50 // per mille of the pairs, for the rarer of two symbols
+#define SUBGHZ_TOOLKIT_CLASSIFY_NRZ_PRIOR 7 // tenths: NRZ fits anything on the grid, so it needs a clear lead
+#define SUBGHZ_TOOLKIT_CLASSIFY_MARGIN 250 // per mille lead over the next encoding for full confidence
+
+// A pulse as a multiple of te: level in the top bit, 0 for a gap, 1..8 otherwise
+#define SUBGHZ_TOOLKIT_CLASSIFY_SYMBOL_LEVEL 0x80u
+#define SUBGHZ_TOOLKIT_CLASSIFY_SYMBOL_GAP 0
+
+typedef struct
+{
+    const uint8_t *symbols;
+    size_t count;
+    uint32_t on_grid; // pulses within te/3 of their multiple
+    uint32_t pulses; // pulses inside frames
+    uint32_t pairs[SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE + 1][SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE + 1]; // (high, low) in te
+    uint32_t pair_count;
+    size_t longest_start; // frame with the most pulses
+    size_t longest_count;
+} SubGhzToolkitClassifyStats;
+
+typedef struct
+{
+    uint8_t *bits;
+    size_t bit_count;
+} SubGhzToolkitClassifyBits;
+
+void subghz_toolkit_classify_init(SubGhzToolkitClassifier *classifier)
+{
+    memset(classifier, 0, sizeof(*classifier));
+}
+
+void subghz_toolkit_classify_add(SubGhzToolkitClassifier *classifier, bool level, uint32_t duration)
+{
+    bool gap = duration >= SUBGHZ_TOOLKIT_CLASSIFY_GAP;
+
+    if (!classifier->started)
+    {
+        // Everything up to the first long pause is whatever the receiver heard before the transmission
+        classifier->started = gap || (!level && duration >= 10000);
+        if (!classifier->started)
+            return;
+    }
+    if (classifier->count == SUBGHZ_TOOLKIT_CLASSIFY_PULSES)
+        return;
+
+    uint16_t value = gap ? SUBGHZ_TOOLKIT_CLASSIFY_GAP : (uint16_t)duration;
+    classifier->pulses[classifier->count++] = level ? value | SUBGHZ_TOOLKIT_CLASSIFY_LEVEL_BIT : value;
+}
+
+void subghz_toolkit_classify_feed(void *context, bool level, uint32_t duration)
+{
+    subghz_toolkit_classify_add(context, level, duration);
+}
+
+const char *subghz_toolkit_encoding_name(SubGhzToolkitEncoding encoding)
+{
+    static const char *const names[] = {
+        "PWM",
+        "PPM",
+        "Manchester",
+        "Differential Manchester",
+        "NRZ",
+        "Unknown",
+    };
+    return names[encoding <= SubGhzToolkitEncodingUnknown ? encoding : SubGhzToolkitEncodingUnknown];
+}
+
+static void subghz_toolkit_classify_push_bit(SubGhzToolkitClassifyBits *out, bool bit)
+{
+    if (out->bit_count == SUBGHZ_TOOLKIT_CLASSIFY_MAX_BITS)
+        return;
+    if (bit)
+        out->bits[out->bit_count / 8] |= 0x80 >> (out->bit_count % 8);
+    out->bit_count++;
+}
+
+static uint8_t subghz_toolkit_classify_multiple(const SubGhzToolkitClassifyStats *stats, size_t i)
+{
+    return stats->symbols[i] & ~SUBGHZ_TOOLKIT_CLASSIFY_SYMBOL_LEVEL;
+}
+
+static bool subghz_toolkit_classify_level(const SubGhzToolkitClassifyStats *stats, size_t i)
+{
+    return stats->symbols[i] & SUBGHZ_TOOLKIT_CLASSIFY_SYMBOL_LEVEL;
+}
+
+// Quantize the kept pulses to multiples of te and collect the symbol statistics
+static void subghz_toolkit_classify_quantize(
+    const SubGhzToolkitClassifier *classifier, uint32_t te, uint8_t *symbols, SubGhzToolkitClassifyStats *stats)
+{
+    size_t frame_start = 0;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->symbols = symbols;
+    stats->count = classifier->count;
+
+    for (size_t i = 0; i <= classifier->count; i++)
+    {
+        bool end = i == classifier->count;
+        uint16_t pulse = end ? SUBGHZ_TOOLKIT_CLASSIFY_GAP : classifier->pulses[i];
+        uint32_t duration = pulse & ~SUBGHZ_TOOLKIT_CLASSIFY_LEVEL_BIT;
+        bool level = pulse & SUBGHZ_TOOLKIT_CLASSIFY_LEVEL_BIT;
+        uint32_t multiple = (duration + te / 2) / te;
+
+        if (duration == SUBGHZ_TOOLKIT_CLASSIFY_GAP || (!level && multiple >= SUBGHZ_TOOLKIT_CLASSIFY_GAP_MULTIPLE))
+        {
+            if (i - frame_start > stats->longest_count)
+            {
+                stats->longest_start = frame_start;
+                stats->longest_count = i - frame_start;
+            }
+            if (!end)
+                symbols[i] = SUBGHZ_TOOLKIT_CLASSIFY_SYMBOL_GAP;
+            frame_start = i + 1;
+            continue;
+        }
+
+        if (!multiple)
+            multiple = 1; // a glitch, off the grid
+        else if (multiple * te + te / 3 >= duration && duration + te / 3 >= multiple * te)
+            stats->on_grid++;
+        if (multiple > SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE)
+            multiple = SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE;
+
+        symbols[i] = (uint8_t)multiple | (level ? SUBGHZ_TOOLKIT_CLASSIFY_SYMBOL_LEVEL : 0);
+        stats->pulses++;
+
+        // A low following a high of the same frame completes a pair
+        if (!level && i > frame_start && subghz_toolkit_classify_level(stats, i - 1))
+        {
+            stats->pairs[subghz_toolkit_classify_multiple(stats, i - 1)][multiple]++;
+            stats->pair_count++;
+        }
+    }
+}
+
+// Scale a score whose rarer symbol is too rare to carry data
+static uint32_t subghz_toolkit_classify_two_symbols(uint32_t first, uint32_t second, uint32_t total)
+{
+    uint32_t score = (first + second) * 1000 / total;
+    return second * 1000 / total >= SUBGHZ_TOOLKIT_CLASSIFY_MIN_SYMBOL ? score : score / 2;
+}
+
+static uint32_t subghz_toolkit_classify_score_pwm(const SubGhzToolkitClassifyStats *stats, SubGhzToolkitClassification *result)
+{
+    uint32_t best = 0;
+
+    for (uint32_t period = 3; period <= 2 * SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE; period++)
+    {
+        // The two most common unequal pairs with this period
+        uint32_t counts[2] = {0, 0};
+        uint8_t highs[2] = {0, 0};
+        for (uint32_t high = 1; high <= SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE; high++)
+        {
+            uint32_t low = period - high;
+            if (low < 1 || low > SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE || low == high)
+                continue;
+            uint32_t count = stats->pairs[high][low];
+            if (count > counts[0])
+            {
+                counts[1] = counts[0];
+                highs[1] = highs[0];
+                counts[0] = count;
+                highs[0] = (uint8_t)high;
+            }
+            else if (count > counts[1])
+            {
+                counts[1] = count;
+                highs[1] = (uint8_t)high;
+            }
+        }
+
+        uint32_t score = subghz_toolkit_classify_two_symbols(counts[0], counts[1], stats->pair_count);
+        if (score > best)
+        {
+            best = score;
+            result->period = (uint8_t)period;
+            // A 1 has the longer high
+            result->symbols[0] = highs[0] < highs[1] || !highs[1] ? highs[0] : highs[1];
+            result->symbols[1] = highs[0] < highs[1] || !highs[1] ? highs[1] : highs[0];
+        }
+    }
+    return best;
+}
+
+static uint32_t subghz_toolkit_classify_score_ppm(const SubGhzToolkitClassifyStats *stats, uint8_t symbols[2])
+{
+    uint32_t high_counts[SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE + 1] = {0};
+    uint32_t marker = 1;
+
+    for (uint32_t high = 1; high <= SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE; high++)
+    {
+        for (uint32_t low = 1; low <= SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE; low++)
+            high_counts[high] += stats->pairs[high][low];
+        if (high_counts[high] > high_counts[marker])
+            marker = high;
+    }
+
+    // The two most common lows after the constant high
+    uint32_t counts[2] = {0, 0};
+    uint8_t lows[2] = {0, 0};
+    for (uint32_t low = 1; low <= SUBGHZ_TOOLKIT_CLASSIFY_MAX_MULTIPLE; low++)
+    {
+        uint32_t count = stats->pairs[marker][low];
+        if (count > counts[0])
+        {
+            counts[1] = counts[0];
+            lows[1] = lows[0];
+            counts[0] = count;
+            lows[0] = (uint8_t)low;
+        }
+        else if (count > counts[1])
+        {
+            counts[1] = count;
+            lows[1] = (uint8_t)low;
+        }
+    }
+
+    // A 1 has the longer low
+    symbols[0] = lows[0] < lows[1] || !lows[1] ? lows[0] : lows[1];
+    symbols[1] = lows[0] < lows[1] || !lows[1] ? lows[1] : lows[0];
+    return subghz_toolkit_classify_two_symbols(counts[0], counts[1], stats->pair_count);
+}
+
+// Manchester half-bits of one frame, paired from `phase`. Returns the pairs with two equal halves.
+static uint32_t subghz_toolkit_classify_manchester_frame(
+    const SubGhzToolkitClassifyStats *stats,
+    size_t start,
+    size_t count,
+    uint32_t phase,
+    uint32_t *pairs,
+    SubGhzToolkitClassifyBits *manchester,
+    SubGhzToolkitClassifyBits *differential)
+{
+    uint32_t violations = 0;
+    uint32_t halves = 0;
+    bool first = false;
+    bool previous = false; // second half of the last bit; the gap before a frame is low
+
+    // The gap that ends the frame is low, one more half-bit of it closes the last pair
+    for (size_t i = start; i <= start + count; i++)
+    {
+        bool level = i < start + count && subghz_toolkit_classify_level(stats, i);
+        uint8_t multiple = i < start + count ? subghz_toolkit_classify_multiple(stats, i) : 1;
+        if (multiple > 2)
+        {
+            violations++;
+            multiple = 2;
+        }
+
+        for (uint8_t half = 0; half < multiple; half++, halves++)
+        {
+            if (halves < phase)
+                continue;
+            if ((halves - phase) % 2 == 0)
+            {
+                first = level;
+                continue;
+            }
+
+            (*pairs)++;
+            if (first == level)
+            {
+                violations++;
+            }
+            else
+            {
+                if (manchester)
+                    subghz_toolkit_classify_push_bit(manchester, first);
+                if (differential)
+                    subghz_toolkit_classify_push_bit(differential, first == previous);
+            }
+            previous = level;
+        }
+    }
+    return violations;
+}
+
+static uint32_t subghz_toolkit_classify_score_manchester(const SubGhzToolkitClassifyStats *stats)
+{
+    uint32_t short_pulses = 0;
+    uint32_t pairs = 0;
+    uint32_t violations = 0;
+    size_t frame_start = 0;
+
+    for (size_t i = 0; i <= stats->count; i++)
+    {
+        if (i < stats->count && stats->symbols[i] != SUBGHZ_TOOLKIT_CLASSIFY_SYMBOL_GAP)
+        {
+            short_pulses += subghz_toolkit_classify_multiple(stats, i) <= 2;
+            continue;
+        }
+        if (i > frame_start)
+        {
+            uint32_t pairs_phase[2] = {0, 0};
+            uint32_t even = subghz_toolkit_classify_manchester_frame(stats, frame_start, i - frame_start, 0, &pairs_phase[0], NULL, NULL);
+            uint32_t odd = subghz_toolkit_classify_manchester_frame(stats, frame_start, i - frame_start, 1, &pairs_phase[1], NULL, NULL);
+            pairs += even <= odd ? pairs_phase[0] : pairs_phase[1];
+            violations += even <= odd ? even : odd;
+        }
+        frame_start = i + 1;
+    }
+    if (!pairs || violations > pairs)
+        return 0;
+
+    return (uint32_t)((uint64_t)short_pulses * (pairs - violations) * 1000 / ((uint64_t)stats->pulses * pairs));
+}
+
+static void subghz_toolkit_classify_decode(const SubGhzToolkitClassifyStats *stats, SubGhzToolkitClassification *result)
+{
+    SubGhzToolkitClassifyBits out = {.bits = result->bits};
+    size_t start = stats->longest_start;
+    size_t end = start + stats->longest_count;
+
+    memset(result->bits, 0, sizeof(result->bits));
+    switch (result->encoding)
+    {
+    case SubGhzToolkitEncodingPwm:
+    case SubGhzToolkitEncodingPpm:
+        for (size_t i = start; i < end; i++)
+        {
+            // The high whose low is the gap is the sync/stop pulse, not a bit, and ends the frame
+            if (!subghz_toolkit_classify_level(stats, i) || i + 1 == end)
+                continue;
+            uint8_t high = subghz_toolkit_classify_multiple(stats, i);
+            uint8_t low = subghz_toolkit_classify_multiple(stats, i + 1);
+            // PWM: the high decides. PPM: the low after the marker.
+            uint8_t symbol = result->encoding == SubGhzToolkitEncodingPwm ? high : low;
+            if (symbol == result->symbols[0] || symbol == result->symbols[1])
+                subghz_toolkit_classify_push_bit(&out, symbol == result->symbols[1]);
+        }
+        break;
+    case SubGhzToolkitEncodingManchester:
+    case SubGhzToolkitEncodingDifferentialManchester:
+    {
+        uint32_t pairs[2] = {0, 0};
+        uint32_t even = subghz_toolkit_classify_manchester_frame(stats, start, end - start, 0, &pairs[0], NULL, NULL);
+        uint32_t odd = subghz_toolkit_classify_manchester_frame(stats, start, end - start, 1, &pairs[1], NULL, NULL);
+        bool manchester = result->encoding == SubGhzToolkitEncodingManchester;
+        subghz_toolkit_classify_manchester_frame(
+            stats, start, end - start, even <= odd ? 0 : 1, &pairs[0], manchester ? &out : NULL, manchester ? NULL : &out);
+        break;
+    }
+    case SubGhzToolkitEncodingNrz:
+        for (size_t i = start; i < end; i++)
+        {
+            for (uint8_t bit = 0; bit < subghz_toolkit_classify_multiple(stats, i); bit++)
+                subghz_toolkit_classify_push_bit(&out, subghz_toolkit_classify_level(stats, i));
+        }
+        break;
+    default:
+        break;
+    }
+    result->bit_count = out.bit_count;
+}
+
+bool subghz_toolkit_classify(const SubGhzToolkitClassifier *classifier, uint32_t te, SubGhzToolkitClassification *result)
+{
+    memset(result, 0, sizeof(*result));
+    result->encoding = SubGhzToolkitEncodingUnknown;
+    result->te = te;
+    if (!te || classifier->count < SUBGHZ_TOOLKIT_CLASSIFY_MIN_PULSES)
+        return false;
+
+    uint8_t *symbols = malloc(classifier->count);
+    SubGhzToolkitClassifyStats *stats = malloc(sizeof(SubGhzToolkitClassifyStats));
+    subghz_toolkit_classify_quantize(classifier, te, symbols, stats);
+
+    bool classified = stats->pulses >= SUBGHZ_TOOLKIT_CLASSIFY_MIN_PULSES && stats->pair_count;
+    if (classified)
+    {
+        uint8_t ppm_symbols[2];
+        uint32_t manchester = subghz_toolkit_classify_score_manchester(stats);
+
+        result->scores[SubGhzToolkitEncodingPwm] = (uint16_t)subghz_toolkit_classify_score_pwm(stats, result);
+        result->scores[SubGhzToolkitEncodingPpm] = (uint16_t)subghz_toolkit_classify_score_ppm(stats, ppm_symbols);
+        result->scores[SubGhzToolkitEncodingManchester] = (uint16_t)manchester;
+        result->scores[SubGhzToolkitEncodingDifferentialManchester] = (uint16_t)(manchester ? manchester - 1 : 0);
+        result->scores[SubGhzToolkitEncodingNrz] =
+            (uint16_t)(stats->on_grid * 100 * SUBGHZ_TOOLKIT_CLASSIFY_NRZ_PRIOR / stats->pulses);
+
+        // Best and runner-up, the Manchester pair counting as one family
+        SubGhzToolkitEncoding best = SubGhzToolkitEncodingPwm;
+        for (SubGhzToolkitEncoding encoding = SubGhzToolkitEncodingPpm; encoding < SubGhzToolkitEncodingCount; encoding++)
+        {
+            if (result->scores[encoding] > result->scores[best])
+                best = encoding;
+        }
+        uint32_t runner_up = 0;
+        for (SubGhzToolkitEncoding encoding = SubGhzToolkitEncodingPwm; encoding < SubGhzToolkitEncodingCount; encoding++)
+        {
+            bool sibling = encoding == SubGhzToolkitEncodingDifferentialManchester && best == SubGhzToolkitEncodingManchester;
+            if (encoding != best && !sibling && result->scores[encoding] > runner_up)
+                runner_up = result->scores[encoding];
+        }
+
+        uint32_t margin = result->scores[best] - runner_up;
+        result->encoding = best;
+        result->confidence = (uint16_t)(margin >= SUBGHZ_TOOLKIT_CLASSIFY_MARGIN ? result->scores[best] :
+                                                                                   result->scores[best] * margin / SUBGHZ_TOOLKIT_CLASSIFY_MARGIN);
+        if (best == SubGhzToolkitEncodingPpm)
+            memcpy(result->symbols, ppm_symbols, sizeof(ppm_symbols));
+        else if (best != SubGhzToolkitEncodingPwm)
+            memset(result->symbols, 0, sizeof(result->symbols));
+        if (best != SubGhzToolkitEncodingPwm)
+            result->period = 0;
+        subghz_toolkit_classify_decode(stats, result);
+    }
+
+    free(stats);
+    free(symbols);
+    return classified;
+}
+
+void subghz_toolkit_classify_write_report(SubGhzToolkitWriter *writer, const SubGhzToolkitClassification *result)
+{
+    subghz_toolkit_writer_cstr(writer, "Encoding:\n");
+    if (result->encoding == SubGhzToolkitEncodingUnknown)
+    {
+        subghz_toolkit_writer_cstr(writer, "  Not enough framed pulses on a te grid to classify\n");
+        return;
+    }
+
+    subghz_toolkit_writer_printf(writer,
+                                 "  Best:             %s, confidence %u.%u%%\n",
+                                 subghz_toolkit_encoding_name(result->encoding),
+                                 result->confidence / 10,
+                                 result->confidence % 10);
+    if (result->encoding == SubGhzToolkitEncodingPwm)
+        subghz_toolkit_writer_printf(writer, "  Symbols:          0 = %u te high, 1 = %u te high, %u te per bit\n",
+                                     result->symbols[0], result->symbols[1], result->period);
+    else if (result->encoding == SubGhzToolkitEncodingPpm)
+        subghz_toolkit_writer_printf(writer, "  Symbols:          0 = %u te low, 1 = %u te low\n", result->symbols[0], result->symbols[1]);
+    else if (result->encoding == SubGhzToolkitEncodingManchester || result->encoding == SubGhzToolkitEncodingDifferentialManchester)
+        subghz_toolkit_writer_cstr(writer, "  Note:             Manchester and differential Manchester share a waveform\n");
+
+    subghz_toolkit_writer_cstr(writer, "  Scores:          ");
+    for (SubGhzToolkitEncoding encoding = SubGhzToolkitEncodingPwm; encoding < SubGhzToolkitEncodingCount; encoding++)
+        subghz_toolkit_writer_printf(writer, " %s %u.%u%%%s", subghz_toolkit_encoding_name(encoding),
+                                     result->scores[encoding] / 10, result->scores[encoding] % 10,
+                                     encoding + 1 < SubGhzToolkitEncodingCount ? "," : "\n");
+
+    subghz_toolkit_writer_printf(writer, "  Bits:             %u of the longest frame\n    ", (unsigned)result->bit_count);
+    for (size_t i = 0; i < result->bit_count; i++)
+    {
+        subghz_toolkit_writer_write(writer, (result->bits[i / 8] & (0x80 >> (i % 8))) ? "1" : "0", 1);
+        if (i % 64 == 63 && i + 1 < result->bit_count)
+            subghz_toolkit_writer_cstr(writer, "\n    ");
+    }
+    subghz_toolkit_writer_cstr(writer, "\n    Hex: ");
+    subghz_toolkit_writer_hex(writer, result->bits, (result->bit_count + 7) / 8);
+    subghz_toolkit_writer_cstr(writer, "\n");
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_writer.h"
+
+// Line coding classifier for unknown signals.
+//
+// add() keeps the first SUBGHZ_TOOLKIT_CLASSIFY_PULSES pulses after the first
+// gap, skipping the noise before a transmission starts; remotes repeat their
+// frame, so that window is representative of any capture length. classify()
+// quantizes the window to multiples of te (from subghz_toolkit_clusters.h) and
+// scores each encoding on the quantized symbols:
+//
+//   PWM         (high, low) pairs with a constant period and two duty cycles
+//   PPM         constant high, two low lengths
+//   Manchester  1 and 2 te pulses only, every bit has a mid-bit transition
+//   Diff. Manch.same waveform as Manchester, bits are the boundary transitions
+//   NRZ         any whole multiple of te, the fallback that explains the rest
+//
+// Manchester and differential Manchester produce identical waveforms and
+// cannot be told apart without knowing the protocol; plain Manchester is
+// preferred on a tie and the report says so. The winning encoding decodes the
+// longest frame of the window into bits; for PWM and PPM the high in front of
+// the closing gap is the sync/stop pulse and adds no bit.
+
+#define SUBGHZ_TOOLKIT_CLASSIFY_PULSES 2048
+#define SUBGHZ_TOOLKIT_CLASSIFY_MAX_BITS 1024
+
+typedef enum
+{
+    SubGhzToolkitEncodingPwm,
+    SubGhzToolkitEncodingPpm,
+    SubGhzToolkitEncodingManchester,
+    SubGhzToolkitEncodingDifferentialManchester,
+    SubGhzToolkitEncodingNrz,
+    SubGhzToolkitEncodingCount,
+    SubGhzToolkitEncodingUnknown = SubGhzToolkitEncodingCount,
+} SubGhzToolkitEncoding;
+
+typedef struct
+{
+    uint16_t pulses[SUBGHZ_TOOLKIT_CLASSIFY_PULSES]; // level in the top bit, duration in us below, 0x7FFF for gaps
+    size_t count;
+    bool started; // a gap was seen, pulses are being kept
+} SubGhzToolkitClassifier;
+
+typedef struct
+{
+    SubGhzToolkitEncoding encoding;
+    uint16_t confidence; // per mille: the winner's score, cut when the next encoding scores close to it
+    uint16_t scores[SubGhzToolkitEncodingCount]; // per mille of the symbols each encoding explains
+    uint32_t te;
+    uint8_t symbols[2]; // PWM: high length of a 0 and a 1 bit, PPM: low length of a 0 and a 1, in te
+    uint8_t period; // PWM: high + low, in te
+    uint8_t bits[SUBGHZ_TOOLKIT_CLASSIFY_MAX_BITS / 8]; // MSB first
+    size_t bit_count;
+} SubGhzToolkitClassification;
+
+void subghz_toolkit_classify_init(SubGhzToolkitClassifier *classifier);
+
+/** Keep a pulse for classify() while there is room */
+void subghz_toolkit_classify_add(SubGhzToolkitClassifier *classifier, bool level, uint32_t duration);
+
+/** subghz_toolkit_classify_add() as a SubGhzToolkitRawPulseCallback, `context` is the classifier */
+void subghz_toolkit_classify_feed(void *context, bool level, uint32_t duration);
+
+/** Score every encoding for base element `te` and decode with the best. False without enough pulses or te. */
+bool subghz_toolkit_classify(const SubGhzToolkitClassifier *classifier, uint32_t te, SubGhzToolkitClassification *result);
+
+const char *subghz_toolkit_encoding_name(SubGhzToolkitEncoding encoding);
+
+/** Winner, confidence, every score and the decoded bits */
+void subghz_toolkit_classify_write_report(SubGhzToolkitWriter *writer, const SubGhzToolkitClassification *result);
@@ -0,0 +1,308 @@
+#include "subghz_toolkit_clusters.h"
+
+#include <string.h>
+
+#define SUBGHZ_TOOLKIT_CLUSTERS_EXACT 16 // durations below are binned one per microsecond
+#define SUBGHZ_TOOLKIT_CLUSTERS_BINS_PER_OCTAVE 16
+#define SUBGHZ_TOOLKIT_CLUSTERS_MIN_PULSES 16
+#define SUBGHZ_TOOLKIT_CLUSTERS_MAX_WIDTH 6 // bins either side of a peak, about +-30%
+#define SUBGHZ_TOOLKIT_CLUSTERS_MAX_DIVISOR 4 // te may be the shortest cluster / 1 .. 4
+#define SUBGHZ_TOOLKIT_CLUSTERS_MAX_MULTIPLE 16
+
+static size_t subghz_toolkit_clusters_bin(uint32_t duration)
+{
+    if (duration < SUBGHZ_TOOLKIT_CLUSTERS_EXACT)
+        return duration;
+
+    uint32_t octave = 31 - (uint32_t)__builtin_clz(duration) - 4;
+    return SUBGHZ_TOOLKIT_CLUSTERS_EXACT + octave * SUBGHZ_TOOLKIT_CLUSTERS_BINS_PER_OCTAVE +
+           ((duration >> octave) & (SUBGHZ_TOOLKIT_CLUSTERS_BINS_PER_OCTAVE - 1));
+}
+
+static uint32_t subghz_toolkit_clusters_bin_low(size_t bin)
+{
+    if (bin < SUBGHZ_TOOLKIT_CLUSTERS_EXACT)
+        return (uint32_t)bin;
+
+    uint32_t octave = (uint32_t)(bin - SUBGHZ_TOOLKIT_CLUSTERS_EXACT) / SUBGHZ_TOOLKIT_CLUSTERS_BINS_PER_OCTAVE;
+    uint32_t step = (uint32_t)(bin - SUBGHZ_TOOLKIT_CLUSTERS_EXACT) % SUBGHZ_TOOLKIT_CLUSTERS_BINS_PER_OCTAVE;
+    return (SUBGHZ_TOOLKIT_CLUSTERS_EXACT + step) << octave;
+}
+
+static uint32_t subghz_toolkit_clusters_bin_high(size_t bin)
+{
+    return bin + 1 < SUBGHZ_TOOLKIT_CLUSTERS_BINS ? subghz_toolkit_clusters_bin_low(bin + 1) - 1 : SUBGHZ_TOOLKIT_CLUSTERS_MAX_DURATION;
+}
+
+static uint32_t subghz_toolkit_clusters_distance(uint32_t a, uint32_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+void subghz_toolkit_clusters_init(SubGhzToolkitClusters *clusters)
+{
+    memset(clusters, 0, sizeof(*clusters));
+}
+
+void subghz_toolkit_clusters_add(SubGhzToolkitClusters *clusters, bool level, uint32_t duration)
+{
+    clusters->pulses++;
+    if (level)
+    {
+        clusters->high_pulses++;
+        clusters->high_us += duration;
+    }
+    else
+    {
+        clusters->low_us += duration;
+    }
+
+    if (duration > SUBGHZ_TOOLKIT_CLUSTERS_MAX_DURATION)
+    {
+        clusters->gaps++;
+        return;
+    }
+
+    size_t bin = subghz_toolkit_clusters_bin(duration);
+    clusters->counts[bin]++;
+    clusters->sums[bin] += duration;
+}
+
+void subghz_toolkit_clusters_feed(void *context, bool level, uint32_t duration)
+{
+    subghz_toolkit_clusters_add(context, level, duration);
+}
+
+static uint32_t subghz_toolkit_clusters_smoothed(const SubGhzToolkitClusters *clusters, size_t bin)
+{
+    uint32_t value = 2 * clusters->counts[bin];
+    if (bin > 0)
+        value += clusters->counts[bin - 1];
+    if (bin + 1 < SUBGHZ_TOOLKIT_CLUSTERS_BINS)
+        value += clusters->counts[bin + 1];
+    return value;
+}
+
+// Sum the bins of one peak into a cluster, from `first` to `last` inclusive
+static void subghz_toolkit_clusters_collect(const SubGhzToolkitClusters *clusters, size_t first, size_t last, SubGhzToolkitCluster *cluster)
+{
+    uint64_t sum = 0;
+    uint64_t deviation = 0;
+
+    memset(cluster, 0, sizeof(*cluster));
+    for (size_t bin = first; bin <= last; bin++)
+    {
+        if (!clusters->counts[bin])
+            continue;
+        if (!cluster->count)
+            cluster->low = subghz_toolkit_clusters_bin_low(bin);
+        cluster->high = subghz_toolkit_clusters_bin_high(bin);
+        cluster->count += clusters->counts[bin];
+        sum += clusters->sums[bin];
+    }
+    if (!cluster->count)
+        return;
+
+    cluster->mean = (uint32_t)(sum / cluster->count);
+    for (size_t bin = first; bin <= last; bin++)
+    {
+        if (clusters->counts[bin])
+            deviation += (uint64_t)clusters->counts[bin] *
+                         subghz_toolkit_clusters_distance((uint32_t)(clusters->sums[bin] / clusters->counts[bin]), cluster->mean);
+    }
+    cluster->jitter = (uint32_t)(deviation / cluster->count);
+}
+
+// Multiple of `te` closest to `mean`, 0 when further than te/4 from any
+static uint8_t subghz_toolkit_clusters_multiple(uint32_t mean, uint32_t te)
+{
+    uint32_t multiple = (mean + te / 2) / te;
+    if (!multiple || multiple > SUBGHZ_TOOLKIT_CLUSTERS_MAX_MULTIPLE)
+        return 0;
+    return subghz_toolkit_clusters_distance(mean, multiple * te) <= te / 4 ? (uint8_t)multiple : 0;
+}
+
+static uint32_t subghz_toolkit_clusters_fitted(const SubGhzToolkitClustersEstimate *estimate, uint32_t te)
+{
+    uint32_t fitted = 0;
+    for (size_t i = 0; i < estimate->cluster_count; i++)
+    {
+        if (subghz_toolkit_clusters_multiple(estimate->clusters[i].mean, te))
+            fitted += estimate->clusters[i].count;
+    }
+    return fitted;
+}
+
+static void subghz_toolkit_clusters_fit(SubGhzToolkitClustersEstimate *estimate)
+{
+    uint32_t shortest = estimate->clusters[0].mean;
+    uint32_t best_te = shortest;
+    uint32_t best_fitted = subghz_toolkit_clusters_fitted(estimate, shortest);
+
+    // A shorter te only wins when it explains strictly more pulses, e.g. clusters at 2x and 3x
+    for (uint32_t divisor = 2; divisor <= SUBGHZ_TOOLKIT_CLUSTERS_MAX_DIVISOR; divisor++)
+    {
+        uint32_t te = shortest / divisor;
+        uint32_t fitted = te ? subghz_toolkit_clusters_fitted(estimate, te) : 0;
+        if (fitted > best_fitted)
+        {
+            best_te = te;
+            best_fitted = fitted;
+        }
+    }
+
+    // Least squares through the origin: te = sum(count * mean) / sum(count * multiple)
+    uint64_t weighted_mean = 0;
+    uint64_t weighted_multiple = 0;
+    for (size_t i = 0; i < estimate->cluster_count; i++)
+    {
+        SubGhzToolkitCluster *cluster = &estimate->clusters[i];
+        cluster->multiple = subghz_toolkit_clusters_multiple(cluster->mean, best_te);
+        if (!cluster->multiple)
+            continue;
+        weighted_mean += (uint64_t)cluster->count * cluster->mean;
+        weighted_multiple += (uint64_t)cluster->count * cluster->multiple;
+    }
+    estimate->te = weighted_multiple ? (uint32_t)((weighted_mean + weighted_multiple / 2) / weighted_multiple) : best_te;
+
+    uint64_t deviation = 0;
+    uint32_t fitted = 0;
+    for (size_t i = 0; i < estimate->cluster_count; i++)
+    {
+        SubGhzToolkitCluster *cluster = &estimate->clusters[i];
+        cluster->multiple = subghz_toolkit_clusters_multiple(cluster->mean, estimate->te);
+        if (!cluster->multiple)
+            continue;
+        fitted += cluster->count;
+        deviation += (uint64_t)cluster->count *
+                     (cluster->jitter + subghz_toolkit_clusters_distance(cluster->mean, cluster->multiple * estimate->te));
+    }
+    estimate->jitter = fitted ? (uint32_t)(deviation / fitted) : 0;
+    estimate->fit = estimate->clustered ? (uint32_t)((uint64_t)fitted * 1000 / estimate->clustered) : 0;
+}
+
+bool subghz_toolkit_clusters_estimate(const SubGhzToolkitClusters *clusters, SubGhzToolkitClustersEstimate *estimate)
+{
+    uint32_t binned = clusters->pulses - clusters->gaps;
+    uint32_t minimum = binned / 100 > 2 ? binned / 100 : 2;
+
+    memset(estimate, 0, sizeof(*estimate));
+    if (binned < SUBGHZ_TOOLKIT_CLUSTERS_MIN_PULSES)
+        return false;
+
+    size_t valley = 0; // lowest bin after the previous peak
+    for (size_t bin = 0; bin < SUBGHZ_TOOLKIT_CLUSTERS_BINS; bin++)
+    {
+        uint32_t value = subghz_toolkit_clusters_smoothed(clusters, bin);
+        uint32_t left = bin > 0 ? subghz_toolkit_clusters_smoothed(clusters, bin - 1) : 0;
+        uint32_t right = bin + 1 < SUBGHZ_TOOLKIT_CLUSTERS_BINS ? subghz_toolkit_clusters_smoothed(clusters, bin + 1) : 0;
+
+        if (!value || value <= left || value < right)
+        {
+            if (bin > valley && value < subghz_toolkit_clusters_smoothed(clusters, valley))
+                valley = bin;
+            continue;
+        }
+
+        // A peak: its cluster runs downhill to the valleys either side, at most MAX_WIDTH bins each way
+        size_t first = bin;
+        while (first > valley && first + SUBGHZ_TOOLKIT_CLUSTERS_MAX_WIDTH > bin &&
+               subghz_toolkit_clusters_smoothed(clusters, first - 1) &&
+               subghz_toolkit_clusters_smoothed(clusters, first - 1) <= subghz_toolkit_clusters_smoothed(clusters, first))
+            first--;
+        size_t last = bin;
+        while (last + 1 < SUBGHZ_TOOLKIT_CLUSTERS_BINS && last < bin + SUBGHZ_TOOLKIT_CLUSTERS_MAX_WIDTH &&
+               subghz_toolkit_clusters_smoothed(clusters, last + 1) &&
+               subghz_toolkit_clusters_smoothed(clusters, last + 1) <= subghz_toolkit_clusters_smoothed(clusters, last))
+            last++;
+
+        SubGhzToolkitCluster cluster;
+        subghz_toolkit_clusters_collect(clusters, first, last, &cluster);
+        valley = last + 1;
+        bin = last;
+        if (cluster.count < minimum)
+            continue;
+
+        estimate->clustered += cluster.count;
+        if (estimate->cluster_count < SUBGHZ_TOOLKIT_CLUSTERS_MAX)
+        {
+            estimate->clusters[estimate->cluster_count++] = cluster;
+            continue;
+        }
+
+        // Full: replace the smallest cluster if this one is bigger, keeping ascending means
+        size_t smallest = 0;
+        for (size_t i = 1; i < estimate->cluster_count; i++)
+        {
+            if (estimate->clusters[i].count < estimate->clusters[smallest].count)
+                smallest = i;
+        }
+        if (estimate->clusters[smallest].count >= cluster.count)
+        {
+            estimate->clustered -= cluster.count;
+            continue;
+        }
+        estimate->clustered -= estimate->clusters[smallest].count;
+        memmove(&estimate->clusters[smallest], &estimate->clusters[smallest + 1],
+                (estimate->cluster_count - smallest - 1) * sizeof(SubGhzToolkitCluster));
+        estimate->clusters[estimate->cluster_count - 1] = cluster;
+    }
+
+    if (!estimate->cluster_count)
+        return false;
+
+    estimate->te_short = estimate->clusters[0].mean;
+    estimate->te_long = estimate->cluster_count > 1 ? estimate->clusters[1].mean : 0;
+    subghz_toolkit_clusters_fit(estimate);
+    return true;
+}
+
+void subghz_toolkit_clusters_write_report(
+    SubGhzToolkitWriter *writer, const SubGhzToolkitClusters *clusters, const SubGhzToolkitClustersEstimate *estimate)
+{
+    uint64_t total_us = clusters->high_us + clusters->low_us;
+
+    subghz_toolkit_writer_printf(writer,
+                                 "Pulse Timing:\n"
+                                 "  Pulses:           %lu (%lu over %lu ms counted as gaps)\n"
+                                 "  High time:        %lu.%lu%%\n",
+                                 (unsigned long)clusters->pulses,
+                                 (unsigned long)clusters->gaps,
+                                 (unsigned long)(SUBGHZ_TOOLKIT_CLUSTERS_MAX_DURATION / 1000),
+                                 (unsigned long)(total_us ? clusters->high_us * 100 / total_us : 0),
+                                 (unsigned long)(total_us ? clusters->high_us * 1000 / total_us % 10 : 0));
+
+    if (!estimate->cluster_count)
+    {
+        subghz_toolkit_writer_cstr(writer, "  Too few pulses for a timing estimate\n");
+        return;
+    }
+
+    subghz_toolkit_writer_printf(writer,
+                                 "  te:               %lu us\n"
+                                 "  te_short/te_long: %lu / %lu us\n"
+                                 "  Jitter:           %lu us\n"
+                                 "  Fit:              %lu.%lu%% of %lu clustered pulses on a multiple of te\n"
+                                 "  Clusters:\n",
+                                 (unsigned long)estimate->te,
+                                 (unsigned long)estimate->te_short,
+                                 (unsigned long)estimate->te_long,
+                                 (unsigned long)estimate->jitter,
+                                 (unsigned long)(estimate->fit / 10),
+                                 (unsigned long)(estimate->fit % 10),
+                                 (unsigned long)estimate->clustered);
+    for (size_t i = 0; i < estimate->cluster_count; i++)
+    {
+        const SubGhzToolkitCluster *cluster = &estimate->clusters[i];
+        subghz_toolkit_writer_printf(writer, "    %6lu us  %8lu pulses  +-%lu us  [%lu..%lu]",
+                                     (unsigned long)cluster->mean,
+                                     (unsigned long)cluster->count,
+                                     (unsigned long)cluster->jitter,
+                                     (unsigned long)cluster->low,
+                                     (unsigned long)cluster->high);
+        if (cluster->multiple)
+            subghz_toolkit_writer_printf(writer, "  %ux te\n", cluster->multiple);
+        else
+            subghz_toolkit_writer_cstr(writer, "  off the te grid\n");
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_writer.h"
+
+// Streaming estimate of a signal's base time element from its pulse durations.
+//
+// add() bins each duration into a log-scaled histogram, 16 bins per octave
+// (about 4.4% wide) from 16 us to 131 ms, with a running sum per bin so
+// cluster means are exact. Memory is fixed at under 3 KB whatever the capture
+// length, and everything is integer arithmetic.
+//
+// estimate() smooths the histogram, takes each local peak holding at least 1%
+// of the pulses as a cluster bounded by the valleys on either side, and fits
+// the base element te so every cluster mean is close to a whole multiple of
+// it: te_short is usually 1x, te_long 2x or 3x. Jitter is the mean absolute
+// distance of the pulses from their cluster's multiple of te.
+
+#define SUBGHZ_TOOLKIT_CLUSTERS_BINS 224
+#define SUBGHZ_TOOLKIT_CLUSTERS_MAX_DURATION 131071 // us, longer pulses are counted as gaps
+#define SUBGHZ_TOOLKIT_CLUSTERS_MAX 8
+
+typedef struct
+{
+    uint32_t counts[SUBGHZ_TOOLKIT_CLUSTERS_BINS];
+    uint64_t sums[SUBGHZ_TOOLKIT_CLUSTERS_BINS];
+    uint32_t pulses;
+    uint32_t gaps; // over SUBGHZ_TOOLKIT_CLUSTERS_MAX_DURATION
+    uint32_t high_pulses;
+    uint64_t high_us;
+    uint64_t low_us;
+} SubGhzToolkitClusters;
+
+typedef struct
+{
+    uint32_t mean; // us
+    uint32_t count;
+    uint32_t jitter; // us, mean absolute deviation from the cluster mean
+    uint32_t low; // us, smallest and largest duration binned into the cluster
+    uint32_t high;
+    uint8_t multiple; // of te, 0 when the cluster is not near a multiple
+} SubGhzToolkitCluster;
+
+typedef struct
+{
+    uint32_t te; // base time element in us, 0 when no clusters were found
+    uint32_t te_short; // mean of the shortest and next cluster
+    uint32_t te_long;
+    uint32_t jitter; // us, from the multiples of te
+    uint32_t fit; // pulses within te/4 of a multiple of te, per mille of the clustered pulses
+    uint32_t clustered; // pulses in clusters
+    SubGhzToolkitCluster clusters[SUBGHZ_TOOLKIT_CLUSTERS_MAX];
+    size_t cluster_count;
+} SubGhzToolkitClustersEstimate;
+
+void subghz_toolkit_clusters_init(SubGhzToolkitClusters *clusters);
+
+/** Count one pulse */
+void subghz_toolkit_clusters_add(SubGhzToolkitClusters *clusters, bool level, uint32_t duration);
+
+/** subghz_toolkit_clusters_add() as a SubGhzToolkitRawPulseCallback, `context` is the clusters */
+void subghz_toolkit_clusters_feed(void *context, bool level, uint32_t duration);
+
+/** Clusters and te of the pulses so far. False when there were too few pulses to tell. */
+bool subghz_toolkit_clusters_estimate(const SubGhzToolkitClusters *clusters, SubGhzToolkitClustersEstimate *estimate);
+
+/** te, te_short/te_long, jitter and the clusters with their multiples */
+void subghz_toolkit_clusters_write_report(
+    SubGhzToolkitWriter *writer, const SubGhzToolkitClusters *clusters, const SubGhzToolkitClustersEstimate *estimate);
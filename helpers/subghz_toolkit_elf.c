@@ -0,0 +1,135 @@
+#include "subghz_toolkit_elf.h"
+
+#include <string.h>
+
+#define SUBGHZ_TOOLKIT_ELF_MACHINE_ARM 40
+#define SUBGHZ_TOOLKIT_ELF_PT_LOAD 1
+#define SUBGHZ_TOOLKIT_ELF_SHT_SYMTAB 2
+#define SUBGHZ_TOOLKIT_ELF_SYM_SIZE 16
+#define SUBGHZ_TOOLKIT_ELF_PHDR_SIZE 32
+#define SUBGHZ_TOOLKIT_ELF_SHDR_SIZE 40
+
+static uint16_t subghz_toolkit_elf_u16(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8);
+}
+
+static uint32_t subghz_toolkit_elf_u32(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+// True if [offset, offset + length) lies within the file
+static bool subghz_toolkit_elf_contains(const SubGhzToolkitElf *elf, uint32_t offset, uint32_t length)
+{
+    return offset <= elf->size && length <= elf->size - offset;
+}
+
+bool subghz_toolkit_elf_open(SubGhzToolkitElf *elf, const uint8_t *data, size_t size)
+{
+    memset(elf, 0, sizeof(*elf));
+    elf->data = data;
+    elf->size = size;
+
+    // 32 bit, little endian, ARM
+    if (size < 52 || memcmp(data, "\x7F" "ELF", 4) || data[4] != 1 || data[5] != 1 ||
+        subghz_toolkit_elf_u16(data + 18) != SUBGHZ_TOOLKIT_ELF_MACHINE_ARM)
+        return false;
+
+    uint32_t shoff = subghz_toolkit_elf_u32(data + 32);
+    uint16_t shentsize = subghz_toolkit_elf_u16(data + 46);
+    uint16_t shnum = subghz_toolkit_elf_u16(data + 48);
+    if (shentsize != SUBGHZ_TOOLKIT_ELF_SHDR_SIZE || !subghz_toolkit_elf_contains(elf, shoff, (uint32_t)shnum * shentsize))
+        return true; // no usable section headers, segments only
+
+    for (uint16_t i = 0; i < shnum; i++)
+    {
+        const uint8_t *section = data + shoff + i * shentsize;
+        if (subghz_toolkit_elf_u32(section + 4) != SUBGHZ_TOOLKIT_ELF_SHT_SYMTAB)
+            continue;
+
+        uint32_t offset = subghz_toolkit_elf_u32(section + 16);
+        uint32_t length = subghz_toolkit_elf_u32(section + 20);
+        uint32_t link = subghz_toolkit_elf_u32(section + 24);
+        if (link >= shnum || !subghz_toolkit_elf_contains(elf, offset, length))
+            break;
+
+        const uint8_t *strtab = data + shoff + link * shentsize;
+        uint32_t str_offset = subghz_toolkit_elf_u32(strtab + 16);
+        uint32_t str_length = subghz_toolkit_elf_u32(strtab + 20);
+        if (!subghz_toolkit_elf_contains(elf, str_offset, str_length))
+            break;
+
+        elf->symbols = data + offset;
+        elf->symbol_count = length / SUBGHZ_TOOLKIT_ELF_SYM_SIZE;
+        elf->strings = (const char *)data + str_offset;
+        elf->strings_size = str_length;
+        break;
+    }
+
+    return true;
+}
+
+size_t subghz_toolkit_elf_map(const SubGhzToolkitElf *elf, SubGhzToolkitMemory *memory)
+{
+    uint32_t phoff = subghz_toolkit_elf_u32(elf->data + 28);
+    uint16_t phentsize = subghz_toolkit_elf_u16(elf->data + 42);
+    uint16_t phnum = subghz_toolkit_elf_u16(elf->data + 44);
+    if (phentsize != SUBGHZ_TOOLKIT_ELF_PHDR_SIZE || !subghz_toolkit_elf_contains(elf, phoff, (uint32_t)phnum * phentsize))
+        return 0;
+
+    size_t added = 0;
+    for (uint16_t i = 0; i < phnum; i++)
+    {
+        const uint8_t *segment = elf->data + phoff + i * phentsize;
+        uint32_t offset = subghz_toolkit_elf_u32(segment + 4);
+        uint32_t address = subghz_toolkit_elf_u32(segment + 8);
+        uint32_t file_size = subghz_toolkit_elf_u32(segment + 16);
+        if (subghz_toolkit_elf_u32(segment) != SUBGHZ_TOOLKIT_ELF_PT_LOAD || !file_size ||
+            !subghz_toolkit_elf_contains(elf, offset, file_size))
+            continue;
+
+        if (subghz_toolkit_memory_add_region(memory, address, elf->data + offset, file_size))
+            added++;
+    }
+
+    return added;
+}
+
+size_t subghz_toolkit_elf_symbol_count(const SubGhzToolkitElf *elf)
+{
+    return elf->symbol_count;
+}
+
+bool subghz_toolkit_elf_symbol(const SubGhzToolkitElf *elf, size_t index, SubGhzToolkitElfSymbol *symbol)
+{
+    if (index >= elf->symbol_count)
+        return false;
+
+    const uint8_t *entry = elf->symbols + index * SUBGHZ_TOOLKIT_ELF_SYM_SIZE;
+    uint32_t name_offset = subghz_toolkit_elf_u32(entry);
+    if (name_offset >= elf->strings_size || !memchr(elf->strings + name_offset, '\0', elf->strings_size - name_offset))
+        return false;
+
+    symbol->name = elf->strings + name_offset;
+    symbol->value = subghz_toolkit_elf_u32(entry + 4);
+    symbol->size = subghz_toolkit_elf_u32(entry + 8);
+    symbol->type = entry[12] & 0x0F;
+    symbol->binding = entry[12] >> 4;
+    symbol->section = subghz_toolkit_elf_u16(entry + 14);
+    return true;
+}
+
+bool subghz_toolkit_elf_find_symbol(const SubGhzToolkitElf *elf, const char *name, uint32_t *value)
+{
+    SubGhzToolkitElfSymbol symbol;
+    for (size_t i = 0; i < elf->symbol_count; i++)
+    {
+        if (subghz_toolkit_elf_symbol(elf, i, &symbol) && symbol.section && !strcmp(symbol.name, name))
+        {
+            *value = symbol.value;
+            return true;
+        }
+    }
+    return false;
+}
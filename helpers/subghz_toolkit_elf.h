@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_memory.h"
+
+// Minimal reader for 32 bit little endian ARM ELF files, such as the
+// firmware.elf of a Flipper build. Works in place on a buffer (usually a
+// memory mapped file): load segments become memory regions and the symbol
+// table can be searched by name.
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t size;
+    const uint8_t *symbols; // Elf32_Sym array, NULL if stripped
+    size_t symbol_count;
+    const char *strings; // string table of the symbols
+    size_t strings_size;
+} SubGhzToolkitElf;
+
+#define SUBGHZ_TOOLKIT_ELF_STT_OBJECT 1
+#define SUBGHZ_TOOLKIT_ELF_STT_FUNC 2
+#define SUBGHZ_TOOLKIT_ELF_STB_GLOBAL 1
+
+typedef struct
+{
+    const char *name; // points into the file
+    uint32_t value;
+    uint32_t size;
+    uint8_t type; // SUBGHZ_TOOLKIT_ELF_STT_*
+    uint8_t binding; // SUBGHZ_TOOLKIT_ELF_STB_*
+    uint16_t section; // 0 for undefined symbols
+} SubGhzToolkitElfSymbol;
+
+/** Check the header and find the symbol table. False if `data` is not a 32 bit ARM ELF. */
+bool subghz_toolkit_elf_open(SubGhzToolkitElf *elf, const uint8_t *data, size_t size);
+
+/** Add every PT_LOAD segment with file contents at its virtual address. Returns the number added. */
+size_t subghz_toolkit_elf_map(const SubGhzToolkitElf *elf, SubGhzToolkitMemory *memory);
+
+/** Number of entries in the symbol table, 0 if stripped */
+size_t subghz_toolkit_elf_symbol_count(const SubGhzToolkitElf *elf);
+
+/** Entry `index` of the symbol table. False if out of range or its name is not in the string table. */
+bool subghz_toolkit_elf_symbol(const SubGhzToolkitElf *elf, size_t index, SubGhzToolkitElfSymbol *symbol);
+
+/** Value of the symbol called `name` */
+bool subghz_toolkit_elf_find_symbol(const SubGhzToolkitElf *elf, const char *name, uint32_t *value);
@@ -0,0 +1,339 @@
+#include "subghz_toolkit_frames.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SUBGHZ_TOOLKIT_FRAMES_MIN_PERIOD 8
+#define SUBGHZ_TOOLKIT_FRAMES_WINDOW 8 // voting window, in max_period
+#define SUBGHZ_TOOLKIT_FRAMES_MAX_DISAGREEMENT 200 // per mille, over this nothing repeats
+#define SUBGHZ_TOOLKIT_FRAMES_MIN_PREAMBLE_CYCLES 4
+#define SUBGHZ_TOOLKIT_FRAMES_MAX_PREAMBLE_PERIOD 8
+#define SUBGHZ_TOOLKIT_FRAMES_RAW_GAP 0x7FFF // us, the RAW parser's marker for a gap
+
+struct SubGhzToolkitFrames
+{
+    uint32_t te;
+    uint32_t max_period;
+    bool started; // a gap was seen, pulses are being appended
+
+    // Autocorrelation: mismatch[lag] over every completed word
+    uint32_t *mismatch;
+    uint32_t *history; // ring of the last completed words, a power of two long
+    uint32_t history_mask;
+    uint32_t words;
+    uint32_t current;
+    uint8_t current_bits;
+    uint64_t bit_count;
+
+    // The first bits, kept for voting
+    uint32_t *window;
+    uint32_t window_capacity; // bits
+    uint32_t window_bits;
+
+    uint32_t *frame;
+    uint32_t *mask;
+};
+
+SubGhzToolkitFrames *subghz_toolkit_frames_alloc(uint32_t max_period)
+{
+    SubGhzToolkitFrames *frames = malloc(sizeof(SubGhzToolkitFrames));
+    uint32_t period_words = (max_period + 31) / 32;
+
+    memset(frames, 0, sizeof(*frames));
+    frames->max_period = period_words * 32;
+    frames->mismatch = malloc((frames->max_period + 1) * sizeof(uint32_t));
+    uint32_t history_words = 2;
+    while (history_words < period_words + 2)
+        history_words *= 2;
+    frames->history_mask = history_words - 1;
+    frames->history = malloc(history_words * sizeof(uint32_t));
+    frames->window_capacity = frames->max_period * SUBGHZ_TOOLKIT_FRAMES_WINDOW;
+    frames->window = malloc(frames->window_capacity / 8);
+    frames->frame = malloc(period_words * sizeof(uint32_t));
+    frames->mask = malloc(period_words * sizeof(uint32_t));
+    subghz_toolkit_frames_reset(frames, 0);
+    return frames;
+}
+
+void subghz_toolkit_frames_free(SubGhzToolkitFrames *frames)
+{
+    free(frames->mismatch);
+    free(frames->history);
+    free(frames->window);
+    free(frames->frame);
+    free(frames->mask);
+    free(frames);
+}
+
+void subghz_toolkit_frames_reset(SubGhzToolkitFrames *frames, uint32_t te)
+{
+    frames->te = te;
+    frames->started = false;
+    frames->words = 0;
+    frames->current = 0;
+    frames->current_bits = 0;
+    frames->bit_count = 0;
+    frames->window_bits = 0;
+    memset(frames->mismatch, 0, (frames->max_period + 1) * sizeof(uint32_t));
+    memset(frames->window, 0, frames->window_capacity / 8);
+}
+
+static void subghz_toolkit_frames_add_word(SubGhzToolkitFrames *frames, uint32_t word)
+{
+    uint32_t *history = frames->history;
+    uint32_t mask = frames->history_mask;
+    uint32_t back = frames->words < frames->max_period / 32 ? frames->words : frames->max_period / 32;
+
+    history[frames->words & mask] = word;
+
+    // Lags 32 * ago - shift compare `word` with the 32 bits starting `shift` bits into the word `ago` words back
+    for (uint32_t ago = 1; ago <= back; ago++)
+    {
+        uint32_t low = history[(frames->words - ago) & mask];
+        uint32_t high = history[(frames->words - ago + 1) & mask];
+        uint32_t *mismatch = &frames->mismatch[32 * ago];
+
+        mismatch[0] += __builtin_popcount(word ^ low);
+        for (uint32_t shift = 1; shift < 32; shift++)
+            mismatch[-(int32_t)shift] += __builtin_popcount(word ^ (low >> shift | high << (32 - shift)));
+    }
+    frames->words++;
+}
+
+void subghz_toolkit_frames_add_bits(SubGhzToolkitFrames *frames, bool bit, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (frames->window_bits < frames->window_capacity)
+        {
+            if (bit)
+                frames->window[frames->window_bits / 32] |= 1u << (frames->window_bits % 32);
+            frames->window_bits++;
+        }
+
+        if (bit)
+            frames->current |= 1u << frames->current_bits;
+        if (++frames->current_bits == 32)
+        {
+            subghz_toolkit_frames_add_word(frames, frames->current);
+            frames->current = 0;
+            frames->current_bits = 0;
+        }
+    }
+    frames->bit_count += count;
+}
+
+void subghz_toolkit_frames_add_pulse(SubGhzToolkitFrames *frames, bool level, uint32_t duration)
+{
+    if (!frames->te)
+        return;
+
+    uint32_t multiple = (duration + frames->te / 2) / frames->te;
+    bool gap = duration >= SUBGHZ_TOOLKIT_FRAMES_RAW_GAP || (!level && multiple >= SUBGHZ_TOOLKIT_FRAMES_GAP);
+
+    if (!frames->started)
+    {
+        // The window starts with the first frame after a gap
+        frames->started = gap;
+        return;
+    }
+    if (gap || multiple > SUBGHZ_TOOLKIT_FRAMES_GAP)
+        multiple = SUBGHZ_TOOLKIT_FRAMES_GAP;
+    subghz_toolkit_frames_add_bits(frames, level, multiple);
+}
+
+void subghz_toolkit_frames_feed(void *context, bool level, uint32_t duration)
+{
+    subghz_toolkit_frames_add_pulse(context, level, duration);
+}
+
+uint64_t subghz_toolkit_frames_bit_count(const SubGhzToolkitFrames *frames)
+{
+    return frames->bit_count;
+}
+
+// Mismatch of `lag` per mille of the bits compared at it, 1001 when there were too few
+static uint32_t subghz_toolkit_frames_rate(const SubGhzToolkitFrames *frames, uint32_t lag)
+{
+    uint32_t skipped = (lag + 31) / 32; // words before the first full comparison
+    if (frames->words <= skipped)
+        return 1001;
+
+    uint64_t compared = (uint64_t)(frames->words - skipped) * 32;
+    if (compared < lag) // less than two frames
+        return 1001;
+    return (uint32_t)((uint64_t)frames->mismatch[lag] * 1000 / compared);
+}
+
+static uint32_t subghz_toolkit_frames_find_period(const SubGhzToolkitFrames *frames, uint16_t *disagreement)
+{
+    uint32_t best = 1001;
+
+    for (uint32_t lag = SUBGHZ_TOOLKIT_FRAMES_MIN_PERIOD; lag <= frames->max_period; lag++)
+    {
+        uint32_t rate = subghz_toolkit_frames_rate(frames, lag);
+        if (rate < best)
+            best = rate;
+    }
+    if (best > SUBGHZ_TOOLKIT_FRAMES_MAX_DISAGREEMENT)
+        return 0;
+
+    // Multiples of the period match about as well, the first lag close to the best is the frame
+    uint32_t tolerance = best + best / 4 + 5;
+    for (uint32_t lag = SUBGHZ_TOOLKIT_FRAMES_MIN_PERIOD; lag <= frames->max_period; lag++)
+    {
+        uint32_t rate = subghz_toolkit_frames_rate(frames, lag);
+        if (rate <= tolerance)
+        {
+            *disagreement = (uint16_t)rate;
+            return lag;
+        }
+    }
+    return 0;
+}
+
+// Majority of every frame bit over the repetitions in the window
+static void subghz_toolkit_frames_vote(SubGhzToolkitFrames *frames, SubGhzToolkitFramesResult *result)
+{
+    uint32_t period = result->period;
+    uint32_t repetitions = result->repetitions;
+
+    memset(frames->frame, 0, (period + 31) / 32 * sizeof(uint32_t));
+    memset(frames->mask, 0, (period + 31) / 32 * sizeof(uint32_t));
+    for (uint32_t i = 0; i < period; i++)
+    {
+        uint32_t ones = 0;
+        for (uint32_t r = 0; r < repetitions; r++)
+            ones += subghz_toolkit_frames_bit(frames->window, r * period + i);
+
+        // A tie keeps the first repetition's bit
+        bool bit = ones * 2 > repetitions || (ones * 2 == repetitions && subghz_toolkit_frames_bit(frames->window, i));
+        if (bit)
+            frames->frame[i / 32] |= 1u << (i % 32);
+        if (ones && ones < repetitions)
+        {
+            frames->mask[i / 32] |= 1u << (i % 32);
+            result->unstable++;
+        }
+    }
+}
+
+// Longest prefix of the frame that repeats every 2..8 bits
+static void subghz_toolkit_frames_find_preamble(const SubGhzToolkitFrames *frames, SubGhzToolkitFramesResult *result)
+{
+    uint32_t body = result->period - result->gap_bits;
+
+    for (uint8_t cycle = 2; cycle <= SUBGHZ_TOOLKIT_FRAMES_MAX_PREAMBLE_PERIOD; cycle++)
+    {
+        uint32_t length = cycle;
+        while (length < body && subghz_toolkit_frames_bit(frames->frame, length) == subghz_toolkit_frames_bit(frames->frame, length - cycle))
+            length++;
+
+        // A cycle with no edge is a run, not a preamble; a prefix spanning the frame is not followed by data
+        bool edge = false;
+        for (uint8_t i = 1; i < cycle; i++)
+            edge |= subghz_toolkit_frames_bit(frames->frame, i) != subghz_toolkit_frames_bit(frames->frame, 0);
+        if (edge && length < body && length >= cycle * SUBGHZ_TOOLKIT_FRAMES_MIN_PREAMBLE_CYCLES && length > result->preamble_bits)
+        {
+            result->preamble_bits = length;
+            result->preamble_period = cycle;
+        }
+    }
+
+    if (result->preamble_bits)
+    {
+        uint32_t rest = body - result->preamble_bits;
+        result->sync_bits = rest < SUBGHZ_TOOLKIT_FRAMES_SYNC_BITS ? rest : SUBGHZ_TOOLKIT_FRAMES_SYNC_BITS;
+    }
+}
+
+bool subghz_toolkit_frames_analyze(SubGhzToolkitFrames *frames, SubGhzToolkitFramesResult *result)
+{
+    memset(result, 0, sizeof(*result));
+    result->frame = frames->frame;
+    result->mask = frames->mask;
+
+    result->period = subghz_toolkit_frames_find_period(frames, &result->disagreement);
+    if (!result->period)
+        return false;
+
+    result->repetitions = frames->window_bits / result->period;
+    result->total_repetitions = (uint32_t)(frames->bit_count / result->period);
+    if (result->repetitions < 2)
+    {
+        result->period = 0;
+        return false;
+    }
+
+    subghz_toolkit_frames_vote(frames, result);
+    while (result->gap_bits < result->period &&
+           !subghz_toolkit_frames_bit(frames->frame, result->period - 1 - result->gap_bits))
+        result->gap_bits++;
+    subghz_toolkit_frames_find_preamble(frames, result);
+    return true;
+}
+
+static void subghz_toolkit_frames_write_bits(SubGhzToolkitWriter *writer, const uint32_t *bits, uint32_t start, uint32_t count)
+{
+    for (uint32_t i = start; i < start + count; i++)
+        subghz_toolkit_writer_write(writer, subghz_toolkit_frames_bit(bits, i) ? "1" : "0", 1);
+}
+
+void subghz_toolkit_frames_write_report(
+    SubGhzToolkitWriter *writer, const SubGhzToolkitFrames *frames, const SubGhzToolkitFramesResult *result)
+{
+    subghz_toolkit_writer_cstr(writer, "Frames:\n");
+    if (!result->period)
+    {
+        subghz_toolkit_writer_printf(writer, "  No repeating frame in %lu bits at te %lu us\n",
+                                     (unsigned long)frames->bit_count, (unsigned long)frames->te);
+        return;
+    }
+
+    subghz_toolkit_writer_printf(writer,
+                                 "  Period:           %lu te (%lu us), %lu.%lu%% of bits differ\n"
+                                 "  Repetitions:      %lu in the capture, %lu voted\n"
+                                 "  Gap:              %lu te%s\n",
+                                 (unsigned long)result->period,
+                                 (unsigned long)(result->period * frames->te),
+                                 (unsigned long)(result->disagreement / 10),
+                                 (unsigned long)(result->disagreement % 10),
+                                 (unsigned long)result->total_repetitions,
+                                 (unsigned long)result->repetitions,
+                                 (unsigned long)result->gap_bits,
+                                 result->gap_bits >= SUBGHZ_TOOLKIT_FRAMES_GAP ? " or longer" : "");
+
+    if (result->preamble_bits)
+    {
+        subghz_toolkit_writer_printf(writer, "  Preamble:         %lu te of ", (unsigned long)result->preamble_bits);
+        subghz_toolkit_frames_write_bits(writer, frames->frame, 0, result->preamble_period);
+        subghz_toolkit_writer_cstr(writer, "\n  Sync:             ");
+        subghz_toolkit_frames_write_bits(writer, frames->frame, result->preamble_bits, result->sync_bits);
+        subghz_toolkit_writer_cstr(writer, "\n");
+    }
+    else
+    {
+        subghz_toolkit_writer_cstr(writer, "  Preamble:         none, frames start after the gap\n");
+    }
+
+    // One te per character, unstable bits marked under the frame
+    subghz_toolkit_writer_printf(writer, "  Unstable bits:    %lu of %lu\n  Frame:\n",
+                                 (unsigned long)result->unstable, (unsigned long)result->period);
+    for (uint32_t start = 0; start < result->period; start += 64)
+    {
+        uint32_t count = result->period - start < 64 ? result->period - start : 64;
+        subghz_toolkit_writer_cstr(writer, "    ");
+        subghz_toolkit_frames_write_bits(writer, frames->frame, start, count);
+        subghz_toolkit_writer_cstr(writer, "\n");
+
+        bool unstable = false;
+        for (uint32_t i = start; i < start + count; i++)
+            unstable |= subghz_toolkit_frames_bit(frames->mask, i);
+        if (!unstable)
+            continue;
+        subghz_toolkit_writer_cstr(writer, "    ");
+        for (uint32_t i = start; i < start + count; i++)
+            subghz_toolkit_writer_write(writer, subghz_toolkit_frames_bit(frames->mask, i) ? "^" : " ", 1);
+        subghz_toolkit_writer_cstr(writer, "\n");
+    }
+}
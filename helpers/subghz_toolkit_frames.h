@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_writer.h"
+
+// Frame period, preamble and sync of a repeated transmission.
+//
+// Remotes send the same frame several times per press. The detector takes a
+// bitstream, either bits pushed directly or pulses quantized to one bit per
+// te, and accumulates its autocorrelation for every lag up to max_period:
+// each completed 32-bit word is XORed against the word `lag` bits earlier
+// and the popcount added to that lag's mismatch count. That is max_period/32
+// word operations per input bit whatever the capture length, so hundreds of
+// thousands of pulses stay linear, in a history of max_period bits.
+//
+// Pulses at or over SUBGHZ_TOOLKIT_FRAMES_GAP te are written as exactly that
+// many bits, so frames separated by jittery gaps still repeat bit for bit.
+// Input starts after the first gap, which aligns the window with a frame.
+//
+// analyze() takes the shortest lag with (near) the least mismatch as the
+// period, then votes each bit of the frame over the repetitions in the first
+// 8 * max_period bits: the majority is the canonical frame, bits where the
+// repetitions disagree are set in the mask. The preamble is the longest
+// periodic prefix of the frame, the sync word the bits that follow it.
+
+#define SUBGHZ_TOOLKIT_FRAMES_GAP 16 // te, pulses at least this long are a frame gap
+#define SUBGHZ_TOOLKIT_FRAMES_MAX_PERIOD 2048 // bits, a good default for max_period
+#define SUBGHZ_TOOLKIT_FRAMES_SYNC_BITS 16
+
+typedef struct SubGhzToolkitFrames SubGhzToolkitFrames;
+
+typedef struct
+{
+    uint32_t period; // bits per frame including the gap, 0 when nothing repeats
+    uint32_t repetitions; // whole frames in the voting window
+    uint32_t total_repetitions; // whole frames in the input
+    uint16_t disagreement; // per mille of bits differing at the period
+    uint32_t preamble_bits; // 0 when the frame has no periodic prefix
+    uint8_t preamble_period; // bits per preamble cycle
+    uint32_t sync_bits; // bits after the preamble
+    uint32_t gap_bits; // trailing low bits of the frame
+    uint32_t unstable; // bits set in mask
+    const uint32_t *frame; // canonical frame, bit i in word i / 32 at bit i % 32; valid until the next add or free
+    const uint32_t *mask; // bits where the repetitions disagree
+} SubGhzToolkitFramesResult;
+
+/** Detector for frames of up to `max_period` bits (rounded up to 32) */
+SubGhzToolkitFrames *subghz_toolkit_frames_alloc(uint32_t max_period);
+
+void subghz_toolkit_frames_free(SubGhzToolkitFrames *frames);
+
+/** Clear the input and set the base element pulses are quantized by, in us */
+void subghz_toolkit_frames_reset(SubGhzToolkitFrames *frames, uint32_t te);
+
+/** Append `count` copies of `bit` */
+void subghz_toolkit_frames_add_bits(SubGhzToolkitFrames *frames, bool bit, uint32_t count);
+
+/** Quantize a pulse to te and append it, once the first gap was seen */
+void subghz_toolkit_frames_add_pulse(SubGhzToolkitFrames *frames, bool level, uint32_t duration);
+
+/** subghz_toolkit_frames_add_pulse() as a SubGhzToolkitRawPulseCallback, `context` is the detector */
+void subghz_toolkit_frames_feed(void *context, bool level, uint32_t duration);
+
+/** Bits appended so far */
+uint64_t subghz_toolkit_frames_bit_count(const SubGhzToolkitFrames *frames);
+
+/** Period, canonical frame and mask. False when no lag repeats the input. */
+bool subghz_toolkit_frames_analyze(SubGhzToolkitFrames *frames, SubGhzToolkitFramesResult *result);
+
+static inline bool subghz_toolkit_frames_bit(const uint32_t *bits, size_t index)
+{
+    return (bits[index / 32] >> (index % 32)) & 1;
+}
+
+/** Period, repetitions, preamble, sync, and the frame with its unstable bits marked */
+void subghz_toolkit_frames_write_report(
+    SubGhzToolkitWriter *writer, const SubGhzToolkitFrames *frames, const SubGhzToolkitFramesResult *result);
@@ -0,0 +1,348 @@
+#include "subghz_toolkit_function.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct SubGhzToolkitFunctionCache
+{
+    SubGhzToolkitFunction *functions;
+    size_t count;
+    size_t capacity;
+    uint32_t *slots; // function index + 1, 0 is empty
+    uint32_t slot_count;
+};
+
+// Size of the TBB/TBH table behind `insn` with `entries` cases, 0 if it is not inline
+static uint32_t subghz_toolkit_function_table_size(const SubGhzToolkitThumbInsn *insn, uint32_t entries)
+{
+    if ((insn->op != SubGhzToolkitThumbOpTbb && insn->op != SubGhzToolkitThumbOpTbh) ||
+        insn->rd != SUBGHZ_TOOLKIT_THUMB_REG_PC || !entries || entries > 256)
+        return 0;
+
+    uint32_t entry_size = insn->op == SubGhzToolkitThumbOpTbh ? 2 : 1;
+    return (entries * entry_size + 1) & ~1u;
+}
+
+// Steps over the TBB/TBH table behind `insn` and extends `reach` to its
+// targets. Returns the table size in bytes, 0 if the table cannot be bounded.
+static uint32_t subghz_toolkit_function_table(
+    const uint8_t *code, size_t size, uint32_t offset, const SubGhzToolkitThumbInsn *insn, uint32_t entries, uint32_t *reach)
+{
+    uint32_t entry_size = insn->op == SubGhzToolkitThumbOpTbh ? 2 : 1;
+    uint32_t table = offset + 4;
+    uint32_t table_size = subghz_toolkit_function_table_size(insn, entries);
+    if (!table_size || table + table_size > size)
+        return 0;
+
+    for (uint32_t i = 0; i < entries; i++)
+    {
+        const uint8_t *entry = code + table + i * entry_size;
+        uint32_t value = entry_size == 2 ? (uint32_t)(entry[0] | (entry[1] << 8)) : entry[0];
+        uint32_t target = table + value * 2; // relative to the table, which is the branch pc
+        if (target > *reach && target < size)
+            *reach = target;
+    }
+
+    return table_size;
+}
+
+void subghz_toolkit_function_bounds(const uint8_t *code, size_t size, uint32_t address, SubGhzToolkitFunction *function)
+{
+    memset(function, 0, sizeof(*function));
+    function->address = address;
+    function->owner = SUBGHZ_TOOLKIT_FUNCTION_NO_OWNER;
+    function->flags = SUBGHZ_TOOLKIT_FUNCTION_FLAG_LEAF;
+
+    if (size > SUBGHZ_TOOLKIT_FUNCTION_MAX_SIZE)
+        size = SUBGHZ_TOOLKIT_FUNCTION_MAX_SIZE;
+
+    uint32_t reach = 0; // furthest forward branch target inside the function
+    uint32_t pool_start = UINT32_MAX;
+    uint32_t pool_end = 0;
+    uint32_t code_end = 0;
+    uint32_t last_compare = 0; // CMP immediate + 1, bounds the next switch table
+    uint32_t it_remaining = 0;
+    uint32_t frame = 0; // registers pushed on the path being decoded
+    uint32_t prologue = 0; // registers pushed on entry
+    uint32_t offset = 0;
+    SubGhzToolkitThumbInsn insn;
+
+    while (offset < size && subghz_toolkit_thumb_decode(code + offset, size - offset, address + offset, &insn))
+    {
+        bool conditional = it_remaining > 0;
+        if (it_remaining)
+            it_remaining--;
+        function->insn_count++;
+
+        uint32_t target = insn.target - address; // wraps for targets before the entry
+        bool terminal = false;
+        bool tail_call = false;
+
+        switch (insn.op)
+        {
+        case SubGhzToolkitThumbOpIt:
+            // firstcond plus one instruction per mask bit above the terminating 1
+            it_remaining = 4 - __builtin_ctz(insn.it_mask & 15);
+            break;
+        case SubGhzToolkitThumbOpBCond:
+        case SubGhzToolkitThumbOpCbz:
+        case SubGhzToolkitThumbOpCbnz:
+            if (target > reach && target < size)
+                reach = target;
+            break;
+        case SubGhzToolkitThumbOpB:
+            // A wide branch forward with the frame already popped is a tail call,
+            // as is anything leaving the function or landing past the literal pool
+            tail_call = insn.target < address || target >= size || target >= pool_start ||
+                        (insn.size == 4 && frame == 0 && target >= reach);
+            if (!tail_call && target > reach)
+                reach = target;
+            terminal = !conditional;
+            break;
+        case SubGhzToolkitThumbOpBl:
+        case SubGhzToolkitThumbOpBlx:
+            function->flags &= ~SUBGHZ_TOOLKIT_FUNCTION_FLAG_LEAF;
+            break;
+        case SubGhzToolkitThumbOpBx:
+            terminal = !conditional;
+            break;
+        case SubGhzToolkitThumbOpLdrLiteral:
+            if (target < size)
+            {
+                if (target < pool_start)
+                    pool_start = target;
+                if (target + 4 > pool_end)
+                    pool_end = target + 4;
+            }
+            break;
+        case SubGhzToolkitThumbOpPush:
+            if (!conditional)
+            {
+                frame += __builtin_popcount(insn.reglist);
+                if (frame > prologue)
+                    prologue = frame;
+            }
+            break;
+        case SubGhzToolkitThumbOpPop:
+            terminal = !conditional && subghz_toolkit_thumb_is_return(&insn);
+            if (!conditional && !terminal)
+            {
+                uint32_t count = __builtin_popcount(insn.reglist);
+                frame = frame > count ? frame - count : 0;
+            }
+            break;
+        case SubGhzToolkitThumbOpCmpImm:
+            last_compare = insn.imm + 1;
+            break;
+        case SubGhzToolkitThumbOpTbb:
+        case SubGhzToolkitThumbOpTbh:
+        {
+            uint32_t table_size = subghz_toolkit_function_table(code, size, offset, &insn, last_compare, &reach);
+            if (!table_size)
+            {
+                function->flags |= SUBGHZ_TOOLKIT_FUNCTION_FLAG_TRUNCATED;
+                code_end = offset + insn.size;
+                break;
+            }
+            function->flags |= SUBGHZ_TOOLKIT_FUNCTION_FLAG_JUMP_TABLE;
+            offset += insn.size + table_size;
+            continue;
+        }
+        case SubGhzToolkitThumbOpUndefined:
+            terminal = true; // trap after a call that does not return
+            break;
+        default:
+            terminal = !conditional && subghz_toolkit_thumb_is_return(&insn);
+            break;
+        }
+
+        if (code_end)
+            break;
+
+        offset += insn.size;
+        // A branch target right behind the return (an early-return tail) is still this function
+        if (terminal && offset > reach)
+        {
+            if (tail_call)
+                function->flags |= SUBGHZ_TOOLKIT_FUNCTION_FLAG_TAIL_CALL;
+            code_end = offset;
+            break;
+        }
+
+        // Code after a return is only reached by a branch, with the entry frame in place
+        if (terminal)
+            frame = prologue;
+    }
+
+    if (!code_end)
+    {
+        function->flags |= SUBGHZ_TOOLKIT_FUNCTION_FLAG_TRUNCATED;
+        code_end = offset < size ? offset : (uint32_t)size;
+    }
+
+    function->code_size = code_end;
+    function->size = pool_end > code_end ? pool_end : code_end;
+}
+
+bool subghz_toolkit_function_next(
+    const uint8_t *code, const SubGhzToolkitFunction *function, SubGhzToolkitFunctionCursor *cursor, SubGhzToolkitThumbInsn *insn)
+{
+    uint32_t offset = cursor->offset;
+    if (offset >= function->code_size ||
+        !subghz_toolkit_thumb_decode(code + offset, function->code_size - offset, function->address + offset, insn))
+        return false;
+
+    cursor->offset += insn->size;
+    cursor->table_entries = 0;
+
+    uint32_t table_size = subghz_toolkit_function_table_size(insn, cursor->last_compare);
+    if (table_size)
+    {
+        cursor->table_entries = cursor->last_compare;
+        cursor->offset += table_size;
+    }
+
+    if (insn->op == SubGhzToolkitThumbOpCmpImm)
+        cursor->last_compare = insn->imm + 1;
+    return true;
+}
+
+static uint32_t subghz_toolkit_function_hash(uint32_t address)
+{
+    // Code addresses are even and clustered, Fibonacci hashing spreads them
+    return (address >> 1) * 2654435761u;
+}
+
+static void subghz_toolkit_function_cache_rehash(SubGhzToolkitFunctionCache *cache, uint32_t slot_count)
+{
+    free(cache->slots);
+    cache->slots = calloc(slot_count, sizeof(uint32_t));
+    cache->slot_count = slot_count;
+
+    for (size_t i = 0; i < cache->count; i++)
+    {
+        uint32_t slot = subghz_toolkit_function_hash(cache->functions[i].address) & (slot_count - 1);
+        while (cache->slots[slot])
+            slot = (slot + 1) & (slot_count - 1);
+        cache->slots[slot] = i + 1;
+    }
+}
+
+static uint32_t subghz_toolkit_function_word(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+void subghz_toolkit_function_write_listing(SubGhzToolkitWriter *writer, const uint8_t *code, const SubGhzToolkitFunction *function)
+{
+    SubGhzToolkitFunctionCursor cursor = {0};
+    char text[48];
+    SubGhzToolkitThumbInsn insn;
+
+    subghz_toolkit_writer_cstr(writer, "  Thumb Disassembly:\n");
+    while (subghz_toolkit_function_next(code, function, &cursor, &insn))
+    {
+        size_t offset = insn.address - function->address;
+        subghz_toolkit_thumb_format(&insn, text, sizeof(text));
+        if (insn.size == 4)
+            subghz_toolkit_writer_printf(writer, "    +%02zu: %04lX %04lX  %s", offset,
+                                         (unsigned long)(insn.raw >> 16), (unsigned long)(insn.raw & 0xFFFF), text);
+        else
+            subghz_toolkit_writer_printf(writer, "    +%02zu: %04lX       %s", offset, (unsigned long)insn.raw, text);
+
+        // Literal loads are where constants live; the pool is right behind the code
+        uint32_t literal = insn.target - function->address;
+        if (insn.op == SubGhzToolkitThumbOpLdrLiteral && literal + 4 <= function->size)
+            subghz_toolkit_writer_printf(writer, " = 0x%08lX", (unsigned long)subghz_toolkit_function_word(code + literal));
+        subghz_toolkit_writer_cstr(writer, "\n");
+
+        // Switch tables sit inline after TBB/TBH, one entry per case of the guarding CMP
+        if (cursor.table_entries)
+            subghz_toolkit_writer_printf(writer, "    +%02zu: (switch table, %lu entries)\n",
+                                         offset + insn.size, (unsigned long)cursor.table_entries);
+    }
+
+    // Pool words are 4 byte aligned, the code may end on a halfword
+    size_t pool = (function->code_size + 3) & ~3u;
+    if (pool < function->size)
+    {
+        subghz_toolkit_writer_cstr(writer, "  Literal Pool:\n");
+        for (; pool + 4 <= function->size; pool += 4)
+            subghz_toolkit_writer_printf(writer, "    +%02zu: 0x%08lX\n", pool, (unsigned long)subghz_toolkit_function_word(code + pool));
+    }
+}
+
+SubGhzToolkitFunctionCache *subghz_toolkit_function_cache_alloc(void)
+{
+    SubGhzToolkitFunctionCache *cache = malloc(sizeof(SubGhzToolkitFunctionCache));
+    memset(cache, 0, sizeof(*cache));
+    cache->capacity = 64;
+    cache->functions = malloc(cache->capacity * sizeof(SubGhzToolkitFunction));
+    subghz_toolkit_function_cache_rehash(cache, 128);
+    return cache;
+}
+
+void subghz_toolkit_function_cache_free(SubGhzToolkitFunctionCache *cache)
+{
+    if (!cache)
+        return;
+    free(cache->functions);
+    free(cache->slots);
+    free(cache);
+}
+
+static uint32_t *subghz_toolkit_function_cache_slot(const SubGhzToolkitFunctionCache *cache, uint32_t address)
+{
+    uint32_t slot = subghz_toolkit_function_hash(address) & (cache->slot_count - 1);
+    while (cache->slots[slot] && cache->functions[cache->slots[slot] - 1].address != address)
+        slot = (slot + 1) & (cache->slot_count - 1);
+    return &cache->slots[slot];
+}
+
+const SubGhzToolkitFunction *subghz_toolkit_function_cache_find(const SubGhzToolkitFunctionCache *cache, uint32_t address)
+{
+    uint32_t index = *subghz_toolkit_function_cache_slot(cache, address);
+    return index ? &cache->functions[index - 1] : NULL;
+}
+
+const SubGhzToolkitFunction *subghz_toolkit_function_cache_get(
+    SubGhzToolkitFunctionCache *cache, const uint8_t *code, size_t size, uint32_t address, uint16_t owner, uint8_t label, bool *inserted)
+{
+    uint32_t *slot = subghz_toolkit_function_cache_slot(cache, address);
+    if (*slot)
+    {
+        if (inserted)
+            *inserted = false;
+        return &cache->functions[*slot - 1];
+    }
+
+    if (cache->count == cache->capacity)
+    {
+        cache->capacity *= 2;
+        cache->functions = realloc(cache->functions, cache->capacity * sizeof(SubGhzToolkitFunction));
+    }
+
+    SubGhzToolkitFunction *function = &cache->functions[cache->count];
+    subghz_toolkit_function_bounds(code, size, address, function);
+    function->owner = owner;
+    function->label = label;
+    *slot = ++cache->count;
+
+    // Load factor at most 50%
+    if (cache->count * 2 > cache->slot_count)
+        subghz_toolkit_function_cache_rehash(cache, cache->slot_count * 2);
+
+    if (inserted)
+        *inserted = true;
+    return function;
+}
+
+size_t subghz_toolkit_function_cache_count(const SubGhzToolkitFunctionCache *cache)
+{
+    return cache->count;
+}
+
+const SubGhzToolkitFunction *subghz_toolkit_function_cache_at(const SubGhzToolkitFunctionCache *cache, size_t i)
+{
+    return i < cache->count ? &cache->functions[i] : NULL;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_thumb.h"
+#include "subghz_toolkit_writer.h"
+
+// Thumb function boundaries and a per-address cache of them.
+//
+// A function is decoded forward from its entry. Forward branches that stay
+// inside the function push the reachable end out; the function's code ends at
+// the first unconditional return or branch past that point. Literal pool words
+// loaded by LDR follow the code and are counted into the size, so consecutive
+// functions tile flash without gaps or overlap. TBB/TBH switch tables are
+// stepped over using the bound of the CMP that guards them.
+
+#define SUBGHZ_TOOLKIT_FUNCTION_MAX_SIZE 4096 // scan limit, feed functions stay well below
+
+#define SUBGHZ_TOOLKIT_FUNCTION_FLAG_TRUNCATED (1u << 0) // no end within the scan limit
+#define SUBGHZ_TOOLKIT_FUNCTION_FLAG_TAIL_CALL (1u << 1) // ends in a branch to another function
+#define SUBGHZ_TOOLKIT_FUNCTION_FLAG_JUMP_TABLE (1u << 2) // contains TBB/TBH tables
+#define SUBGHZ_TOOLKIT_FUNCTION_FLAG_LEAF (1u << 3) // no BL / BLX
+
+#define SUBGHZ_TOOLKIT_FUNCTION_NO_OWNER 0xFFFF
+
+/** Readable memory at `address`, NULL if the address is not readable. `size` is the number of readable bytes. */
+typedef const uint8_t *(*SubGhzToolkitCodeAt)(void *context, uint32_t address, size_t *size);
+
+typedef struct
+{
+    uint32_t address; // code address, Thumb bit clear
+    uint16_t size; // code plus literal pool
+    uint16_t code_size; // up to and including the last instruction
+    uint16_t insn_count;
+    uint8_t flags; // SUBGHZ_TOOLKIT_FUNCTION_FLAG_*
+    uint8_t label; // caller defined, e.g. which pointer led here first
+    uint16_t owner; // caller defined, e.g. the protocol index it was first seen under
+} SubGhzToolkitFunction;
+
+/** Find the extent of the function at code[0..size) located at `address` */
+void subghz_toolkit_function_bounds(const uint8_t *code, size_t size, uint32_t address, SubGhzToolkitFunction *function);
+
+typedef struct
+{
+    uint32_t offset; // of the next instruction
+    uint32_t last_compare; // CMP immediate + 1, bounds a following switch table
+    uint32_t table_entries; // set when a switch table follows the instruction just returned
+} SubGhzToolkitFunctionCursor;
+
+/** Step through the code of an analyzed function, skipping switch tables. Start with a zeroed cursor. */
+bool subghz_toolkit_function_next(
+    const uint8_t *code, const SubGhzToolkitFunction *function, SubGhzToolkitFunctionCursor *cursor, SubGhzToolkitThumbInsn *insn);
+
+/** Annotated disassembly of an analyzed function: instructions, literal values, switch tables and the literal pool */
+void subghz_toolkit_function_write_listing(SubGhzToolkitWriter *writer, const uint8_t *code, const SubGhzToolkitFunction *function);
+
+typedef struct SubGhzToolkitFunctionCache SubGhzToolkitFunctionCache;
+
+SubGhzToolkitFunctionCache *subghz_toolkit_function_cache_alloc(void);
+
+void subghz_toolkit_function_cache_free(SubGhzToolkitFunctionCache *cache);
+
+/** Cached function at `address`, NULL if it has not been analyzed */
+const SubGhzToolkitFunction *subghz_toolkit_function_cache_find(const SubGhzToolkitFunctionCache *cache, uint32_t address);
+
+/** Analyze and cache the function at `address` unless already cached. `inserted` is set when this
+ *  call did the analysis. The returned pointer is valid until the next insert. */
+const SubGhzToolkitFunction *subghz_toolkit_function_cache_get(
+    SubGhzToolkitFunctionCache *cache, const uint8_t *code, size_t size, uint32_t address, uint16_t owner, uint8_t label, bool *inserted);
+
+size_t subghz_toolkit_function_cache_count(const SubGhzToolkitFunctionCache *cache);
+
+/** Functions in the order they were first analyzed */
+const SubGhzToolkitFunction *subghz_toolkit_function_cache_at(const SubGhzToolkitFunctionCache *cache, size_t i);
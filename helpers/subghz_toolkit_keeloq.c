@@ -0,0 +1,492 @@
+#include "subghz_toolkit_keeloq.h"
+
+#include <string.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define KEELOQ_NLF 0x3A5C742Eu
+#define KEELOQ_ROUNDS 528
+#define KEELOQ_FAAC_ENDING 0x544Du
+
+#define bit(x, n) (((x) >> (n)) & 1)
+#define g5(x, a, b, c, d, e) (bit(x, a) + bit(x, b) * 2 + bit(x, c) * 4 + bit(x, d) * 8 + bit(x, e) * 16)
+
+void subghz_toolkit_keeloq_capture_from_data(SubGhzToolkitKeeloqCapture *capture, uint64_t data)
+{
+    uint64_t reversed = 0;
+    for (int i = 0; i < 64; i++)
+        reversed = (reversed << 1) | bit(data, i);
+
+    capture->fix = (uint32_t)(reversed >> 32);
+    capture->hop = (uint32_t)reversed;
+}
+
+uint32_t subghz_toolkit_keeloq_encrypt(uint32_t data, uint64_t key)
+{
+    uint32_t x = data;
+    for (uint32_t r = 0; r < KEELOQ_ROUNDS; r++)
+        x = (x >> 1) ^
+            ((bit(x, 0) ^ bit(x, 16) ^ (uint32_t)bit(key, r & 63) ^ bit(KEELOQ_NLF, g5(x, 1, 9, 20, 26, 31))) << 31);
+    return x;
+}
+
+uint32_t subghz_toolkit_keeloq_decrypt(uint32_t data, uint64_t key)
+{
+    uint32_t x = data;
+    for (uint32_t r = 0; r < KEELOQ_ROUNDS; r++)
+        x = (x << 1) ^ bit(x, 31) ^ bit(x, 15) ^ (uint32_t)bit(key, (15 - r) & 63) ^
+            bit(KEELOQ_NLF, g5(x, 0, 8, 19, 25, 30));
+    return x;
+}
+
+static uint32_t subghz_toolkit_keeloq_serial(const SubGhzToolkitKeeloqCapture *capture)
+{
+    return capture->fix & 0x0FFFFFFF;
+}
+
+// The magic serial types overwrite part of the manufacturer key with the fix word
+static uint64_t subghz_toolkit_keeloq_magic_serial(SubGhzToolkitKeeloqLearning learning, uint32_t fix, uint64_t key)
+{
+    switch (learning)
+    {
+    case SubGhzToolkitKeeloqLearningMagicSerialType1:
+        return (key & 0xFFFFFFFF) | ((uint64_t)fix << 40) | ((uint64_t)(((fix & 0xFF) + ((fix >> 8) & 0xFF)) & 0xFF) << 32);
+    case SubGhzToolkitKeeloqLearningMagicSerialType2:
+        return (key & 0xFFFFFFFF) | ((uint64_t)__builtin_bswap32(fix) << 32);
+    default:
+        return (key & 0xFFFFFFFFFF000000ull) | (fix & 0xFFFFFF);
+    }
+}
+
+uint64_t subghz_toolkit_keeloq_learn(
+    SubGhzToolkitKeeloqLearning learning, const SubGhzToolkitKeeloqCapture *capture, uint64_t key)
+{
+    uint32_t serial = subghz_toolkit_keeloq_serial(capture);
+
+    switch (learning)
+    {
+    case SubGhzToolkitKeeloqLearningNormal:
+        return ((uint64_t)subghz_toolkit_keeloq_decrypt(serial | 0x60000000, key) << 32) |
+               subghz_toolkit_keeloq_decrypt(serial | 0x20000000, key);
+    case SubGhzToolkitKeeloqLearningSecure:
+        return ((uint64_t)subghz_toolkit_keeloq_decrypt(serial, key) << 32) |
+               subghz_toolkit_keeloq_decrypt(capture->seed, key);
+    case SubGhzToolkitKeeloqLearningMagicXorType1:
+        return (((uint64_t)serial << 32) | serial) ^ key;
+    case SubGhzToolkitKeeloqLearningFaac:
+        return ((uint64_t)subghz_toolkit_keeloq_encrypt(capture->seed, key) << 32) |
+               subghz_toolkit_keeloq_encrypt((capture->seed & 0xFFFF0000) | KEELOQ_FAAC_ENDING, key);
+    case SubGhzToolkitKeeloqLearningMagicSerialType1:
+    case SubGhzToolkitKeeloqLearningMagicSerialType2:
+    case SubGhzToolkitKeeloqLearningMagicSerialType3:
+        return subghz_toolkit_keeloq_magic_serial(learning, capture->fix, key);
+    default:
+        return key;
+    }
+}
+
+bool subghz_toolkit_keeloq_check(const SubGhzToolkitKeeloqCapture *capture, uint32_t decrypt)
+{
+    uint32_t discriminator = (decrypt >> 16) & 0xFF;
+    return (decrypt >> 28) == (capture->fix >> 28) && (discriminator == (capture->fix & 0xFF) || discriminator == 0);
+}
+
+const char *subghz_toolkit_keeloq_learning_name(SubGhzToolkitKeeloqLearning learning)
+{
+    static const char *const names[SubGhzToolkitKeeloqLearningCount] = {
+        "Unknown",
+        "Simple",
+        "Normal",
+        "Secure",
+        "Magic_XOR_Type_1",
+        "FAAC",
+        "Magic_Serial_Type_1",
+        "Magic_Serial_Type_2",
+        "Magic_Serial_Type_3",
+    };
+    return learning < SubGhzToolkitKeeloqLearningCount ? names[learning] : "Invalid";
+}
+
+uint32_t subghz_toolkit_keeloq_learning_usable(const SubGhzToolkitKeeloqCapture *capture, uint32_t learning_mask)
+{
+    learning_mask &= SUBGHZ_TOOLKIT_KEELOQ_LEARNING_ALL;
+    if (!capture->has_seed)
+        learning_mask &= ~(SUBGHZ_TOOLKIT_KEELOQ_LEARNING_BIT(SubGhzToolkitKeeloqLearningSecure) |
+                           SUBGHZ_TOOLKIT_KEELOQ_LEARNING_BIT(SubGhzToolkitKeeloqLearningFaac));
+    return learning_mask;
+}
+
+static bool subghz_toolkit_keeloq_type_allowed(const uint16_t *types, size_t index, SubGhzToolkitKeeloqLearning learning)
+{
+    return !types || types[index] == SubGhzToolkitKeeloqLearningUnknown || types[index] == learning;
+}
+
+size_t subghz_toolkit_keeloq_search_scalar(
+    const SubGhzToolkitKeeloqCapture *capture,
+    const uint64_t *keys,
+    const uint16_t *types,
+    size_t count,
+    uint32_t learning_mask,
+    SubGhzToolkitKeeloqMatchCallback callback,
+    void *context)
+{
+    uint32_t usable = subghz_toolkit_keeloq_learning_usable(capture, learning_mask);
+    size_t matches = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        for (uint32_t l = 1; l < SubGhzToolkitKeeloqLearningCount; l++)
+        {
+            if (!(usable & SUBGHZ_TOOLKIT_KEELOQ_LEARNING_BIT(l)) || !subghz_toolkit_keeloq_type_allowed(types, i, l))
+                continue;
+
+            uint64_t man = subghz_toolkit_keeloq_learn(l, capture, keys[i]);
+            uint32_t decrypt = subghz_toolkit_keeloq_decrypt(capture->hop, man);
+            if (subghz_toolkit_keeloq_check(capture, decrypt))
+            {
+                matches++;
+                if (callback)
+                    callback(context, i, l, decrypt);
+            }
+        }
+    }
+    return matches;
+}
+
+// Bitsliced core. Plane j holds bit j of every lane's value, so one bitwise
+// instruction runs a round step for all lanes. Keys never need transposing
+// back: the output planes of a learning decrypt are the key planes of the
+// next stage, and only lanes that pass the check are recomputed in scalar.
+
+#ifdef __AVX2__
+typedef __m256i SubGhzToolkitKeeloqLane;
+#define KEELOQ_LANES 256
+#define LANE_ZERO() _mm256_setzero_si256()
+#define LANE_ONES() _mm256_set1_epi64x(-1)
+#define LANE_AND(a, b) _mm256_and_si256(a, b)
+#define LANE_OR(a, b) _mm256_or_si256(a, b)
+#define LANE_XOR(a, b) _mm256_xor_si256(a, b)
+#define LANE_ANDNOT(a, b) _mm256_andnot_si256(a, b) // ~a & b
+#else
+typedef uint64_t SubGhzToolkitKeeloqLane;
+#define KEELOQ_LANES 64
+#define LANE_ZERO() ((uint64_t)0)
+#define LANE_ONES() (~(uint64_t)0)
+#define LANE_AND(a, b) ((a) & (b))
+#define LANE_OR(a, b) ((a) | (b))
+#define LANE_XOR(a, b) ((a) ^ (b))
+#define LANE_ANDNOT(a, b) (~(a) & (b))
+#endif
+
+#define KEELOQ_WORDS (KEELOQ_LANES / 64)
+
+typedef SubGhzToolkitKeeloqLane Lane;
+
+size_t subghz_toolkit_keeloq_lanes(void)
+{
+    return KEELOQ_LANES;
+}
+
+static void subghz_toolkit_keeloq_transpose64(uint64_t a[64])
+{
+    uint64_t m = 0x00000000FFFFFFFFull;
+    for (int j = 32; j; j >>= 1, m ^= m << j)
+    {
+        for (int k = 0; k < 64; k = (k + j + 1) & ~j)
+        {
+            uint64_t t = ((a[k] >> j) ^ a[k + j]) & m;
+            a[k] ^= t << j;
+            a[k + j] ^= t;
+        }
+    }
+}
+
+static Lane subghz_toolkit_keeloq_lane_from_words(const uint64_t *words)
+{
+#ifdef __AVX2__
+    return _mm256_loadu_si256((const __m256i *)words);
+#else
+    return words[0];
+#endif
+}
+
+static void subghz_toolkit_keeloq_lane_to_words(Lane lane, uint64_t *words)
+{
+#ifdef __AVX2__
+    _mm256_storeu_si256((__m256i *)words, lane);
+#else
+    words[0] = lane;
+#endif
+}
+
+static Lane subghz_toolkit_keeloq_lane_broadcast(uint32_t bit_value)
+{
+    return bit_value ? LANE_ONES() : LANE_ZERO();
+}
+
+// Lanes [0, n) set
+static Lane subghz_toolkit_keeloq_lane_first(size_t n)
+{
+    uint64_t words[KEELOQ_WORDS];
+    for (size_t w = 0; w < KEELOQ_WORDS; w++)
+    {
+        size_t left = n > w * 64 ? n - w * 64 : 0;
+        words[w] = left >= 64 ? ~0ull : ((1ull << left) - 1);
+    }
+    return subghz_toolkit_keeloq_lane_from_words(words);
+}
+
+// keys[0..n) into 64 key planes, missing lanes are zero
+static void subghz_toolkit_keeloq_load_keys(Lane planes[64], const uint64_t *keys, size_t n)
+{
+    uint64_t words[KEELOQ_WORDS][64];
+
+    for (size_t w = 0; w < KEELOQ_WORDS; w++)
+    {
+        for (size_t i = 0; i < 64; i++)
+        {
+            size_t lane = w * 64 + i;
+            words[w][i] = lane < n ? keys[lane] : 0;
+        }
+        subghz_toolkit_keeloq_transpose64(words[w]);
+    }
+
+    for (size_t j = 0; j < 64; j++)
+    {
+        uint64_t plane[KEELOQ_WORDS];
+        for (size_t w = 0; w < KEELOQ_WORDS; w++)
+            plane[w] = words[w][j];
+        planes[j] = subghz_toolkit_keeloq_lane_from_words(plane);
+    }
+}
+
+// NLF 0x3A5C742E in algebraic normal form, regrouped as p ^ (e & q):
+// a ^ b ^ ab ^ bc ^ ad ^ cd ^ e(a ^ ab ^ c ^ ac ^ bd ^ cd)
+static inline Lane subghz_toolkit_keeloq_nlf(Lane a, Lane b, Lane c, Lane d, Lane e)
+{
+    Lane p = LANE_XOR(LANE_XOR(LANE_OR(a, b), LANE_AND(b, c)), LANE_AND(d, LANE_XOR(a, c)));
+    Lane q = LANE_XOR(LANE_XOR(LANE_ANDNOT(b, a), LANE_ANDNOT(a, c)), LANE_AND(d, LANE_XOR(b, c)));
+    return LANE_XOR(p, LANE_AND(e, q));
+}
+
+// The 32 state planes form a ring; `s[(i + off) & 31]` is logical bit i, so a
+// shift is a change of `off` instead of 32 moves. Every 32 rounds the ring is
+// back where it started.
+
+static void subghz_toolkit_keeloq_bs_decrypt(Lane state[32], const Lane key[64])
+{
+    unsigned off = 0;
+    for (unsigned r = 0; r < KEELOQ_ROUNDS; r++)
+    {
+#define S(i) state[((i) + off) & 31]
+        Lane next = LANE_XOR(LANE_XOR(S(31), S(15)), key[(15 - r) & 63]);
+        next = LANE_XOR(next, subghz_toolkit_keeloq_nlf(S(0), S(8), S(19), S(25), S(30)));
+        off = (off - 1) & 31;
+        S(0) = next;
+#undef S
+    }
+
+    // Rotate the ring back to off = 0 (528 rounds leave it at 16)
+    Lane tmp[32];
+    for (unsigned i = 0; i < 32; i++)
+        tmp[i] = state[(i + off) & 31];
+    memcpy(state, tmp, sizeof(tmp));
+}
+
+static void subghz_toolkit_keeloq_bs_encrypt(Lane state[32], const Lane key[64])
+{
+    unsigned off = 0;
+    for (unsigned r = 0; r < KEELOQ_ROUNDS; r++)
+    {
+#define S(i) state[((i) + off) & 31]
+        Lane next = LANE_XOR(LANE_XOR(S(0), S(16)), key[r & 63]);
+        next = LANE_XOR(next, subghz_toolkit_keeloq_nlf(S(1), S(9), S(20), S(26), S(31)));
+        off = (off + 1) & 31;
+        S(31) = next;
+#undef S
+    }
+
+    Lane tmp[32];
+    for (unsigned i = 0; i < 32; i++)
+        tmp[i] = state[(i + off) & 31];
+    memcpy(state, tmp, sizeof(tmp));
+}
+
+static void subghz_toolkit_keeloq_bs_const(Lane state[32], uint32_t value)
+{
+    for (unsigned i = 0; i < 32; i++)
+        state[i] = subghz_toolkit_keeloq_lane_broadcast(bit(value, i));
+}
+
+// Cipher of a constant data word under every lane's key, written to out[0..32)
+static void subghz_toolkit_keeloq_bs_cipher(Lane *out, uint32_t data, const Lane key[64], bool encrypt)
+{
+    subghz_toolkit_keeloq_bs_const(out, data);
+    if (encrypt)
+        subghz_toolkit_keeloq_bs_encrypt(out, key);
+    else
+        subghz_toolkit_keeloq_bs_decrypt(out, key);
+}
+
+// Device key planes for one learning type, mirroring subghz_toolkit_keeloq_learn()
+static void subghz_toolkit_keeloq_bs_learn(
+    Lane man[64], SubGhzToolkitKeeloqLearning learning, const SubGhzToolkitKeeloqCapture *capture, const Lane key[64])
+{
+    uint32_t serial = subghz_toolkit_keeloq_serial(capture);
+
+    switch (learning)
+    {
+    case SubGhzToolkitKeeloqLearningNormal:
+        subghz_toolkit_keeloq_bs_cipher(&man[0], serial | 0x20000000, key, false);
+        subghz_toolkit_keeloq_bs_cipher(&man[32], serial | 0x60000000, key, false);
+        break;
+    case SubGhzToolkitKeeloqLearningSecure:
+        subghz_toolkit_keeloq_bs_cipher(&man[0], capture->seed, key, false);
+        subghz_toolkit_keeloq_bs_cipher(&man[32], serial, key, false);
+        break;
+    case SubGhzToolkitKeeloqLearningFaac:
+        subghz_toolkit_keeloq_bs_cipher(&man[0], (capture->seed & 0xFFFF0000) | KEELOQ_FAAC_ENDING, key, true);
+        subghz_toolkit_keeloq_bs_cipher(&man[32], capture->seed, key, true);
+        break;
+    case SubGhzToolkitKeeloqLearningMagicXorType1:
+    {
+        uint64_t mask = ((uint64_t)serial << 32) | serial;
+        for (unsigned j = 0; j < 64; j++)
+            man[j] = LANE_XOR(key[j], subghz_toolkit_keeloq_lane_broadcast(bit(mask, j)));
+        break;
+    }
+    case SubGhzToolkitKeeloqLearningMagicSerialType1:
+    case SubGhzToolkitKeeloqLearningMagicSerialType2:
+    case SubGhzToolkitKeeloqLearningMagicSerialType3:
+    {
+        // Bits the learning keeps from the key are found by learning an all ones and an all zeros key
+        uint64_t ones = subghz_toolkit_keeloq_magic_serial(learning, capture->fix, ~0ull);
+        uint64_t zeros = subghz_toolkit_keeloq_magic_serial(learning, capture->fix, 0);
+        for (unsigned j = 0; j < 64; j++)
+            man[j] = bit(ones ^ zeros, j) ? key[j] : subghz_toolkit_keeloq_lane_broadcast(bit(zeros, j));
+        break;
+    }
+    default:
+        memcpy(man, key, 64 * sizeof(Lane));
+        break;
+    }
+}
+
+// Lanes whose decrypted hop passes subghz_toolkit_keeloq_check()
+static Lane subghz_toolkit_keeloq_bs_check(const Lane hop[32], const SubGhzToolkitKeeloqCapture *capture)
+{
+    Lane button = LANE_ONES();
+    for (unsigned j = 0; j < 4; j++)
+        button = LANE_ANDNOT(LANE_XOR(hop[28 + j], subghz_toolkit_keeloq_lane_broadcast(bit(capture->fix, 28 + j))), button);
+
+    Lane serial = LANE_ONES();
+    Lane zero = LANE_ONES();
+    for (unsigned j = 0; j < 8; j++)
+    {
+        serial = LANE_ANDNOT(LANE_XOR(hop[16 + j], subghz_toolkit_keeloq_lane_broadcast(bit(capture->fix, j))), serial);
+        zero = LANE_ANDNOT(hop[16 + j], zero);
+    }
+
+    return LANE_AND(button, LANE_OR(serial, zero));
+}
+
+static Lane subghz_toolkit_keeloq_type_lanes(const uint16_t *types, size_t n, SubGhzToolkitKeeloqLearning learning)
+{
+    if (!types)
+        return subghz_toolkit_keeloq_lane_first(n);
+
+    uint64_t words[KEELOQ_WORDS] = {0};
+    for (size_t i = 0; i < n; i++)
+    {
+        if (subghz_toolkit_keeloq_type_allowed(types, i, learning))
+            words[i / 64] |= 1ull << (i % 64);
+    }
+    return subghz_toolkit_keeloq_lane_from_words(words);
+}
+
+size_t subghz_toolkit_keeloq_search(
+    const SubGhzToolkitKeeloqCapture *capture,
+    const uint64_t *keys,
+    const uint16_t *types,
+    size_t count,
+    uint32_t learning_mask,
+    SubGhzToolkitKeeloqMatchCallback callback,
+    void *context)
+{
+    uint32_t usable = subghz_toolkit_keeloq_learning_usable(capture, learning_mask);
+    size_t matches = 0;
+    Lane key[64];
+    Lane man[64];
+    Lane hop[32];
+
+    for (size_t base = 0; base < count; base += KEELOQ_LANES)
+    {
+        size_t n = count - base < KEELOQ_LANES ? count - base : KEELOQ_LANES;
+        subghz_toolkit_keeloq_load_keys(key, keys + base, n);
+
+        for (uint32_t l = 1; l < SubGhzToolkitKeeloqLearningCount; l++)
+        {
+            if (!(usable & SUBGHZ_TOOLKIT_KEELOQ_LEARNING_BIT(l)))
+                continue;
+
+            Lane enabled = subghz_toolkit_keeloq_type_lanes(types ? types + base : NULL, n, l);
+            uint64_t words[KEELOQ_WORDS];
+            uint64_t any = 0;
+            subghz_toolkit_keeloq_lane_to_words(enabled, words);
+            for (size_t w = 0; w < KEELOQ_WORDS; w++)
+                any |= words[w];
+            if (!any)
+                continue;
+
+            subghz_toolkit_keeloq_bs_learn(man, l, capture, key);
+            subghz_toolkit_keeloq_bs_cipher(hop, capture->hop, man, false);
+
+            subghz_toolkit_keeloq_lane_to_words(LANE_AND(enabled, subghz_toolkit_keeloq_bs_check(hop, capture)), words);
+            for (size_t w = 0; w < KEELOQ_WORDS; w++)
+            {
+                for (uint64_t hits = words[w]; hits; hits &= hits - 1)
+                {
+                    size_t index = base + w * 64 + (size_t)__builtin_ctzll(hits);
+                    matches++;
+                    if (callback)
+                    {
+                        uint64_t device_key = subghz_toolkit_keeloq_learn(l, capture, keys[index]);
+                        callback(context, index, l, subghz_toolkit_keeloq_decrypt(capture->hop, device_key));
+                    }
+                }
+            }
+        }
+    }
+    return matches;
+}
+
+void subghz_toolkit_keeloq_decrypt_batch(uint32_t data, const uint64_t *keys, size_t count, uint32_t *out)
+{
+    Lane key[64];
+    Lane state[32];
+
+    for (size_t base = 0; base < count; base += KEELOQ_LANES)
+    {
+        size_t n = count - base < KEELOQ_LANES ? count - base : KEELOQ_LANES;
+        subghz_toolkit_keeloq_load_keys(key, keys + base, n);
+        subghz_toolkit_keeloq_bs_cipher(state, data, key, false);
+
+        uint64_t words[KEELOQ_WORDS][64];
+        for (size_t j = 0; j < 64; j++)
+        {
+            uint64_t plane[KEELOQ_WORDS];
+            subghz_toolkit_keeloq_lane_to_words(j < 32 ? state[j] : LANE_ZERO(), plane);
+            for (size_t w = 0; w < KEELOQ_WORDS; w++)
+                words[w][j] = plane[w];
+        }
+
+        for (size_t w = 0; w < KEELOQ_WORDS; w++)
+        {
+            subghz_toolkit_keeloq_transpose64(words[w]);
+            for (size_t i = 0; i < 64 && w * 64 + i < n; i++)
+                out[base + w * 64 + i] = (uint32_t)words[w][i];
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// KeeLoq cipher, manufacturer key learning and a bitsliced batch search.
+//
+// The scalar functions match lib/subghz/protocols/keeloq_common.c bit for
+// bit. The batch search runs one cipher instance per bit of a machine word:
+// 64 keys per pass with uint64_t planes, or 256 with AVX2 when the file is
+// built with -mavx2 (or -march=native on a machine that has it).
+
+// Learning types as stored in the keystore
+typedef enum
+{
+    SubGhzToolkitKeeloqLearningUnknown = 0,
+    SubGhzToolkitKeeloqLearningSimple = 1,
+    SubGhzToolkitKeeloqLearningNormal = 2,
+    SubGhzToolkitKeeloqLearningSecure = 3,
+    SubGhzToolkitKeeloqLearningMagicXorType1 = 4,
+    SubGhzToolkitKeeloqLearningFaac = 5,
+    SubGhzToolkitKeeloqLearningMagicSerialType1 = 6,
+    SubGhzToolkitKeeloqLearningMagicSerialType2 = 7,
+    SubGhzToolkitKeeloqLearningMagicSerialType3 = 8,
+    SubGhzToolkitKeeloqLearningCount,
+} SubGhzToolkitKeeloqLearning;
+
+#define SUBGHZ_TOOLKIT_KEELOQ_LEARNING_BIT(learning) (1u << (learning))
+#define SUBGHZ_TOOLKIT_KEELOQ_LEARNING_ALL 0x1FEu // every type except Unknown
+
+// One received KeeLoq packet. Secure and FAAC learning also need the seed
+// from the remote's seed transmission.
+typedef struct
+{
+    uint32_t fix; // button (4) | serial (28)
+    uint32_t hop; // encrypted: button (4) | overflow (2) | discriminator (10) | counter (16)
+    uint32_t seed;
+    bool has_seed;
+} SubGhzToolkitKeeloqCapture;
+
+/** Split the 64 bit "Key:" value of a .sub file into fix and hop, as the decoder does */
+void subghz_toolkit_keeloq_capture_from_data(SubGhzToolkitKeeloqCapture *capture, uint64_t data);
+
+uint32_t subghz_toolkit_keeloq_encrypt(uint32_t data, uint64_t key);
+
+uint32_t subghz_toolkit_keeloq_decrypt(uint32_t data, uint64_t key);
+
+/** Device key for `capture` derived from a manufacturer key */
+uint64_t subghz_toolkit_keeloq_learn(
+    SubGhzToolkitKeeloqLearning learning, const SubGhzToolkitKeeloqCapture *capture, uint64_t key);
+
+/** Firmware acceptance test: button matches and the discriminator matches the serial or is zero */
+bool subghz_toolkit_keeloq_check(const SubGhzToolkitKeeloqCapture *capture, uint32_t decrypt);
+
+const char *subghz_toolkit_keeloq_learning_name(SubGhzToolkitKeeloqLearning learning);
+
+/** Learning types that can be tried for this capture out of `learning_mask` */
+uint32_t subghz_toolkit_keeloq_learning_usable(const SubGhzToolkitKeeloqCapture *capture, uint32_t learning_mask);
+
+typedef void (*SubGhzToolkitKeeloqMatchCallback)(
+    void *context, size_t key_index, SubGhzToolkitKeeloqLearning learning, uint32_t decrypt);
+
+/** Try keys[0..count) under every learning type in `learning_mask`.
+ *  If `types` is given, a key is only tried under its stored type (Unknown tries all).
+ *  Calls `callback` for each passing (key, learning) pair and returns how many there were. */
+size_t subghz_toolkit_keeloq_search(
+    const SubGhzToolkitKeeloqCapture *capture,
+    const uint64_t *keys,
+    const uint16_t *types,
+    size_t count,
+    uint32_t learning_mask,
+    SubGhzToolkitKeeloqMatchCallback callback,
+    void *context);
+
+/** Same contract as subghz_toolkit_keeloq_search(), one key at a time. Reference and baseline. */
+size_t subghz_toolkit_keeloq_search_scalar(
+    const SubGhzToolkitKeeloqCapture *capture,
+    const uint64_t *keys,
+    const uint16_t *types,
+    size_t count,
+    uint32_t learning_mask,
+    SubGhzToolkitKeeloqMatchCallback callback,
+    void *context);
+
+/** decrypt(data, keys[i]) for every key, using the bitsliced core */
+void subghz_toolkit_keeloq_decrypt_batch(uint32_t data, const uint64_t *keys, size_t count, uint32_t *out);
+
+/** Keys per bitsliced pass: 64 or 256 */
+size_t subghz_toolkit_keeloq_lanes(void);
@@ -0,0 +1,266 @@
+#include "subghz_toolkit_key_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct SubGhzToolkitKeyIndex
+{
+    uint8_t *data;
+    size_t size;
+    bool owned;
+    SubGhzToolkitKeyIndexHeader *header;
+    SubGhzToolkitKeyfileRecord *records;
+    uint32_t *slots;
+    uint32_t capacity;
+};
+
+static uint32_t subghz_toolkit_key_index_slot_count(uint32_t capacity)
+{
+    // Load factor at most 50%, as in the protocol name index
+    uint32_t size = 8;
+    while (size < capacity * 2)
+        size <<= 1;
+    return size;
+}
+
+static uint32_t subghz_toolkit_key_index_hash(uint64_t key)
+{
+    // MurmurHash3 finalizer: manufacturer keys share long runs of bits
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDull;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ull;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+static int subghz_toolkit_key_index_lower(int c)
+{
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+// Compares at most the stored name length, so a longer `b` is cut where the
+// index cut the names it stores; prefix mode treats a name that starts with
+// `b` as equal.
+static int subghz_toolkit_key_index_compare_name(const char *a, const char *b, bool prefix)
+{
+    for (size_t i = 0; i < SUBGHZ_TOOLKIT_KEYFILE_NAME_SIZE - 1; i++)
+    {
+        if (prefix && !b[i])
+            return 0;
+        int ca = subghz_toolkit_key_index_lower((uint8_t)a[i]);
+        int cb = subghz_toolkit_key_index_lower((uint8_t)b[i]);
+        if (ca != cb)
+            return ca - cb;
+        if (!ca)
+            return 0;
+    }
+    return 0;
+}
+
+static int subghz_toolkit_key_index_sort_compare(const void *a, const void *b)
+{
+    const SubGhzToolkitKeyfileRecord *ra = a;
+    const SubGhzToolkitKeyfileRecord *rb = b;
+
+    int result = subghz_toolkit_key_index_compare_name(ra->name, rb->name, false);
+    if (result)
+        return result;
+    if (ra->key != rb->key)
+        return ra->key < rb->key ? -1 : 1;
+    return (int)ra->type - (int)rb->type;
+}
+
+static void subghz_toolkit_key_index_layout(SubGhzToolkitKeyIndex *index)
+{
+    index->header = (SubGhzToolkitKeyIndexHeader *)index->data;
+    index->records = (SubGhzToolkitKeyfileRecord *)(index->data + sizeof(SubGhzToolkitKeyIndexHeader));
+    index->slots = (uint32_t *)(index->data + sizeof(SubGhzToolkitKeyIndexHeader) +
+                                (size_t)index->capacity * sizeof(SubGhzToolkitKeyfileRecord));
+}
+
+SubGhzToolkitKeyIndex *subghz_toolkit_key_index_alloc(uint32_t capacity)
+{
+    SubGhzToolkitKeyIndex *index = malloc(sizeof(SubGhzToolkitKeyIndex));
+    uint32_t slot_count = subghz_toolkit_key_index_slot_count(capacity);
+
+    index->capacity = capacity;
+    index->size = sizeof(SubGhzToolkitKeyIndexHeader) + (size_t)capacity * sizeof(SubGhzToolkitKeyfileRecord) +
+                  (size_t)slot_count * sizeof(uint32_t);
+    index->data = calloc(1, index->size);
+    index->owned = true;
+    subghz_toolkit_key_index_layout(index);
+
+    index->header->magic = SUBGHZ_TOOLKIT_KEY_INDEX_MAGIC;
+    index->header->version = SUBGHZ_TOOLKIT_KEY_INDEX_VERSION;
+    index->header->record_size = sizeof(SubGhzToolkitKeyfileRecord);
+    index->header->count = 0;
+    index->header->slot_count = slot_count;
+    return index;
+}
+
+SubGhzToolkitKeyIndex *subghz_toolkit_key_index_wrap(void *data, size_t size, bool owned)
+{
+    const SubGhzToolkitKeyIndexHeader *header = data;
+
+    if (size < sizeof(*header) || header->magic != SUBGHZ_TOOLKIT_KEY_INDEX_MAGIC ||
+        header->version != SUBGHZ_TOOLKIT_KEY_INDEX_VERSION ||
+        header->record_size != sizeof(SubGhzToolkitKeyfileRecord) ||
+        header->slot_count != subghz_toolkit_key_index_slot_count(header->count))
+        return NULL;
+
+    size_t expected = sizeof(*header) + (size_t)header->count * sizeof(SubGhzToolkitKeyfileRecord) +
+                      (size_t)header->slot_count * sizeof(uint32_t);
+    if (size != expected)
+        return NULL;
+
+    SubGhzToolkitKeyIndex *index = malloc(sizeof(SubGhzToolkitKeyIndex));
+    index->data = data;
+    index->size = size;
+    index->owned = owned;
+    index->capacity = header->count;
+    subghz_toolkit_key_index_layout(index);
+
+    // Lookups trust the slots and names from here on, so check them once
+    bool valid = true;
+    for (uint32_t i = 0; valid && i < header->slot_count; i++)
+        valid = index->slots[i] <= header->count;
+    for (uint32_t i = 0; valid && i < header->count; i++)
+        valid = index->records[i].name[SUBGHZ_TOOLKIT_KEYFILE_NAME_SIZE - 1] == '\0';
+
+    if (!valid)
+    {
+        index->owned = false;
+        subghz_toolkit_key_index_free(index);
+        return NULL;
+    }
+    return index;
+}
+
+void subghz_toolkit_key_index_free(SubGhzToolkitKeyIndex *index)
+{
+    if (index->owned)
+        free(index->data);
+    free(index);
+}
+
+bool subghz_toolkit_key_index_add(SubGhzToolkitKeyIndex *index, const char *name, uint64_t key, uint16_t type)
+{
+    if (index->header->count >= index->capacity)
+        return false;
+
+    SubGhzToolkitKeyfileRecord *record = &index->records[index->header->count++];
+    memset(record, 0, sizeof(*record));
+    record->key = key;
+    record->type = type;
+    strncpy(record->name, name, sizeof(record->name) - 1);
+    return true;
+}
+
+void subghz_toolkit_key_index_build(SubGhzToolkitKeyIndex *index, uint32_t source_stamp)
+{
+    uint32_t count = index->header->count;
+    uint32_t slot_count = subghz_toolkit_key_index_slot_count(count);
+
+    qsort(index->records, count, sizeof(SubGhzToolkitKeyfileRecord), subghz_toolkit_key_index_sort_compare);
+
+    // Fewer keys than capacity: pull the table up against the records so the
+    // blob is exactly what wrap() expects
+    if (count < index->capacity)
+    {
+        index->capacity = count;
+        index->size = sizeof(SubGhzToolkitKeyIndexHeader) + (size_t)count * sizeof(SubGhzToolkitKeyfileRecord) +
+                      (size_t)slot_count * sizeof(uint32_t);
+        subghz_toolkit_key_index_layout(index);
+    }
+
+    memset(index->slots, 0, (size_t)slot_count * sizeof(uint32_t));
+    index->header->slot_count = slot_count;
+    index->header->source_stamp = source_stamp;
+
+    uint32_t mask = slot_count - 1;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t pos = subghz_toolkit_key_index_hash(index->records[i].key) & mask;
+        while (index->slots[pos])
+            pos = (pos + 1) & mask;
+        index->slots[pos] = i + 1;
+    }
+}
+
+const void *subghz_toolkit_key_index_get_data(const SubGhzToolkitKeyIndex *index, size_t *size)
+{
+    *size = index->size;
+    return index->data;
+}
+
+uint32_t subghz_toolkit_key_index_count(const SubGhzToolkitKeyIndex *index)
+{
+    return index->header->count;
+}
+
+uint32_t subghz_toolkit_key_index_source_stamp(const SubGhzToolkitKeyIndex *index)
+{
+    return index->header->source_stamp;
+}
+
+const SubGhzToolkitKeyfileRecord *subghz_toolkit_key_index_get(const SubGhzToolkitKeyIndex *index, uint32_t i)
+{
+    return i < index->header->count ? &index->records[i] : NULL;
+}
+
+size_t subghz_toolkit_key_index_find_key(
+    const SubGhzToolkitKeyIndex *index, uint64_t key, const SubGhzToolkitKeyfileRecord **found, size_t max)
+{
+    uint32_t mask = index->header->slot_count - 1;
+    size_t matches = 0;
+
+    for (uint32_t pos = subghz_toolkit_key_index_hash(key) & mask; index->slots[pos]; pos = (pos + 1) & mask)
+    {
+        const SubGhzToolkitKeyfileRecord *record = &index->records[index->slots[pos] - 1];
+        if (record->key == key)
+        {
+            if (matches < max)
+                found[matches] = record;
+            matches++;
+        }
+    }
+    return matches;
+}
+
+// First record whose name is not less than `name`
+static uint32_t subghz_toolkit_key_index_lower_bound(const SubGhzToolkitKeyIndex *index, const char *name, bool prefix)
+{
+    uint32_t lo = 0;
+    uint32_t hi = index->header->count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (subghz_toolkit_key_index_compare_name(index->records[mid].name, name, prefix) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+const SubGhzToolkitKeyfileRecord *subghz_toolkit_key_index_find_name(const SubGhzToolkitKeyIndex *index, const char *name)
+{
+    uint32_t pos = subghz_toolkit_key_index_lower_bound(index, name, false);
+    if (pos < index->header->count &&
+        subghz_toolkit_key_index_compare_name(index->records[pos].name, name, false) == 0)
+        return &index->records[pos];
+    return NULL;
+}
+
+uint32_t subghz_toolkit_key_index_find_prefix(const SubGhzToolkitKeyIndex *index, const char *prefix, uint32_t *first)
+{
+    uint32_t pos = subghz_toolkit_key_index_lower_bound(index, prefix, true);
+    uint32_t end = pos;
+    while (end < index->header->count &&
+           subghz_toolkit_key_index_compare_name(index->records[end].name, prefix, true) == 0)
+        end++;
+
+    *first = pos;
+    return end - pos;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_keyfile.h"
+
+// KeeLoq manufacturer key index: key -> manufacturer and name -> key.
+//
+// The whole index is one contiguous blob, so it is saved and loaded as is:
+//
+//   header | records[count] sorted by name | slots[slot_count]
+//
+// Records are the 32 byte key file records. Names are sorted case
+// insensitively for binary and prefix search. Slots are an open addressing
+// table on the 64 bit key holding record index + 1 (0 is empty). Several
+// manufacturers may share a key, so key lookups return every match.
+
+#define SUBGHZ_TOOLKIT_KEY_INDEX_MAGIC 0x494B4753u // "SGKI"
+#define SUBGHZ_TOOLKIT_KEY_INDEX_VERSION 1
+
+typedef struct __attribute__((packed))
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t slot_count;
+    uint32_t source_stamp; // caller defined, e.g. derived from the keystore file sizes and times
+    uint32_t reserved;
+} SubGhzToolkitKeyIndexHeader;
+
+_Static_assert(sizeof(SubGhzToolkitKeyIndexHeader) == 24, "key index header layout");
+
+typedef struct SubGhzToolkitKeyIndex SubGhzToolkitKeyIndex;
+
+/** Start an empty index for up to `capacity` keys. Fill with add(), then call build(). */
+SubGhzToolkitKeyIndex *subghz_toolkit_key_index_alloc(uint32_t capacity);
+
+/** Use a saved index in place. Returns NULL if the data is not a valid index.
+ *  If `owned` the data is released with free() together with the index. */
+SubGhzToolkitKeyIndex *subghz_toolkit_key_index_wrap(void *data, size_t size, bool owned);
+
+void subghz_toolkit_key_index_free(SubGhzToolkitKeyIndex *index);
+
+/** Returns false once capacity is reached */
+bool subghz_toolkit_key_index_add(SubGhzToolkitKeyIndex *index, const char *name, uint64_t key, uint16_t type);
+
+/** Sort the names and fill the key table. Lookups are valid after this. */
+void subghz_toolkit_key_index_build(SubGhzToolkitKeyIndex *index, uint32_t source_stamp);
+
+/** The serialized index, ready to be written out */
+const void *subghz_toolkit_key_index_get_data(const SubGhzToolkitKeyIndex *index, size_t *size);
+
+uint32_t subghz_toolkit_key_index_count(const SubGhzToolkitKeyIndex *index);
+
+uint32_t subghz_toolkit_key_index_source_stamp(const SubGhzToolkitKeyIndex *index);
+
+/** Record at position `i` in name order */
+const SubGhzToolkitKeyfileRecord *subghz_toolkit_key_index_get(const SubGhzToolkitKeyIndex *index, uint32_t i);
+
+/** Stores up to `max` records owning `key` and returns the total number of matches */
+size_t subghz_toolkit_key_index_find_key(
+    const SubGhzToolkitKeyIndex *index, uint64_t key, const SubGhzToolkitKeyfileRecord **found, size_t max);
+
+/** Case insensitive exact match, NULL if absent. Names are stored cut to
+ *  SUBGHZ_TOOLKIT_KEYFILE_NAME_SIZE - 1 characters and `name` is compared up to that length. */
+const SubGhzToolkitKeyfileRecord *subghz_toolkit_key_index_find_name(const SubGhzToolkitKeyIndex *index, const char *name);
+
+/** Case insensitive prefix match, cut like find_name(). Returns the number of matches, which are consecutive from `first`. */
+uint32_t subghz_toolkit_key_index_find_prefix(const SubGhzToolkitKeyIndex *index, const char *prefix, uint32_t *first);
@@ -0,0 +1,190 @@
+#include "subghz_toolkit_keyfile.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void subghz_toolkit_keyfile_csv_header(SubGhzToolkitWriter *writer)
+{
+    subghz_toolkit_writer_cstr(writer, "name,key_hex,type\n");
+}
+
+void subghz_toolkit_keyfile_csv_record(SubGhzToolkitWriter *writer, const char *name, uint64_t key, uint16_t type)
+{
+    // Manufacturer names are plain identifiers; quote only if one ever needs it
+    if (strpbrk(name, ",\"\n"))
+    {
+        subghz_toolkit_writer_write(writer, "\"", 1);
+        for (const char *c = name; *c; c++)
+        {
+            if (*c == '"')
+                subghz_toolkit_writer_write(writer, "\"", 1);
+            subghz_toolkit_writer_write(writer, c, 1);
+        }
+        subghz_toolkit_writer_write(writer, "\"", 1);
+    }
+    else
+    {
+        subghz_toolkit_writer_cstr(writer, name);
+    }
+
+    subghz_toolkit_writer_write(writer, ",", 1);
+    subghz_toolkit_writer_hex_u64(writer, key);
+    subghz_toolkit_writer_write(writer, ",", 1);
+    subghz_toolkit_writer_dec_u32(writer, type);
+    subghz_toolkit_writer_write(writer, "\n", 1);
+}
+
+void subghz_toolkit_keyfile_binary_header(SubGhzToolkitWriter *writer, uint32_t count)
+{
+    SubGhzToolkitKeyfileHeader header = {
+        .magic = SUBGHZ_TOOLKIT_KEYFILE_MAGIC,
+        .version = SUBGHZ_TOOLKIT_KEYFILE_VERSION,
+        .record_size = sizeof(SubGhzToolkitKeyfileRecord),
+        .count = count,
+        .reserved = 0,
+    };
+    subghz_toolkit_writer_write(writer, &header, sizeof(header));
+}
+
+void subghz_toolkit_keyfile_binary_record(SubGhzToolkitWriter *writer, const char *name, uint64_t key, uint16_t type)
+{
+    SubGhzToolkitKeyfileRecord record;
+    memset(&record, 0, sizeof(record));
+    record.key = key;
+    record.type = type;
+    strncpy(record.name, name, sizeof(record.name) - 1);
+    subghz_toolkit_writer_write(writer, &record, sizeof(record));
+}
+
+bool subghz_toolkit_keyfile_parse(
+    const void *data, size_t size, const SubGhzToolkitKeyfileRecord **records, uint32_t *count)
+{
+    const SubGhzToolkitKeyfileHeader *header = data;
+
+    if (size < sizeof(*header) || header->magic != SUBGHZ_TOOLKIT_KEYFILE_MAGIC ||
+        header->version != SUBGHZ_TOOLKIT_KEYFILE_VERSION ||
+        header->record_size != sizeof(SubGhzToolkitKeyfileRecord))
+        return false;
+
+    // A cancelled export leaves fewer records than announced
+    size_t available = (size - sizeof(*header)) / sizeof(SubGhzToolkitKeyfileRecord);
+    *count = header->count < available ? header->count : (uint32_t)available;
+    *records = (const SubGhzToolkitKeyfileRecord *)((const uint8_t *)data + sizeof(*header));
+    return true;
+}
+
+static int subghz_toolkit_keyfile_hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+bool subghz_toolkit_keyfile_parse_csv_line(
+    const char *line, char *name, size_t name_size, uint64_t *key, uint16_t *type)
+{
+    const char *c = line;
+    size_t len = 0;
+
+    if (*c == '"')
+    {
+        for (c++; *c && !(c[0] == '"' && c[1] != '"'); c++)
+        {
+            if (c[0] == '"')
+                c++;
+            if (len + 1 < name_size)
+                name[len++] = *c;
+        }
+        if (*c++ != '"')
+            return false;
+    }
+    else
+    {
+        for (; *c && *c != ','; c++)
+        {
+            if (len + 1 < name_size)
+                name[len++] = *c;
+        }
+    }
+    name[len] = '\0';
+
+    if (*c++ != ',')
+        return false;
+
+    uint64_t value = 0;
+    int digits = 0;
+    for (int v; (v = subghz_toolkit_keyfile_hex_value(*c)) >= 0; c++, digits++)
+        value = (value << 4) | (uint64_t)v;
+    if (digits == 0 || digits > 16 || *c++ != ',')
+        return false;
+
+    uint32_t t = 0;
+    if (*c < '0' || *c > '9')
+        return false;
+    for (; *c >= '0' && *c <= '9'; c++)
+        t = t * 10 + (*c - '0');
+    if (*c && *c != '\r' && *c != '\n')
+        return false;
+
+    *key = value;
+    *type = (uint16_t)t;
+    return true;
+}
+
+bool subghz_toolkit_keyfile_load(
+    const void *data, size_t size, SubGhzToolkitKeyfileRecord **records, uint32_t *count)
+{
+    const SubGhzToolkitKeyfileRecord *binary;
+    if (subghz_toolkit_keyfile_parse(data, size, &binary, count))
+    {
+        *records = malloc((*count ? *count : 1) * sizeof(SubGhzToolkitKeyfileRecord));
+        memcpy(*records, binary, *count * sizeof(SubGhzToolkitKeyfileRecord));
+        return true;
+    }
+
+    // CSV: at most one record per line
+    const char *text = data;
+    size_t lines = 1;
+    for (size_t i = 0; i < size; i++)
+        lines += text[i] == '\n';
+
+    *records = malloc(lines * sizeof(SubGhzToolkitKeyfileRecord));
+    *count = 0;
+
+    char line[128];
+    for (size_t pos = 0; pos < size;)
+    {
+        size_t len = 0;
+        while (pos < size && text[pos] != '\n')
+        {
+            if (len + 1 < sizeof(line))
+                line[len++] = text[pos];
+            pos++;
+        }
+        line[len] = '\0';
+        pos++;
+
+        SubGhzToolkitKeyfileRecord *record = &(*records)[*count];
+        uint64_t key;
+        uint16_t type;
+        memset(record, 0, sizeof(*record));
+        if (subghz_toolkit_keyfile_parse_csv_line(line, record->name, sizeof(record->name), &key, &type))
+        {
+            record->key = key;
+            record->type = type;
+            (*count)++;
+        }
+    }
+
+    if (*count == 0)
+    {
+        free(*records);
+        *records = NULL;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_writer.h"
+
+// Compact KeeLoq manufacturer key exports.
+//
+// CSV:    "name,key_hex,type" header, then one line per key, e.g.
+//         "Alutech,0123456789ABCDEF,2"
+// Binary: a 16 byte header followed by fixed 32 byte records, little endian.
+//         Host tools read the records in place or mmap the file.
+
+#define SUBGHZ_TOOLKIT_KEYFILE_MAGIC 0x4B544753u // "SGTK"
+#define SUBGHZ_TOOLKIT_KEYFILE_VERSION 1
+#define SUBGHZ_TOOLKIT_KEYFILE_NAME_SIZE 22
+
+typedef struct __attribute__((packed))
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t reserved;
+} SubGhzToolkitKeyfileHeader;
+
+typedef struct __attribute__((packed))
+{
+    uint64_t key;
+    uint16_t type;
+    char name[SUBGHZ_TOOLKIT_KEYFILE_NAME_SIZE]; // NUL padded, truncated if longer
+} SubGhzToolkitKeyfileRecord;
+
+_Static_assert(sizeof(SubGhzToolkitKeyfileHeader) == 16, "keyfile header layout");
+_Static_assert(sizeof(SubGhzToolkitKeyfileRecord) == 32, "keyfile record layout");
+
+void subghz_toolkit_keyfile_csv_header(SubGhzToolkitWriter *writer);
+
+void subghz_toolkit_keyfile_csv_record(SubGhzToolkitWriter *writer, const char *name, uint64_t key, uint16_t type);
+
+void subghz_toolkit_keyfile_binary_header(SubGhzToolkitWriter *writer, uint32_t count);
+
+void subghz_toolkit_keyfile_binary_record(SubGhzToolkitWriter *writer, const char *name, uint64_t key, uint16_t type);
+
+/** Validate a binary key file held in memory. On success points `records` at the first record. */
+bool subghz_toolkit_keyfile_parse(
+    const void *data, size_t size, const SubGhzToolkitKeyfileRecord **records, uint32_t *count);
+
+/** Parse one CSV line (without the newline). `name` receives at most name_size - 1 chars. */
+bool subghz_toolkit_keyfile_parse_csv_line(
+    const char *line, char *name, size_t name_size, uint64_t *key, uint16_t *type);
+
+/** Decode a binary or CSV key file held in memory into a malloc'ed record array.
+ *  CSV lines that do not parse (the header, blank lines) are skipped. */
+bool subghz_toolkit_keyfile_load(
+    const void *data, size_t size, SubGhzToolkitKeyfileRecord **records, uint32_t *count);
@@ -0,0 +1,260 @@
+#include "subghz_toolkit_manifest.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "subghz_toolkit_name_index.h"
+
+#define SUBGHZ_TOOLKIT_MANIFEST_MAGIC 0x4D414753u // "SGAM"
+#define SUBGHZ_TOOLKIT_MANIFEST_HEADER_SIZE (16 + 2 * SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE)
+#define SUBGHZ_TOOLKIT_MANIFEST_MAX_PASSES 32
+
+typedef struct
+{
+    uint32_t hash;
+    uint32_t index;
+} SubGhzToolkitManifestHashIndex;
+
+struct SubGhzToolkitManifest
+{
+    char githash[SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE + 1];
+    char build_date[SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE + 1];
+    uint32_t config;
+    uint32_t protocol_count;
+    uint32_t *hashes;
+    SubGhzToolkitManifestHashIndex *sorted; // hashes by value, only for loaded manifests
+    SubGhzToolkitManifestPass passes[SUBGHZ_TOOLKIT_MANIFEST_MAX_PASSES];
+    size_t pass_count;
+};
+
+static uint32_t subghz_toolkit_manifest_u32(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void subghz_toolkit_manifest_put_u32(uint8_t *data, uint32_t value)
+{
+    data[0] = value;
+    data[1] = value >> 8;
+    data[2] = value >> 16;
+    data[3] = value >> 24;
+}
+
+SubGhzToolkitManifest *subghz_toolkit_manifest_alloc(
+    const char *githash, const char *build_date, uint32_t config, uint32_t protocol_count)
+{
+    SubGhzToolkitManifest *manifest = malloc(sizeof(SubGhzToolkitManifest));
+    memset(manifest, 0, sizeof(*manifest));
+    strncpy(manifest->githash, githash ? githash : "", SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE);
+    strncpy(manifest->build_date, build_date ? build_date : "", SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE);
+    manifest->config = config;
+    manifest->protocol_count = protocol_count;
+    manifest->hashes = calloc(protocol_count ? protocol_count : 1, sizeof(uint32_t));
+    return manifest;
+}
+
+void subghz_toolkit_manifest_free(SubGhzToolkitManifest *manifest)
+{
+    for (size_t i = 0; i < manifest->pass_count; i++)
+        free(manifest->passes[i].sections);
+    free(manifest->sorted);
+    free(manifest->hashes);
+    free(manifest);
+}
+
+bool subghz_toolkit_manifest_same_build(const SubGhzToolkitManifest *old, const SubGhzToolkitManifest *manifest)
+{
+    return old->config == manifest->config && old->protocol_count == manifest->protocol_count &&
+           !strcmp(old->githash, manifest->githash) && !strcmp(old->build_date, manifest->build_date);
+}
+
+uint32_t subghz_toolkit_manifest_config(const SubGhzToolkitManifest *manifest)
+{
+    return manifest->config;
+}
+
+uint32_t subghz_toolkit_manifest_protocol_count(const SubGhzToolkitManifest *manifest)
+{
+    return manifest->protocol_count;
+}
+
+void subghz_toolkit_manifest_set_hash(SubGhzToolkitManifest *manifest, uint32_t index, uint32_t hash)
+{
+    manifest->hashes[index] = hash;
+}
+
+uint32_t subghz_toolkit_manifest_hash(const SubGhzToolkitManifest *manifest, uint32_t index)
+{
+    return manifest->hashes[index];
+}
+
+void subghz_toolkit_manifest_copy_hashes(SubGhzToolkitManifest *manifest, const SubGhzToolkitManifest *from)
+{
+    memcpy(manifest->hashes, from->hashes, manifest->protocol_count * sizeof(uint32_t));
+}
+
+bool subghz_toolkit_manifest_find_hash(const SubGhzToolkitManifest *manifest, uint32_t hash, uint32_t *index)
+{
+    if (!manifest->sorted)
+    {
+        for (uint32_t i = 0; i < manifest->protocol_count; i++)
+        {
+            if (manifest->hashes[i] == hash)
+            {
+                *index = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t low = 0;
+    uint32_t high = manifest->protocol_count;
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        if (manifest->sorted[mid].hash < hash)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == manifest->protocol_count || manifest->sorted[low].hash != hash)
+        return false;
+    *index = manifest->sorted[low].index;
+    return true;
+}
+
+const SubGhzToolkitManifestPass *subghz_toolkit_manifest_find_pass(const SubGhzToolkitManifest *manifest, const char *file)
+{
+    uint32_t hash = subghz_toolkit_name_hash(file);
+    for (size_t i = 0; i < manifest->pass_count; i++)
+    {
+        if (manifest->passes[i].file == hash)
+            return &manifest->passes[i];
+    }
+    return NULL;
+}
+
+static SubGhzToolkitManifestPass *subghz_toolkit_manifest_add_pass_hash(SubGhzToolkitManifest *manifest, uint32_t file)
+{
+    for (size_t i = 0; i < manifest->pass_count; i++)
+    {
+        if (manifest->passes[i].file == file)
+            return &manifest->passes[i];
+    }
+    if (manifest->pass_count == SUBGHZ_TOOLKIT_MANIFEST_MAX_PASSES)
+        return NULL;
+
+    SubGhzToolkitManifestPass *pass = &manifest->passes[manifest->pass_count++];
+    pass->file = file;
+    pass->size = 0;
+    pass->sections = calloc(manifest->protocol_count + 1, sizeof(uint32_t));
+    return pass;
+}
+
+SubGhzToolkitManifestPass *subghz_toolkit_manifest_add_pass(SubGhzToolkitManifest *manifest, const char *file)
+{
+    return subghz_toolkit_manifest_add_pass_hash(manifest, subghz_toolkit_name_hash(file));
+}
+
+void subghz_toolkit_manifest_merge_passes(SubGhzToolkitManifest *manifest, const SubGhzToolkitManifest *from)
+{
+    for (size_t i = 0; i < from->pass_count; i++)
+    {
+        bool present = false;
+        for (size_t j = 0; j < manifest->pass_count && !present; j++)
+            present = manifest->passes[j].file == from->passes[i].file;
+        if (present)
+            continue;
+
+        SubGhzToolkitManifestPass *pass = subghz_toolkit_manifest_add_pass_hash(manifest, from->passes[i].file);
+        if (!pass)
+            return;
+        pass->size = from->passes[i].size;
+        memcpy(pass->sections, from->passes[i].sections, (manifest->protocol_count + 1) * sizeof(uint32_t));
+    }
+}
+
+void subghz_toolkit_manifest_save(const SubGhzToolkitManifest *manifest, SubGhzToolkitWriter *writer)
+{
+    uint8_t header[SUBGHZ_TOOLKIT_MANIFEST_HEADER_SIZE] = {0};
+    subghz_toolkit_manifest_put_u32(header, SUBGHZ_TOOLKIT_MANIFEST_MAGIC);
+    header[4] = SUBGHZ_TOOLKIT_MANIFEST_VERSION;
+    header[6] = manifest->pass_count;
+    header[7] = manifest->pass_count >> 8;
+    subghz_toolkit_manifest_put_u32(header + 8, manifest->protocol_count);
+    subghz_toolkit_manifest_put_u32(header + 12, manifest->config);
+    memcpy(header + 16, manifest->githash, strlen(manifest->githash));
+    memcpy(header + 16 + SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE, manifest->build_date, strlen(manifest->build_date));
+    subghz_toolkit_writer_write(writer, header, sizeof(header));
+
+    uint8_t word[4];
+    for (uint32_t i = 0; i < manifest->protocol_count; i++)
+    {
+        subghz_toolkit_manifest_put_u32(word, manifest->hashes[i]);
+        subghz_toolkit_writer_write(writer, word, sizeof(word));
+    }
+
+    for (size_t p = 0; p < manifest->pass_count; p++)
+    {
+        const SubGhzToolkitManifestPass *pass = &manifest->passes[p];
+        subghz_toolkit_manifest_put_u32(word, pass->file);
+        subghz_toolkit_writer_write(writer, word, sizeof(word));
+        subghz_toolkit_manifest_put_u32(word, pass->size);
+        subghz_toolkit_writer_write(writer, word, sizeof(word));
+        for (uint32_t i = 0; i <= manifest->protocol_count; i++)
+        {
+            subghz_toolkit_manifest_put_u32(word, pass->sections[i]);
+            subghz_toolkit_writer_write(writer, word, sizeof(word));
+        }
+    }
+}
+
+static int subghz_toolkit_manifest_compare(const void *a, const void *b)
+{
+    uint32_t x = ((const SubGhzToolkitManifestHashIndex *)a)->hash;
+    uint32_t y = ((const SubGhzToolkitManifestHashIndex *)b)->hash;
+    return x < y ? -1 : x > y;
+}
+
+SubGhzToolkitManifest *subghz_toolkit_manifest_load(const uint8_t *data, size_t size)
+{
+    if (size < SUBGHZ_TOOLKIT_MANIFEST_HEADER_SIZE || subghz_toolkit_manifest_u32(data) != SUBGHZ_TOOLKIT_MANIFEST_MAGIC ||
+        data[4] != SUBGHZ_TOOLKIT_MANIFEST_VERSION)
+        return NULL;
+
+    size_t pass_count = data[6] | (data[7] << 8);
+    uint32_t protocol_count = subghz_toolkit_manifest_u32(data + 8);
+    size_t pass_size = ((size_t)protocol_count + 3) * 4;
+    if (pass_count > SUBGHZ_TOOLKIT_MANIFEST_MAX_PASSES || protocol_count > size / 4 ||
+        size != SUBGHZ_TOOLKIT_MANIFEST_HEADER_SIZE + (size_t)protocol_count * 4 + pass_count * pass_size)
+        return NULL;
+
+    char githash[SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE + 1] = {0};
+    char build_date[SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE + 1] = {0};
+    memcpy(githash, data + 16, SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE);
+    memcpy(build_date, data + 16 + SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE, SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE);
+
+    SubGhzToolkitManifest *manifest =
+        subghz_toolkit_manifest_alloc(githash, build_date, subghz_toolkit_manifest_u32(data + 12), protocol_count);
+
+    const uint8_t *hashes = data + SUBGHZ_TOOLKIT_MANIFEST_HEADER_SIZE;
+    manifest->sorted = malloc((protocol_count ? protocol_count : 1) * sizeof(SubGhzToolkitManifestHashIndex));
+    for (uint32_t i = 0; i < protocol_count; i++)
+    {
+        manifest->hashes[i] = subghz_toolkit_manifest_u32(hashes + i * 4);
+        manifest->sorted[i] = (SubGhzToolkitManifestHashIndex){.hash = manifest->hashes[i], .index = i};
+    }
+    qsort(manifest->sorted, protocol_count, sizeof(SubGhzToolkitManifestHashIndex), subghz_toolkit_manifest_compare);
+
+    const uint8_t *record = hashes + (size_t)protocol_count * 4;
+    for (size_t p = 0; p < pass_count; p++, record += pass_size)
+    {
+        SubGhzToolkitManifestPass *pass = subghz_toolkit_manifest_add_pass_hash(manifest, subghz_toolkit_manifest_u32(record));
+        pass->size = subghz_toolkit_manifest_u32(record + 4);
+        for (uint32_t i = 0; i <= protocol_count; i++)
+            pass->sections[i] = subghz_toolkit_manifest_u32(record + 8 + i * 4);
+    }
+
+    return manifest;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_writer.h"
+
+// What the last analysis run wrote and for which firmware, so the next run
+// can skip work that would produce the same output.
+//
+//   header    "SGAM", u8 version, u8 reserved, u16 pass count, u32 protocol count,
+//             u32 config, char githash[16], char build date[16]
+//   hashes    protocol count x u32, content hash of each protocol in registry order
+//   passes    pass count x {u32 file name hash, u32 file size, u32 sections[protocol count + 1]}
+//
+// sections[i] is the file offset where protocol i's part of a pass output
+// starts; sections[protocol count] is where the part after the last protocol
+// starts. `config` covers anything besides the firmware that changes the
+// output, such as the toolkit version.
+
+#define SUBGHZ_TOOLKIT_MANIFEST_VERSION 1
+#define SUBGHZ_TOOLKIT_MANIFEST_TEXT_SIZE 16
+
+typedef struct
+{
+    uint32_t file; // subghz_toolkit_name_hash of the output path
+    uint32_t size; // of the output file when it was written
+    uint32_t *sections;
+} SubGhzToolkitManifestPass;
+
+typedef struct SubGhzToolkitManifest SubGhzToolkitManifest;
+
+SubGhzToolkitManifest *subghz_toolkit_manifest_alloc(
+    const char *githash, const char *build_date, uint32_t config, uint32_t protocol_count);
+
+void subghz_toolkit_manifest_free(SubGhzToolkitManifest *manifest);
+
+/** Same firmware build and configuration: every output recorded in `old` is still valid */
+bool subghz_toolkit_manifest_same_build(const SubGhzToolkitManifest *old, const SubGhzToolkitManifest *manifest);
+
+/** Outputs recorded in `old` can only be reused when the configuration matches */
+uint32_t subghz_toolkit_manifest_config(const SubGhzToolkitManifest *manifest);
+
+uint32_t subghz_toolkit_manifest_protocol_count(const SubGhzToolkitManifest *manifest);
+
+void subghz_toolkit_manifest_set_hash(SubGhzToolkitManifest *manifest, uint32_t index, uint32_t hash);
+
+uint32_t subghz_toolkit_manifest_hash(const SubGhzToolkitManifest *manifest, uint32_t index);
+
+/** Copy the protocol hashes of `from`, which must have the same protocol count */
+void subghz_toolkit_manifest_copy_hashes(SubGhzToolkitManifest *manifest, const SubGhzToolkitManifest *from);
+
+/** Index of the protocol whose content hash is `hash`. Binary search of a loaded manifest. */
+bool subghz_toolkit_manifest_find_hash(const SubGhzToolkitManifest *manifest, uint32_t hash, uint32_t *index);
+
+/** The pass entry for output `file`, NULL if there is none */
+const SubGhzToolkitManifestPass *subghz_toolkit_manifest_find_pass(const SubGhzToolkitManifest *manifest, const char *file);
+
+/** The pass entry for output `file`, added with zeroed sections if missing */
+SubGhzToolkitManifestPass *subghz_toolkit_manifest_add_pass(SubGhzToolkitManifest *manifest, const char *file);
+
+/** Copy every pass entry of `from` that `manifest` does not have yet. Both must be the same build. */
+void subghz_toolkit_manifest_merge_passes(SubGhzToolkitManifest *manifest, const SubGhzToolkitManifest *from);
+
+void subghz_toolkit_manifest_save(const SubGhzToolkitManifest *manifest, SubGhzToolkitWriter *writer);
+
+/** Parse a saved manifest, copying what it needs. NULL if `data` is not a valid one. */
+SubGhzToolkitManifest *subghz_toolkit_manifest_load(const uint8_t *data, size_t size);
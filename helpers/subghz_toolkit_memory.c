@@ -0,0 +1,65 @@
+#include "subghz_toolkit_memory.h"
+
+#include <string.h>
+
+void subghz_toolkit_memory_init(SubGhzToolkitMemory *memory)
+{
+    memset(memory, 0, sizeof(*memory));
+}
+
+bool subghz_toolkit_memory_add_region(SubGhzToolkitMemory *memory, uint32_t address, const uint8_t *data, uint32_t size)
+{
+    if (memory->region_count == SUBGHZ_TOOLKIT_MEMORY_MAX_REGIONS || !size)
+        return false;
+
+    memory->regions[memory->region_count++] = (SubGhzToolkitMemoryRegion){.address = address, .size = size, .data = data};
+    return true;
+}
+
+const uint8_t *subghz_toolkit_memory_at(const SubGhzToolkitMemory *memory, uint32_t address, size_t *size)
+{
+    for (size_t i = 0; i < memory->region_count; i++)
+    {
+        const SubGhzToolkitMemoryRegion *region = &memory->regions[i];
+        uint32_t offset = address - region->address; // wraps for addresses below the region
+        if (offset < region->size)
+        {
+            *size = region->size - offset;
+            return region->data + offset;
+        }
+    }
+    return NULL;
+}
+
+const uint8_t *subghz_toolkit_memory_code_at(void *context, uint32_t address, size_t *size)
+{
+    return subghz_toolkit_memory_at(context, address, size);
+}
+
+bool subghz_toolkit_memory_read_u32(const SubGhzToolkitMemory *memory, uint32_t address, uint32_t *value)
+{
+    size_t size = 0;
+    const uint8_t *data = subghz_toolkit_memory_at(memory, address, &size);
+    if (!data || size < 4)
+        return false;
+
+    *value = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+    return true;
+}
+
+const char *subghz_toolkit_memory_string(const SubGhzToolkitMemory *memory, uint32_t address, size_t max_length)
+{
+    size_t size = 0;
+    const char *str = (const char *)subghz_toolkit_memory_at(memory, address, &size);
+    if (!str)
+        return NULL;
+
+    for (size_t i = 0; i < size && i <= max_length; i++)
+    {
+        if (str[i] == '\0')
+            return i ? str : NULL;
+        if (str[i] < 0x20 || str[i] > 0x7E)
+            return NULL;
+    }
+    return NULL;
+}
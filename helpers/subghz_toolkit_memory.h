@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Target address space seen through a handful of regions.
+//
+// On the device the only region is the firmware image in flash, mapped one to
+// one and ending below CPU2's secure area. The host tools map a firmware
+// image: one region per ELF load segment, or the whole .bin at its load
+// address. Analysis code reads target memory only through here, so the same
+// code runs against the live firmware and against a file.
+
+#define SUBGHZ_TOOLKIT_MEMORY_MAX_REGIONS 8
+
+typedef struct
+{
+    uint32_t address;
+    uint32_t size;
+    const uint8_t *data;
+} SubGhzToolkitMemoryRegion;
+
+typedef struct
+{
+    SubGhzToolkitMemoryRegion regions[SUBGHZ_TOOLKIT_MEMORY_MAX_REGIONS];
+    size_t region_count;
+} SubGhzToolkitMemory;
+
+void subghz_toolkit_memory_init(SubGhzToolkitMemory *memory);
+
+/** Map `size` bytes at `data` to target `address`. False when the region table is full. */
+bool subghz_toolkit_memory_add_region(SubGhzToolkitMemory *memory, uint32_t address, const uint8_t *data, uint32_t size);
+
+/** Host pointer for target `address`, NULL if unmapped. `size` is set to the bytes readable from there. */
+const uint8_t *subghz_toolkit_memory_at(const SubGhzToolkitMemory *memory, uint32_t address, size_t *size);
+
+/** subghz_toolkit_memory_at as a SubGhzToolkitCodeAt, `context` is the memory */
+const uint8_t *subghz_toolkit_memory_code_at(void *context, uint32_t address, size_t *size);
+
+/** Little endian 32 bit word at `address` */
+bool subghz_toolkit_memory_read_u32(const SubGhzToolkitMemory *memory, uint32_t address, uint32_t *value);
+
+/** NUL terminated printable string of at most `max_length` characters at `address`, NULL otherwise */
+const char *subghz_toolkit_memory_string(const SubGhzToolkitMemory *memory, uint32_t address, size_t max_length);
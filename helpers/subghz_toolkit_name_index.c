@@ -0,0 +1,93 @@
+#include "subghz_toolkit_name_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+    const char *name;
+    uint32_t hash;
+    uint32_t value;
+} SubGhzToolkitNameIndexSlot;
+
+struct SubGhzToolkitNameIndex
+{
+    SubGhzToolkitNameIndexSlot *slots;
+    size_t mask;
+    size_t count;
+};
+
+uint32_t subghz_toolkit_name_hash(const char *name)
+{
+    uint32_t hash = 2166136261u;
+    while (*name)
+    {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+SubGhzToolkitNameIndex *subghz_toolkit_name_index_alloc(size_t capacity)
+{
+    SubGhzToolkitNameIndex *index = malloc(sizeof(SubGhzToolkitNameIndex));
+
+    // Keep the load factor at or below 50% so probe chains stay short
+    size_t size = 8;
+    while (size < capacity * 2)
+        size <<= 1;
+
+    index->slots = calloc(size, sizeof(SubGhzToolkitNameIndexSlot));
+    index->mask = size - 1;
+    index->count = 0;
+    return index;
+}
+
+void subghz_toolkit_name_index_free(SubGhzToolkitNameIndex *index)
+{
+    free(index->slots);
+    free(index);
+}
+
+bool subghz_toolkit_name_index_add(SubGhzToolkitNameIndex *index, const char *name, size_t value)
+{
+    if (index->count * 2 >= index->mask + 1)
+        return false;
+
+    uint32_t hash = subghz_toolkit_name_hash(name);
+    for (size_t pos = hash & index->mask;; pos = (pos + 1) & index->mask)
+    {
+        SubGhzToolkitNameIndexSlot *slot = &index->slots[pos];
+        if (!slot->name)
+        {
+            slot->name = name;
+            slot->hash = hash;
+            slot->value = value;
+            index->count++;
+            return true;
+        }
+        if (slot->hash == hash && strcmp(slot->name, name) == 0)
+            return false;
+    }
+}
+
+bool subghz_toolkit_name_index_find(const SubGhzToolkitNameIndex *index, const char *name, size_t *value)
+{
+    uint32_t hash = subghz_toolkit_name_hash(name);
+    for (size_t pos = hash & index->mask;; pos = (pos + 1) & index->mask)
+    {
+        const SubGhzToolkitNameIndexSlot *slot = &index->slots[pos];
+        if (!slot->name)
+            return false;
+        if (slot->hash == hash && strcmp(slot->name, name) == 0)
+        {
+            *value = slot->value;
+            return true;
+        }
+    }
+}
+
+size_t subghz_toolkit_name_index_count(const SubGhzToolkitNameIndex *index)
+{
+    return index->count;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Open-addressing hash table from a NUL-terminated name to an index.
+// Names are not copied: they must outlive the table (protocol names are
+// static strings in firmware flash).
+
+typedef struct SubGhzToolkitNameIndex SubGhzToolkitNameIndex;
+
+SubGhzToolkitNameIndex *subghz_toolkit_name_index_alloc(size_t capacity);
+
+void subghz_toolkit_name_index_free(SubGhzToolkitNameIndex *index);
+
+/** Returns false if the table is full or the name is already present */
+bool subghz_toolkit_name_index_add(SubGhzToolkitNameIndex *index, const char *name, size_t value);
+
+bool subghz_toolkit_name_index_find(const SubGhzToolkitNameIndex *index, const char *name, size_t *value);
+
+size_t subghz_toolkit_name_index_count(const SubGhzToolkitNameIndex *index);
+
+/** FNV-1a, shared with other name keyed tables */
+uint32_t subghz_toolkit_name_hash(const char *name);
@@ -0,0 +1,237 @@
+#include "subghz_toolkit_profile.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SUBGHZ_TOOLKIT_PROFILE_CALIBRATION_ROUNDS 64
+
+struct SubGhzToolkitProfile
+{
+    SubGhzToolkitProfileEntry *entries;
+    const char **names;
+    size_t entry_count;
+    uint32_t overhead;
+};
+
+// Four buckets per power of two: values below 4 are exact, then 4 steps per octave
+static size_t subghz_toolkit_profile_bucket(uint32_t value)
+{
+    if (value < 4)
+        return value;
+
+    uint32_t msb = 31 - (uint32_t)__builtin_clz(value);
+    size_t bucket = (msb - 1) * 4 + ((value >> (msb - 2)) & 3);
+    return bucket < SUBGHZ_TOOLKIT_PROFILE_BUCKETS ? bucket : SUBGHZ_TOOLKIT_PROFILE_BUCKETS - 1;
+}
+
+// Middle of a bucket
+static uint32_t subghz_toolkit_profile_bucket_value(size_t bucket)
+{
+    if (bucket < 4)
+        return (uint32_t)bucket;
+
+    uint32_t shift = (uint32_t)(bucket / 4) - 1;
+    uint32_t low = (uint32_t)(4 + bucket % 4) << shift;
+    return low + (shift ? 1u << (shift - 1) : 0);
+}
+
+static uint32_t subghz_toolkit_profile_calibrate(void)
+{
+    uint32_t best = UINT32_MAX;
+    for (size_t i = 0; i < SUBGHZ_TOOLKIT_PROFILE_CALIBRATION_ROUNDS; i++)
+    {
+        uint32_t start = subghz_toolkit_profile_now();
+        uint32_t elapsed = subghz_toolkit_profile_now() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+SubGhzToolkitProfile *subghz_toolkit_profile_alloc(size_t entry_count)
+{
+    SubGhzToolkitProfile *profile = malloc(sizeof(SubGhzToolkitProfile));
+
+    profile->entries = malloc(entry_count * sizeof(SubGhzToolkitProfileEntry));
+    profile->names = malloc(entry_count * sizeof(const char *));
+    profile->entry_count = entry_count;
+    memset(profile->names, 0, entry_count * sizeof(const char *));
+    subghz_toolkit_profile_reset(profile);
+    profile->overhead = subghz_toolkit_profile_calibrate();
+    return profile;
+}
+
+void subghz_toolkit_profile_free(SubGhzToolkitProfile *profile)
+{
+    free(profile->entries);
+    free(profile->names);
+    free(profile);
+}
+
+void subghz_toolkit_profile_reset(SubGhzToolkitProfile *profile)
+{
+    memset(profile->entries, 0, profile->entry_count * sizeof(SubGhzToolkitProfileEntry));
+}
+
+void subghz_toolkit_profile_set_name(SubGhzToolkitProfile *profile, size_t entry, const char *name)
+{
+    profile->names[entry] = name;
+}
+
+uint32_t subghz_toolkit_profile_overhead(const SubGhzToolkitProfile *profile)
+{
+    return profile->overhead;
+}
+
+void subghz_toolkit_profile_record(SubGhzToolkitProfile *profile, size_t entry, uint32_t elapsed)
+{
+    SubGhzToolkitProfileEntry *sample = &profile->entries[entry];
+
+    elapsed = elapsed > profile->overhead ? elapsed - profile->overhead : 0;
+    sample->calls++;
+    sample->total += elapsed;
+    if (elapsed > sample->max)
+        sample->max = elapsed;
+    sample->histogram[subghz_toolkit_profile_bucket(elapsed)]++;
+}
+
+const SubGhzToolkitProfileEntry *subghz_toolkit_profile_get_entry(const SubGhzToolkitProfile *profile, size_t entry)
+{
+    return &profile->entries[entry];
+}
+
+uint32_t subghz_toolkit_profile_percentile(const SubGhzToolkitProfileEntry *entry, uint32_t percent)
+{
+    if (!entry->calls)
+        return 0;
+
+    // Rank of the sample, rounded up: p99 of 100 calls is the 99th
+    uint64_t rank = ((uint64_t)entry->calls * percent + 99) / 100;
+    uint64_t seen = 0;
+    if (!rank)
+        rank = 1;
+
+    for (size_t bucket = 0; bucket < SUBGHZ_TOOLKIT_PROFILE_BUCKETS; bucket++)
+    {
+        seen += entry->histogram[bucket];
+        if (seen >= rank)
+        {
+            uint32_t value = subghz_toolkit_profile_bucket_value(bucket);
+            return value < entry->max ? value : entry->max;
+        }
+    }
+    return entry->max;
+}
+
+typedef struct
+{
+    const SubGhzToolkitProfile *profile;
+    SubGhzToolkitProfileSort sort;
+} SubGhzToolkitProfileOrder;
+
+// qsort has no context argument and the report runs on one thread
+static SubGhzToolkitProfileOrder subghz_toolkit_profile_order;
+
+static uint64_t subghz_toolkit_profile_sort_key(size_t index)
+{
+    const SubGhzToolkitProfileEntry *entry = &subghz_toolkit_profile_order.profile->entries[index];
+
+    switch (subghz_toolkit_profile_order.sort)
+    {
+    case SubGhzToolkitProfileSortP50:
+        return subghz_toolkit_profile_percentile(entry, 50);
+    case SubGhzToolkitProfileSortP99:
+        return subghz_toolkit_profile_percentile(entry, 99);
+    case SubGhzToolkitProfileSortMax:
+        return entry->max;
+    default:
+        return entry->total;
+    }
+}
+
+static int subghz_toolkit_profile_compare(const void *a, const void *b)
+{
+    size_t left = *(const uint16_t *)a;
+    size_t right = *(const uint16_t *)b;
+
+    if (subghz_toolkit_profile_order.sort == SubGhzToolkitProfileSortName)
+    {
+        const char *left_name = subghz_toolkit_profile_order.profile->names[left];
+        const char *right_name = subghz_toolkit_profile_order.profile->names[right];
+        return strcmp(left_name ? left_name : "", right_name ? right_name : "");
+    }
+
+    // Most expensive first, ties in decoder order
+    uint64_t left_key = subghz_toolkit_profile_sort_key(left);
+    uint64_t right_key = subghz_toolkit_profile_sort_key(right);
+    if (left_key != right_key)
+        return left_key > right_key ? -1 : 1;
+    return left < right ? -1 : left > right;
+}
+
+void subghz_toolkit_profile_write_report(
+    SubGhzToolkitWriter *writer, const SubGhzToolkitProfile *profile, SubGhzToolkitProfileSort sort, uint64_t pulses)
+{
+    uint16_t *order = malloc(profile->entry_count * sizeof(uint16_t));
+    size_t count = 0;
+    uint64_t total = 0;
+
+    for (size_t i = 0; i < profile->entry_count; i++)
+    {
+        if (!profile->entries[i].calls)
+            continue;
+        order[count++] = (uint16_t)i;
+        total += profile->entries[i].total;
+    }
+
+    subghz_toolkit_profile_order = (SubGhzToolkitProfileOrder){.profile = profile, .sort = sort};
+    qsort(order, count, sizeof(uint16_t), subghz_toolkit_profile_compare);
+
+    subghz_toolkit_writer_printf(writer,
+                                 "feed() cost per pulse in " SUBGHZ_TOOLKIT_PROFILE_UNIT ", clock overhead of %lu taken off\n\n"
+                                 "%-24s %10s %8s %8s %8s %8s %7s\n",
+                                 (unsigned long)profile->overhead,
+                                 "Protocol", "Calls", "p50", "p99", "Max", "Mean", "Share");
+    for (size_t i = 0; i < count; i++)
+    {
+        const SubGhzToolkitProfileEntry *entry = &profile->entries[order[i]];
+        const char *name = profile->names[order[i]];
+        uint32_t share = total ? (uint32_t)(entry->total * 1000 / total) : 0; // tenths of a percent
+
+        subghz_toolkit_writer_printf(writer,
+                                     "%-24s %10lu %8lu %8lu %8lu %8lu %5lu.%lu%%\n",
+                                     name ? name : "?",
+                                     (unsigned long)entry->calls,
+                                     (unsigned long)subghz_toolkit_profile_percentile(entry, 50),
+                                     (unsigned long)subghz_toolkit_profile_percentile(entry, 99),
+                                     (unsigned long)entry->max,
+                                     (unsigned long)(entry->total / entry->calls),
+                                     (unsigned long)(share / 10),
+                                     (unsigned long)(share % 10));
+    }
+    if (!count)
+        subghz_toolkit_writer_cstr(writer, "  no calls recorded\n");
+    else if (pulses)
+        subghz_toolkit_writer_printf(writer,
+                                     "\nAll decoders: %llu " SUBGHZ_TOOLKIT_PROFILE_UNIT " over %llu pulses, %llu per pulse\n",
+                                     (unsigned long long)total,
+                                     (unsigned long long)pulses,
+                                     (unsigned long long)(total / pulses));
+
+    free(order);
+}
+
+bool subghz_toolkit_profile_parse_sort(const char *name, SubGhzToolkitProfileSort *sort)
+{
+    static const char *const names[] = {"share", "p50", "p99", "max", "name"};
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        if (strcmp(name, names[i]) == 0)
+        {
+            *sort = (SubGhzToolkitProfileSort)i;
+            return true;
+        }
+    }
+    return false;
+}
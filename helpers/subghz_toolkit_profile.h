@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_writer.h"
+
+// Per-decoder cost of feed() during a replay.
+//
+// Each call is timed with subghz_toolkit_profile_now(): the DWT cycle counter
+// on the Flipper (64 MHz core clock, always running under Furi) and
+// CLOCK_MONOTONIC nanoseconds on the host. The cost of reading the clock is
+// measured once and taken off every sample. Samples go into a log-linear
+// histogram per decoder, four buckets per power of two, so p50/p99 are within
+// 12.5% in a fixed 320 bytes per decoder however long the replay.
+
+#define SUBGHZ_TOOLKIT_PROFILE_BUCKETS 80 // up to 2^21 clock units, longer calls land in the last bucket
+
+#if defined(__arm__)
+#define SUBGHZ_TOOLKIT_PROFILE_UNIT "cycles"
+
+/** Clock in SUBGHZ_TOOLKIT_PROFILE_UNIT, wraps */
+static inline uint32_t subghz_toolkit_profile_now(void)
+{
+    return *(volatile const uint32_t *)0xE0001004u; // DWT->CYCCNT
+}
+#else
+#include <time.h>
+
+#define SUBGHZ_TOOLKIT_PROFILE_UNIT "ns"
+
+/** Clock in SUBGHZ_TOOLKIT_PROFILE_UNIT, wraps */
+static inline uint32_t subghz_toolkit_profile_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#endif
+
+typedef enum
+{
+    SubGhzToolkitProfileSortShare, // total time, most expensive first
+    SubGhzToolkitProfileSortP50,
+    SubGhzToolkitProfileSortP99,
+    SubGhzToolkitProfileSortMax,
+    SubGhzToolkitProfileSortName,
+} SubGhzToolkitProfileSort;
+
+typedef struct
+{
+    uint32_t calls;
+    uint32_t max;
+    uint64_t total;
+    uint32_t histogram[SUBGHZ_TOOLKIT_PROFILE_BUCKETS];
+} SubGhzToolkitProfileEntry;
+
+typedef struct SubGhzToolkitProfile SubGhzToolkitProfile;
+
+/** One entry per decoder, names are used by the report */
+SubGhzToolkitProfile *subghz_toolkit_profile_alloc(size_t entry_count);
+
+void subghz_toolkit_profile_free(SubGhzToolkitProfile *profile);
+
+/** Forget all samples */
+void subghz_toolkit_profile_reset(SubGhzToolkitProfile *profile);
+
+void subghz_toolkit_profile_set_name(SubGhzToolkitProfile *profile, size_t entry, const char *name);
+
+/** Clock reads between two subghz_toolkit_profile_now() calls, already taken off by record() */
+uint32_t subghz_toolkit_profile_overhead(const SubGhzToolkitProfile *profile);
+
+/** One feed() of `entry` that took `elapsed` (end - start of subghz_toolkit_profile_now()) */
+void subghz_toolkit_profile_record(SubGhzToolkitProfile *profile, size_t entry, uint32_t elapsed);
+
+const SubGhzToolkitProfileEntry *subghz_toolkit_profile_get_entry(const SubGhzToolkitProfile *profile, size_t entry);
+
+/** Value below which `percent` of the entry's calls fall, from the histogram */
+uint32_t subghz_toolkit_profile_percentile(const SubGhzToolkitProfileEntry *entry, uint32_t percent);
+
+/** Table of every decoder with calls: calls, p50, p99, max, mean and share of the total, ordered by `sort`.
+ *  The total is divided by `pulses`, the pulses replayed, which routed decoders are not all fed; 0 leaves it out. */
+void subghz_toolkit_profile_write_report(
+    SubGhzToolkitWriter *writer, const SubGhzToolkitProfile *profile, SubGhzToolkitProfileSort sort, uint64_t pulses);
+
+/** "share", "p50", "p99", "max" or "name", false for anything else */
+bool subghz_toolkit_profile_parse_sort(const char *name, SubGhzToolkitProfileSort *sort);
@@ -0,0 +1,286 @@
+#include "subghz_toolkit_protocol.h"
+
+#include <string.h>
+
+const char *const subghz_toolkit_function_slot_names[SubGhzToolkitFunctionSlotCount] = {
+    "decoder->alloc",
+    "decoder->free",
+    "decoder->reset",
+    "decoder->feed",
+    "decoder->get_string",
+    "decoder->serialize",
+    "decoder->deserialize",
+    "decoder->get_hash_data",
+    "encoder->alloc",
+    "encoder->free",
+    "encoder->deserialize",
+    "encoder->stop",
+    "encoder->yield",
+};
+
+// SubGhzProtocol: name, type, flag, encoder, decoder
+#define SUBGHZ_TOOLKIT_PROTOCOL_OFFSET_NAME 0
+#define SUBGHZ_TOOLKIT_PROTOCOL_OFFSET_TYPE 4
+#define SUBGHZ_TOOLKIT_PROTOCOL_OFFSET_FLAG 8
+#define SUBGHZ_TOOLKIT_PROTOCOL_OFFSET_ENCODER 12
+#define SUBGHZ_TOOLKIT_PROTOCOL_OFFSET_DECODER 16
+
+// Offset of each slot's pointer in SubGhzProtocolDecoder
+// (alloc, free, feed, reset, get_hash_data, serialize, deserialize, get_string)
+// or SubGhzProtocolEncoder (alloc, free, deserialize, stop, yield)
+static const uint8_t subghz_toolkit_protocol_slot_offsets[SubGhzToolkitFunctionSlotCount] = {
+    [SubGhzToolkitFunctionSlotDecoderAlloc] = 0,
+    [SubGhzToolkitFunctionSlotDecoderFree] = 4,
+    [SubGhzToolkitFunctionSlotDecoderReset] = 12,
+    [SubGhzToolkitFunctionSlotDecoderFeed] = 8,
+    [SubGhzToolkitFunctionSlotDecoderGetString] = 28,
+    [SubGhzToolkitFunctionSlotDecoderSerialize] = 20,
+    [SubGhzToolkitFunctionSlotDecoderDeserialize] = 24,
+    [SubGhzToolkitFunctionSlotDecoderGetHashData] = 16,
+    [SubGhzToolkitFunctionSlotEncoderAlloc] = 0,
+    [SubGhzToolkitFunctionSlotEncoderFree] = 4,
+    [SubGhzToolkitFunctionSlotEncoderDeserialize] = 8,
+    [SubGhzToolkitFunctionSlotEncoderStop] = 12,
+    [SubGhzToolkitFunctionSlotEncoderYield] = 16,
+};
+
+// Functions most likely to reference the protocol's SubGhzBlockConst, in scan order
+static const SubGhzToolkitFunctionSlot subghz_toolkit_protocol_timing_slots[] = {
+    SubGhzToolkitFunctionSlotDecoderFeed,
+    SubGhzToolkitFunctionSlotDecoderAlloc,
+    SubGhzToolkitFunctionSlotDecoderGetString,
+    SubGhzToolkitFunctionSlotEncoderDeserialize,
+};
+
+// Function pointers are Thumb: odd and readable one byte lower
+static bool subghz_toolkit_protocol_is_code(const SubGhzToolkitMemory *memory, uint32_t pointer)
+{
+    size_t size = 0;
+    return !pointer || ((pointer & 1) && subghz_toolkit_memory_at(memory, pointer & ~1u, &size));
+}
+
+bool subghz_toolkit_protocol_read(const SubGhzToolkitMemory *memory, uint32_t address, SubGhzToolkitProtocolInfo *info)
+{
+    memset(info, 0, sizeof(*info));
+    info->address = address;
+
+    uint32_t name = 0;
+    if (!subghz_toolkit_memory_read_u32(memory, address + SUBGHZ_TOOLKIT_PROTOCOL_OFFSET_NAME, &name) ||
+        !subghz_toolkit_memory_read_u32(memory, address + SUBGHZ_TOOLKIT_PROTOCOL_OFFSET_TYPE, &info->type) ||
+        !subghz_toolkit_memory_read_u32(memory, address + SUBGHZ_TOOLKIT_PROTOCOL_OFFSET_FLAG, &info->flag) ||
+        !subghz_toolkit_memory_read_u32(memory, address + SUBGHZ_TOOLKIT_PROTOCOL_OFFSET_ENCODER, &info->encoder) ||
+        !subghz_toolkit_memory_read_u32(memory, address + SUBGHZ_TOOLKIT_PROTOCOL_OFFSET_DECODER, &info->decoder))
+        return false;
+
+    info->name = subghz_toolkit_memory_string(memory, name, SUBGHZ_TOOLKIT_PROTOCOL_NAME_MAX);
+    if (!info->name || info->type > 0xFF || info->flag > 0xFFFF || (!info->decoder && !info->encoder))
+        return false;
+
+    for (size_t slot = 0; slot < SubGhzToolkitFunctionSlotCount; slot++)
+    {
+        uint32_t base = slot < SubGhzToolkitFunctionSlotEncoderAlloc ? info->decoder : info->encoder;
+        if (!base)
+            continue;
+        if (!subghz_toolkit_memory_read_u32(memory, base + subghz_toolkit_protocol_slot_offsets[slot], &info->functions[slot]) ||
+            !subghz_toolkit_protocol_is_code(memory, info->functions[slot]))
+            return false;
+    }
+
+    return true;
+}
+
+bool subghz_toolkit_protocol_registry_read(
+    const SubGhzToolkitMemory *memory, uint32_t registry, uint32_t *items, uint32_t *count)
+{
+    if (!subghz_toolkit_memory_read_u32(memory, registry, items) ||
+        !subghz_toolkit_memory_read_u32(memory, registry + 4, count))
+        return false;
+    if (!*count || *count > SUBGHZ_TOOLKIT_PROTOCOL_REGISTRY_MAX || (*items & 3))
+        return false;
+
+    for (uint32_t i = 0; i < *count; i++)
+    {
+        uint32_t protocol = 0;
+        SubGhzToolkitProtocolInfo info;
+        if (!subghz_toolkit_memory_read_u32(memory, *items + i * 4, &protocol) ||
+            !subghz_toolkit_protocol_read(memory, protocol, &info))
+            return false;
+    }
+
+    return true;
+}
+
+uint32_t subghz_toolkit_protocol_registry_locate(const SubGhzToolkitMemory *memory)
+{
+    uint32_t best = 0;
+    uint32_t best_count = 0;
+
+    for (size_t r = 0; r < memory->region_count; r++)
+    {
+        const SubGhzToolkitMemoryRegion *region = &memory->regions[r];
+        for (uint32_t offset = (4 - (region->address & 3)) & 3; offset + 8 <= region->size; offset += 4)
+        {
+            // Cheap rejects first: the size word must be small and the items word a mapped pointer
+            const uint8_t *word = region->data + offset;
+            uint32_t count = word[4] | (word[5] << 8) | (word[6] << 16) | ((uint32_t)word[7] << 24);
+            if (count <= best_count || count > SUBGHZ_TOOLKIT_PROTOCOL_REGISTRY_MAX)
+                continue;
+
+            uint32_t items = 0;
+            uint32_t address = region->address + offset;
+            if (subghz_toolkit_protocol_registry_read(memory, address, &items, &count))
+            {
+                best = address;
+                best_count = count;
+            }
+        }
+    }
+
+    return best;
+}
+
+const SubGhzToolkitFunction *subghz_toolkit_protocol_function(
+    SubGhzToolkitFunctionCache *cache,
+    SubGhzToolkitCodeAt code_at,
+    void *context,
+    uint32_t pointer,
+    uint16_t owner,
+    SubGhzToolkitFunctionSlot slot,
+    bool *inserted)
+{
+    // Firmware is Thumb-2 only: the pointer carries the Thumb bit, the code starts one byte lower
+    uint32_t address = subghz_toolkit_thumb_code_address(pointer);
+    size_t size = 0;
+    const uint8_t *code = code_at(context, address, &size);
+    if (!code)
+        return NULL;
+
+    return subghz_toolkit_function_cache_get(cache, code, size, address, owner, (uint8_t)slot, inserted);
+}
+
+size_t subghz_toolkit_protocol_scan_timing(
+    const uint32_t functions[SubGhzToolkitFunctionSlotCount],
+    SubGhzToolkitFunctionCache *cache,
+    SubGhzToolkitCodeAt code_at,
+    void *context,
+    uint16_t owner,
+    SubGhzToolkitTimingScan *scan)
+{
+    subghz_toolkit_timing_scan_init(scan);
+
+    size_t scanned = 0;
+    for (size_t i = 0; i < sizeof(subghz_toolkit_protocol_timing_slots) / sizeof(subghz_toolkit_protocol_timing_slots[0]) && !scan->found; i++)
+    {
+        SubGhzToolkitFunctionSlot slot = subghz_toolkit_protocol_timing_slots[i];
+        if (!functions[slot])
+            continue;
+
+        const SubGhzToolkitFunction *cached =
+            subghz_toolkit_protocol_function(cache, code_at, context, functions[slot], owner, slot, NULL);
+        if (!cached)
+            continue;
+
+        // Copied: the cache entry is only valid until the next insert
+        SubGhzToolkitFunction function = *cached;
+        size_t size = 0;
+        subghz_toolkit_timing_scan_function(scan, code_at(context, function.address, &size), &function, code_at, context);
+        scanned++;
+    }
+
+    return scanned;
+}
+
+void subghz_toolkit_protocol_write_timing(
+    SubGhzToolkitWriter *writer, const char *name, uint32_t type, const SubGhzToolkitTimingScan *scan)
+{
+    subghz_toolkit_writer_cstr(writer, "\n  Timing Pattern Analysis:\n");
+    subghz_toolkit_writer_printf(writer, "    Protocol: %s\n", name);
+
+    if (scan->found)
+    {
+        const SubGhzToolkitTimingConst *timing = &scan->block;
+        subghz_toolkit_writer_printf(writer,
+                                     "    SubGhzBlockConst at 0x%08lX (via 0x%08lX):\n"
+                                     "      te_short:      %u us\n"
+                                     "      te_long:       %u us (%u.%02ux te_short)\n"
+                                     "      te_delta:      %u us\n"
+                                     "      min_count_bit: %u\n",
+                                     (unsigned long)scan->block_address,
+                                     (unsigned long)scan->referenced_by,
+                                     timing->te_short,
+                                     timing->te_long,
+                                     timing->te_long / timing->te_short,
+                                     (timing->te_long % timing->te_short) * 100 / timing->te_short,
+                                     timing->te_delta,
+                                     timing->min_count_bit);
+    }
+    else if (scan->duration_count)
+    {
+        // No block reference: the decoder compares against folded constants
+        subghz_toolkit_writer_cstr(writer, "    No SubGhzBlockConst found, duration immediates (us):\n     ");
+        for (size_t i = 0; i < scan->duration_count; i++)
+            subghz_toolkit_writer_printf(writer, " %u", scan->durations[i]);
+        subghz_toolkit_writer_cstr(writer, "\n");
+    }
+    else
+    {
+        subghz_toolkit_writer_cstr(writer, "    No timing constants found\n");
+    }
+
+    switch (type)
+    {
+        case SUBGHZ_TOOLKIT_PROTOCOL_TYPE_STATIC:
+            subghz_toolkit_writer_cstr(writer, "    Type: Static (fixed timing)\n");
+            break;
+        case SUBGHZ_TOOLKIT_PROTOCOL_TYPE_DYNAMIC:
+            subghz_toolkit_writer_cstr(writer, "    Type: Dynamic (variable timing)\n");
+            break;
+        default:
+            subghz_toolkit_writer_cstr(writer, "    Type: RAW (custom timing)\n");
+            break;
+    }
+}
+
+void subghz_toolkit_protocol_write_c_header(SubGhzToolkitWriter *writer, const char *name, uint32_t type, uint32_t flag)
+{
+    subghz_toolkit_writer_printf(writer, "\n// Generated C Header for Protocol: %s\n", name);
+    subghz_toolkit_writer_printf(writer, "#ifndef %s_PROTOCOL_H\n", name);
+    subghz_toolkit_writer_printf(writer, "#define %s_PROTOCOL_H\n\n", name);
+
+    subghz_toolkit_writer_cstr(writer, "#include <stdint.h>\n");
+    subghz_toolkit_writer_cstr(writer, "#include <stddef.h>\n\n");
+
+    subghz_toolkit_writer_cstr(writer, "// Protocol Information\n");
+    subghz_toolkit_writer_printf(writer, "#define %s_PROTOCOL_NAME \"%s\"\n", name, name);
+    subghz_toolkit_writer_printf(writer, "#define %s_PROTOCOL_TYPE 0x%02lX\n", name, (unsigned long)type);
+    subghz_toolkit_writer_printf(writer, "#define %s_PROTOCOL_FLAG 0x%08lX\n\n", name, (unsigned long)flag);
+
+    subghz_toolkit_writer_cstr(writer, "// Function Pointer Types\n");
+    subghz_toolkit_writer_printf(writer, "typedef void* (*%s_alloc_func)(void* env);\n", name);
+    subghz_toolkit_writer_printf(writer, "typedef void (*%s_free_func)(void* decoder);\n", name);
+    subghz_toolkit_writer_printf(writer, "typedef void (*%s_reset_func)(void* decoder);\n", name);
+    subghz_toolkit_writer_printf(writer, "typedef void (*%s_feed_func)(void* decoder, bool level, uint32_t duration);\n", name);
+    subghz_toolkit_writer_printf(writer, "typedef void (*%s_get_string_func)(void* decoder, FuriString* output);\n", name);
+
+    subghz_toolkit_writer_cstr(writer, "\n// Protocol Structure\n");
+    subghz_toolkit_writer_cstr(writer, "typedef struct {\n");
+    subghz_toolkit_writer_cstr(writer, "    const char* name;\n");
+    subghz_toolkit_writer_cstr(writer, "    uint8_t type;\n");
+    subghz_toolkit_writer_cstr(writer, "    uint32_t flag;\n");
+    subghz_toolkit_writer_cstr(writer, "    struct {\n");
+    subghz_toolkit_writer_printf(writer, "        %s_alloc_func alloc;\n", name);
+    subghz_toolkit_writer_printf(writer, "        %s_free_func free;\n", name);
+    subghz_toolkit_writer_printf(writer, "        %s_reset_func reset;\n", name);
+    subghz_toolkit_writer_printf(writer, "        %s_feed_func feed;\n", name);
+    subghz_toolkit_writer_printf(writer, "        %s_get_string_func get_string;\n", name);
+    subghz_toolkit_writer_cstr(writer, "    } decoder;\n");
+    subghz_toolkit_writer_printf(writer, "} %s_Protocol;\n\n", name);
+
+    subghz_toolkit_writer_cstr(writer, "// Implementation Notes\n");
+    subghz_toolkit_writer_cstr(writer, "// - Function pointers can be extracted from firmware\n");
+    subghz_toolkit_writer_cstr(writer, "// - Timing patterns need to be analyzed from signals\n");
+    subghz_toolkit_writer_cstr(writer, "// - Protocol state machine needs reverse engineering\n");
+    subghz_toolkit_writer_cstr(writer, "// - Use signal capture to understand data encoding\n\n");
+
+    subghz_toolkit_writer_printf(writer, "#endif // %s_PROTOCOL_H\n", name);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_function.h"
+#include "subghz_toolkit_memory.h"
+#include "subghz_toolkit_timing.h"
+#include "subghz_toolkit_writer.h"
+
+// Firmware protocol registry as plain target memory.
+//
+// Mirrors the 32 bit layout of lib/subghz/types.h and registry.h so a
+// registry can be walked in a firmware image the same way the app walks the
+// live one, and holds the per-protocol analyses both of them run.
+
+typedef enum
+{
+    SubGhzToolkitFunctionSlotDecoderAlloc,
+    SubGhzToolkitFunctionSlotDecoderFree,
+    SubGhzToolkitFunctionSlotDecoderReset,
+    SubGhzToolkitFunctionSlotDecoderFeed,
+    SubGhzToolkitFunctionSlotDecoderGetString,
+    SubGhzToolkitFunctionSlotDecoderSerialize,
+    SubGhzToolkitFunctionSlotDecoderDeserialize,
+    SubGhzToolkitFunctionSlotDecoderGetHashData,
+    SubGhzToolkitFunctionSlotEncoderAlloc,
+    SubGhzToolkitFunctionSlotEncoderFree,
+    SubGhzToolkitFunctionSlotEncoderDeserialize,
+    SubGhzToolkitFunctionSlotEncoderStop,
+    SubGhzToolkitFunctionSlotEncoderYield,
+    SubGhzToolkitFunctionSlotCount,
+} SubGhzToolkitFunctionSlot;
+
+extern const char *const subghz_toolkit_function_slot_names[SubGhzToolkitFunctionSlotCount];
+
+// SubGhzProtocolType values
+#define SUBGHZ_TOOLKIT_PROTOCOL_TYPE_STATIC 1
+#define SUBGHZ_TOOLKIT_PROTOCOL_TYPE_DYNAMIC 2
+
+#define SUBGHZ_TOOLKIT_PROTOCOL_NAME_MAX 64
+#define SUBGHZ_TOOLKIT_PROTOCOL_REGISTRY_MAX 512 // sanity bound on the registry size
+
+typedef struct
+{
+    uint32_t address; // of the SubGhzProtocol
+    const char *name; // points into target memory
+    uint32_t type;
+    uint32_t flag;
+    uint32_t decoder; // SubGhzProtocolDecoder address, 0 if none
+    uint32_t encoder;
+    uint32_t functions[SubGhzToolkitFunctionSlotCount]; // pointer values as stored, Thumb bit set, 0 if none
+} SubGhzToolkitProtocolInfo;
+
+/** Read and sanity check the SubGhzProtocol at `address` */
+bool subghz_toolkit_protocol_read(const SubGhzToolkitMemory *memory, uint32_t address, SubGhzToolkitProtocolInfo *info);
+
+/** Read a SubGhzProtocolRegistry: its items array and size. Every item must be a readable protocol. */
+bool subghz_toolkit_protocol_registry_read(
+    const SubGhzToolkitMemory *memory, uint32_t registry, uint32_t *items, uint32_t *count);
+
+/** Find the registry without symbols: the largest {items, size} pair whose items all read as protocols. 0 if none. */
+uint32_t subghz_toolkit_protocol_registry_locate(const SubGhzToolkitMemory *memory);
+
+/** Bounds of the function behind `pointer`, through `cache`. `owner` and `slot` are recorded if it is new. NULL if unreadable. */
+const SubGhzToolkitFunction *subghz_toolkit_protocol_function(
+    SubGhzToolkitFunctionCache *cache,
+    SubGhzToolkitCodeAt code_at,
+    void *context,
+    uint32_t pointer,
+    uint16_t owner,
+    SubGhzToolkitFunctionSlot slot,
+    bool *inserted);
+
+/** Scan the entry points most likely to reference the protocol's SubGhzBlockConst. Returns the functions scanned. */
+size_t subghz_toolkit_protocol_scan_timing(
+    const uint32_t functions[SubGhzToolkitFunctionSlotCount],
+    SubGhzToolkitFunctionCache *cache,
+    SubGhzToolkitCodeAt code_at,
+    void *context,
+    uint16_t owner,
+    SubGhzToolkitTimingScan *scan);
+
+void subghz_toolkit_protocol_write_timing(
+    SubGhzToolkitWriter *writer, const char *name, uint32_t type, const SubGhzToolkitTimingScan *scan);
+
+void subghz_toolkit_protocol_write_c_header(SubGhzToolkitWriter *writer, const char *name, uint32_t type, uint32_t flag);
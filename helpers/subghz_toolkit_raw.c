@@ -0,0 +1,171 @@
+#include "subghz_toolkit_raw.h"
+
+#include <string.h>
+
+#define SUBGHZ_TOOLKIT_RAW_FREQUENCY_KEY "Frequency:"
+#define SUBGHZ_TOOLKIT_RAW_DURATION_MAX 0x7FFFFFFFu
+
+void subghz_toolkit_raw_parser_init(SubGhzToolkitRawParser *parser)
+{
+    memset(parser, 0, sizeof(*parser));
+    parser->line_start = true;
+}
+
+static size_t subghz_toolkit_raw_parser_end_value(
+    SubGhzToolkitRawParser *parser,
+    SubGhzToolkitRawPulseCallback callback,
+    void *context)
+{
+    size_t pulses = 0;
+    if (parser->digits && parser->value)
+    {
+        callback(context, !parser->negative, parser->value);
+        pulses = 1;
+    }
+    parser->value = 0;
+    parser->negative = false;
+    parser->digits = false;
+    return pulses;
+}
+
+size_t subghz_toolkit_raw_parser_feed(
+    SubGhzToolkitRawParser *parser,
+    const char *data,
+    size_t size,
+    SubGhzToolkitRawPulseCallback callback,
+    void *context)
+{
+    static const char prefix[] = SUBGHZ_TOOLKIT_RAW_PREFIX;
+    static const char frequency_key[] = SUBGHZ_TOOLKIT_RAW_FREQUENCY_KEY;
+    size_t pulses = 0;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        char c = data[i];
+
+        if (c == '\n' || c == '\r')
+        {
+            if (parser->in_data)
+                pulses += subghz_toolkit_raw_parser_end_value(parser, callback, context);
+            if (parser->in_frequency && parser->digits && !parser->frequency)
+                parser->frequency = parser->value;
+            parser->value = 0;
+            parser->digits = false;
+            parser->negative = false;
+            parser->in_data = false;
+            parser->in_frequency = false;
+            parser->match = 0;
+            parser->frequency_match = 0;
+            parser->line_start = true;
+            continue;
+        }
+
+        if (parser->in_data)
+        {
+            if (c >= '0' && c <= '9')
+            {
+                uint32_t digit = (uint32_t)(c - '0');
+                parser->value = parser->value > (SUBGHZ_TOOLKIT_RAW_DURATION_MAX - digit) / 10 ? SUBGHZ_TOOLKIT_RAW_DURATION_MAX
+                                                                                               : parser->value * 10 + digit;
+                parser->digits = true;
+            }
+            else if (c == '-' && !parser->digits)
+            {
+                parser->negative = true;
+            }
+            else
+            {
+                pulses += subghz_toolkit_raw_parser_end_value(parser, callback, context);
+            }
+            continue;
+        }
+
+        if (parser->in_frequency)
+        {
+            if (c >= '0' && c <= '9')
+            {
+                parser->value = parser->value * 10 + (uint32_t)(c - '0');
+                parser->digits = true;
+            }
+            continue;
+        }
+
+        if (!parser->line_start)
+            continue;
+
+        // Still matching the start of the line against the two keys we know
+        bool matched = false;
+        if (parser->match != 0xFF)
+        {
+            if (c == prefix[parser->match])
+            {
+                matched = true;
+                if (++parser->match == sizeof(prefix) - 1)
+                    parser->in_data = true;
+            }
+            else
+            {
+                parser->match = 0xFF;
+            }
+        }
+        if (parser->frequency_match != 0xFF)
+        {
+            if (c == frequency_key[parser->frequency_match])
+            {
+                matched = true;
+                if (++parser->frequency_match == sizeof(frequency_key) - 1)
+                    parser->in_frequency = true;
+            }
+            else
+            {
+                parser->frequency_match = 0xFF;
+            }
+        }
+        if (!matched)
+            parser->line_start = false;
+    }
+
+    return pulses;
+}
+
+size_t subghz_toolkit_raw_parser_finish(
+    SubGhzToolkitRawParser *parser,
+    SubGhzToolkitRawPulseCallback callback,
+    void *context)
+{
+    return subghz_toolkit_raw_parser_feed(parser, "\n", 1, callback, context);
+}
+
+void subghz_toolkit_raw_write_header(SubGhzToolkitWriter *writer, uint32_t frequency, const char *preset)
+{
+    subghz_toolkit_writer_printf(writer,
+                                 "Filetype: Flipper SubGhz RAW File\n"
+                                 "Version: 1\n"
+                                 "Frequency: %lu\n"
+                                 "Preset: %s\n"
+                                 "Protocol: RAW\n",
+                                 (unsigned long)frequency,
+                                 preset);
+}
+
+size_t subghz_toolkit_raw_format_value(char *out, bool level, uint32_t duration)
+{
+    char digits[10];
+    size_t count = 0;
+
+    if (duration > SUBGHZ_TOOLKIT_RAW_DURATION_MAX)
+        duration = SUBGHZ_TOOLKIT_RAW_DURATION_MAX;
+    do
+    {
+        digits[count++] = (char)('0' + duration % 10);
+        duration /= 10;
+    } while (duration);
+
+    size_t length = 0;
+    out[length++] = ' ';
+    if (!level)
+        out[length++] = '-';
+    while (count)
+        out[length++] = digits[--count];
+    return length;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_writer.h"
+
+// Flipper RAW .sub files: a short key/value header, then pulses as lines of
+//
+//   RAW_Data: 412 -1260 1228 -428 ...
+//
+// where a positive value is a high level and a negative one a low level, in
+// microseconds. The parser is incremental, so a file of any length can be read
+// in small chunks with constant memory.
+
+#define SUBGHZ_TOOLKIT_RAW_LINE_VALUES 512 // values per RAW_Data line, as the firmware writes them
+#define SUBGHZ_TOOLKIT_RAW_VALUE_SIZE 12 // longest " -2147483647"
+#define SUBGHZ_TOOLKIT_RAW_PREFIX "RAW_Data:"
+#define SUBGHZ_TOOLKIT_RAW_DEFAULT_FREQUENCY 433920000u
+#define SUBGHZ_TOOLKIT_RAW_DEFAULT_PRESET "FuriHalSubGhzPresetOok650Async"
+
+/** One pulse, in file order */
+typedef void (*SubGhzToolkitRawPulseCallback)(void *context, bool level, uint32_t duration);
+
+typedef struct
+{
+    uint32_t value;
+    uint8_t match; // characters of SUBGHZ_TOOLKIT_RAW_PREFIX matched at the start of the line
+    bool line_start;
+    bool in_data; // past the prefix of a RAW_Data line
+    bool negative;
+    bool digits;
+    uint32_t frequency; // from the "Frequency:" header, 0 until seen
+    uint8_t frequency_match;
+    bool in_frequency;
+} SubGhzToolkitRawParser;
+
+void subghz_toolkit_raw_parser_init(SubGhzToolkitRawParser *parser);
+
+/** Parse the next `size` bytes of a file, calling `callback` per pulse. Returns the pulses found. */
+size_t subghz_toolkit_raw_parser_feed(
+    SubGhzToolkitRawParser *parser,
+    const char *data,
+    size_t size,
+    SubGhzToolkitRawPulseCallback callback,
+    void *context);
+
+/** End of file: emits a pulse still pending without a trailing newline */
+size_t subghz_toolkit_raw_parser_finish(
+    SubGhzToolkitRawParser *parser,
+    SubGhzToolkitRawPulseCallback callback,
+    void *context);
+
+/** Header of a RAW file. `preset` is the firmware preset name, see SUBGHZ_TOOLKIT_RAW_DEFAULT_PRESET. */
+void subghz_toolkit_raw_write_header(SubGhzToolkitWriter *writer, uint32_t frequency, const char *preset);
+
+/** " 412" or " -1260" into `out` (SUBGHZ_TOOLKIT_RAW_VALUE_SIZE bytes), returns the length */
+size_t subghz_toolkit_raw_format_value(char *out, bool level, uint32_t duration);
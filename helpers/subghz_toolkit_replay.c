@@ -0,0 +1,376 @@
+#include "subghz_toolkit_replay.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "subghz_toolkit_name_index.h"
+#include "subghz_toolkit_router.h"
+
+#define SUBGHZ_TOOLKIT_REPLAY_DECODES_INITIAL 64
+#define SUBGHZ_TOOLKIT_REPLAY_TIMING_GAP SUBGHZ_TOOLKIT_ROUTER_GAP // the router mirrors the frame end
+#define SUBGHZ_TOOLKIT_REPLAY_TIMING_BITS_MAX 64
+#define SUBGHZ_TOOLKIT_REPLAY_TEXT_SIZE 96
+
+typedef struct
+{
+    const char *name;
+    void *instance;
+    SubGhzToolkitReplayFeed feed;
+    SubGhzToolkitReplayReset reset;
+    SubGhzToolkitReplayFree free;
+    const SubGhzToolkitTimingConst *timing; // generic timing decoders only, for routing
+    uint32_t decodes;
+} SubGhzToolkitReplayDecoder;
+
+struct SubGhzToolkitReplay
+{
+    SubGhzToolkitReplayDecoder *decoders;
+    size_t decoder_count;
+    size_t decoder_capacity;
+    size_t current; // decoder inside feed()
+    SubGhzToolkitWriter *output;
+    SubGhzToolkitProfile *profile;
+    SubGhzToolkitRouter *router;
+
+    SubGhzToolkitReplayDecode *decodes;
+    size_t decode_count;
+    size_t decode_capacity;
+
+    SubGhzToolkitReplayStats stats;
+};
+
+// Generic PWM decoder: each bit is a high then a low pulse, short+long is 0 and long+short is 1
+typedef struct
+{
+    SubGhzToolkitReplay *replay;
+    const char *name;
+    SubGhzToolkitTimingConst timing;
+    uint32_t high; // pending high pulse, 0 when none
+    uint64_t data;
+    uint8_t bits;
+} SubGhzToolkitReplayTimingDecoder;
+
+SubGhzToolkitReplay *subghz_toolkit_replay_alloc(size_t decoder_capacity, SubGhzToolkitWriter *output)
+{
+    SubGhzToolkitReplay *replay = malloc(sizeof(SubGhzToolkitReplay));
+    memset(replay, 0, sizeof(*replay));
+
+    replay->decoders = malloc(decoder_capacity * sizeof(SubGhzToolkitReplayDecoder));
+    replay->decoder_capacity = decoder_capacity;
+    replay->output = output;
+    return replay;
+}
+
+void subghz_toolkit_replay_free(SubGhzToolkitReplay *replay)
+{
+    for (size_t i = 0; i < replay->decoder_count; i++)
+    {
+        if (replay->decoders[i].free)
+            replay->decoders[i].free(replay->decoders[i].instance);
+    }
+    if (replay->router)
+        subghz_toolkit_router_free(replay->router);
+    free(replay->decoders);
+    free(replay->decodes);
+    free(replay);
+}
+
+int subghz_toolkit_replay_add(
+    SubGhzToolkitReplay *replay,
+    const char *name,
+    void *instance,
+    SubGhzToolkitReplayFeed feed,
+    SubGhzToolkitReplayReset reset,
+    SubGhzToolkitReplayFree free)
+{
+    if (replay->decoder_count == replay->decoder_capacity)
+        return -1;
+
+    replay->decoders[replay->decoder_count] = (SubGhzToolkitReplayDecoder){
+        .name = name,
+        .instance = instance,
+        .feed = feed,
+        .reset = reset,
+        .free = free,
+    };
+    return (int)replay->decoder_count++;
+}
+
+static bool subghz_toolkit_replay_timing_match(uint32_t duration, uint16_t te, uint16_t delta)
+{
+    return duration + delta >= te && duration <= (uint32_t)te + delta;
+}
+
+static void subghz_toolkit_replay_timing_reset(void *instance)
+{
+    SubGhzToolkitReplayTimingDecoder *decoder = instance;
+    decoder->high = 0;
+    decoder->data = 0;
+    decoder->bits = 0;
+}
+
+// Shift in the bit of a high pulse followed by `low`, false when the pair is not a bit
+static bool subghz_toolkit_replay_timing_bit(SubGhzToolkitReplayTimingDecoder *decoder, uint32_t high, uint32_t low)
+{
+    const SubGhzToolkitTimingConst *timing = &decoder->timing;
+    bool bit;
+
+    if (subghz_toolkit_replay_timing_match(high, timing->te_short, timing->te_delta) &&
+        subghz_toolkit_replay_timing_match(low, timing->te_long, timing->te_delta))
+        bit = false;
+    else if (subghz_toolkit_replay_timing_match(high, timing->te_long, timing->te_delta) &&
+             subghz_toolkit_replay_timing_match(low, timing->te_short, timing->te_delta))
+        bit = true;
+    else
+        return false;
+
+    if (decoder->bits == SUBGHZ_TOOLKIT_REPLAY_TIMING_BITS_MAX)
+        return false;
+    decoder->data = decoder->data << 1 | bit;
+    decoder->bits++;
+    return true;
+}
+
+static void subghz_toolkit_replay_timing_feed(void *instance, bool level, uint32_t duration)
+{
+    SubGhzToolkitReplayTimingDecoder *decoder = instance;
+
+    if (level)
+    {
+        decoder->high = duration;
+        return;
+    }
+    if (!decoder->high)
+        return;
+
+    uint32_t high = decoder->high;
+    decoder->high = 0;
+    // The high before a gap is the sync/stop pulse, not a bit
+    if (duration <= (uint32_t)decoder->timing.te_long * SUBGHZ_TOOLKIT_REPLAY_TIMING_GAP &&
+        subghz_toolkit_replay_timing_bit(decoder, high, duration))
+        return;
+
+    // A gap or a pulse pair that is not a bit ends the frame
+    if (decoder->bits >= decoder->timing.min_count_bit)
+    {
+        char text[SUBGHZ_TOOLKIT_REPLAY_TEXT_SIZE];
+        snprintf(text, sizeof(text), "%s %ubit Key:0x%0*" PRIX64,
+                 decoder->name, decoder->bits, (decoder->bits + 3) / 4, decoder->data);
+        subghz_toolkit_replay_decoded(decoder->replay, text);
+    }
+    subghz_toolkit_replay_timing_reset(decoder);
+}
+
+int subghz_toolkit_replay_add_timing_decoder(SubGhzToolkitReplay *replay, const char *name, const SubGhzToolkitTimingConst *timing)
+{
+    if (!timing->te_short || timing->te_long <= timing->te_short || !timing->min_count_bit)
+        return -1;
+
+    SubGhzToolkitReplayTimingDecoder *decoder = malloc(sizeof(SubGhzToolkitReplayTimingDecoder));
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->replay = replay;
+    decoder->name = name;
+    decoder->timing = *timing;
+
+    int index = subghz_toolkit_replay_add(
+        replay, name, decoder, subghz_toolkit_replay_timing_feed, subghz_toolkit_replay_timing_reset, free);
+    if (index < 0)
+        free(decoder);
+    else
+        replay->decoders[index].timing = &decoder->timing;
+    return index;
+}
+
+size_t subghz_toolkit_replay_decoder_count(const SubGhzToolkitReplay *replay)
+{
+    return replay->decoder_count;
+}
+
+const char *subghz_toolkit_replay_decoder_name(const SubGhzToolkitReplay *replay, size_t decoder)
+{
+    return replay->decoders[decoder].name;
+}
+
+void subghz_toolkit_replay_reset(SubGhzToolkitReplay *replay)
+{
+    for (size_t i = 0; i < replay->decoder_count; i++)
+    {
+        if (replay->decoders[i].reset)
+            replay->decoders[i].reset(replay->decoders[i].instance);
+    }
+    if (replay->router)
+        subghz_toolkit_router_reset(replay->router);
+    memset(&replay->stats, 0, sizeof(replay->stats));
+}
+
+void subghz_toolkit_replay_set_profile(SubGhzToolkitReplay *replay, SubGhzToolkitProfile *profile)
+{
+    replay->profile = profile;
+    for (size_t i = 0; profile && i < replay->decoder_count; i++)
+        subghz_toolkit_profile_set_name(profile, i, replay->decoders[i].name);
+}
+
+void subghz_toolkit_replay_set_routing(SubGhzToolkitReplay *replay, bool routing)
+{
+    if (replay->router)
+        subghz_toolkit_router_free(replay->router);
+    replay->router = NULL;
+    if (!routing)
+        return;
+
+    replay->router = subghz_toolkit_router_alloc(replay->decoder_count);
+    for (size_t i = 0; i < replay->decoder_count; i++)
+        subghz_toolkit_router_add(replay->router, replay->decoders[i].timing);
+    subghz_toolkit_router_build(replay->router);
+}
+
+const SubGhzToolkitRouterStats *subghz_toolkit_replay_get_routing(const SubGhzToolkitReplay *replay)
+{
+    return replay->router ? subghz_toolkit_router_get_stats(replay->router) : NULL;
+}
+
+static void subghz_toolkit_replay_route_feed(void *context, size_t decoder, bool level, uint32_t duration)
+{
+    SubGhzToolkitReplay *replay = context;
+    SubGhzToolkitReplayDecoder *entry = &replay->decoders[decoder];
+
+    replay->current = decoder;
+    if (replay->profile)
+    {
+        uint32_t start = subghz_toolkit_profile_now();
+        entry->feed(entry->instance, level, duration);
+        subghz_toolkit_profile_record(replay->profile, decoder, subghz_toolkit_profile_now() - start);
+    }
+    else
+    {
+        entry->feed(entry->instance, level, duration);
+    }
+}
+
+static void subghz_toolkit_replay_route_reset(void *context, size_t decoder)
+{
+    SubGhzToolkitReplay *replay = context;
+    if (replay->decoders[decoder].reset)
+        replay->decoders[decoder].reset(replay->decoders[decoder].instance);
+}
+
+void subghz_toolkit_replay_feed(void *context, bool level, uint32_t duration)
+{
+    SubGhzToolkitReplay *replay = context;
+    SubGhzToolkitReplayDecoder *decoders = replay->decoders;
+
+    if (replay->router)
+    {
+        subghz_toolkit_router_route(
+            replay->router, level, duration, subghz_toolkit_replay_route_feed, subghz_toolkit_replay_route_reset, replay);
+    }
+    else if (replay->profile)
+    {
+        // A decode callback inside feed() is part of the cost, as it is in the receiver
+        for (size_t i = 0; i < replay->decoder_count; i++)
+        {
+            replay->current = i;
+            uint32_t start = subghz_toolkit_profile_now();
+            decoders[i].feed(decoders[i].instance, level, duration);
+            subghz_toolkit_profile_record(replay->profile, i, subghz_toolkit_profile_now() - start);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < replay->decoder_count; i++)
+        {
+            replay->current = i;
+            decoders[i].feed(decoders[i].instance, level, duration);
+        }
+    }
+
+    replay->stats.pulses++;
+    replay->stats.duration_us += duration;
+}
+
+void subghz_toolkit_replay_decoded(SubGhzToolkitReplay *replay, const char *text)
+{
+    if (replay->decode_count == replay->decode_capacity)
+    {
+        size_t capacity = replay->decode_capacity ? replay->decode_capacity * 2 : SUBGHZ_TOOLKIT_REPLAY_DECODES_INITIAL;
+        SubGhzToolkitReplayDecode *decodes = realloc(replay->decodes, capacity * sizeof(SubGhzToolkitReplayDecode));
+        if (!decodes)
+            return;
+        replay->decodes = decodes;
+        replay->decode_capacity = capacity;
+    }
+
+    SubGhzToolkitReplayDecode *decode = &replay->decodes[replay->decode_count++];
+    decode->pulse = replay->stats.pulses;
+    decode->time_ms = (uint32_t)(replay->stats.duration_us / 1000);
+    decode->decoder = (uint16_t)replay->current;
+    decode->hash = subghz_toolkit_name_hash(text);
+
+    replay->decoders[replay->current].decodes++;
+    replay->stats.decodes++;
+
+    if (replay->output)
+    {
+        subghz_toolkit_writer_printf(replay->output,
+                                     "  pulse %lu, %lu.%03lu s, %s:\n",
+                                     (unsigned long)decode->pulse,
+                                     (unsigned long)(decode->time_ms / 1000),
+                                     (unsigned long)(decode->time_ms % 1000),
+                                     replay->decoders[replay->current].name);
+        subghz_toolkit_writer_cstr(replay->output, text);
+        if (!text[0] || text[strlen(text) - 1] != '\n')
+            subghz_toolkit_writer_cstr(replay->output, "\n");
+    }
+}
+
+const SubGhzToolkitReplayStats *subghz_toolkit_replay_get_stats(const SubGhzToolkitReplay *replay)
+{
+    return &replay->stats;
+}
+
+const SubGhzToolkitReplayDecode *subghz_toolkit_replay_get_decodes(const SubGhzToolkitReplay *replay, size_t *count)
+{
+    *count = replay->decode_count;
+    return replay->decodes;
+}
+
+void subghz_toolkit_replay_write_summary(SubGhzToolkitWriter *writer, const SubGhzToolkitReplay *replay, uint32_t elapsed_ms)
+{
+    const SubGhzToolkitReplayStats *stats = &replay->stats;
+    uint32_t pulses_per_sec = elapsed_ms ? (uint32_t)((uint64_t)stats->pulses * 1000 / elapsed_ms) : 0;
+    uint32_t signal_ms = (uint32_t)(stats->duration_us / 1000);
+
+    subghz_toolkit_writer_printf(writer,
+                                 "Replay Statistics:\n"
+                                 "  Decoders:         %lu\n"
+                                 "  Pulses:           %lu\n"
+                                 "  Decodes:          %lu\n"
+                                 "  Signal length:    %lu ms\n"
+                                 "  Replay time:      %lu ms\n"
+                                 "  Throughput:       %lu pulses/s (%lu decoder feeds/s)\n",
+                                 (unsigned long)replay->decoder_count,
+                                 (unsigned long)stats->pulses,
+                                 (unsigned long)stats->decodes,
+                                 (unsigned long)signal_ms,
+                                 (unsigned long)elapsed_ms,
+                                 (unsigned long)pulses_per_sec,
+                                 (unsigned long)((uint64_t)pulses_per_sec * replay->decoder_count));
+}
+
+void subghz_toolkit_replay_write_decoder_counts(SubGhzToolkitWriter *writer, const SubGhzToolkitReplay *replay)
+{
+    size_t decoding = 0;
+
+    subghz_toolkit_writer_cstr(writer, "Decodes per decoder:\n");
+    for (size_t i = 0; i < replay->decoder_count; i++)
+    {
+        if (!replay->decoders[i].decodes)
+            continue;
+        subghz_toolkit_writer_printf(writer, "  %-24s %lu\n", replay->decoders[i].name, (unsigned long)replay->decoders[i].decodes);
+        decoding++;
+    }
+    if (!decoding)
+        subghz_toolkit_writer_cstr(writer, "  none\n");
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_profile.h"
+#include "subghz_toolkit_router.h"
+#include "subghz_toolkit_timing.h"
+#include "subghz_toolkit_writer.h"
+
+// Replays a pulse stream through a set of decoders, the way SubGhzReceiver
+// hands every pulse to every decoder, and records what they decode and where.
+//
+// Decoders are plain (instance, feed, reset, free) tuples: on the Flipper the
+// firmware's own decoders from subghz_protocol_registry, on the host generic
+// PWM decoders built from the timing table the toolkit recovers (see
+// subghz_toolkit_replay_add_timing_decoder()). Decode callbacks fire inside
+// feed(), so they report with subghz_toolkit_replay_decoded() and the engine
+// knows which decoder and which pulse it was.
+
+typedef void (*SubGhzToolkitReplayFeed)(void *instance, bool level, uint32_t duration);
+typedef void (*SubGhzToolkitReplayReset)(void *instance);
+typedef void (*SubGhzToolkitReplayFree)(void *instance);
+
+typedef struct
+{
+    uint32_t pulse;    // index of the pulse that completed the decode, counted from the last reset
+    uint32_t time_ms;  // signal time at that pulse
+    uint16_t decoder;
+    uint32_t hash;     // of the decode text, to compare runs
+} SubGhzToolkitReplayDecode;
+
+typedef struct
+{
+    uint32_t pulses;
+    uint32_t decodes;
+    uint64_t duration_us; // signal time replayed
+} SubGhzToolkitReplayStats;
+
+typedef struct SubGhzToolkitReplay SubGhzToolkitReplay;
+
+/** Room for `decoder_capacity` decoders. Decodes are written to `output` as they happen, if set. */
+SubGhzToolkitReplay *subghz_toolkit_replay_alloc(size_t decoder_capacity, SubGhzToolkitWriter *output);
+
+/** Frees every decoder through its free callback */
+void subghz_toolkit_replay_free(SubGhzToolkitReplay *replay);
+
+/** Returns the decoder index, or -1 when full */
+int subghz_toolkit_replay_add(
+    SubGhzToolkitReplay *replay,
+    const char *name,
+    void *instance,
+    SubGhzToolkitReplayFeed feed,
+    SubGhzToolkitReplayReset reset,
+    SubGhzToolkitReplayFree free);
+
+/** A generic PWM decoder for a protocol's timing: short/long high + long/short low per bit, a long gap ends the frame */
+int subghz_toolkit_replay_add_timing_decoder(SubGhzToolkitReplay *replay, const char *name, const SubGhzToolkitTimingConst *timing);
+
+size_t subghz_toolkit_replay_decoder_count(const SubGhzToolkitReplay *replay);
+
+const char *subghz_toolkit_replay_decoder_name(const SubGhzToolkitReplay *replay, size_t decoder);
+
+/** Reset every decoder and the counters, between files. Recorded decodes are kept. */
+void subghz_toolkit_replay_reset(SubGhzToolkitReplay *replay);
+
+/** Time every feed() into `profile` (one entry per decoder, named here), NULL to stop */
+void subghz_toolkit_replay_set_profile(SubGhzToolkitReplay *replay, SubGhzToolkitProfile *profile);
+
+/** Route pulses to the timing decoders whose frame they can start or continue (see
+ *  subghz_toolkit_router.h), others are still fed everything. Call after the last add; false to feed all. */
+void subghz_toolkit_replay_set_routing(SubGhzToolkitReplay *replay, bool routing);
+
+/** Feed counts of the routed replay since the last reset, NULL without routing */
+const SubGhzToolkitRouterStats *subghz_toolkit_replay_get_routing(const SubGhzToolkitReplay *replay);
+
+/** Hand one pulse to every decoder. Matches SubGhzToolkitRawPulseCallback, `context` is the replay. */
+void subghz_toolkit_replay_feed(void *context, bool level, uint32_t duration);
+
+/** From a decode callback: the decoder being fed decoded `text` */
+void subghz_toolkit_replay_decoded(SubGhzToolkitReplay *replay, const char *text);
+
+const SubGhzToolkitReplayStats *subghz_toolkit_replay_get_stats(const SubGhzToolkitReplay *replay);
+
+/** Every decode since alloc, in order */
+const SubGhzToolkitReplayDecode *subghz_toolkit_replay_get_decodes(const SubGhzToolkitReplay *replay, size_t *count);
+
+/** Pulses, decodes and pulses/s of the replay since the last reset, which took `elapsed_ms` */
+void subghz_toolkit_replay_write_summary(SubGhzToolkitWriter *writer, const SubGhzToolkitReplay *replay, uint32_t elapsed_ms);
+
+/** Decoders that decoded anything since alloc, with their decode counts */
+void subghz_toolkit_replay_write_decoder_counts(SubGhzToolkitWriter *writer, const SubGhzToolkitReplay *replay);
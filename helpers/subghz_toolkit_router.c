@@ -0,0 +1,278 @@
+#include "subghz_toolkit_router.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SUBGHZ_TOOLKIT_ROUTER_EDGES 5 // per decoder: short and long interval, gap start
+#define SUBGHZ_TOOLKIT_ROUTER_LOOKUP_SHIFT 4 // 16 us per lookup slot
+#define SUBGHZ_TOOLKIT_ROUTER_LOOKUP_SIZE 4096 // slots, durations past 65 ms are searched
+
+struct SubGhzToolkitRouter
+{
+    SubGhzToolkitTimingConst *timings;
+    bool *timed;
+    size_t count;
+    size_t capacity;
+    size_t words; // per decoder bitset
+
+    // Symbol s is [edges[s - 1], edges[s]), symbol 0 starts at 0 and the last is open
+    uint32_t *edges;
+    size_t edge_count;
+    uint16_t *lookup; // first symbol of each 16 us slot, the walk from there is a step or two
+    uint32_t *short_sets; // per symbol, the decoders it is a short pulse for
+    uint32_t *long_sets;
+    uint32_t *gap_sets;
+
+    uint32_t *always;
+    uint32_t *active;
+    bool high_pending; // the last pulse was a high, a low completes the pair
+    uint32_t high_duration;
+    size_t high_symbol;
+
+    SubGhzToolkitRouterStats stats;
+};
+
+SubGhzToolkitRouter *subghz_toolkit_router_alloc(size_t decoder_capacity)
+{
+    SubGhzToolkitRouter *router = malloc(sizeof(SubGhzToolkitRouter));
+    memset(router, 0, sizeof(*router));
+
+    router->timings = malloc(decoder_capacity * sizeof(SubGhzToolkitTimingConst));
+    router->timed = malloc(decoder_capacity * sizeof(bool));
+    router->capacity = decoder_capacity;
+    return router;
+}
+
+static void subghz_toolkit_router_free_sets(SubGhzToolkitRouter *router)
+{
+    free(router->edges);
+    free(router->lookup);
+    free(router->short_sets);
+    free(router->long_sets);
+    free(router->gap_sets);
+    free(router->always);
+    free(router->active);
+}
+
+void subghz_toolkit_router_free(SubGhzToolkitRouter *router)
+{
+    subghz_toolkit_router_free_sets(router);
+    free(router->timings);
+    free(router->timed);
+    free(router);
+}
+
+int subghz_toolkit_router_add(SubGhzToolkitRouter *router, const SubGhzToolkitTimingConst *timing)
+{
+    if (router->count == router->capacity)
+        return -1;
+
+    router->timed[router->count] = timing != NULL;
+    if (timing)
+        router->timings[router->count] = *timing;
+    return (int)router->count++;
+}
+
+static int subghz_toolkit_router_compare_edges(const void *a, const void *b)
+{
+    uint32_t left = *(const uint32_t *)a;
+    uint32_t right = *(const uint32_t *)b;
+    return left < right ? -1 : left > right;
+}
+
+// Symbol of `duration`: the number of edges at or below it
+static size_t subghz_toolkit_router_search(const SubGhzToolkitRouter *router, uint32_t duration)
+{
+    size_t low = 0;
+    size_t high = router->edge_count;
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+        if (router->edges[middle] <= duration)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+static inline size_t subghz_toolkit_router_symbol(const SubGhzToolkitRouter *router, uint32_t duration)
+{
+    uint32_t slot = duration >> SUBGHZ_TOOLKIT_ROUTER_LOOKUP_SHIFT;
+    if (!router->lookup || slot >= SUBGHZ_TOOLKIT_ROUTER_LOOKUP_SIZE)
+        return subghz_toolkit_router_search(router, duration);
+
+    size_t symbol = router->lookup[slot];
+    while (symbol < router->edge_count && router->edges[symbol] <= duration)
+        symbol++;
+    return symbol;
+}
+
+// Inclusive [first, last] us, as the decoders match a duration against te +- te_delta
+static void subghz_toolkit_router_interval(uint16_t te, uint16_t delta, uint32_t *first, uint32_t *last)
+{
+    *first = te > delta ? (uint32_t)te - delta : 0;
+    *last = (uint32_t)te + delta;
+}
+
+static void subghz_toolkit_router_mark(
+    SubGhzToolkitRouter *router, uint32_t *sets, size_t decoder, uint32_t first, uint32_t last)
+{
+    size_t end = last == UINT32_MAX ? router->edge_count : subghz_toolkit_router_symbol(router, last);
+    for (size_t symbol = subghz_toolkit_router_symbol(router, first); symbol <= end; symbol++)
+        sets[symbol * router->words + decoder / 32] |= 1u << (decoder % 32);
+}
+
+void subghz_toolkit_router_build(SubGhzToolkitRouter *router)
+{
+    subghz_toolkit_router_free_sets(router);
+    router->words = (router->count + 31) / 32;
+    router->edges = malloc((router->count * SUBGHZ_TOOLKIT_ROUTER_EDGES + 1) * sizeof(uint32_t));
+    router->edge_count = 0;
+
+    for (size_t i = 0; i < router->count; i++)
+    {
+        const SubGhzToolkitTimingConst *timing = &router->timings[i];
+        uint32_t first, last;
+        if (!router->timed[i])
+            continue;
+
+        subghz_toolkit_router_interval(timing->te_short, timing->te_delta, &first, &last);
+        if (first)
+            router->edges[router->edge_count++] = first;
+        router->edges[router->edge_count++] = last + 1;
+        subghz_toolkit_router_interval(timing->te_long, timing->te_delta, &first, &last);
+        if (first)
+            router->edges[router->edge_count++] = first;
+        router->edges[router->edge_count++] = last + 1;
+        router->edges[router->edge_count++] = (uint32_t)timing->te_long * SUBGHZ_TOOLKIT_ROUTER_GAP + 1;
+    }
+
+    qsort(router->edges, router->edge_count, sizeof(uint32_t), subghz_toolkit_router_compare_edges);
+    size_t unique = 0;
+    for (size_t i = 0; i < router->edge_count; i++)
+    {
+        if (!unique || router->edges[i] != router->edges[unique - 1])
+            router->edges[unique++] = router->edges[i];
+    }
+    router->edge_count = unique;
+
+    router->lookup = malloc(SUBGHZ_TOOLKIT_ROUTER_LOOKUP_SIZE * sizeof(uint16_t));
+    for (uint32_t slot = 0; slot < SUBGHZ_TOOLKIT_ROUTER_LOOKUP_SIZE; slot++)
+        router->lookup[slot] = (uint16_t)subghz_toolkit_router_search(router, slot << SUBGHZ_TOOLKIT_ROUTER_LOOKUP_SHIFT);
+
+    size_t set_size = (router->edge_count + 1) * router->words * sizeof(uint32_t);
+    router->short_sets = calloc(1, set_size);
+    router->long_sets = calloc(1, set_size);
+    router->gap_sets = calloc(1, set_size);
+    router->always = calloc(router->words, sizeof(uint32_t));
+    router->active = calloc(router->words, sizeof(uint32_t));
+
+    for (size_t i = 0; i < router->count; i++)
+    {
+        const SubGhzToolkitTimingConst *timing = &router->timings[i];
+        uint32_t first, last;
+        if (!router->timed[i])
+        {
+            router->always[i / 32] |= 1u << (i % 32);
+            continue;
+        }
+
+        subghz_toolkit_router_interval(timing->te_short, timing->te_delta, &first, &last);
+        subghz_toolkit_router_mark(router, router->short_sets, i, first, last);
+        subghz_toolkit_router_interval(timing->te_long, timing->te_delta, &first, &last);
+        subghz_toolkit_router_mark(router, router->long_sets, i, first, last);
+        subghz_toolkit_router_mark(router, router->gap_sets, i, (uint32_t)timing->te_long * SUBGHZ_TOOLKIT_ROUTER_GAP + 1, UINT32_MAX);
+    }
+    subghz_toolkit_router_reset(router);
+}
+
+void subghz_toolkit_router_reset(SubGhzToolkitRouter *router)
+{
+    if (router->active)
+        memcpy(router->active, router->always, router->words * sizeof(uint32_t));
+    router->high_pending = false;
+    memset(&router->stats, 0, sizeof(router->stats));
+}
+
+static void subghz_toolkit_router_feed_active(
+    SubGhzToolkitRouter *router, bool level, uint32_t duration, SubGhzToolkitRouterFeed feed, void *context)
+{
+    for (size_t w = 0; w < router->words; w++)
+    {
+        for (uint32_t bits = router->active[w]; bits; bits &= bits - 1)
+        {
+            feed(context, w * 32 + __builtin_ctz(bits), level, duration);
+            router->stats.feeds++;
+        }
+    }
+}
+
+void subghz_toolkit_router_route(
+    SubGhzToolkitRouter *router,
+    bool level,
+    uint32_t duration,
+    SubGhzToolkitRouterFeed feed,
+    SubGhzToolkitRouterReset reset,
+    void *context)
+{
+    router->stats.pulses++;
+
+    if (level || !router->high_pending)
+    {
+        // Only a low after a high can start or end a frame
+        subghz_toolkit_router_feed_active(router, level, duration, feed, context);
+        if (level)
+        {
+            router->high_pending = true;
+            router->high_duration = duration;
+            router->high_symbol = subghz_toolkit_router_symbol(router, duration);
+        }
+        return;
+    }
+
+    size_t words = router->words;
+    const uint32_t *high_short = &router->short_sets[router->high_symbol * words];
+    const uint32_t *high_long = &router->long_sets[router->high_symbol * words];
+    size_t low_symbol = subghz_toolkit_router_symbol(router, duration);
+    const uint32_t *low_short = &router->short_sets[low_symbol * words];
+    const uint32_t *low_long = &router->long_sets[low_symbol * words];
+    const uint32_t *low_gap = &router->gap_sets[low_symbol * words];
+
+    for (size_t w = 0; w < words; w++)
+    {
+        // Decoders for which (high, low) is a bit: short then long, or long then short. A high
+        // before a gap is a sync pulse, active decoders end their frame on it and idle ones ignore it.
+        uint32_t match = ((high_short[w] & low_long[w]) | (high_long[w] & low_short[w])) & ~low_gap[w];
+
+        for (uint32_t bits = router->active[w] | match; bits; bits &= bits - 1)
+        {
+            uint32_t bit = bits & -bits;
+            size_t decoder = w * 32 + __builtin_ctz(bits);
+            if (!(router->active[w] & bit))
+            {
+                // A frame starts: the decoder is idle, so it gets the high it was not handed
+                reset(context, decoder);
+                feed(context, decoder, true, router->high_duration);
+                router->stats.feeds++;
+                router->stats.activations++;
+            }
+            feed(context, decoder, false, duration);
+            router->stats.feeds++;
+        }
+
+        // A pair that is not a bit, or a gap, ends the frame and the decoder has reset itself
+        router->active[w] = match | router->always[w];
+    }
+    router->high_pending = false;
+}
+
+size_t subghz_toolkit_router_symbol_count(const SubGhzToolkitRouter *router)
+{
+    return router->edge_count + 1;
+}
+
+const SubGhzToolkitRouterStats *subghz_toolkit_router_get_stats(const SubGhzToolkitRouter *router)
+{
+    return &router->stats;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_timing.h"
+
+// Routes each pulse to the decoders that could be in a frame, instead of all.
+//
+// Each decoder is described by its timing: a bit is a high then a low pulse,
+// short+long or long+short within te_delta, and a low over te_long *
+// SUBGHZ_TOOLKIT_ROUTER_GAP ends the frame. build() cuts the duration axis at
+// every decoder's interval edges, so each pulse quantizes (binary search) to
+// one shared symbol, and every symbol carries bitsets of the decoders it is
+// short, long or a gap for. Those bitsets are a two-level prefix automaton
+// shared by every decoder: the high symbol selects the candidates, the low
+// symbol intersects them into the decoders whose first bit just matched,
+// word-parallel over 32 decoders at a time. Expanding the same automaton into
+// a trie would take a node per (high, low) symbol pair.
+//
+// A matched decoder is reset and handed the high it missed, then gets every
+// pulse until a pair that is not a bit or a gap ends its frame, where the
+// decoder resets itself anyway. An idle decoder would only have seen pairs
+// it rejects, so the decodes are the same as feeding every decoder every
+// pulse. Decoders added without a timing are always fed.
+
+#define SUBGHZ_TOOLKIT_ROUTER_GAP 3 // low pulses over te_long * 3 end a frame
+
+typedef struct SubGhzToolkitRouter SubGhzToolkitRouter;
+
+typedef void (*SubGhzToolkitRouterFeed)(void *context, size_t decoder, bool level, uint32_t duration);
+typedef void (*SubGhzToolkitRouterReset)(void *context, size_t decoder);
+
+typedef struct
+{
+    uint64_t pulses;
+    uint64_t feeds; // decoder feed() calls, pulses * decoders without routing
+    uint64_t activations; // frames started by a matching first bit
+} SubGhzToolkitRouterStats;
+
+SubGhzToolkitRouter *subghz_toolkit_router_alloc(size_t decoder_capacity);
+
+void subghz_toolkit_router_free(SubGhzToolkitRouter *router);
+
+/** Decoder number `index` is next; `timing` NULL to always feed it. Returns the index, -1 when full. */
+int subghz_toolkit_router_add(SubGhzToolkitRouter *router, const SubGhzToolkitTimingConst *timing);
+
+/** Quantization and symbol bitsets for the decoders added so far */
+void subghz_toolkit_router_build(SubGhzToolkitRouter *router);
+
+/** Every routed decoder idle, counters cleared. The caller resets the decoders. */
+void subghz_toolkit_router_reset(SubGhzToolkitRouter *router);
+
+/** Hand one pulse to the decoders it can reach, in decoder order */
+void subghz_toolkit_router_route(
+    SubGhzToolkitRouter *router,
+    bool level,
+    uint32_t duration,
+    SubGhzToolkitRouterFeed feed,
+    SubGhzToolkitRouterReset reset,
+    void *context);
+
+/** Shared symbols after build() */
+size_t subghz_toolkit_router_symbol_count(const SubGhzToolkitRouter *router);
+
+const SubGhzToolkitRouterStats *subghz_toolkit_router_get_stats(const SubGhzToolkitRouter *router);
@@ -0,0 +1,532 @@
+#include "subghz_toolkit_snapshot.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "subghz_toolkit_name_index.h"
+
+#define SUBGHZ_TOOLKIT_SNAPSHOT_MAGIC 0x53464753u // "SGFS"
+#define SUBGHZ_TOOLKIT_SNAPSHOT_HEADER_SIZE (16 + SUBGHZ_TOOLKIT_SNAPSHOT_GITHASH_SIZE)
+#define SUBGHZ_TOOLKIT_SNAPSHOT_PROTOCOL_SIZE 12
+#define SUBGHZ_TOOLKIT_SNAPSHOT_FUNCTION_SIZE 8
+
+// Stands in for a masked field, so masking still records that something was there
+#define SUBGHZ_TOOLKIT_SNAPSHOT_MASKED 0xA5A5A5A5u
+
+typedef struct
+{
+    uint16_t size;
+    uint32_t hash;
+} SubGhzToolkitSnapshotFunction;
+
+typedef struct
+{
+    uint32_t name; // offset into the names
+    uint32_t flag;
+    uint8_t type;
+    uint16_t mask; // bit n set when slot n has a function
+    uint32_t first; // index of the first function
+} SubGhzToolkitSnapshotProtocol;
+
+struct SubGhzToolkitSnapshot
+{
+    char githash[SUBGHZ_TOOLKIT_SNAPSHOT_GITHASH_SIZE + 1];
+    SubGhzToolkitSnapshotProtocol *protocols;
+    size_t protocol_count;
+    size_t protocol_capacity;
+    SubGhzToolkitSnapshotFunction *functions;
+    size_t function_count;
+    size_t function_capacity;
+    char *names;
+    size_t names_size;
+    size_t names_capacity;
+};
+
+static uint32_t subghz_toolkit_snapshot_u32(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static uint16_t subghz_toolkit_snapshot_u16(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8);
+}
+
+static void subghz_toolkit_snapshot_put_u32(uint8_t *data, uint32_t value)
+{
+    data[0] = value;
+    data[1] = value >> 8;
+    data[2] = value >> 16;
+    data[3] = value >> 24;
+}
+
+static void subghz_toolkit_snapshot_put_u16(uint8_t *data, uint16_t value)
+{
+    data[0] = value;
+    data[1] = value >> 8;
+}
+
+// FNV-1a over the four bytes of `value`
+static uint32_t subghz_toolkit_snapshot_mix(uint32_t hash, uint32_t value)
+{
+    for (size_t i = 0; i < 4; i++)
+    {
+        hash ^= (uint8_t)(value >> (i * 8));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool subghz_toolkit_snapshot_is_address(uint32_t value)
+{
+    return (value >= SUBGHZ_TOOLKIT_SNAPSHOT_FLASH_START && value < SUBGHZ_TOOLKIT_SNAPSHOT_FLASH_END) ||
+           (value >= SUBGHZ_TOOLKIT_SNAPSHOT_RAM_START && value < SUBGHZ_TOOLKIT_SNAPSHOT_RAM_END);
+}
+
+uint32_t subghz_toolkit_snapshot_hash_function(const uint8_t *code, const SubGhzToolkitFunction *function)
+{
+    uint32_t hash = 2166136261u;
+    uint32_t movw[16]; // raw MOVW per register, held back until it is known not to be an address
+    uint16_t movw_pending = 0;
+    SubGhzToolkitFunctionCursor cursor = {0};
+    SubGhzToolkitThumbInsn insn;
+
+    while (subghz_toolkit_function_next(code, function, &cursor, &insn))
+    {
+        uint32_t value = insn.raw;
+        bool inside = insn.target >= function->address && insn.target < function->address + function->size;
+
+        switch (insn.op)
+        {
+        case SubGhzToolkitThumbOpBl:
+            value = SUBGHZ_TOOLKIT_SNAPSHOT_MASKED;
+            break;
+        case SubGhzToolkitThumbOpB:
+        case SubGhzToolkitThumbOpBCond:
+            // Branches within the function are position independent, tail calls are not
+            if (!inside)
+                value = SUBGHZ_TOOLKIT_SNAPSHOT_MASKED ^ insn.cond;
+            break;
+        case SubGhzToolkitThumbOpMovw:
+            if (movw_pending & (1u << insn.rd))
+                hash = subghz_toolkit_snapshot_mix(hash, movw[insn.rd]);
+            movw[insn.rd] = insn.raw;
+            movw_pending |= 1u << insn.rd;
+            continue;
+        case SubGhzToolkitThumbOpMovt:
+            // The upper half of an address: the low half from the MOVW before it is masked as well
+            if (subghz_toolkit_snapshot_is_address(insn.imm << 16))
+            {
+                movw_pending &= ~(1u << insn.rd);
+                value = SUBGHZ_TOOLKIT_SNAPSHOT_MASKED ^ insn.rd;
+            }
+            break;
+        case SubGhzToolkitThumbOpLdrLiteral:
+        {
+            // The offset to the pool depends on where the function sits (Align(PC, 4)),
+            // the constant it loads does not: constants count, addresses do not
+            uint32_t literal = insn.target - function->address;
+            hash = subghz_toolkit_snapshot_mix(hash, insn.op << 8 | insn.size << 4 | insn.rd);
+            value = SUBGHZ_TOOLKIT_SNAPSHOT_MASKED;
+            if (literal + 4 <= function->size && !subghz_toolkit_snapshot_is_address(subghz_toolkit_snapshot_u32(code + literal)))
+                value = subghz_toolkit_snapshot_u32(code + literal);
+            break;
+        }
+        case SubGhzToolkitThumbOpAdr:
+            value = SUBGHZ_TOOLKIT_SNAPSHOT_MASKED ^ (insn.op << 8 | insn.rd);
+            break;
+        default:
+            break;
+        }
+
+        hash = subghz_toolkit_snapshot_mix(hash, value);
+    }
+
+    for (size_t rd = 0; rd < 16; rd++)
+    {
+        if (movw_pending & (1u << rd))
+            hash = subghz_toolkit_snapshot_mix(hash, movw[rd]);
+    }
+
+    return hash;
+}
+
+SubGhzToolkitSnapshot *subghz_toolkit_snapshot_alloc(const char *githash)
+{
+    SubGhzToolkitSnapshot *snapshot = malloc(sizeof(SubGhzToolkitSnapshot));
+    memset(snapshot, 0, sizeof(*snapshot));
+    strncpy(snapshot->githash, githash ? githash : "", SUBGHZ_TOOLKIT_SNAPSHOT_GITHASH_SIZE);
+    return snapshot;
+}
+
+void subghz_toolkit_snapshot_free(SubGhzToolkitSnapshot *snapshot)
+{
+    free(snapshot->protocols);
+    free(snapshot->functions);
+    free(snapshot->names);
+    free(snapshot);
+}
+
+const char *subghz_toolkit_snapshot_githash(const SubGhzToolkitSnapshot *snapshot)
+{
+    return snapshot->githash;
+}
+
+size_t subghz_toolkit_snapshot_protocol_count(const SubGhzToolkitSnapshot *snapshot)
+{
+    return snapshot->protocol_count;
+}
+
+static const char *subghz_toolkit_snapshot_name(const SubGhzToolkitSnapshot *snapshot, const SubGhzToolkitSnapshotProtocol *protocol)
+{
+    return snapshot->names + protocol->name;
+}
+
+// Room for one more protocol, `functions` more functions and a name of `name_size` bytes
+static void subghz_toolkit_snapshot_reserve(SubGhzToolkitSnapshot *snapshot, size_t functions, size_t name_size)
+{
+    if (snapshot->protocol_count == snapshot->protocol_capacity)
+    {
+        snapshot->protocol_capacity = snapshot->protocol_capacity ? snapshot->protocol_capacity * 2 : 64;
+        snapshot->protocols = realloc(snapshot->protocols, snapshot->protocol_capacity * sizeof(SubGhzToolkitSnapshotProtocol));
+    }
+    if (snapshot->function_count + functions > snapshot->function_capacity)
+    {
+        snapshot->function_capacity = (snapshot->function_count + functions) * 2;
+        snapshot->functions = realloc(snapshot->functions, snapshot->function_capacity * sizeof(SubGhzToolkitSnapshotFunction));
+    }
+    if (snapshot->names_size + name_size > snapshot->names_capacity)
+    {
+        snapshot->names_capacity = (snapshot->names_size + name_size) * 2;
+        snapshot->names = realloc(snapshot->names, snapshot->names_capacity);
+    }
+}
+
+// Hash the functions behind `functions` into entries[], one per pointer set, and set a bit in `mask` for each.
+// Returns the number hashed; an unreadable pointer still gets an entry, with an empty body.
+static size_t subghz_toolkit_snapshot_hash_functions(
+    const uint32_t functions[SubGhzToolkitFunctionSlotCount],
+    SubGhzToolkitFunctionCache *cache,
+    SubGhzToolkitCodeAt code_at,
+    void *context,
+    uint16_t owner,
+    SubGhzToolkitSnapshotFunction *entries,
+    uint16_t *mask)
+{
+    size_t hashed = 0;
+    *mask = 0;
+
+    for (size_t slot = 0; slot < SubGhzToolkitFunctionSlotCount; slot++)
+    {
+        if (!functions[slot])
+            continue;
+
+        SubGhzToolkitSnapshotFunction *entry = entries++;
+        entry->size = 0;
+        entry->hash = 0;
+        *mask |= 1u << slot;
+
+        const SubGhzToolkitFunction *function =
+            subghz_toolkit_protocol_function(cache, code_at, context, functions[slot], owner, slot, NULL);
+        size_t size = 0;
+        const uint8_t *code = function ? code_at(context, function->address, &size) : NULL;
+        if (!code)
+            continue;
+
+        entry->size = function->size;
+        entry->hash = subghz_toolkit_snapshot_hash_function(code, function);
+        hashed++;
+    }
+
+    return hashed;
+}
+
+// Insert keeping the protocols sorted by name. Registries hold a few hundred at most.
+static SubGhzToolkitSnapshotProtocol *subghz_toolkit_snapshot_insert(SubGhzToolkitSnapshot *snapshot, const char *name)
+{
+    size_t name_size = strlen(name) + 1;
+    subghz_toolkit_snapshot_reserve(snapshot, SubGhzToolkitFunctionSlotCount, name_size);
+
+    size_t i = snapshot->protocol_count;
+    while (i && strcmp(subghz_toolkit_snapshot_name(snapshot, &snapshot->protocols[i - 1]), name) > 0)
+        i--;
+    memmove(&snapshot->protocols[i + 1], &snapshot->protocols[i], (snapshot->protocol_count - i) * sizeof(SubGhzToolkitSnapshotProtocol));
+    snapshot->protocol_count++;
+
+    SubGhzToolkitSnapshotProtocol *protocol = &snapshot->protocols[i];
+    memset(protocol, 0, sizeof(*protocol));
+    protocol->name = snapshot->names_size;
+    protocol->first = snapshot->function_count;
+    memcpy(snapshot->names + snapshot->names_size, name, name_size);
+    snapshot->names_size += name_size;
+    return protocol;
+}
+
+size_t subghz_toolkit_snapshot_add_protocol(
+    SubGhzToolkitSnapshot *snapshot,
+    const char *name,
+    uint32_t type,
+    uint32_t flag,
+    const uint32_t functions[SubGhzToolkitFunctionSlotCount],
+    SubGhzToolkitFunctionCache *cache,
+    SubGhzToolkitCodeAt code_at,
+    void *context,
+    uint16_t owner)
+{
+    SubGhzToolkitSnapshotProtocol *protocol = subghz_toolkit_snapshot_insert(snapshot, name);
+    protocol->type = type;
+    protocol->flag = flag;
+
+    size_t hashed = subghz_toolkit_snapshot_hash_functions(
+        functions, cache, code_at, context, owner, &snapshot->functions[snapshot->function_count], &protocol->mask);
+    for (uint16_t mask = protocol->mask; mask; mask &= mask - 1)
+        snapshot->function_count++;
+
+    return hashed;
+}
+
+uint32_t subghz_toolkit_snapshot_hash_protocol(
+    const char *name,
+    uint32_t type,
+    uint32_t flag,
+    const uint32_t functions[SubGhzToolkitFunctionSlotCount],
+    SubGhzToolkitFunctionCache *cache,
+    SubGhzToolkitCodeAt code_at,
+    void *context,
+    uint16_t owner)
+{
+    SubGhzToolkitSnapshotFunction entries[SubGhzToolkitFunctionSlotCount];
+    uint16_t mask;
+    subghz_toolkit_snapshot_hash_functions(functions, cache, code_at, context, owner, entries, &mask);
+
+    uint32_t hash = subghz_toolkit_name_hash(name);
+    hash = subghz_toolkit_snapshot_mix(hash, type);
+    hash = subghz_toolkit_snapshot_mix(hash, flag);
+    hash = subghz_toolkit_snapshot_mix(hash, mask);
+
+    const SubGhzToolkitSnapshotFunction *entry = entries;
+    for (; mask; mask &= mask - 1, entry++)
+    {
+        hash = subghz_toolkit_snapshot_mix(hash, entry->size);
+        hash = subghz_toolkit_snapshot_mix(hash, entry->hash);
+    }
+    return hash;
+}
+
+void subghz_toolkit_snapshot_save(const SubGhzToolkitSnapshot *snapshot, SubGhzToolkitWriter *writer)
+{
+    uint8_t header[SUBGHZ_TOOLKIT_SNAPSHOT_HEADER_SIZE] = {0};
+    subghz_toolkit_snapshot_put_u32(header, SUBGHZ_TOOLKIT_SNAPSHOT_MAGIC);
+    header[4] = SUBGHZ_TOOLKIT_SNAPSHOT_VERSION;
+    subghz_toolkit_snapshot_put_u16(header + 6, snapshot->protocol_count);
+    subghz_toolkit_snapshot_put_u32(header + 8, snapshot->function_count);
+    subghz_toolkit_snapshot_put_u32(header + 12, snapshot->names_size);
+    memcpy(header + 16, snapshot->githash, strlen(snapshot->githash));
+    subghz_toolkit_writer_write(writer, header, sizeof(header));
+
+    for (size_t i = 0; i < snapshot->protocol_count; i++)
+    {
+        const SubGhzToolkitSnapshotProtocol *protocol = &snapshot->protocols[i];
+        uint8_t record[SUBGHZ_TOOLKIT_SNAPSHOT_PROTOCOL_SIZE] = {0};
+        subghz_toolkit_snapshot_put_u32(record, protocol->name);
+        subghz_toolkit_snapshot_put_u32(record + 4, protocol->flag);
+        record[8] = protocol->type;
+        subghz_toolkit_snapshot_put_u16(record + 10, protocol->mask);
+        subghz_toolkit_writer_write(writer, record, sizeof(record));
+    }
+
+    // In protocol order, so a loaded snapshot finds them by counting mask bits
+    for (size_t i = 0; i < snapshot->protocol_count; i++)
+    {
+        const SubGhzToolkitSnapshotProtocol *protocol = &snapshot->protocols[i];
+        const SubGhzToolkitSnapshotFunction *function = &snapshot->functions[protocol->first];
+        for (uint16_t mask = protocol->mask; mask; mask &= mask - 1, function++)
+        {
+            uint8_t record[SUBGHZ_TOOLKIT_SNAPSHOT_FUNCTION_SIZE] = {0};
+            subghz_toolkit_snapshot_put_u16(record, function->size);
+            subghz_toolkit_snapshot_put_u32(record + 4, function->hash);
+            subghz_toolkit_writer_write(writer, record, sizeof(record));
+        }
+    }
+
+    subghz_toolkit_writer_write(writer, snapshot->names, snapshot->names_size);
+}
+
+SubGhzToolkitSnapshot *subghz_toolkit_snapshot_load(const uint8_t *data, size_t size)
+{
+    if (size < SUBGHZ_TOOLKIT_SNAPSHOT_HEADER_SIZE || subghz_toolkit_snapshot_u32(data) != SUBGHZ_TOOLKIT_SNAPSHOT_MAGIC ||
+        data[4] != SUBGHZ_TOOLKIT_SNAPSHOT_VERSION)
+        return NULL;
+
+    size_t protocol_count = subghz_toolkit_snapshot_u16(data + 6);
+    size_t function_count = subghz_toolkit_snapshot_u32(data + 8);
+    size_t names_size = subghz_toolkit_snapshot_u32(data + 12);
+    size_t functions_offset = SUBGHZ_TOOLKIT_SNAPSHOT_HEADER_SIZE + protocol_count * SUBGHZ_TOOLKIT_SNAPSHOT_PROTOCOL_SIZE;
+    if (function_count > size / SUBGHZ_TOOLKIT_SNAPSHOT_FUNCTION_SIZE || functions_offset > size)
+        return NULL;
+    size_t names_offset = functions_offset + function_count * SUBGHZ_TOOLKIT_SNAPSHOT_FUNCTION_SIZE;
+    if (names_offset > size || names_size != size - names_offset || (names_size && data[size - 1]))
+        return NULL;
+
+    char githash[SUBGHZ_TOOLKIT_SNAPSHOT_GITHASH_SIZE + 1] = {0};
+    memcpy(githash, data + 16, SUBGHZ_TOOLKIT_SNAPSHOT_GITHASH_SIZE);
+
+    SubGhzToolkitSnapshot *snapshot = subghz_toolkit_snapshot_alloc(githash);
+    snapshot->protocols = malloc((protocol_count ? protocol_count : 1) * sizeof(SubGhzToolkitSnapshotProtocol));
+    snapshot->protocol_capacity = protocol_count;
+    snapshot->functions = malloc((function_count ? function_count : 1) * sizeof(SubGhzToolkitSnapshotFunction));
+    snapshot->function_capacity = function_count;
+    snapshot->names = malloc(names_size ? names_size : 1);
+    snapshot->names_capacity = names_size;
+    memcpy(snapshot->names, data + names_offset, names_size);
+    snapshot->names_size = names_size;
+
+    bool valid = true;
+    for (size_t i = 0; i < protocol_count && valid; i++)
+    {
+        const uint8_t *record = data + SUBGHZ_TOOLKIT_SNAPSHOT_HEADER_SIZE + i * SUBGHZ_TOOLKIT_SNAPSHOT_PROTOCOL_SIZE;
+        SubGhzToolkitSnapshotProtocol *protocol = &snapshot->protocols[i];
+        protocol->name = subghz_toolkit_snapshot_u32(record);
+        protocol->flag = subghz_toolkit_snapshot_u32(record + 4);
+        protocol->type = record[8];
+        protocol->mask = subghz_toolkit_snapshot_u16(record + 10);
+        protocol->first = snapshot->function_count;
+
+        // The diff relies on the order, so an unsorted file is as bad as a truncated one
+        valid = protocol->name < names_size && (protocol->mask >> SubGhzToolkitFunctionSlotCount) == 0 &&
+                (!i || strcmp(subghz_toolkit_snapshot_name(snapshot, protocol - 1), subghz_toolkit_snapshot_name(snapshot, protocol)) <= 0);
+
+        for (uint16_t mask = protocol->mask; mask && valid; mask &= mask - 1)
+        {
+            if (snapshot->function_count == function_count)
+            {
+                valid = false;
+                break;
+            }
+            const uint8_t *entry = data + functions_offset + snapshot->function_count * SUBGHZ_TOOLKIT_SNAPSHOT_FUNCTION_SIZE;
+            snapshot->functions[snapshot->function_count].size = subghz_toolkit_snapshot_u16(entry);
+            snapshot->functions[snapshot->function_count].hash = subghz_toolkit_snapshot_u32(entry + 4);
+            snapshot->function_count++;
+        }
+        snapshot->protocol_count++;
+    }
+
+    if (!valid || snapshot->function_count != function_count)
+    {
+        subghz_toolkit_snapshot_free(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+static const char *subghz_toolkit_snapshot_type_name(uint8_t type)
+{
+    return type == SUBGHZ_TOOLKIT_PROTOCOL_TYPE_STATIC ? "Static" : type == SUBGHZ_TOOLKIT_PROTOCOL_TYPE_DYNAMIC ? "Dynamic"
+                                                                                                              : "RAW";
+}
+
+// Report the differences of one protocol present in both, false if there are none
+static bool subghz_toolkit_snapshot_diff_protocol(
+    const SubGhzToolkitSnapshot *old,
+    const SubGhzToolkitSnapshotProtocol *a,
+    const SubGhzToolkitSnapshot *new,
+    const SubGhzToolkitSnapshotProtocol *b,
+    SubGhzToolkitWriter *writer,
+    SubGhzToolkitSnapshotDiff *diff)
+{
+    bool changed = false;
+    const SubGhzToolkitSnapshotFunction *fa = &old->functions[a->first];
+    const SubGhzToolkitSnapshotFunction *fb = &new->functions[b->first];
+
+    for (size_t slot = 0; slot < SubGhzToolkitFunctionSlotCount; slot++)
+    {
+        bool in_a = a->mask & (1u << slot);
+        bool in_b = b->mask & (1u << slot);
+        bool same = in_a == in_b && (!in_a || (fa->size == fb->size && fa->hash == fb->hash));
+
+        if (!same)
+        {
+            if (!changed)
+                subghz_toolkit_writer_printf(writer, "~ %s\n", subghz_toolkit_snapshot_name(new, b));
+            changed = true;
+            diff->functions_changed++;
+
+            const char *slot_name = subghz_toolkit_function_slot_names[slot];
+            if (!in_a)
+                subghz_toolkit_writer_printf(writer, "    + %s (%u bytes)\n", slot_name, fb->size);
+            else if (!in_b)
+                subghz_toolkit_writer_printf(writer, "    - %s (%u bytes)\n", slot_name, fa->size);
+            else if (fa->size != fb->size)
+                subghz_toolkit_writer_printf(writer, "    ~ %s: %u -> %u bytes\n", slot_name, fa->size, fb->size);
+            else
+                subghz_toolkit_writer_printf(writer, "    ~ %s: code changed, %u bytes\n", slot_name, fb->size);
+        }
+
+        fa += in_a;
+        fb += in_b;
+    }
+
+    if (a->type != b->type || a->flag != b->flag)
+    {
+        if (!changed)
+            subghz_toolkit_writer_printf(writer, "~ %s\n", subghz_toolkit_snapshot_name(new, b));
+        changed = true;
+        subghz_toolkit_writer_printf(writer, "    type %s -> %s, flag 0x%08lX -> 0x%08lX\n",
+                                     subghz_toolkit_snapshot_type_name(a->type),
+                                     subghz_toolkit_snapshot_type_name(b->type),
+                                     (unsigned long)a->flag,
+                                     (unsigned long)b->flag);
+    }
+
+    return changed;
+}
+
+void subghz_toolkit_snapshot_diff(
+    const SubGhzToolkitSnapshot *old,
+    const SubGhzToolkitSnapshot *new,
+    SubGhzToolkitWriter *writer,
+    SubGhzToolkitSnapshotDiff *diff)
+{
+    memset(diff, 0, sizeof(*diff));
+    subghz_toolkit_writer_printf(writer, "Firmware %s -> %s\n\n", old->githash, new->githash);
+
+    // Both lists are sorted by name: one merge finds every pair and every orphan
+    size_t i = 0;
+    size_t j = 0;
+    while (i < old->protocol_count || j < new->protocol_count)
+    {
+        const SubGhzToolkitSnapshotProtocol *a = i < old->protocol_count ? &old->protocols[i] : NULL;
+        const SubGhzToolkitSnapshotProtocol *b = j < new->protocol_count ? &new->protocols[j] : NULL;
+        int order = !a ? 1 : !b ? -1 : strcmp(subghz_toolkit_snapshot_name(old, a), subghz_toolkit_snapshot_name(new, b));
+
+        if (order < 0)
+        {
+            subghz_toolkit_writer_printf(writer, "- %s\n", subghz_toolkit_snapshot_name(old, a));
+            diff->removed++;
+            i++;
+        }
+        else if (order > 0)
+        {
+            subghz_toolkit_writer_printf(writer, "+ %s (%s)\n", subghz_toolkit_snapshot_name(new, b), subghz_toolkit_snapshot_type_name(b->type));
+            diff->added++;
+            j++;
+        }
+        else
+        {
+            if (subghz_toolkit_snapshot_diff_protocol(old, a, new, b, writer, diff))
+                diff->changed++;
+            else
+                diff->unchanged++;
+            i++;
+            j++;
+        }
+    }
+
+    subghz_toolkit_writer_printf(writer,
+                                 "\n%lu added, %lu removed, %lu changed (%lu functions), %lu unchanged\n",
+                                 (unsigned long)diff->added,
+                                 (unsigned long)diff->removed,
+                                 (unsigned long)diff->changed,
+                                 (unsigned long)diff->functions_changed,
+                                 (unsigned long)diff->unchanged);
+}
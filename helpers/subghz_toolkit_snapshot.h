@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_function.h"
+#include "subghz_toolkit_protocol.h"
+#include "subghz_toolkit_writer.h"
+
+// Compact per-firmware fingerprint of the protocol registry, and a diff of two.
+//
+// Every protocol function is hashed over its instructions with everything the
+// linker decides masked out: BL / B.W offsets to other functions, the PC
+// relative offsets of LDR literal and ADR (they change with the alignment of
+// the literal pool), and literal words and MOVW/MOVT pairs that hold flash or
+// RAM addresses. A literal load is hashed with the constant it loads instead.
+// Moving code around, by as little as a halfword, therefore keeps the hash,
+// while a changed instruction or constant changes it.
+//
+// File layout, little endian:
+//
+//   header     "SGFS", u8 version, u8 reserved, u16 protocol count,
+//              u32 function count, u32 names size, char githash[16]
+//   protocols  count x {u32 name offset, u32 flag, u8 type, u8 reserved, u16 slot mask}, sorted by name
+//   functions  one {u16 size, u16 reserved, u32 hash} per set mask bit, protocol by protocol
+//   names      NUL terminated
+//
+// Protocols are kept sorted by name, so a diff is a single merge of the two lists.
+
+#define SUBGHZ_TOOLKIT_SNAPSHOT_VERSION 2 // 2: literal loads hashed by value
+#define SUBGHZ_TOOLKIT_SNAPSHOT_GITHASH_SIZE 16
+
+// Values in these ranges are link time addresses and are masked (STM32WB55 flash and SRAM)
+#define SUBGHZ_TOOLKIT_SNAPSHOT_FLASH_START 0x08000000u
+#define SUBGHZ_TOOLKIT_SNAPSHOT_FLASH_END 0x08100000u
+#define SUBGHZ_TOOLKIT_SNAPSHOT_RAM_START 0x20000000u
+#define SUBGHZ_TOOLKIT_SNAPSHOT_RAM_END 0x20040000u
+
+typedef struct SubGhzToolkitSnapshot SubGhzToolkitSnapshot;
+
+typedef struct
+{
+    uint32_t added;
+    uint32_t removed;
+    uint32_t changed;
+    uint32_t unchanged;
+    uint32_t functions_changed; // includes functions added to or removed from a kept protocol
+} SubGhzToolkitSnapshotDiff;
+
+/** Hash of an analyzed function at code[0..function->size), relocations masked */
+uint32_t subghz_toolkit_snapshot_hash_function(const uint8_t *code, const SubGhzToolkitFunction *function);
+
+SubGhzToolkitSnapshot *subghz_toolkit_snapshot_alloc(const char *githash);
+
+void subghz_toolkit_snapshot_free(SubGhzToolkitSnapshot *snapshot);
+
+const char *subghz_toolkit_snapshot_githash(const SubGhzToolkitSnapshot *snapshot);
+
+size_t subghz_toolkit_snapshot_protocol_count(const SubGhzToolkitSnapshot *snapshot);
+
+/** Hash every function of a protocol (pointer values as stored, 0 if none) and add it. Returns the functions hashed. */
+size_t subghz_toolkit_snapshot_add_protocol(
+    SubGhzToolkitSnapshot *snapshot,
+    const char *name,
+    uint32_t type,
+    uint32_t flag,
+    const uint32_t functions[SubGhzToolkitFunctionSlotCount],
+    SubGhzToolkitFunctionCache *cache,
+    SubGhzToolkitCodeAt code_at,
+    void *context,
+    uint16_t owner);
+
+/** One hash over a protocol's name, type, flag and functions, as add_protocol() would record them */
+uint32_t subghz_toolkit_snapshot_hash_protocol(
+    const char *name,
+    uint32_t type,
+    uint32_t flag,
+    const uint32_t functions[SubGhzToolkitFunctionSlotCount],
+    SubGhzToolkitFunctionCache *cache,
+    SubGhzToolkitCodeAt code_at,
+    void *context,
+    uint16_t owner);
+
+void subghz_toolkit_snapshot_save(const SubGhzToolkitSnapshot *snapshot, SubGhzToolkitWriter *writer);
+
+/** Parse a saved snapshot, copying what it needs. NULL if `data` is not a valid one. */
+SubGhzToolkitSnapshot *subghz_toolkit_snapshot_load(const uint8_t *data, size_t size);
+
+/** Write the protocols added, removed and changed from `old` to `new`, one merge pass over both */
+void subghz_toolkit_snapshot_diff(
+    const SubGhzToolkitSnapshot *old,
+    const SubGhzToolkitSnapshot *new,
+    SubGhzToolkitWriter *writer,
+    SubGhzToolkitSnapshotDiff *diff);
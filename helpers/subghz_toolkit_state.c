@@ -0,0 +1,190 @@
+#include "subghz_toolkit_state.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SUBGHZ_TOOLKIT_STATE_HEAP4_ALLOCATED 0x80000000u
+#define SUBGHZ_TOOLKIT_STATE_HEAP4_HEADER 8 // BlockLink_t in front of the block
+#define SUBGHZ_TOOLKIT_STATE_TLSF_FREE 0x1u
+#define SUBGHZ_TOOLKIT_STATE_TLSF_FLAGS 0x3u
+#define SUBGHZ_TOOLKIT_STATE_MIN_BLOCK 12 // SubGhzProtocolDecoderBase
+#define SUBGHZ_TOOLKIT_STATE_MAJORITY 8 // tenths of the changes a kind must explain
+#define SUBGHZ_TOOLKIT_STATE_ENUM_MAX 255
+
+size_t subghz_toolkit_state_block_size(const void *instance, size_t heap_delta)
+{
+    uint32_t header = ((const uint32_t *)instance)[-1];
+
+    if (header & SUBGHZ_TOOLKIT_STATE_HEAP4_ALLOCATED)
+    {
+        size_t size = (header & ~SUBGHZ_TOOLKIT_STATE_HEAP4_ALLOCATED) - SUBGHZ_TOOLKIT_STATE_HEAP4_HEADER;
+        if (size >= SUBGHZ_TOOLKIT_STATE_MIN_BLOCK && size <= heap_delta)
+            return size;
+    }
+    if (!(header & SUBGHZ_TOOLKIT_STATE_TLSF_FREE))
+    {
+        size_t size = header & ~SUBGHZ_TOOLKIT_STATE_TLSF_FLAGS;
+        if (size >= SUBGHZ_TOOLKIT_STATE_MIN_BLOCK && size <= heap_delta)
+            return size;
+    }
+    return 0;
+}
+
+void subghz_toolkit_state_trace_init(SubGhzToolkitStateTrace *trace, const void *instance, size_t size)
+{
+    if (size > SUBGHZ_TOOLKIT_STATE_MAX_SIZE)
+        size = SUBGHZ_TOOLKIT_STATE_MAX_SIZE;
+
+    memset(trace, 0, sizeof(*trace));
+    trace->instance = instance;
+    trace->word_count = size / 4;
+    trace->size = trace->word_count * 4;
+    trace->snapshot = malloc(trace->size ? trace->size : 4);
+    trace->words = malloc((trace->word_count ? trace->word_count : 1) * sizeof(SubGhzToolkitStateWord));
+    memcpy(trace->snapshot, instance, trace->size);
+    memset(trace->words, 0, trace->word_count * sizeof(SubGhzToolkitStateWord));
+
+    for (size_t i = 0; i < trace->word_count; i++)
+    {
+        SubGhzToolkitStateWord *word = &trace->words[i];
+        word->initial = word->min = word->max = word->values[0] = trace->snapshot[i];
+        word->value_count = 1;
+    }
+}
+
+void subghz_toolkit_state_trace_deinit(SubGhzToolkitStateTrace *trace)
+{
+    free(trace->snapshot);
+    free(trace->words);
+    memset(trace, 0, sizeof(*trace));
+}
+
+static void subghz_toolkit_state_word_change(SubGhzToolkitStateWord *word, uint32_t old, uint32_t value, uint32_t duration)
+{
+    uint32_t diff = old ^ value;
+
+    word->changes++;
+    word->increments += value == old + 1;
+    word->decrements += value == old - 1;
+    word->shifts += (value & ~1u) == old << 1 || (value & 0x7FFFFFFFu) == old >> 1;
+    word->cleared += !value;
+    word->durations += value == duration;
+    for (uint8_t byte = 0; byte < 4; byte++)
+    {
+        if (diff & (0xFFu << (byte * 8)))
+            word->bytes |= 1 << byte;
+    }
+
+    if (value < word->min)
+        word->min = value;
+    if (value > word->max)
+        word->max = value;
+    if (word->many_values)
+        return;
+    for (uint8_t i = 0; i < word->value_count; i++)
+    {
+        if (word->values[i] == value)
+            return;
+    }
+    if (word->value_count == SUBGHZ_TOOLKIT_STATE_VALUES)
+        word->many_values = true;
+    else
+        word->values[word->value_count++] = value;
+}
+
+void subghz_toolkit_state_trace_sample(SubGhzToolkitStateTrace *trace, uint32_t duration)
+{
+    const uint32_t *instance = (const uint32_t *)trace->instance;
+
+    trace->samples++;
+    for (size_t i = 0; i < trace->word_count; i++)
+    {
+        uint32_t value = instance[i];
+        if (value == trace->snapshot[i])
+            continue;
+        subghz_toolkit_state_word_change(&trace->words[i], trace->snapshot[i], value, duration);
+        trace->snapshot[i] = value;
+    }
+}
+
+// `count` plus the resets to 0 explain most of the word's changes
+static bool subghz_toolkit_state_explains(const SubGhzToolkitStateWord *word, uint32_t count)
+{
+    return count && (uint64_t)(count + word->cleared) * 10 >= (uint64_t)word->changes * SUBGHZ_TOOLKIT_STATE_MAJORITY;
+}
+
+SubGhzToolkitStateKind subghz_toolkit_state_word_kind(const SubGhzToolkitStateWord *word)
+{
+    if (!word->changes)
+        return SubGhzToolkitStateKindConstant;
+    if ((uint64_t)word->durations * 10 >= (uint64_t)word->changes * SUBGHZ_TOOLKIT_STATE_MAJORITY)
+        return SubGhzToolkitStateKindDuration;
+    // A counter runs one way and restarts at 0, an enum stepping 1 -> 2 -> 1 goes both.
+    // Small values step and shift alike (1 -> 2), a counter steps more often than it doubles.
+    uint32_t steps = word->increments > word->decrements ? word->increments : word->decrements;
+    if (steps >= word->shifts && subghz_toolkit_state_explains(word, steps))
+        return SubGhzToolkitStateKindCounter;
+    // 0 -> 1 -> 2 -> 1 also reads as shifts, a shift register soon has more values than an enum
+    if (!word->many_values && word->max <= SUBGHZ_TOOLKIT_STATE_ENUM_MAX)
+        return SubGhzToolkitStateKindEnum;
+    if (subghz_toolkit_state_explains(word, word->shifts))
+        return SubGhzToolkitStateKindShift;
+    return SubGhzToolkitStateKindData;
+}
+
+const char *subghz_toolkit_state_kind_name(SubGhzToolkitStateKind kind)
+{
+    static const char *const names[] = {
+        "constant",
+        "last duration",
+        "shift register",
+        "counter",
+        "state enum",
+        "data",
+    };
+    return kind <= SubGhzToolkitStateKindData ? names[kind] : "?";
+}
+
+void subghz_toolkit_state_trace_write_report(SubGhzToolkitWriter *writer, const SubGhzToolkitStateTrace *trace)
+{
+    size_t changing = 0;
+
+    subghz_toolkit_writer_printf(writer,
+                                 "    State Trace: %lu bytes over %lu feeds\n"
+                                 "      Offset  Changes  Bytes  Kind            Values\n",
+                                 (unsigned long)trace->size,
+                                 (unsigned long)trace->samples);
+    for (size_t i = 0; i < trace->word_count; i++)
+    {
+        const SubGhzToolkitStateWord *word = &trace->words[i];
+        SubGhzToolkitStateKind kind = subghz_toolkit_state_word_kind(word);
+        char bytes[5];
+
+        // Byte 0 first, the way the word sits in memory
+        for (uint8_t byte = 0; byte < 4; byte++)
+            bytes[byte] = (word->bytes & (1 << byte)) ? 'X' : '.';
+        bytes[4] = '\0';
+
+        subghz_toolkit_writer_printf(writer, "      +%03u    %-7lu  %s   %-14s  ",
+                                     (unsigned)(i * 4), (unsigned long)word->changes, bytes, subghz_toolkit_state_kind_name(kind));
+        if (kind == SubGhzToolkitStateKindConstant)
+        {
+            subghz_toolkit_writer_printf(writer, "0x%08lX\n", (unsigned long)word->initial);
+            continue;
+        }
+
+        changing++;
+        if (kind == SubGhzToolkitStateKindEnum)
+        {
+            for (uint8_t v = 0; v < word->value_count; v++)
+                subghz_toolkit_writer_printf(writer, "%s%lu", v ? "," : "", (unsigned long)word->values[v]);
+            subghz_toolkit_writer_cstr(writer, "\n");
+        }
+        else
+        {
+            subghz_toolkit_writer_printf(writer, "0x%lX..0x%lX\n", (unsigned long)word->min, (unsigned long)word->max);
+        }
+    }
+    subghz_toolkit_writer_printf(writer, "      %lu of %lu words change while decoding\n",
+                                 (unsigned long)changing, (unsigned long)trace->word_count);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_writer.h"
+
+// Decoder instance size and state layout, measured rather than read from headers.
+//
+// subghz_toolkit_state_block_size() reads the allocator's header in front of
+// an instance: FreeRTOS heap_4 keeps the block size with the allocated flag in
+// the top bit, TLSF the usable size with flags in the low two bits. Either is
+// accepted only when it fits the heap free-space delta measured around
+// alloc(), which also covers any buffers the decoder allocates itself.
+//
+// The trace snapshots an instance after every feed() and classifies each
+// 32-bit word from how it changed:
+//
+//   constant        never changed (protocol pointer, callbacks, timing)
+//   last duration   takes the duration just fed (te_last)
+//   shift register  shifted by one bit with a bit in, or cleared (decode_data)
+//   counter         stepped by one the same way, or cleared (decode_count_bit)
+//   state enum      a handful of small values, back and forth (parser_step)
+//   data            anything else
+//
+// Words are checked whole, the byte mask shows which bytes of a word changed
+// so packed uint8_t fields sharing a word can be told apart.
+
+#define SUBGHZ_TOOLKIT_STATE_MAX_SIZE 512 // bytes traced per instance
+#define SUBGHZ_TOOLKIT_STATE_VALUES 8 // distinct values kept per word to spot enums
+
+typedef enum
+{
+    SubGhzToolkitStateKindConstant,
+    SubGhzToolkitStateKindDuration,
+    SubGhzToolkitStateKindShift,
+    SubGhzToolkitStateKindCounter,
+    SubGhzToolkitStateKindEnum,
+    SubGhzToolkitStateKindData,
+} SubGhzToolkitStateKind;
+
+typedef struct
+{
+    uint32_t initial;
+    uint32_t changes;
+    uint32_t increments; // +1
+    uint32_t decrements; // -1
+    uint32_t shifts; // left or right by one, any bit in
+    uint32_t cleared; // changed to 0
+    uint32_t durations; // changed to the duration just fed
+    uint32_t min;
+    uint32_t max;
+    uint32_t values[SUBGHZ_TOOLKIT_STATE_VALUES];
+    uint8_t value_count;
+    bool many_values; // more than SUBGHZ_TOOLKIT_STATE_VALUES
+    uint8_t bytes; // bit n set when byte n of the word changed
+} SubGhzToolkitStateWord;
+
+typedef struct
+{
+    const uint8_t *instance;
+    size_t size; // bytes traced, a multiple of 4
+    size_t word_count;
+    uint32_t *snapshot;
+    SubGhzToolkitStateWord *words;
+    uint32_t samples;
+} SubGhzToolkitStateTrace;
+
+/** Usable size of the heap block at `instance`, 0 when the header does not fit within `heap_delta` */
+size_t subghz_toolkit_state_block_size(const void *instance, size_t heap_delta);
+
+/** Trace the first `size` bytes of `instance` (capped at SUBGHZ_TOOLKIT_STATE_MAX_SIZE), from its current contents */
+void subghz_toolkit_state_trace_init(SubGhzToolkitStateTrace *trace, const void *instance, size_t size);
+
+void subghz_toolkit_state_trace_deinit(SubGhzToolkitStateTrace *trace);
+
+/** Compare the instance with the last snapshot after feeding it `duration` */
+void subghz_toolkit_state_trace_sample(SubGhzToolkitStateTrace *trace, uint32_t duration);
+
+SubGhzToolkitStateKind subghz_toolkit_state_word_kind(const SubGhzToolkitStateWord *word);
+
+const char *subghz_toolkit_state_kind_name(SubGhzToolkitStateKind kind);
+
+/** Per-offset change map: changes, byte mask, kind and value range of every word */
+void subghz_toolkit_state_trace_write_report(SubGhzToolkitWriter *writer, const SubGhzToolkitStateTrace *trace);
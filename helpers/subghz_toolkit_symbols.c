@@ -0,0 +1,275 @@
+#include "subghz_toolkit_symbols.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SUBGHZ_TOOLKIT_SYMBOLS_MAGIC 0x59534753u // "SGSY"
+#define SUBGHZ_TOOLKIT_SYMBOLS_HEADER_SIZE 16
+#define SUBGHZ_TOOLKIT_SYMBOLS_RECORD_SIZE 12
+
+typedef struct
+{
+    uint32_t address; // looked up address, the key
+    uint32_t offset; // from the symbol start
+    uint32_t used; // lookup stamp of the last hit, 0 for an empty slot
+    bool found;
+    char name[SUBGHZ_TOOLKIT_SYMBOLS_NAME_MAX];
+} SubGhzToolkitSymbolsCacheEntry;
+
+struct SubGhzToolkitSymbols
+{
+    SubGhzToolkitSymbolsRead read;
+    void *context;
+    uint32_t count;
+    uint32_t anchor;
+    uint32_t names; // file offset of the name blob
+    uint32_t stamp;
+    uint32_t hits;
+    uint32_t misses;
+    SubGhzToolkitSymbolsCacheEntry cache[SUBGHZ_TOOLKIT_SYMBOLS_CACHE_SIZE];
+};
+
+typedef struct
+{
+    uint32_t address;
+    uint32_t size;
+    const char *name;
+    bool global;
+} SubGhzToolkitSymbolsBuildEntry;
+
+static uint32_t subghz_toolkit_symbols_u32(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void subghz_toolkit_symbols_put_u32(uint8_t *data, uint32_t value)
+{
+    data[0] = value;
+    data[1] = value >> 8;
+    data[2] = value >> 16;
+    data[3] = value >> 24;
+}
+
+// By address; at the same address globals first, then the larger symbol
+static int subghz_toolkit_symbols_compare(const void *a, const void *b)
+{
+    const SubGhzToolkitSymbolsBuildEntry *x = a;
+    const SubGhzToolkitSymbolsBuildEntry *y = b;
+    if (x->address != y->address)
+        return x->address < y->address ? -1 : 1;
+    if (x->global != y->global)
+        return x->global ? -1 : 1;
+    return x->size > y->size ? -1 : x->size < y->size;
+}
+
+size_t subghz_toolkit_symbols_build(const SubGhzToolkitElf *elf, uint32_t anchor, SubGhzToolkitWriter *writer)
+{
+    size_t total = subghz_toolkit_elf_symbol_count(elf);
+    SubGhzToolkitSymbolsBuildEntry *entries = malloc((total ? total : 1) * sizeof(SubGhzToolkitSymbolsBuildEntry));
+    size_t count = 0;
+
+    for (size_t i = 0; i < total; i++)
+    {
+        SubGhzToolkitElfSymbol symbol;
+        if (!subghz_toolkit_elf_symbol(elf, i, &symbol) || !symbol.section || !symbol.value || !symbol.name[0])
+            continue;
+        if (symbol.type != SUBGHZ_TOOLKIT_ELF_STT_FUNC && symbol.type != SUBGHZ_TOOLKIT_ELF_STT_OBJECT)
+            continue;
+
+        entries[count++] = (SubGhzToolkitSymbolsBuildEntry){
+            .address = symbol.type == SUBGHZ_TOOLKIT_ELF_STT_FUNC ? symbol.value & ~1u : symbol.value,
+            .size = symbol.size,
+            .name = symbol.name,
+            .global = symbol.binding == SUBGHZ_TOOLKIT_ELF_STB_GLOBAL,
+        };
+    }
+
+    qsort(entries, count, sizeof(SubGhzToolkitSymbolsBuildEntry), subghz_toolkit_symbols_compare);
+
+    // One symbol per address: aliases would make lookups ambiguous
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!unique || entries[unique - 1].address != entries[i].address)
+            entries[unique++] = entries[i];
+    }
+
+    uint8_t header[SUBGHZ_TOOLKIT_SYMBOLS_HEADER_SIZE] = {0};
+    subghz_toolkit_symbols_put_u32(header, SUBGHZ_TOOLKIT_SYMBOLS_MAGIC);
+    header[4] = SUBGHZ_TOOLKIT_SYMBOLS_VERSION;
+    subghz_toolkit_symbols_put_u32(header + 8, unique);
+    subghz_toolkit_symbols_put_u32(header + 12, anchor);
+    subghz_toolkit_writer_write(writer, header, sizeof(header));
+
+    uint32_t name_offset = 0;
+    for (size_t i = 0; i < unique; i++)
+    {
+        uint8_t record[SUBGHZ_TOOLKIT_SYMBOLS_RECORD_SIZE];
+        subghz_toolkit_symbols_put_u32(record, entries[i].address);
+        subghz_toolkit_symbols_put_u32(record + 4, entries[i].size);
+        subghz_toolkit_symbols_put_u32(record + 8, name_offset);
+        subghz_toolkit_writer_write(writer, record, sizeof(record));
+        name_offset += strlen(entries[i].name) + 1;
+    }
+
+    for (size_t i = 0; i < unique; i++)
+        subghz_toolkit_writer_write(writer, entries[i].name, strlen(entries[i].name) + 1);
+
+    free(entries);
+    return unique;
+}
+
+SubGhzToolkitSymbols *subghz_toolkit_symbols_open(SubGhzToolkitSymbolsRead read, void *context)
+{
+    uint8_t header[SUBGHZ_TOOLKIT_SYMBOLS_HEADER_SIZE];
+    if (read(context, 0, header, sizeof(header)) != sizeof(header) || subghz_toolkit_symbols_u32(header) != SUBGHZ_TOOLKIT_SYMBOLS_MAGIC ||
+        header[4] != SUBGHZ_TOOLKIT_SYMBOLS_VERSION)
+        return NULL;
+
+    SubGhzToolkitSymbols *symbols = malloc(sizeof(SubGhzToolkitSymbols));
+    memset(symbols, 0, sizeof(*symbols));
+    symbols->read = read;
+    symbols->context = context;
+    symbols->count = subghz_toolkit_symbols_u32(header + 8);
+    symbols->anchor = subghz_toolkit_symbols_u32(header + 12);
+    symbols->names = SUBGHZ_TOOLKIT_SYMBOLS_HEADER_SIZE + symbols->count * SUBGHZ_TOOLKIT_SYMBOLS_RECORD_SIZE;
+    return symbols;
+}
+
+void subghz_toolkit_symbols_free(SubGhzToolkitSymbols *symbols)
+{
+    free(symbols);
+}
+
+uint32_t subghz_toolkit_symbols_count(const SubGhzToolkitSymbols *symbols)
+{
+    return symbols->count;
+}
+
+uint32_t subghz_toolkit_symbols_anchor(const SubGhzToolkitSymbols *symbols)
+{
+    return symbols->anchor;
+}
+
+static bool subghz_toolkit_symbols_record(const SubGhzToolkitSymbols *symbols, uint32_t index, uint32_t record[3])
+{
+    uint8_t data[SUBGHZ_TOOLKIT_SYMBOLS_RECORD_SIZE];
+    uint32_t offset = SUBGHZ_TOOLKIT_SYMBOLS_HEADER_SIZE + index * SUBGHZ_TOOLKIT_SYMBOLS_RECORD_SIZE;
+    if (symbols->read(symbols->context, offset, data, sizeof(data)) != sizeof(data))
+        return false;
+
+    record[0] = subghz_toolkit_symbols_u32(data);
+    record[1] = subghz_toolkit_symbols_u32(data + 4);
+    record[2] = subghz_toolkit_symbols_u32(data + 8);
+    return true;
+}
+
+// Binary search of the records for the last symbol at or below `address`
+static void subghz_toolkit_symbols_resolve(SubGhzToolkitSymbols *symbols, SubGhzToolkitSymbolsCacheEntry *entry)
+{
+    uint32_t low = 0;
+    uint32_t high = symbols->count;
+    uint32_t record[3];
+    bool have = false;
+    uint32_t best[3];
+
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        if (!subghz_toolkit_symbols_record(symbols, mid, record))
+            return;
+        if (record[0] <= entry->address)
+        {
+            memcpy(best, record, sizeof(best));
+            have = true;
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    if (!have)
+        return;
+
+    uint32_t offset = entry->address - best[0];
+    uint32_t span = best[1] ? best[1] : SUBGHZ_TOOLKIT_SYMBOLS_UNSIZED_SPAN;
+    if (offset >= span)
+        return;
+
+    // One read covers the name; the last one ends at the end of the file
+    size_t length = symbols->read(symbols->context, symbols->names + best[2], entry->name, sizeof(entry->name) - 1);
+    entry->name[length] = '\0';
+
+    entry->offset = offset;
+    entry->found = entry->name[0] != '\0';
+}
+
+bool subghz_toolkit_symbols_lookup(SubGhzToolkitSymbols *symbols, uint32_t address, const char **name, uint32_t *offset)
+{
+    symbols->stamp++;
+
+    SubGhzToolkitSymbolsCacheEntry *entry = NULL;
+    SubGhzToolkitSymbolsCacheEntry *oldest = &symbols->cache[0];
+    for (size_t i = 0; i < SUBGHZ_TOOLKIT_SYMBOLS_CACHE_SIZE; i++)
+    {
+        SubGhzToolkitSymbolsCacheEntry *slot = &symbols->cache[i];
+        if (slot->used && slot->address == address)
+        {
+            entry = slot;
+            break;
+        }
+        if (slot->used < oldest->used)
+            oldest = slot;
+    }
+
+    if (entry)
+    {
+        symbols->hits++;
+    }
+    else
+    {
+        // Evict the least recently used entry; misses are cached too
+        symbols->misses++;
+        entry = oldest;
+        entry->address = address;
+        entry->found = false;
+        subghz_toolkit_symbols_resolve(symbols, entry);
+    }
+    entry->used = symbols->stamp;
+
+    if (!entry->found)
+        return false;
+    *name = entry->name;
+    *offset = entry->offset;
+    return true;
+}
+
+void subghz_toolkit_symbols_write_address(SubGhzToolkitWriter *writer, SubGhzToolkitSymbols *symbols, uint32_t address)
+{
+    subghz_toolkit_writer_printf(writer, "0x%08lX", (unsigned long)address);
+    if (!symbols || !address)
+        return;
+
+    const char *name;
+    uint32_t offset;
+
+    // Function pointers carry the Thumb bit: an odd address at a symbol's start + 1 is that function
+    bool found = (address & 1) && subghz_toolkit_symbols_lookup(symbols, address & ~1u, &name, &offset) && !offset;
+    if (!found)
+        found = subghz_toolkit_symbols_lookup(symbols, address, &name, &offset);
+    if (!found)
+        return;
+
+    if (offset)
+        subghz_toolkit_writer_printf(writer, " <%s+0x%lX>", name, (unsigned long)offset);
+    else
+        subghz_toolkit_writer_printf(writer, " <%s>", name);
+}
+
+void subghz_toolkit_symbols_get_stats(const SubGhzToolkitSymbols *symbols, uint32_t *hits, uint32_t *misses)
+{
+    *hits = symbols->hits;
+    *misses = symbols->misses;
+}
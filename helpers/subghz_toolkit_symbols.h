@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_elf.h"
+#include "subghz_toolkit_writer.h"
+
+// Address to symbol+offset lookup for firmware pointers.
+//
+// A symbol file is built once from firmware.elf on the host:
+//
+//   header   "SGSY", u16 version, u16 reserved, u32 count, u32 anchor
+//   records  count x {u32 address, u32 size, u32 name offset}, sorted by address
+//   names    NUL terminated, offsets relative to the end of the records
+//
+// `anchor` is the address of subghz_protocol_registry in that build, so the
+// app can tell whether the file matches the running firmware. The file is
+// never loaded whole: lookups binary search the records through a read
+// callback (memory on the host, seek+read on the SD card) and the results of
+// recent lookups are kept in a small LRU cache, as the same handful of
+// helpers show up under every protocol.
+
+#define SUBGHZ_TOOLKIT_SYMBOLS_VERSION 1
+#define SUBGHZ_TOOLKIT_SYMBOLS_CACHE_SIZE 32
+#define SUBGHZ_TOOLKIT_SYMBOLS_NAME_MAX 64 // longer names are truncated in lookups
+#define SUBGHZ_TOOLKIT_SYMBOLS_UNSIZED_SPAN 256 // how far past a symbol without size it may match
+
+/** Read up to `size` bytes at `offset` of the symbol file, return the number read */
+typedef size_t (*SubGhzToolkitSymbolsRead)(void *context, uint32_t offset, void *data, size_t size);
+
+typedef struct SubGhzToolkitSymbols SubGhzToolkitSymbols;
+
+/** Write the symbol file for `elf`: its FUNC and OBJECT symbols, Thumb bit cleared. Returns the symbol count, 0 on error. */
+size_t subghz_toolkit_symbols_build(const SubGhzToolkitElf *elf, uint32_t anchor, SubGhzToolkitWriter *writer);
+
+/** Check the header of a symbol file. NULL if it is not one. */
+SubGhzToolkitSymbols *subghz_toolkit_symbols_open(SubGhzToolkitSymbolsRead read, void *context);
+
+void subghz_toolkit_symbols_free(SubGhzToolkitSymbols *symbols);
+
+uint32_t subghz_toolkit_symbols_count(const SubGhzToolkitSymbols *symbols);
+
+uint32_t subghz_toolkit_symbols_anchor(const SubGhzToolkitSymbols *symbols);
+
+/** Symbol containing `address`. `name` stays valid until the next lookup. */
+bool subghz_toolkit_symbols_lookup(SubGhzToolkitSymbols *symbols, uint32_t address, const char **name, uint32_t *offset);
+
+/** "0x%08lX", followed by " <name+0xoff>" when `symbols` is set and has a match. Thumb bit is ignored for the lookup. */
+void subghz_toolkit_symbols_write_address(SubGhzToolkitWriter *writer, SubGhzToolkitSymbols *symbols, uint32_t address);
+
+/** Cache hits and misses since open */
+void subghz_toolkit_symbols_get_stats(const SubGhzToolkitSymbols *symbols, uint32_t *hits, uint32_t *misses);
@@ -0,0 +1,484 @@
+#include "subghz_toolkit_thumb.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// 16 bit encodings are classified by their top byte with one table lookup;
+// the class decides which fields to extract.
+typedef enum
+{
+    Thumb16Other,
+    Thumb16MovImm,
+    Thumb16CmpImm,
+    Thumb16DataProc,
+    Thumb16Special,
+    Thumb16BxBlx,
+    Thumb16LdrLiteral,
+    Thumb16Adr,
+    Thumb16Cbz,
+    Thumb16Push,
+    Thumb16Pop,
+    Thumb16Hint,
+    Thumb16Undefined,
+    Thumb16BCond,
+    Thumb16B,
+    Thumb16Wide,
+} SubGhzToolkitThumb16Class;
+
+static const uint8_t subghz_toolkit_thumb16_class[256] = {
+    [0x20 ... 0x27] = Thumb16MovImm,
+    [0x28 ... 0x2F] = Thumb16CmpImm,
+    [0x40 ... 0x43] = Thumb16DataProc,
+    [0x44 ... 0x46] = Thumb16Special,
+    [0x47] = Thumb16BxBlx,
+    [0x48 ... 0x4F] = Thumb16LdrLiteral,
+    [0xA0 ... 0xA7] = Thumb16Adr,
+    [0xB1] = Thumb16Cbz,
+    [0xB3] = Thumb16Cbz,
+    [0xB9] = Thumb16Cbz,
+    [0xBB] = Thumb16Cbz,
+    [0xB4 ... 0xB5] = Thumb16Push,
+    [0xBC ... 0xBD] = Thumb16Pop,
+    [0xBE] = Thumb16Undefined, // BKPT
+    [0xBF] = Thumb16Hint,
+    [0xD0 ... 0xDD] = Thumb16BCond,
+    [0xDE] = Thumb16Undefined, // UDF
+    [0xE0 ... 0xE7] = Thumb16B,
+    [0xE8 ... 0xFF] = Thumb16Wide,
+};
+
+// 32 bit encodings of interest, matched in order on (first, second) halfword
+typedef struct
+{
+    uint16_t mask1;
+    uint16_t value1;
+    uint16_t mask2;
+    uint16_t value2;
+    uint8_t op;
+} SubGhzToolkitThumb32Pattern;
+
+static const SubGhzToolkitThumb32Pattern subghz_toolkit_thumb32_patterns[] = {
+    {0xF800, 0xF000, 0xD000, 0xD000, SubGhzToolkitThumbOpBl},
+    {0xF800, 0xF000, 0xD000, 0x9000, SubGhzToolkitThumbOpB}, // B.W T4
+    {0xF800, 0xF000, 0xD000, 0x8000, SubGhzToolkitThumbOpBCond}, // B<c>.W T3
+    {0xFFFF, 0xE92D, 0xA000, 0x0000, SubGhzToolkitThumbOpPush}, // STMDB sp!, {...}
+    {0xFFFF, 0xE8BD, 0x2000, 0x0000, SubGhzToolkitThumbOpPop}, // LDMIA sp!, {...}
+    {0xFFFF, 0xF84D, 0x0FFF, 0x0D04, SubGhzToolkitThumbOpPush}, // STR rt, [sp, #-4]!
+    {0xFFFF, 0xF85D, 0x0FFF, 0x0B04, SubGhzToolkitThumbOpPop}, // LDR rt, [sp], #4
+    {0xFF7F, 0xF85F, 0x0000, 0x0000, SubGhzToolkitThumbOpLdrLiteral},
+    {0xFBF0, 0xF240, 0x8000, 0x0000, SubGhzToolkitThumbOpMovw},
+    {0xFBF0, 0xF2C0, 0x8000, 0x0000, SubGhzToolkitThumbOpMovt},
+    {0xFBEF, 0xF04F, 0x8000, 0x0000, SubGhzToolkitThumbOpMovImm}, // MOV.W rd, #const
+    {0xFBF0, 0xF1B0, 0x8F00, 0x0F00, SubGhzToolkitThumbOpCmpImm}, // CMP.W rn, #const
+    {0xFFF0, 0xEBB0, 0xFFF0, 0x0F00, SubGhzToolkitThumbOpCmpReg}, // CMP.W rn, rm (imm3:imm2 and type 0, no shift)
+    {0xFFF0, 0xE8D0, 0xFFF0, 0xF000, SubGhzToolkitThumbOpTbb},
+    {0xFFF0, 0xE8D0, 0xFFF0, 0xF010, SubGhzToolkitThumbOpTbh},
+    {0xFFFF, 0xF3AF, 0xFF00, 0x8000, SubGhzToolkitThumbOpHint}, // NOP.W, YIELD.W, WFE.W, WFI.W, SEV.W
+};
+
+static const char *const subghz_toolkit_thumb_cond_names[16] =
+    {"eq", "ne", "cs", "cc", "mi", "pl", "vs", "vc", "hi", "ls", "ge", "lt", "gt", "le", "", ""};
+
+static const char *const subghz_toolkit_thumb_reg_names[16] =
+    {"r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7", "r8", "r9", "r10", "r11", "r12", "sp", "lr", "pc"};
+
+static uint32_t subghz_toolkit_thumb_sign_extend(uint32_t value, unsigned bits)
+{
+    uint32_t sign = 1u << (bits - 1);
+    return (value ^ sign) - sign;
+}
+
+// ThumbExpandImm: the 12 bit "modified immediate" of data processing instructions
+static uint32_t subghz_toolkit_thumb_expand_imm(uint32_t imm12)
+{
+    uint32_t imm8 = imm12 & 0xFF;
+
+    if ((imm12 >> 10) == 0)
+    {
+        switch ((imm12 >> 8) & 3)
+        {
+        case 0:
+            return imm8;
+        case 1:
+            return imm8 * 0x00010001u;
+        case 2:
+            return imm8 * 0x01000100u;
+        default:
+            return imm8 * 0x01010101u;
+        }
+    }
+
+    uint32_t value = 0x80 | (imm12 & 0x7F);
+    uint32_t rotate = imm12 >> 7;
+    return (value >> rotate) | (value << (32 - rotate));
+}
+
+static uint32_t subghz_toolkit_thumb_pc(const SubGhzToolkitThumbInsn *insn, bool aligned)
+{
+    uint32_t pc = insn->address + 4;
+    return aligned ? pc & ~3u : pc;
+}
+
+static void subghz_toolkit_thumb_decode16(SubGhzToolkitThumbInsn *insn, uint16_t hw)
+{
+    switch (subghz_toolkit_thumb16_class[hw >> 8])
+    {
+    case Thumb16MovImm:
+        insn->op = SubGhzToolkitThumbOpMovImm;
+        insn->rd = (hw >> 8) & 7;
+        insn->imm = hw & 0xFF;
+        break;
+    case Thumb16CmpImm:
+        insn->op = SubGhzToolkitThumbOpCmpImm;
+        insn->rd = (hw >> 8) & 7;
+        insn->imm = hw & 0xFF;
+        break;
+    case Thumb16DataProc:
+        if ((hw & 0xFFC0) == 0x4280)
+        {
+            insn->op = SubGhzToolkitThumbOpCmpReg;
+            insn->rd = hw & 7;
+            insn->rm = (hw >> 3) & 7;
+        }
+        break;
+    case Thumb16Special:
+        if ((hw & 0xFF00) == 0x4500 || (hw & 0xFF00) == 0x4600)
+        {
+            insn->op = (hw & 0xFF00) == 0x4500 ? SubGhzToolkitThumbOpCmpReg : SubGhzToolkitThumbOpMovReg;
+            insn->rd = ((hw >> 4) & 8) | (hw & 7);
+            insn->rm = (hw >> 3) & 15;
+        }
+        break;
+    case Thumb16BxBlx:
+        insn->op = (hw & 0x80) ? SubGhzToolkitThumbOpBlx : SubGhzToolkitThumbOpBx;
+        insn->rd = (hw >> 3) & 15;
+        break;
+    case Thumb16LdrLiteral:
+        insn->op = SubGhzToolkitThumbOpLdrLiteral;
+        insn->rd = (hw >> 8) & 7;
+        insn->imm = (hw & 0xFF) * 4;
+        insn->target = subghz_toolkit_thumb_pc(insn, true) + insn->imm;
+        break;
+    case Thumb16Adr:
+        insn->op = SubGhzToolkitThumbOpAdr;
+        insn->rd = (hw >> 8) & 7;
+        insn->imm = (hw & 0xFF) * 4;
+        insn->target = subghz_toolkit_thumb_pc(insn, true) + insn->imm;
+        break;
+    case Thumb16Cbz:
+        insn->op = (hw & 0x0800) ? SubGhzToolkitThumbOpCbnz : SubGhzToolkitThumbOpCbz;
+        insn->rd = hw & 7;
+        insn->target = subghz_toolkit_thumb_pc(insn, false) + ((((hw >> 9) & 1) << 6) | (((hw >> 3) & 0x1F) << 1));
+        break;
+    case Thumb16Push:
+        insn->op = SubGhzToolkitThumbOpPush;
+        insn->reglist = (hw & 0xFF) | ((hw & 0x100) ? 1u << SUBGHZ_TOOLKIT_THUMB_REG_LR : 0);
+        break;
+    case Thumb16Pop:
+        insn->op = SubGhzToolkitThumbOpPop;
+        insn->reglist = (hw & 0xFF) | ((hw & 0x100) ? 1u << SUBGHZ_TOOLKIT_THUMB_REG_PC : 0);
+        break;
+    case Thumb16Hint:
+        if (hw & 0x0F)
+        {
+            insn->op = SubGhzToolkitThumbOpIt;
+            insn->cond = (hw >> 4) & 15;
+            insn->it_mask = hw & 15;
+        }
+        else
+        {
+            insn->op = SubGhzToolkitThumbOpHint;
+            insn->imm = (hw >> 4) & 15;
+        }
+        break;
+    case Thumb16Undefined:
+        insn->op = SubGhzToolkitThumbOpUndefined;
+        break;
+    case Thumb16BCond:
+        insn->op = SubGhzToolkitThumbOpBCond;
+        insn->cond = (hw >> 8) & 15;
+        insn->target = subghz_toolkit_thumb_pc(insn, false) + subghz_toolkit_thumb_sign_extend((hw & 0xFF) << 1, 9);
+        break;
+    case Thumb16B:
+        insn->op = SubGhzToolkitThumbOpB;
+        insn->target = subghz_toolkit_thumb_pc(insn, false) + subghz_toolkit_thumb_sign_extend((hw & 0x7FF) << 1, 12);
+        break;
+    default:
+        break;
+    }
+}
+
+static void subghz_toolkit_thumb_decode32(SubGhzToolkitThumbInsn *insn, uint16_t hw1, uint16_t hw2)
+{
+    const SubGhzToolkitThumb32Pattern *pattern = NULL;
+    for (size_t i = 0; i < sizeof(subghz_toolkit_thumb32_patterns) / sizeof(subghz_toolkit_thumb32_patterns[0]); i++)
+    {
+        const SubGhzToolkitThumb32Pattern *p = &subghz_toolkit_thumb32_patterns[i];
+        // Conditions 14 and 15 of the B<c>.W space are the misc control instructions
+        if (p->op == SubGhzToolkitThumbOpBCond && ((hw1 >> 6) & 15) >= 14)
+            continue;
+        if ((hw1 & p->mask1) == p->value1 && (hw2 & p->mask2) == p->value2)
+        {
+            pattern = p;
+            break;
+        }
+    }
+    if (!pattern)
+        return;
+
+    uint32_t s = (hw1 >> 10) & 1;
+    uint32_t j1 = (hw2 >> 13) & 1;
+    uint32_t j2 = (hw2 >> 11) & 1;
+    uint32_t imm16 = ((hw1 & 0xF) << 12) | (((hw1 >> 10) & 1) << 11) | (((hw2 >> 12) & 7) << 8) | (hw2 & 0xFF);
+    uint32_t imm12 = (((hw1 >> 10) & 1) << 11) | (((hw2 >> 12) & 7) << 8) | (hw2 & 0xFF);
+
+    switch (pattern->op)
+    {
+    case SubGhzToolkitThumbOpBl:
+    case SubGhzToolkitThumbOpB:
+    {
+        uint32_t i1 = !(j1 ^ s);
+        uint32_t i2 = !(j2 ^ s);
+        uint32_t offset = (s << 24) | (i1 << 23) | (i2 << 22) | ((hw1 & 0x3FF) << 12) | ((hw2 & 0x7FF) << 1);
+        insn->target = subghz_toolkit_thumb_pc(insn, false) + subghz_toolkit_thumb_sign_extend(offset, 25);
+        break;
+    }
+    case SubGhzToolkitThumbOpBCond:
+    {
+        insn->cond = (hw1 >> 6) & 15;
+        uint32_t offset = (s << 20) | (j2 << 19) | (j1 << 18) | ((hw1 & 0x3F) << 12) | ((hw2 & 0x7FF) << 1);
+        insn->target = subghz_toolkit_thumb_pc(insn, false) + subghz_toolkit_thumb_sign_extend(offset, 21);
+        break;
+    }
+    case SubGhzToolkitThumbOpPush:
+    case SubGhzToolkitThumbOpPop:
+        insn->reglist = (hw1 >> 8) == 0xF8 ? 1u << (hw2 >> 12) : hw2; // single register STR/LDR forms
+        break;
+    case SubGhzToolkitThumbOpLdrLiteral:
+        insn->rd = hw2 >> 12;
+        insn->imm = hw2 & 0xFFF;
+        insn->target = subghz_toolkit_thumb_pc(insn, true) + ((hw1 & 0x80) ? insn->imm : -insn->imm);
+        break;
+    case SubGhzToolkitThumbOpMovw:
+    case SubGhzToolkitThumbOpMovt:
+        insn->rd = (hw2 >> 8) & 15;
+        insn->imm = imm16;
+        break;
+    case SubGhzToolkitThumbOpMovImm:
+        insn->rd = (hw2 >> 8) & 15;
+        insn->imm = subghz_toolkit_thumb_expand_imm(imm12);
+        break;
+    case SubGhzToolkitThumbOpCmpImm:
+        insn->rd = hw1 & 15;
+        insn->imm = subghz_toolkit_thumb_expand_imm(imm12);
+        break;
+    case SubGhzToolkitThumbOpCmpReg:
+    case SubGhzToolkitThumbOpTbb:
+    case SubGhzToolkitThumbOpTbh:
+        insn->rd = hw1 & 15;
+        insn->rm = hw2 & 15;
+        break;
+    case SubGhzToolkitThumbOpHint:
+        insn->imm = hw2 & 0xFF;
+        break;
+    default:
+        break;
+    }
+
+    insn->op = pattern->op;
+}
+
+bool subghz_toolkit_thumb_decode(const uint8_t *code, size_t size, uint32_t address, SubGhzToolkitThumbInsn *insn)
+{
+    if (size < 2)
+        return false;
+
+    memset(insn, 0, sizeof(*insn));
+    insn->address = address;
+
+    uint16_t hw1 = code[0] | (code[1] << 8);
+    insn->size = subghz_toolkit_thumb_insn_size(hw1);
+
+    if (insn->size == 2)
+    {
+        insn->raw = hw1;
+        subghz_toolkit_thumb_decode16(insn, hw1);
+        return true;
+    }
+
+    if (size < 4)
+        return false;
+
+    uint16_t hw2 = code[2] | (code[3] << 8);
+    insn->raw = ((uint32_t)hw1 << 16) | hw2;
+    subghz_toolkit_thumb_decode32(insn, hw1, hw2);
+    return true;
+}
+
+bool subghz_toolkit_thumb_is_return(const SubGhzToolkitThumbInsn *insn)
+{
+    switch (insn->op)
+    {
+    case SubGhzToolkitThumbOpBx:
+        return insn->rd == SUBGHZ_TOOLKIT_THUMB_REG_LR;
+    case SubGhzToolkitThumbOpPop:
+        return insn->reglist & (1u << SUBGHZ_TOOLKIT_THUMB_REG_PC);
+    case SubGhzToolkitThumbOpMovReg:
+        return insn->rd == SUBGHZ_TOOLKIT_THUMB_REG_PC && insn->rm == SUBGHZ_TOOLKIT_THUMB_REG_LR;
+    default:
+        return false;
+    }
+}
+
+const char *subghz_toolkit_thumb_op_name(SubGhzToolkitThumbOp op)
+{
+    static const char *const names[SubGhzToolkitThumbOpCount] = {
+        "OTHER",
+        "PUSH",
+        "POP",
+        "B",
+        "Bcc",
+        "BL",
+        "BX",
+        "BLX",
+        "CBZ",
+        "CBNZ",
+        "IT",
+        "LDR",
+        "ADR",
+        "MOV",
+        "MOVW",
+        "MOVT",
+        "MOV",
+        "CMP",
+        "CMP",
+        "TBB",
+        "TBH",
+        "HINT",
+        "UDF",
+    };
+    return op < SubGhzToolkitThumbOpCount ? names[op] : "?";
+}
+
+static size_t subghz_toolkit_thumb_format_reglist(uint16_t reglist, char *text, size_t text_size)
+{
+    size_t len = 0;
+    bool first = true;
+
+    len += snprintf(text + len, text_size - len, "{");
+    for (int r = 0; r < 16 && len < text_size; r++)
+    {
+        if (!(reglist & (1u << r)))
+            continue;
+
+        // Collapse runs of low registers: r4-r7
+        int end = r;
+        while (end < 12 && (reglist & (1u << (end + 1))))
+            end++;
+
+        len += snprintf(text + len, text_size - len, "%s%s", first ? "" : ", ", subghz_toolkit_thumb_reg_names[r]);
+        if (end > r + 1 && len < text_size)
+        {
+            len += snprintf(text + len, text_size - len, "-%s", subghz_toolkit_thumb_reg_names[end]);
+            r = end;
+        }
+        first = false;
+    }
+    if (len < text_size)
+        len += snprintf(text + len, text_size - len, "}");
+    return len;
+}
+
+void subghz_toolkit_thumb_format(const SubGhzToolkitThumbInsn *insn, char *text, size_t text_size)
+{
+    const char *rd = subghz_toolkit_thumb_reg_names[insn->rd & 15];
+    const char *rm = subghz_toolkit_thumb_reg_names[insn->rm & 15];
+    const char *wide = insn->size == 4 ? ".w" : "";
+
+    switch (insn->op)
+    {
+    case SubGhzToolkitThumbOpPush:
+    case SubGhzToolkitThumbOpPop:
+    {
+        size_t len = snprintf(text, text_size, "%s%s ", insn->op == SubGhzToolkitThumbOpPush ? "push" : "pop", wide);
+        if (len < text_size)
+            subghz_toolkit_thumb_format_reglist(insn->reglist, text + len, text_size - len);
+        break;
+    }
+    case SubGhzToolkitThumbOpB:
+        snprintf(text, text_size, "b%s 0x%08lx", wide, (unsigned long)insn->target);
+        break;
+    case SubGhzToolkitThumbOpBCond:
+        snprintf(text, text_size, "b%s%s 0x%08lx",
+                 subghz_toolkit_thumb_cond_names[insn->cond], wide, (unsigned long)insn->target);
+        break;
+    case SubGhzToolkitThumbOpBl:
+        snprintf(text, text_size, "bl 0x%08lx", (unsigned long)insn->target);
+        break;
+    case SubGhzToolkitThumbOpBx:
+    case SubGhzToolkitThumbOpBlx:
+        snprintf(text, text_size, "%s %s", insn->op == SubGhzToolkitThumbOpBx ? "bx" : "blx", rd);
+        break;
+    case SubGhzToolkitThumbOpCbz:
+    case SubGhzToolkitThumbOpCbnz:
+        snprintf(text, text_size, "%s %s, 0x%08lx",
+                 insn->op == SubGhzToolkitThumbOpCbz ? "cbz" : "cbnz", rd, (unsigned long)insn->target);
+        break;
+    case SubGhzToolkitThumbOpIt:
+    {
+        // Each mask bit above the terminating 1 adds a Then (same as cond bit 0) or Else
+        char pattern[4] = {0};
+        size_t n = 0;
+        int last = __builtin_ctz(insn->it_mask);
+        for (int b = 3; b > last; b--)
+            pattern[n++] = (((insn->it_mask >> b) & 1) == (insn->cond & 1)) ? 't' : 'e';
+        snprintf(text, text_size, "it%s %s", pattern, subghz_toolkit_thumb_cond_names[insn->cond]);
+        break;
+    }
+    case SubGhzToolkitThumbOpLdrLiteral:
+        snprintf(text, text_size, "ldr%s %s, [pc, #%lu] ; 0x%08lx",
+                 wide, rd, (unsigned long)insn->imm, (unsigned long)insn->target);
+        break;
+    case SubGhzToolkitThumbOpAdr:
+        snprintf(text, text_size, "adr %s, 0x%08lx", rd, (unsigned long)insn->target);
+        break;
+    case SubGhzToolkitThumbOpMovImm:
+        snprintf(text, text_size, "mov%s %s, #%lu", insn->size == 4 ? ".w" : "s", rd, (unsigned long)insn->imm);
+        break;
+    case SubGhzToolkitThumbOpMovw:
+    case SubGhzToolkitThumbOpMovt:
+        snprintf(text, text_size, "%s %s, #0x%04lx",
+                 insn->op == SubGhzToolkitThumbOpMovw ? "movw" : "movt", rd, (unsigned long)insn->imm);
+        break;
+    case SubGhzToolkitThumbOpMovReg:
+        snprintf(text, text_size, "mov %s, %s", rd, rm);
+        break;
+    case SubGhzToolkitThumbOpCmpImm:
+        snprintf(text, text_size, "cmp%s %s, #%lu", wide, rd, (unsigned long)insn->imm);
+        break;
+    case SubGhzToolkitThumbOpCmpReg:
+        snprintf(text, text_size, "cmp%s %s, %s", wide, rd, rm);
+        break;
+    case SubGhzToolkitThumbOpTbb:
+        snprintf(text, text_size, "tbb [%s, %s]", rd, rm);
+        break;
+    case SubGhzToolkitThumbOpTbh:
+        snprintf(text, text_size, "tbh [%s, %s, lsl #1]", rd, rm);
+        break;
+    case SubGhzToolkitThumbOpHint:
+    {
+        static const char *const hints[] = {"nop", "yield", "wfe", "wfi", "sev"};
+        if (insn->imm < sizeof(hints) / sizeof(hints[0]))
+            snprintf(text, text_size, "%s%s", hints[insn->imm], wide);
+        else
+            snprintf(text, text_size, "hint%s #%lu", wide, (unsigned long)insn->imm);
+        break;
+    }
+    case SubGhzToolkitThumbOpUndefined:
+        snprintf(text, text_size, "udf");
+        break;
+    default:
+        snprintf(text, text_size, "%s", insn->size == 4 ? "(32-bit)" : "(16-bit)");
+        break;
+    }
+}
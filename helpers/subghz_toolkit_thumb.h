@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Thumb / Thumb-2 (ARMv7-M) instruction decoder.
+//
+// Covers what function analysis needs: stack frames (PUSH/POP), control flow
+// (B, B<cond>, BL, BX, BLX, CBZ/CBNZ, IT, TBB/TBH), constant loads (LDR literal, ADR,
+// MOVW/MOVT, MOV immediate) and compares. Everything else is decoded for its
+// length only. The decoder works on a byte buffer plus the address it was read
+// from, so the same code runs on-device over flash and on the host over a
+// firmware image.
+
+typedef enum
+{
+    SubGhzToolkitThumbOpOther, // valid, not decoded further
+    SubGhzToolkitThumbOpPush,
+    SubGhzToolkitThumbOpPop,
+    SubGhzToolkitThumbOpB,
+    SubGhzToolkitThumbOpBCond,
+    SubGhzToolkitThumbOpBl,
+    SubGhzToolkitThumbOpBx,
+    SubGhzToolkitThumbOpBlx, // register
+    SubGhzToolkitThumbOpCbz,
+    SubGhzToolkitThumbOpCbnz,
+    SubGhzToolkitThumbOpIt,
+    SubGhzToolkitThumbOpLdrLiteral,
+    SubGhzToolkitThumbOpAdr,
+    SubGhzToolkitThumbOpMovImm,
+    SubGhzToolkitThumbOpMovw,
+    SubGhzToolkitThumbOpMovt,
+    SubGhzToolkitThumbOpMovReg,
+    SubGhzToolkitThumbOpCmpImm,
+    SubGhzToolkitThumbOpCmpReg,
+    SubGhzToolkitThumbOpTbb, // table branch, byte entries follow inline when rd is pc
+    SubGhzToolkitThumbOpTbh, // halfword entries
+    SubGhzToolkitThumbOpHint, // NOP, YIELD, WFE, WFI, SEV or another hint, imm is the hint number
+    SubGhzToolkitThumbOpUndefined, // UDF, BKPT or an unallocated encoding
+    SubGhzToolkitThumbOpCount,
+} SubGhzToolkitThumbOp;
+
+#define SUBGHZ_TOOLKIT_THUMB_REG_SP 13
+#define SUBGHZ_TOOLKIT_THUMB_REG_LR 14
+#define SUBGHZ_TOOLKIT_THUMB_REG_PC 15
+
+typedef struct
+{
+    uint32_t address;
+    uint32_t raw; // first halfword in the upper 16 bits for 32 bit encodings
+    uint8_t size; // 2 or 4
+    uint8_t op; // SubGhzToolkitThumbOp
+    uint8_t rd; // destination, or the compared / branched-on register, TBB/TBH base
+    uint8_t rm; // second register of CMP and MOV, TBB/TBH index
+    uint8_t cond; // B<cond> condition, IT first condition
+    uint8_t it_mask; // IT mask as encoded
+    uint16_t reglist; // PUSH / POP registers, bit n = rn
+    uint32_t imm; // immediate operand, already expanded
+    uint32_t target; // branch target or literal address
+} SubGhzToolkitThumbInsn;
+
+/** Code address of a function pointer: Thumb pointers have bit 0 set */
+static inline uint32_t subghz_toolkit_thumb_code_address(uintptr_t function)
+{
+    return (uint32_t)(function & ~(uintptr_t)1);
+}
+
+/** 2 or 4, from the first halfword only */
+static inline uint8_t subghz_toolkit_thumb_insn_size(uint16_t halfword)
+{
+    return (halfword >> 11) >= 0x1D ? 4 : 2;
+}
+
+/** Decode the instruction at code[0..size) located at `address`. Returns false if it runs past `size`. */
+bool subghz_toolkit_thumb_decode(const uint8_t *code, size_t size, uint32_t address, SubGhzToolkitThumbInsn *insn);
+
+/** Assembly text such as "push {r4-r7, lr}" or "bl 0x08012345" */
+void subghz_toolkit_thumb_format(const SubGhzToolkitThumbInsn *insn, char *text, size_t text_size);
+
+/** Short operation name, e.g. "BL" */
+const char *subghz_toolkit_thumb_op_name(SubGhzToolkitThumbOp op);
+
+/** Whether the instruction returns: BX LR, POP {..., pc} or MOV pc, lr */
+bool subghz_toolkit_thumb_is_return(const SubGhzToolkitThumbInsn *insn);
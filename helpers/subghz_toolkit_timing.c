@@ -0,0 +1,131 @@
+#include "subghz_toolkit_timing.h"
+
+#include <string.h>
+
+// Timings outside this range are not OOK symbol durations in microseconds
+#define SUBGHZ_TOOLKIT_TIMING_MIN_US 50
+#define SUBGHZ_TOOLKIT_TIMING_MAX_US 20000
+
+static bool subghz_toolkit_timing_is_duration(uint32_t value)
+{
+    return value >= SUBGHZ_TOOLKIT_TIMING_MIN_US && value <= SUBGHZ_TOOLKIT_TIMING_MAX_US;
+}
+
+bool subghz_toolkit_timing_parse_block(const uint8_t *data, SubGhzToolkitTimingConst *timing)
+{
+    timing->te_long = data[0] | (data[1] << 8);
+    timing->te_short = data[2] | (data[3] << 8);
+    timing->te_delta = data[4] | (data[5] << 8);
+    timing->min_count_bit = data[6];
+
+    return subghz_toolkit_timing_is_duration(timing->te_short) && subghz_toolkit_timing_is_duration(timing->te_long) &&
+           timing->te_short <= timing->te_long && timing->te_delta >= 10 && timing->te_delta <= timing->te_long &&
+           timing->min_count_bit >= 8 && timing->min_count_bit <= 200;
+}
+
+void subghz_toolkit_timing_scan_init(SubGhzToolkitTimingScan *scan)
+{
+    memset(scan, 0, sizeof(*scan));
+}
+
+static void subghz_toolkit_timing_add_duration(SubGhzToolkitTimingScan *scan, uint32_t value)
+{
+    if (!subghz_toolkit_timing_is_duration(value))
+        return;
+
+    // Insertion into the sorted set; small enough that a scan is the fastest
+    size_t i = 0;
+    while (i < scan->duration_count && scan->durations[i] < value)
+        i++;
+    if (i < scan->duration_count && scan->durations[i] == value)
+        return;
+    if (scan->duration_count == SUBGHZ_TOOLKIT_TIMING_MAX_DURATIONS)
+        return;
+
+    memmove(&scan->durations[i + 1], &scan->durations[i], (scan->duration_count - i) * sizeof(uint16_t));
+    scan->durations[i] = value;
+    scan->duration_count++;
+}
+
+static bool subghz_toolkit_timing_try_block(
+    SubGhzToolkitTimingScan *scan, uint32_t address, const SubGhzToolkitFunction *function, SubGhzToolkitCodeAt code_at, void *context)
+{
+    if (address & 1)
+        return false;
+
+    size_t size = 0;
+    const uint8_t *data = code_at(context, address, &size);
+    if (!data || size < SUBGHZ_TOOLKIT_TIMING_BLOCK_SIZE)
+        return false;
+
+    SubGhzToolkitTimingConst timing;
+    if (!subghz_toolkit_timing_parse_block(data, &timing))
+        return false;
+
+    scan->found = true;
+    scan->block = timing;
+    scan->block_address = address;
+    scan->referenced_by = function->address;
+    return true;
+}
+
+bool subghz_toolkit_timing_scan_function(
+    SubGhzToolkitTimingScan *scan,
+    const uint8_t *code,
+    const SubGhzToolkitFunction *function,
+    SubGhzToolkitCodeAt code_at,
+    void *context)
+{
+    uint32_t movw[16]; // low halves waiting for their MOVT
+    uint16_t movw_valid = 0;
+    SubGhzToolkitFunctionCursor cursor = {0};
+    SubGhzToolkitThumbInsn insn;
+
+    while (!scan->found && subghz_toolkit_function_next(code, function, &cursor, &insn))
+    {
+        scan->insn_count++;
+
+        switch (insn.op)
+        {
+        case SubGhzToolkitThumbOpLdrLiteral:
+        {
+            uint32_t offset = insn.target - function->address;
+            if (offset + 4 > function->size)
+                break;
+            const uint8_t *literal = code + offset;
+            uint32_t value = literal[0] | (literal[1] << 8) | (literal[2] << 16) | ((uint32_t)literal[3] << 24);
+            if (!subghz_toolkit_timing_try_block(scan, value, function, code_at, context))
+                subghz_toolkit_timing_add_duration(scan, value);
+            break;
+        }
+        case SubGhzToolkitThumbOpMovw:
+            // Not a duration yet: it may be the low half of an address
+            if (movw_valid & (1u << insn.rd))
+                subghz_toolkit_timing_add_duration(scan, movw[insn.rd]);
+            movw[insn.rd] = insn.imm;
+            movw_valid |= 1u << insn.rd;
+            break;
+        case SubGhzToolkitThumbOpMovt:
+            if (movw_valid & (1u << insn.rd))
+            {
+                subghz_toolkit_timing_try_block(scan, (insn.imm << 16) | movw[insn.rd], function, code_at, context);
+                movw_valid &= ~(1u << insn.rd);
+            }
+            break;
+        case SubGhzToolkitThumbOpMovImm:
+        case SubGhzToolkitThumbOpCmpImm:
+            subghz_toolkit_timing_add_duration(scan, insn.imm);
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (uint8_t rd = 0; rd < 16; rd++)
+    {
+        if (movw_valid & (1u << rd))
+            subghz_toolkit_timing_add_duration(scan, movw[rd]);
+    }
+
+    return scan->found;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subghz_toolkit_function.h"
+
+// Recovers protocol timing constants from decoder code.
+//
+// Every firmware protocol keeps its timings in a SubGhzBlockConst
+// (lib/subghz/blocks/const.h):
+//
+//   uint16_t te_long; uint16_t te_short; uint16_t te_delta; uint8_t min_count_bit_for_found;
+//
+// The decoder reaches it through an address built by LDR literal or a
+// MOVW/MOVT pair. Each such address is checked for a plausible block. When the
+// compiler folded the constants into the code instead, the CMP/MOV immediates
+// and literal values in the microsecond range are collected as candidates.
+
+#define SUBGHZ_TOOLKIT_TIMING_MAX_DURATIONS 16
+#define SUBGHZ_TOOLKIT_TIMING_BLOCK_SIZE 8
+
+typedef struct
+{
+    uint16_t te_long;
+    uint16_t te_short;
+    uint16_t te_delta;
+    uint8_t min_count_bit;
+} SubGhzToolkitTimingConst;
+
+typedef struct
+{
+    bool found; // block located, `block` and `block_address` are valid
+    SubGhzToolkitTimingConst block;
+    uint32_t block_address;
+    uint32_t referenced_by; // function the block was found through
+    uint16_t durations[SUBGHZ_TOOLKIT_TIMING_MAX_DURATIONS]; // immediates, ascending and unique
+    uint8_t duration_count;
+    uint32_t insn_count; // instructions scanned
+} SubGhzToolkitTimingScan;
+
+/** Parse and sanity check the 8 byte block at `data` */
+bool subghz_toolkit_timing_parse_block(const uint8_t *data, SubGhzToolkitTimingConst *timing);
+
+void subghz_toolkit_timing_scan_init(SubGhzToolkitTimingScan *scan);
+
+/** Scan one analyzed function. Addresses it builds are read through `code_at`. Returns true once a block is found. */
+bool subghz_toolkit_timing_scan_function(
+    SubGhzToolkitTimingScan *scan,
+    const uint8_t *code,
+    const SubGhzToolkitFunction *function,
+    SubGhzToolkitCodeAt code_at,
+    void *context);
@@ -0,0 +1,186 @@
+#include "subghz_toolkit_writer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct SubGhzToolkitWriter
+{
+    SubGhzToolkitWriterFlushCallback callback;
+    void *context;
+    size_t used;
+    SubGhzToolkitWriterStats stats;
+    uint8_t block[SUBGHZ_TOOLKIT_WRITER_BLOCK_SIZE];
+    char line[SUBGHZ_TOOLKIT_WRITER_LINE_SIZE];
+};
+
+// Two ASCII digits per byte value
+#define H2(n) "0123456789ABCDEF"[(n) >> 4], "0123456789ABCDEF"[(n)&0xF]
+#define H8(n) H2(n), H2(n + 1), H2(n + 2), H2(n + 3), H2(n + 4), H2(n + 5), H2(n + 6), H2(n + 7)
+#define H32(n) H8(n), H8(n + 8), H8(n + 16), H8(n + 24)
+static const char subghz_toolkit_hex_table[512] = {
+    H32(0x00), H32(0x20), H32(0x40), H32(0x60), H32(0x80), H32(0xA0), H32(0xC0), H32(0xE0)};
+#undef H32
+#undef H8
+#undef H2
+
+static void subghz_toolkit_writer_emit(SubGhzToolkitWriter *writer, const uint8_t *data, size_t size)
+{
+    if (!size)
+        return;
+
+    writer->stats.flushes++;
+    if (writer->callback(writer->context, data, size) != size)
+        writer->stats.error = true;
+}
+
+SubGhzToolkitWriter *subghz_toolkit_writer_alloc(SubGhzToolkitWriterFlushCallback callback, void *context)
+{
+    SubGhzToolkitWriter *writer = malloc(sizeof(SubGhzToolkitWriter));
+    writer->callback = callback;
+    writer->context = context;
+    writer->used = 0;
+    memset(&writer->stats, 0, sizeof(writer->stats));
+    return writer;
+}
+
+void subghz_toolkit_writer_free(SubGhzToolkitWriter *writer)
+{
+    subghz_toolkit_writer_flush(writer);
+    free(writer);
+}
+
+void subghz_toolkit_writer_write(SubGhzToolkitWriter *writer, const void *data, size_t size)
+{
+    const uint8_t *src = data;
+    writer->stats.bytes += size;
+
+    while (size)
+    {
+        // Whole blocks bypass the buffer when it is empty
+        if (writer->used == 0 && size >= SUBGHZ_TOOLKIT_WRITER_BLOCK_SIZE)
+        {
+            size_t chunk = size - (size % SUBGHZ_TOOLKIT_WRITER_BLOCK_SIZE);
+            subghz_toolkit_writer_emit(writer, src, chunk);
+            src += chunk;
+            size -= chunk;
+            continue;
+        }
+
+        size_t room = SUBGHZ_TOOLKIT_WRITER_BLOCK_SIZE - writer->used;
+        size_t chunk = size < room ? size : room;
+        memcpy(writer->block + writer->used, src, chunk);
+        writer->used += chunk;
+        src += chunk;
+        size -= chunk;
+
+        if (writer->used == SUBGHZ_TOOLKIT_WRITER_BLOCK_SIZE)
+        {
+            subghz_toolkit_writer_emit(writer, writer->block, writer->used);
+            writer->used = 0;
+        }
+    }
+}
+
+void subghz_toolkit_writer_cstr(SubGhzToolkitWriter *writer, const char *str)
+{
+    subghz_toolkit_writer_write(writer, str, strlen(str));
+}
+
+void subghz_toolkit_writer_vprintf(SubGhzToolkitWriter *writer, const char *format, va_list args)
+{
+    va_list copy;
+    va_copy(copy, args);
+    int len = vsnprintf(writer->line, sizeof(writer->line), format, copy);
+    va_end(copy);
+
+    if (len < 0)
+        return;
+
+    if ((size_t)len < sizeof(writer->line))
+    {
+        subghz_toolkit_writer_write(writer, writer->line, len);
+        return;
+    }
+
+    // Rare long line: format on the heap
+    char *text = malloc(len + 1);
+    vsnprintf(text, len + 1, format, args);
+    subghz_toolkit_writer_write(writer, text, len);
+    free(text);
+}
+
+void subghz_toolkit_writer_printf(SubGhzToolkitWriter *writer, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    subghz_toolkit_writer_vprintf(writer, format, args);
+    va_end(args);
+}
+
+void subghz_toolkit_writer_hex(SubGhzToolkitWriter *writer, const uint8_t *data, size_t size)
+{
+    char *out = writer->line;
+    size_t pos = 0;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        memcpy(out + pos, &subghz_toolkit_hex_table[data[i] * 2], 2);
+        out[pos + 2] = ' ';
+        pos += 3;
+
+        if (pos + 3 > sizeof(writer->line))
+        {
+            subghz_toolkit_writer_write(writer, out, pos);
+            pos = 0;
+        }
+    }
+
+    subghz_toolkit_writer_write(writer, out, pos);
+}
+
+void subghz_toolkit_writer_hex_dump(
+    SubGhzToolkitWriter *writer, const char *indent, const uint8_t *data, size_t size, size_t per_line)
+{
+    for (size_t offset = 0; offset < size; offset += per_line)
+    {
+        size_t count = size - offset < per_line ? size - offset : per_line;
+        subghz_toolkit_writer_cstr(writer, indent);
+        subghz_toolkit_writer_hex(writer, data + offset, count);
+        subghz_toolkit_writer_write(writer, "\n", 1);
+    }
+}
+
+void subghz_toolkit_writer_flush(SubGhzToolkitWriter *writer)
+{
+    subghz_toolkit_writer_emit(writer, writer->block, writer->used);
+    writer->used = 0;
+}
+
+const SubGhzToolkitWriterStats *subghz_toolkit_writer_get_stats(const SubGhzToolkitWriter *writer)
+{
+    return &writer->stats;
+}
+
+void subghz_toolkit_writer_hex_u64(SubGhzToolkitWriter *writer, uint64_t value)
+{
+    char text[16];
+    for (int i = 7; i >= 0; i--)
+    {
+        memcpy(&text[i * 2], &subghz_toolkit_hex_table[(value & 0xFF) * 2], 2);
+        value >>= 8;
+    }
+    subghz_toolkit_writer_write(writer, text, sizeof(text));
+}
+
+void subghz_toolkit_writer_dec_u32(SubGhzToolkitWriter *writer, uint32_t value)
+{
+    char text[10];
+    size_t pos = sizeof(text);
+    do
+    {
+        text[--pos] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    subghz_toolkit_writer_write(writer, text + pos, sizeof(text) - pos);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Buffered text sink for analysis output.
+// Formats into a fixed RAM block and hands it to the flush callback in whole
+// SD-sector multiples, so a file is written with a handful of large writes
+// instead of one write per formatted field.
+// No Furi dependencies: the same code backs the app and the host tools.
+
+#define SUBGHZ_TOOLKIT_WRITER_SECTOR_SIZE 512
+#define SUBGHZ_TOOLKIT_WRITER_BLOCK_SIZE (2 * SUBGHZ_TOOLKIT_WRITER_SECTOR_SIZE)
+#define SUBGHZ_TOOLKIT_WRITER_LINE_SIZE 256
+
+typedef struct SubGhzToolkitWriter SubGhzToolkitWriter;
+
+/** Write `size` bytes to the backing store, return the number written */
+typedef size_t (*SubGhzToolkitWriterFlushCallback)(void *context, const uint8_t *data, size_t size);
+
+typedef struct
+{
+    uint64_t bytes;   // bytes accepted by the writer
+    uint32_t flushes; // calls made to the flush callback
+    bool error;       // a flush came back short
+} SubGhzToolkitWriterStats;
+
+SubGhzToolkitWriter *subghz_toolkit_writer_alloc(SubGhzToolkitWriterFlushCallback callback, void *context);
+
+/** Flushes pending data, then frees */
+void subghz_toolkit_writer_free(SubGhzToolkitWriter *writer);
+
+void subghz_toolkit_writer_write(SubGhzToolkitWriter *writer, const void *data, size_t size);
+
+void subghz_toolkit_writer_cstr(SubGhzToolkitWriter *writer, const char *str);
+
+void subghz_toolkit_writer_printf(SubGhzToolkitWriter *writer, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+void subghz_toolkit_writer_vprintf(SubGhzToolkitWriter *writer, const char *format, va_list args);
+
+/** "XX XX XX " for each byte, via lookup table */
+void subghz_toolkit_writer_hex(SubGhzToolkitWriter *writer, const uint8_t *data, size_t size);
+
+/** Hex dump, `per_line` bytes per line, each line starts with `indent` and ends with '\n' */
+void subghz_toolkit_writer_hex_dump(
+    SubGhzToolkitWriter *writer, const char *indent, const uint8_t *data, size_t size, size_t per_line);
+
+/** Push any buffered bytes to the flush callback */
+void subghz_toolkit_writer_flush(SubGhzToolkitWriter *writer);
+
+const SubGhzToolkitWriterStats *subghz_toolkit_writer_get_stats(const SubGhzToolkitWriter *writer);
+
+/** 16 upper-case hex digits, no prefix */
+void subghz_toolkit_writer_hex_u64(SubGhzToolkitWriter *writer, uint64_t value);
+
+/** Unsigned decimal without going through printf */
+void subghz_toolkit_writer_dec_u32(SubGhzToolkitWriter *writer, uint32_t value);
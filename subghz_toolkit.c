@@ -14,7 +14,8 @@
 #include <gui/modules/submenu.h>
 #include <gui/modules/popup.h>
 #include <gui/modules/text_box.h>
-#include <gui/modules/loading.h>
+#include <gui/modules/byte_input.h>
+#include <gui/modules/text_input.h>
 #include <storage/storage.h>
 #include <lib/toolbox/stream/file_stream.h>
 #include <notification/notification_messages.h>
@@ -26,16 +27,100 @@
 #include <lib/subghz/protocols/base.h>
 #include <lib/subghz/environment.h>
 #include <lib/subghz/subghz_setting.h>
+#include <lib/subghz/devices/devices.h>
+#include <lib/subghz/devices/cc1101_int/cc1101_int_interconnect.h>
 #include <lib/subghz/registry.h>
 
+#include "subghz_toolkit_worker.h"
+#include "helpers/subghz_toolkit_writer.h"
+#include "helpers/subghz_toolkit_name_index.h"
+#include "helpers/subghz_toolkit_keyfile.h"
+#include "helpers/subghz_toolkit_key_index.h"
+#include "helpers/subghz_toolkit_thumb.h"
+#include "helpers/subghz_toolkit_function.h"
+#include "helpers/subghz_toolkit_call_graph.h"
+#include "helpers/subghz_toolkit_timing.h"
+#include "helpers/subghz_toolkit_memory.h"
+#include "helpers/subghz_toolkit_protocol.h"
+#include "helpers/subghz_toolkit_symbols.h"
+#include "helpers/subghz_toolkit_snapshot.h"
+#include "helpers/subghz_toolkit_manifest.h"
+#include "helpers/subghz_toolkit_capture.h"
+#include "helpers/subghz_toolkit_replay.h"
+#include "helpers/subghz_toolkit_profile.h"
+#include "helpers/subghz_toolkit_classify.h"
+#include "helpers/subghz_toolkit_clusters.h"
+#include "helpers/subghz_toolkit_frames.h"
+#include "helpers/subghz_toolkit_state.h"
+
 #define TAG "SubGhzToolkit"
 #define SUBGHZ_TOOLKIT_VERSION "1.0"
 #define TEXT_BUFFER_SIZE 32768
 #define SUBGHZ_ANALYSIS_DIR EXT_PATH("subghz/analysis")
+#define SUBGHZ_KEYSTORE_PATH EXT_PATH("subghz/assets/keeloq_mfcodes")
+#define SUBGHZ_KEYSTORE_USER_PATH EXT_PATH("subghz/assets/keeloq_mfcodes_user")
+#define SUBGHZ_KEY_INDEX_PATH SUBGHZ_ANALYSIS_DIR "/keeloq_index.bin"
+#define SUBGHZ_SYMBOLS_PATH SUBGHZ_ANALYSIS_DIR "/symbols.bin"
+#define SUBGHZ_SNAPSHOT_DIR SUBGHZ_ANALYSIS_DIR "/snapshots"
+#define SUBGHZ_FIRMWARE_DIFF_PATH SUBGHZ_ANALYSIS_DIR "/firmware_diff.txt"
+#define SUBGHZ_MANIFEST_PATH SUBGHZ_ANALYSIS_DIR "/manifest.bin"
+#define SUBGHZ_CAPTURE_PATH SUBGHZ_ANALYSIS_DIR "/signal_capture.sub"
+#define SUBGHZ_TOOLKIT_CAPTURE_SECONDS 10
+#define SUBGHZ_TOOLKIT_REPLAY_READ_SIZE 1024 // bytes per read of a RAW file
+#define SUBGHZ_TOOLKIT_STATE_TRACE_PULSES 4096 // of the last capture, fed to every decoder
+#define SUBGHZ_TOOLKIT_STATE_ALLOC_RUNS 3
+#define SUBGHZ_REPLAY_DIR SUBGHZ_ANALYSIS_DIR "/replay"
+#define SUBGHZ_REPLAY_REPORT_PATH SUBGHZ_ANALYSIS_DIR "/replay_report.txt"
+#define SUBGHZ_PROFILE_REPORT_PATH SUBGHZ_ANALYSIS_DIR "/decoder_profile.txt"
+#define SUBGHZ_TOOLKIT_LOOKUP_MAX_RESULTS 32
+#define SUBGHZ_CALL_GRAPH_EDGES_PATH SUBGHZ_ANALYSIS_DIR "/call_graph.txt"
+#define SUBGHZ_TOOLKIT_CALL_GRAPH_NODE_LIMIT 1024 // 16 KB nodes + 8 KB hash set + 2 KB pending, ~40 KB with 2 edges per node
+#define SUBGHZ_TOOLKIT_CALL_GRAPH_HOT_FAN_IN 8
+
+// STM32WB55: the firmware, and with it every protocol, runs from the start of
+// flash. Only the image up to furi_hal_flash_get_free_start_address() is mapped:
+// the top of flash from SFSA on is CPU2's secure area and a CPU1 read of it
+// bus-faults, and the scans read at any literal that looks like a flash address.
+#define SUBGHZ_TOOLKIT_FLASH_START 0x08000000u
 
 extern const SubGhzProtocolRegistry subghz_protocol_registry;
 
+typedef struct SubGhzToolkitApp SubGhzToolkitApp;
+
+typedef struct
+{
+    SubGhzToolkitApp *app;
+    SubGhzToolkitWriter *writer;
+    void *state;
+} SubGhzToolkitPassContext;
+
+// A pluggable analysis pass: one output file, fed each protocol by a single registry walk
+typedef struct
+{
+    const char *file_name;
+    const char *banner;
+    const char *success_text;
+    const char *error_text;
+    size_t state_size;
+    bool sections; // protocol() output depends on that protocol alone, so unchanged ones are copied from the last run
+    void (*begin)(SubGhzToolkitPassContext *ctx);
+    void (*protocol)(SubGhzToolkitPassContext *ctx, size_t index, const SubGhzProtocol *protocol);
+    void (*end)(SubGhzToolkitPassContext *ctx);
+} SubGhzToolkitAnalysisPass;
+
+// An export run on the worker thread: either a custom body or a pipeline over passes
 typedef struct
+{
+    const char *title;
+    bool (*run)(SubGhzToolkitApp *app);
+    const SubGhzToolkitAnalysisPass *const *passes;
+    size_t pass_count;
+    const char *success_text;
+    const char *error_text;
+    bool show_text; // on success, show text_buffer in the text box instead of a popup
+} SubGhzToolkitJob;
+
+struct SubGhzToolkitApp
 {
     ViewDispatcher *view_dispatcher;
     Gui *gui;
@@ -43,57 +128,100 @@ typedef struct
     Submenu *submenu;
     Popup *popup;
     TextBox *text_box;
-    Loading *loading;
+    Popup *progress;
+    ByteInput *byte_input;
+    TextInput *text_input;
+    uint8_t key_input[8];
+    char name_input[SUBGHZ_TOOLKIT_KEYFILE_NAME_SIZE];
     FuriString *text_buffer;
+    FuriString *progress_text;
+    FuriString *result_text; // optional job summary, replaces success_text when set
+    // Created on first use, see subghz_toolkit_get_environment() and friends
+    FuriMutex *resource_mutex;
     SubGhzEnvironment *environment;
     SubGhzReceiver *receiver;
     SubGhzSetting *setting;
+    SubGhzToolkitKeyIndex *key_index;
+    SubGhzToolkitFunctionCache *function_cache;
+    SubGhzToolkitSymbols *symbols; // NULL without a matching symbols.bin
+    File *symbol_file; // kept open, lookups read the file
+    bool symbols_loaded;
+    SubGhzToolkitMemory flash; // firmware code and constants, read in place
     const SubGhzProtocolRegistry *protocol_registry;
-} SubGhzToolkitApp;
+    SubGhzToolkitNameIndex *protocol_index;
+    SubGhzToolkitWorker *worker;
+    SubGhzToolkitJob job;
+};
 
 typedef enum
 {
     SubGhzToolkitViewSubmenu,
     SubGhzToolkitViewPopup,
     SubGhzToolkitViewTextBox,
-    SubGhzToolkitViewLoading,
+    SubGhzToolkitViewProgress,
+    SubGhzToolkitViewByteInput,
+    SubGhzToolkitViewTextInput,
 } SubGhzToolkitView;
 
 typedef enum
 {
     SubGhzToolkitSubmenuIndexDecryptKeeloq,
+    SubGhzToolkitSubmenuIndexExportKeeloqCsv,
+    SubGhzToolkitSubmenuIndexExportKeeloqBinary,
+    SubGhzToolkitSubmenuIndexKeeloqKeyLookup,
+    SubGhzToolkitSubmenuIndexKeeloqNameLookup,
     SubGhzToolkitSubmenuIndexListProtocols,
     SubGhzToolkitSubmenuIndexExportProtocolInfo,
     SubGhzToolkitSubmenuIndexAdvancedAnalysis,
-    SubGhzToolkitSubmenuIndexProtocolDetails = 100,
+    SubGhzToolkitSubmenuIndexRunAllAnalyses,
     SubGhzToolkitSubmenuIndexFunctionDisassembly,
+    SubGhzToolkitSubmenuIndexCallGraph,
     SubGhzToolkitSubmenuIndexProtocolStateAnalysis,
     SubGhzToolkitSubmenuIndexSignalCapture,
+    SubGhzToolkitSubmenuIndexReplayCaptures,
+    SubGhzToolkitSubmenuIndexProfileDecoders,
     SubGhzToolkitSubmenuIndexTimingAnalysis,
     SubGhzToolkitSubmenuIndexCHeaderGeneration,
+    SubGhzToolkitSubmenuIndexCompareFirmware,
     SubGhzToolkitSubmenuIndexAbout,
+    // Must stay last: protocol entries use ProtocolDetails + registry index
+    SubGhzToolkitSubmenuIndexProtocolDetails = 100,
 } SubGhzToolkitSubmenuIndex;
 
 static bool subghz_toolkit_export_keeloq_keys(SubGhzToolkitApp *app);
+static bool subghz_toolkit_export_keeloq_keys_csv(SubGhzToolkitApp *app);
+static bool subghz_toolkit_export_keeloq_keys_binary(SubGhzToolkitApp *app);
 static void subghz_toolkit_show_protocols_list(SubGhzToolkitApp *app);
-static void subghz_toolkit_extract_protocol_details(SubGhzToolkitApp *app, const char *protocol_name);
+static void subghz_toolkit_extract_protocol_details(SubGhzToolkitApp *app, size_t protocol_index);
+static SubGhzEnvironment *subghz_toolkit_get_environment(SubGhzToolkitApp *app);
+static SubGhzReceiver *subghz_toolkit_get_receiver(SubGhzToolkitApp *app);
+static SubGhzSetting *subghz_toolkit_get_setting(SubGhzToolkitApp *app);
+static void subghz_toolkit_show_key_lookup(SubGhzToolkitApp *app);
+static void subghz_toolkit_show_name_lookup(SubGhzToolkitApp *app);
 static void subghz_toolkit_export_all_protocol_info(SubGhzToolkitApp *app);
 static void subghz_toolkit_advanced_analysis(SubGhzToolkitApp *app);
+static void subghz_toolkit_run_all_analyses(SubGhzToolkitApp *app);
 static void subghz_toolkit_show_about(SubGhzToolkitApp *app);
+static void subghz_toolkit_popup_callback(void *context);
+static void subghz_toolkit_show_result_popup(SubGhzToolkitApp *app, bool success, const char *success_text, const char *error_text);
+static void subghz_toolkit_start_job(SubGhzToolkitApp *app, const SubGhzToolkitJob *job);
+static void subghz_toolkit_show_text(SubGhzToolkitApp *app);
+static bool subghz_toolkit_run_pipeline(SubGhzToolkitApp *app, const SubGhzToolkitAnalysisPass *const *passes, size_t pass_count);
 
-static void subghz_toolkit_deep_protocol_analysis(Stream *stream, const SubGhzProtocol *protocol, SubGhzEnvironment *env);
+static void subghz_toolkit_deep_protocol_analysis(SubGhzToolkitWriter *writer, SubGhzToolkitSymbols *symbols, const SubGhzProtocol *protocol, SubGhzEnvironment *env);
 
 // Enhanced analysis functions
 static void subghz_toolkit_function_disassembly(SubGhzToolkitApp *app);
+static void subghz_toolkit_call_graph(SubGhzToolkitApp *app);
 static void subghz_toolkit_protocol_state_analysis(SubGhzToolkitApp *app);
 static void subghz_toolkit_signal_capture_analysis(SubGhzToolkitApp *app);
+static void subghz_toolkit_replay_captures(SubGhzToolkitApp *app);
+static void subghz_toolkit_profile_decoders(SubGhzToolkitApp *app);
 static void subghz_toolkit_timing_analysis(SubGhzToolkitApp *app);
 static void subghz_toolkit_generate_c_headers(SubGhzToolkitApp *app);
-static void subghz_toolkit_analyze_function_bytes(Stream *stream, const char *func_name, void *func_ptr, size_t max_bytes);
-static void subghz_toolkit_analyze_protocol_state(Stream *stream, const SubGhzProtocol *protocol, SubGhzEnvironment *env);
-static void subghz_toolkit_capture_signal_samples(Stream *stream, SubGhzReceiver *receiver);
-static void subghz_toolkit_analyze_timing_patterns(Stream *stream, const SubGhzProtocol *protocol);
-static void subghz_toolkit_generate_protocol_c_header(Stream *stream, const SubGhzProtocol *protocol);
+static void subghz_toolkit_compare_firmware(SubGhzToolkitApp *app);
+static bool subghz_toolkit_capture_signal_samples(
+    SubGhzToolkitApp *app, const SubGhzToolkitCaptureSource *source, Stream *raw, SubGhzToolkitWriter *report, uint32_t *te);
 
 static uint32_t subghz_toolkit_exit_callback(void *context)
 {
@@ -113,22 +241,38 @@ static void subghz_toolkit_submenu_callback(void *context, uint32_t index)
 
     if (index == SubGhzToolkitSubmenuIndexDecryptKeeloq)
     {
-        view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewLoading);
-        if (subghz_toolkit_export_keeloq_keys(app))
-        {
-            popup_set_header(app->popup, "Success!", 64, 10, AlignCenter, AlignTop);
-            popup_set_text(app->popup, "Keeloq keys exported to:\n/ext/subghz/keeloq_keys.txt", 64, 20, AlignCenter, AlignTop);
-        }
-        else
-        {
-            popup_set_header(app->popup, "Error!", 64, 10, AlignCenter, AlignTop);
-            popup_set_text(app->popup, "Failed to export Keeloq keys", 64, 20, AlignCenter, AlignTop);
-        }
-        popup_set_callback(app->popup, subghz_toolkit_popup_callback);
-        popup_set_context(app->popup, app);
-        popup_set_timeout(app->popup, 3000);
-        popup_enable_timeout(app->popup);
-        view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewPopup);
+        static const SubGhzToolkitJob job = {
+            .title = "Decrypt Keeloq",
+            .run = subghz_toolkit_export_keeloq_keys,
+            .error_text = "Failed to export Keeloq keys",
+        };
+        subghz_toolkit_start_job(app, &job);
+    }
+    else if (index == SubGhzToolkitSubmenuIndexExportKeeloqCsv)
+    {
+        static const SubGhzToolkitJob job = {
+            .title = "Keeloq CSV",
+            .run = subghz_toolkit_export_keeloq_keys_csv,
+            .error_text = "Failed to export Keeloq keys",
+        };
+        subghz_toolkit_start_job(app, &job);
+    }
+    else if (index == SubGhzToolkitSubmenuIndexExportKeeloqBinary)
+    {
+        static const SubGhzToolkitJob job = {
+            .title = "Keeloq Binary",
+            .run = subghz_toolkit_export_keeloq_keys_binary,
+            .error_text = "Failed to export Keeloq keys",
+        };
+        subghz_toolkit_start_job(app, &job);
+    }
+    else if (index == SubGhzToolkitSubmenuIndexKeeloqKeyLookup)
+    {
+        subghz_toolkit_show_key_lookup(app);
+    }
+    else if (index == SubGhzToolkitSubmenuIndexKeeloqNameLookup)
+    {
+        subghz_toolkit_show_name_lookup(app);
     }
     else if (index == SubGhzToolkitSubmenuIndexListProtocols)
     {
@@ -136,24 +280,24 @@ static void subghz_toolkit_submenu_callback(void *context, uint32_t index)
     }
     else if (index == SubGhzToolkitSubmenuIndexExportProtocolInfo)
     {
-        view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewLoading);
         subghz_toolkit_export_all_protocol_info(app);
-        popup_set_header(app->popup, "Success!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Protocol info exported to:\n/ext/subghz/protocols.txt", 64, 20, AlignCenter, AlignTop);
-        popup_set_callback(app->popup, subghz_toolkit_popup_callback);
-        popup_set_context(app->popup, app);
-        popup_set_timeout(app->popup, 3000);
-        popup_enable_timeout(app->popup);
-        view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewPopup);
     }
     else if (index == SubGhzToolkitSubmenuIndexAdvancedAnalysis)
     {
         subghz_toolkit_advanced_analysis(app);
     }
+    else if (index == SubGhzToolkitSubmenuIndexRunAllAnalyses)
+    {
+        subghz_toolkit_run_all_analyses(app);
+    }
     else if (index == SubGhzToolkitSubmenuIndexFunctionDisassembly)
     {
         subghz_toolkit_function_disassembly(app);
     }
+    else if (index == SubGhzToolkitSubmenuIndexCallGraph)
+    {
+        subghz_toolkit_call_graph(app);
+    }
     else if (index == SubGhzToolkitSubmenuIndexProtocolStateAnalysis)
     {
         subghz_toolkit_protocol_state_analysis(app);
@@ -162,6 +306,14 @@ static void subghz_toolkit_submenu_callback(void *context, uint32_t index)
     {
         subghz_toolkit_signal_capture_analysis(app);
     }
+    else if (index == SubGhzToolkitSubmenuIndexReplayCaptures)
+    {
+        subghz_toolkit_replay_captures(app);
+    }
+    else if (index == SubGhzToolkitSubmenuIndexProfileDecoders)
+    {
+        subghz_toolkit_profile_decoders(app);
+    }
     else if (index == SubGhzToolkitSubmenuIndexTimingAnalysis)
     {
         subghz_toolkit_timing_analysis(app);
@@ -170,6 +322,10 @@ static void subghz_toolkit_submenu_callback(void *context, uint32_t index)
     {
         subghz_toolkit_generate_c_headers(app);
     }
+    else if (index == SubGhzToolkitSubmenuIndexCompareFirmware)
+    {
+        subghz_toolkit_compare_firmware(app);
+    }
     else if (index == SubGhzToolkitSubmenuIndexAbout)
     {
         subghz_toolkit_show_about(app);
@@ -177,12 +333,7 @@ static void subghz_toolkit_submenu_callback(void *context, uint32_t index)
     else if (index >= SubGhzToolkitSubmenuIndexProtocolDetails)
     {
         // Handle protocol-specific details
-        size_t protocol_index = index - SubGhzToolkitSubmenuIndexProtocolDetails;
-        const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, protocol_index);
-        if (protocol && protocol->name)
-        {
-            subghz_toolkit_extract_protocol_details(app, protocol->name);
-        }
+        subghz_toolkit_extract_protocol_details(app, index - SubGhzToolkitSubmenuIndexProtocolDetails);
     }
 }
 
@@ -192,9 +343,139 @@ static void subghz_toolkit_popup_callback(void *context)
     view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewSubmenu);
 }
 
-static bool subghz_toolkit_export_keeloq_keys(SubGhzToolkitApp *app)
+static void subghz_toolkit_show_result_popup(SubGhzToolkitApp *app, bool success, const char *success_text, const char *error_text)
+{
+    if (success)
+    {
+        popup_set_header(app->popup, "Success!", 64, 10, AlignCenter, AlignTop);
+        popup_set_text(app->popup, success_text, 64, 20, AlignCenter, AlignTop);
+    }
+    else
+    {
+        popup_set_header(app->popup, "Error!", 64, 10, AlignCenter, AlignTop);
+        popup_set_text(app->popup, error_text, 64, 20, AlignCenter, AlignTop);
+    }
+
+    popup_set_callback(app->popup, subghz_toolkit_popup_callback);
+    popup_set_context(app->popup, app);
+    popup_set_timeout(app->popup, 3000);
+    popup_enable_timeout(app->popup);
+    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewPopup);
+}
+
+static bool subghz_toolkit_job_callback(SubGhzToolkitWorker *worker, void *context)
+{
+    UNUSED(worker);
+    SubGhzToolkitApp *app = context;
+
+    if (app->job.run)
+        return app->job.run(app);
+
+    return subghz_toolkit_run_pipeline(app, app->job.passes, app->job.pass_count);
+}
+
+static void subghz_toolkit_update_progress(SubGhzToolkitApp *app)
+{
+    size_t done = 0;
+    size_t total = 0;
+    FuriString *item = furi_string_alloc();
+
+    subghz_toolkit_worker_get_progress(app->worker, &done, &total, item);
+
+    furi_string_printf(app->progress_text, "%s\n%zu / %zu\n", furi_string_get_cstr(item), done, total);
+    furi_string_cat_str(
+        app->progress_text,
+        subghz_toolkit_worker_is_cancelled(app->worker) ? "Cancelling..." : "Back: cancel");
+    popup_set_text(app->progress, furi_string_get_cstr(app->progress_text), 64, 22, AlignCenter, AlignTop);
+
+    furi_string_free(item);
+}
+
+static void subghz_toolkit_start_job(SubGhzToolkitApp *app, const SubGhzToolkitJob *job)
+{
+    if (subghz_toolkit_worker_is_running(app->worker))
+        return;
+
+    app->job = *job;
+    furi_string_reset(app->result_text);
+
+    popup_set_header(app->progress, job->title, 64, 8, AlignCenter, AlignTop);
+    furi_string_set_str(app->progress_text, "Starting...");
+    popup_set_text(app->progress, furi_string_get_cstr(app->progress_text), 64, 22, AlignCenter, AlignTop);
+    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewProgress);
+
+    subghz_toolkit_worker_start(app->worker, subghz_toolkit_job_callback, app);
+}
+
+static bool subghz_toolkit_custom_event_callback(void *context, uint32_t event)
+{
+    SubGhzToolkitApp *app = context;
+
+    if (event == SubGhzToolkitCustomEventWorkerProgress)
+    {
+        subghz_toolkit_update_progress(app);
+        return true;
+    }
+    else if (event == SubGhzToolkitCustomEventWorkerDone)
+    {
+        bool cancelled = subghz_toolkit_worker_is_cancelled(app->worker);
+        bool success = subghz_toolkit_worker_stop(app->worker);
+
+        if (cancelled)
+            subghz_toolkit_show_result_popup(app, false, NULL, "Cancelled, output is incomplete");
+        else if (success && app->job.show_text)
+            subghz_toolkit_show_text(app);
+        else
+            subghz_toolkit_show_result_popup(
+                app,
+                success,
+                furi_string_empty(app->result_text) ? app->job.success_text : furi_string_get_cstr(app->result_text),
+                app->job.error_text);
+        return true;
+    }
+
+    return false;
+}
+
+static bool subghz_toolkit_navigation_event_callback(void *context)
+{
+    SubGhzToolkitApp *app = context;
+
+    // Back on the progress screen cancels between items instead of leaving the app
+    if (subghz_toolkit_worker_is_running(app->worker))
+    {
+        subghz_toolkit_worker_cancel(app->worker);
+        subghz_toolkit_update_progress(app);
+        return true;
+    }
+
+    return false;
+}
+
+static size_t subghz_toolkit_stream_flush(void *context, const uint8_t *data, size_t size)
+{
+    return stream_write(context, data, size);
+}
+
+static void subghz_toolkit_log_throughput(const char *what, uint64_t bytes, uint32_t flushes, uint32_t elapsed_ms)
+{
+    FURI_LOG_I(TAG, "%s: %lu bytes in %lu writes, %lu ms (%lu B/s)",
+               what,
+               (uint32_t)bytes,
+               flushes,
+               elapsed_ms,
+               elapsed_ms ? (uint32_t)(bytes * 1000 / elapsed_ms) : 0);
+}
+
+typedef enum
+{
+    SubGhzToolkitKeeloqFormatText,
+    SubGhzToolkitKeeloqFormatCsv,
+    SubGhzToolkitKeeloqFormatBinary,
+} SubGhzToolkitKeeloqFormat;
+
+static bool subghz_toolkit_export_keeloq(SubGhzToolkitApp *app, SubGhzToolkitKeeloqFormat format, const char *path)
 {
-    UNUSED(app);
     bool success = false;
     SubGhzKeystore *keystore = subghz_keystore_alloc();
     Storage *storage = furi_record_open(RECORD_STORAGE);
@@ -202,7 +483,7 @@ static bool subghz_toolkit_export_keeloq_keys(SubGhzToolkitApp *app)
 
     do
     {
-        if (!subghz_keystore_load(keystore, EXT_PATH("subghz/assets/keeloq_mfcodes")))
+        if (!subghz_keystore_load(keystore, SUBGHZ_KEYSTORE_PATH))
         {
             FURI_LOG_E(TAG, "Failed to load keystore");
             break;
@@ -211,45 +492,83 @@ static bool subghz_toolkit_export_keeloq_keys(SubGhzToolkitApp *app)
         storage_simply_mkdir(storage, EXT_PATH("subghz"));
         storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
 
-        if (!file_stream_open(stream, SUBGHZ_ANALYSIS_DIR "/keeloq_keys.txt",
-                              FSAM_WRITE, FSOM_CREATE_ALWAYS))
+        if (!file_stream_open(stream, path, FSAM_WRITE, FSOM_CREATE_ALWAYS))
         {
             FURI_LOG_E(TAG, "Failed to open output file");
             break;
         }
 
-        stream_write_format(stream,
-                            "====================================\n"
-                            "  Flipper SubGhz KeeLoq Mfcodes\n"
-                            "  Decrypted by SubGhz Toolkit\n"
-                            "  RocketGod | betaskynet.com\n"
-                            "====================================\n\n");
+        uint32_t start_tick = furi_get_tick();
+        SubGhzToolkitWriter *writer = subghz_toolkit_writer_alloc(subghz_toolkit_stream_flush, stream);
 
         SubGhzKeyArray_t *keys = subghz_keystore_get_data(keystore);
         size_t key_count = SubGhzKeyArray_size(*keys);
 
-        stream_write_format(stream, "Total Keys: %zu\n\n", key_count);
+        if (format == SubGhzToolkitKeeloqFormatText)
+        {
+            subghz_toolkit_writer_cstr(writer,
+                                       "====================================\n"
+                                       "  Flipper SubGhz KeeLoq Mfcodes\n"
+                                       "  Decrypted by SubGhz Toolkit\n"
+                                       "  RocketGod | betaskynet.com\n"
+                                       "====================================\n\n");
+            subghz_toolkit_writer_printf(writer, "Total Keys: %zu\n\n", key_count);
+        }
+        else if (format == SubGhzToolkitKeeloqFormatCsv)
+        {
+            subghz_toolkit_keyfile_csv_header(writer);
+        }
+        else
+        {
+            subghz_toolkit_keyfile_binary_header(writer, key_count);
+        }
 
         size_t exported = 0;
         for (size_t i = 0; i < key_count; i++)
         {
+            if (subghz_toolkit_worker_is_cancelled(app->worker))
+                break;
+
             const SubGhzKey *key = SubGhzKeyArray_get(*keys, i);
+            const char *name = furi_string_get_cstr(key->name);
 
-            stream_write_format(stream,
-                                "Manufacturer: %s\n"
-                                "Key (Hex):    %016llX\n"
-                                "Key (Dec):    %llu\n"
-                                "Type:         %hu\n"
-                                "------------------------------------\n\n",
-                                furi_string_get_cstr(key->name),
-                                key->key,
-                                key->key,
-                                key->type);
+            if (format == SubGhzToolkitKeeloqFormatText)
+            {
+                subghz_toolkit_writer_printf(writer,
+                                             "Manufacturer: %s\n"
+                                             "Key (Hex):    %016llX\n"
+                                             "Key (Dec):    %llu\n"
+                                             "Type:         %hu\n"
+                                             "------------------------------------\n\n",
+                                             name,
+                                             key->key,
+                                             key->key,
+                                             key->type);
+            }
+            else if (format == SubGhzToolkitKeeloqFormatCsv)
+            {
+                subghz_toolkit_keyfile_csv_record(writer, name, key->key, key->type);
+            }
+            else
+            {
+                subghz_toolkit_keyfile_binary_record(writer, name, key->key, key->type);
+            }
 
             exported++;
+            subghz_toolkit_worker_report(app->worker, exported, key_count, name);
         }
 
-        success = (exported == key_count);
+        subghz_toolkit_writer_flush(writer);
+        const SubGhzToolkitWriterStats *stats = subghz_toolkit_writer_get_stats(writer);
+        uint32_t elapsed_ms = furi_get_tick() - start_tick;
+        uint32_t keys_per_sec = elapsed_ms ? (uint32_t)((uint64_t)exported * 1000 / elapsed_ms) : 0;
+
+        subghz_toolkit_log_throughput("Keeloq export", stats->bytes, stats->flushes, elapsed_ms);
+        FURI_LOG_I(TAG, "Keeloq export: %zu keys, %lu keys/s", exported, keys_per_sec);
+        furi_string_printf(app->result_text, "%zu keys, %lu keys/s\n%s", exported, keys_per_sec, path);
+
+        success = (exported == key_count) && !stats->error;
+        subghz_toolkit_writer_free(writer);
 
     } while (0);
 
@@ -260,482 +579,771 @@ static bool subghz_toolkit_export_keeloq_keys(SubGhzToolkitApp *app)
     return success;
 }
 
-static void subghz_toolkit_extract_protocol_details(SubGhzToolkitApp *app, const char *protocol_name)
+static bool subghz_toolkit_export_keeloq_keys(SubGhzToolkitApp *app)
 {
-    furi_string_reset(app->text_buffer);
-    furi_string_cat_printf(app->text_buffer, "=== %s Protocol Analysis ===\n\n", protocol_name);
+    return subghz_toolkit_export_keeloq(app, SubGhzToolkitKeeloqFormatText, SUBGHZ_ANALYSIS_DIR "/keeloq_keys.txt");
+}
 
-    const SubGhzProtocol *protocol = NULL;
-    size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
+static bool subghz_toolkit_export_keeloq_keys_csv(SubGhzToolkitApp *app)
+{
+    return subghz_toolkit_export_keeloq(app, SubGhzToolkitKeeloqFormatCsv, SUBGHZ_ANALYSIS_DIR "/keeloq_keys.csv");
+}
 
-    for (size_t i = 0; i < protocol_count; i++)
-    {
-        const SubGhzProtocol *p = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
-        if (p && p->name && strcmp(p->name, protocol_name) == 0)
-        {
-            protocol = p;
-            break;
-        }
-    }
+static bool subghz_toolkit_export_keeloq_keys_binary(SubGhzToolkitApp *app)
+{
+    return subghz_toolkit_export_keeloq(app, SubGhzToolkitKeeloqFormatBinary, SUBGHZ_ANALYSIS_DIR "/keeloq_keys.bin");
+}
 
-    if (!protocol)
-    {
-        furi_string_cat_str(app->text_buffer, "Protocol not found!\n");
-        text_box_set_text(app->text_box, furi_string_get_cstr(app->text_buffer));
-        view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewTextBox);
-        return;
-    }
+// Lazily created SubGhz resources. Most sessions only list protocols, so the
+// keystores, the receiver (one decoder per protocol) and the settings file are
+// loaded the first time something needs them. Callable from the worker thread.
 
-    furi_string_cat_printf(app->text_buffer, "Protocol Name: %s\n", protocol->name);
-    furi_string_cat_printf(app->text_buffer, "Type: ");
-    switch (protocol->type)
+static void subghz_toolkit_log_first_use(const char *what, uint32_t start_tick, size_t free_heap_before)
+{
+    size_t free_heap_after = memmgr_get_free_heap();
+    FURI_LOG_I(TAG, "%s loaded in %lu ms, %ld bytes of heap",
+               what,
+               furi_get_tick() - start_tick,
+               (int32_t)(free_heap_before - free_heap_after));
+}
+
+static SubGhzEnvironment *subghz_toolkit_get_environment(SubGhzToolkitApp *app)
+{
+    furi_mutex_acquire(app->resource_mutex, FuriWaitForever);
+    if (!app->environment)
     {
-    case SubGhzProtocolTypeStatic:
-        furi_string_cat_str(app->text_buffer, "Static\n");
-        break;
-    case SubGhzProtocolTypeDynamic:
-        furi_string_cat_str(app->text_buffer, "Dynamic\n");
-        break;
-    case SubGhzProtocolTypeRAW:
-        furi_string_cat_str(app->text_buffer, "RAW\n");
-        break;
-    default:
-        furi_string_cat_str(app->text_buffer, "Unknown\n");
-        break;
+        uint32_t start_tick = furi_get_tick();
+        size_t free_heap = memmgr_get_free_heap();
+
+        app->environment = subghz_environment_alloc();
+        subghz_environment_load_keystore(app->environment, SUBGHZ_KEYSTORE_PATH);
+        subghz_environment_load_keystore(app->environment, SUBGHZ_KEYSTORE_USER_PATH);
+        subghz_environment_set_protocol_registry(app->environment, (void *)&subghz_protocol_registry);
+
+        subghz_toolkit_log_first_use("Environment", start_tick, free_heap);
     }
+    furi_mutex_release(app->resource_mutex);
 
-    furi_string_cat_printf(app->text_buffer, "Flag: 0x%08lX\n", (uint32_t)protocol->flag);
+    return app->environment;
+}
 
-    if (protocol->decoder)
+static SubGhzReceiver *subghz_toolkit_get_receiver(SubGhzToolkitApp *app)
+{
+    SubGhzEnvironment *environment = subghz_toolkit_get_environment(app);
+
+    furi_mutex_acquire(app->resource_mutex, FuriWaitForever);
+    if (!app->receiver)
     {
-        furi_string_cat_printf(app->text_buffer, "\nDecoder Functions:\n");
-        furi_string_cat_printf(app->text_buffer, "- Alloc: %p\n", protocol->decoder->alloc);
-        furi_string_cat_printf(app->text_buffer, "- Free: %p\n", protocol->decoder->free);
-        furi_string_cat_printf(app->text_buffer, "- Feed: %p\n", protocol->decoder->feed);
-        furi_string_cat_printf(app->text_buffer, "- Reset: %p\n", protocol->decoder->reset);
-        furi_string_cat_printf(app->text_buffer, "- Get String: %p\n", protocol->decoder->get_string);
-        furi_string_cat_printf(app->text_buffer, "- Serialize: %p\n", protocol->decoder->serialize);
-        furi_string_cat_printf(app->text_buffer, "- Deserialize: %p\n", protocol->decoder->deserialize);
-        furi_string_cat_printf(app->text_buffer, "- Get Hash: %p\n", protocol->decoder->get_hash_data);
+        uint32_t start_tick = furi_get_tick();
+        size_t free_heap = memmgr_get_free_heap();
+
+        app->receiver = subghz_receiver_alloc_init(environment);
+
+        subghz_toolkit_log_first_use("Receiver", start_tick, free_heap);
     }
+    furi_mutex_release(app->resource_mutex);
 
-    if (protocol->encoder)
+    return app->receiver;
+}
+
+static SubGhzSetting *subghz_toolkit_get_setting(SubGhzToolkitApp *app)
+{
+    furi_mutex_acquire(app->resource_mutex, FuriWaitForever);
+    if (!app->setting)
     {
-        furi_string_cat_printf(app->text_buffer, "\nEncoder Functions:\n");
-        furi_string_cat_printf(app->text_buffer, "- Alloc: %p\n", protocol->encoder->alloc);
-        furi_string_cat_printf(app->text_buffer, "- Free: %p\n", protocol->encoder->free);
-        furi_string_cat_printf(app->text_buffer, "- Deserialize: %p\n", protocol->encoder->deserialize);
-        furi_string_cat_printf(app->text_buffer, "- Stop: %p\n", protocol->encoder->stop);
-        furi_string_cat_printf(app->text_buffer, "- Yield: %p\n", protocol->encoder->yield);
+        uint32_t start_tick = furi_get_tick();
+        size_t free_heap = memmgr_get_free_heap();
+
+        app->setting = subghz_setting_alloc();
+        subghz_setting_load(app->setting, EXT_PATH("subghz/assets/setting_user"));
+
+        subghz_toolkit_log_first_use("Settings", start_tick, free_heap);
     }
+    furi_mutex_release(app->resource_mutex);
 
-    if (app->setting)
+    return app->setting;
+}
+
+// KeeLoq key index, see helpers/subghz_toolkit_key_index.h. Decrypting the
+// keystores is the slow part, so the index is saved to SD and only rebuilt
+// when the keystore files change size or modification time.
+
+static uint32_t subghz_toolkit_keystore_stamp(Storage *storage)
+{
+    static const char *const paths[] = {SUBGHZ_KEYSTORE_PATH, SUBGHZ_KEYSTORE_USER_PATH};
+    uint32_t stamp = 0;
+
+    for (size_t i = 0; i < COUNT_OF(paths); i++)
     {
-        furi_string_cat_printf(app->text_buffer, "\nSupported Frequencies:\n");
-        for (size_t i = 0; i < subghz_setting_get_frequency_count(app->setting); i++)
+        FileInfo info;
+        uint32_t size = 0;
+        uint32_t time = 0;
+        if (storage_common_stat(storage, paths[i], &info) == FSE_OK)
         {
-            uint32_t freq = subghz_setting_get_frequency(app->setting, i);
-            furi_string_cat_printf(app->text_buffer, "- %lu Hz\n", freq);
+            // An edit that keeps the size still changes the time
+            size = (uint32_t)info.size;
+            storage_common_timestamp(storage, paths[i], &time);
         }
+        stamp = stamp * 2654435761u + size;
+        stamp = stamp * 2654435761u + time;
     }
-
-    text_box_set_text(app->text_box, furi_string_get_cstr(app->text_buffer));
-    text_box_set_focus(app->text_box, TextBoxFocusStart);
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewTextBox);
+    return stamp;
 }
 
-static void subghz_toolkit_export_all_protocol_info(SubGhzToolkitApp *app)
+static SubGhzToolkitKeyIndex *subghz_toolkit_load_key_index(Storage *storage, uint32_t stamp)
 {
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewLoading);
-
-    bool success = false;
-    Storage *storage = furi_record_open(RECORD_STORAGE);
-    Stream *stream = file_stream_alloc(storage);
+    SubGhzToolkitKeyIndex *index = NULL;
+    File *file = storage_file_alloc(storage);
 
-    do
+    if (storage_file_open(file, SUBGHZ_KEY_INDEX_PATH, FSAM_READ, FSOM_OPEN_EXISTING))
     {
-        storage_simply_mkdir(storage, EXT_PATH("subghz"));
-        storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+        size_t size = storage_file_size(file);
+        uint8_t *data = malloc(size);
 
-        if (!file_stream_open(stream, SUBGHZ_ANALYSIS_DIR "/protocol_analysis.txt",
-                              FSAM_WRITE, FSOM_CREATE_ALWAYS))
+        if (storage_file_read(file, data, size) == size)
+            index = subghz_toolkit_key_index_wrap(data, size, true);
+
+        if (!index)
         {
-            break;
+            FURI_LOG_W(TAG, "Ignoring invalid key index");
+            free(data);
         }
-
-        stream_write_format(stream,
-                            "==============================================\n"
-                            "     SubGhz Protocol Implementation Analysis\n"
-                            "           Generated by SubGhz Toolkit\n"
-                            "           RocketGod | betaskynet.com\n"
-                            "==============================================\n\n");
-
-        const Version *ver = furi_hal_version_get_firmware_version();
-        stream_write_format(stream,
-                            "Firmware Info:\n"
-                            "Version: %s\n"
-                            "Build Date: %s\n"
-                            "Git Hash: %s\n"
-                            "Target: %d\n\n",
-                            version_get_version(ver),
-                            version_get_builddate(ver),
-                            version_get_githash(ver),
-                            version_get_target(ver));
-
-        size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
-        stream_write_format(stream, "Total Protocols: %zu\n\n", protocol_count);
-
-        for (size_t i = 0; i < protocol_count; i++)
+        else if (subghz_toolkit_key_index_source_stamp(index) != stamp)
         {
-            const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
-            if (!protocol || !protocol->name)
-                continue;
+            FURI_LOG_I(TAG, "Keystore changed, rebuilding key index");
+            subghz_toolkit_key_index_free(index);
+            index = NULL;
+        }
+    }
 
-            stream_write_format(stream, "\n========== %s ==========\n", protocol->name);
+    storage_file_close(file);
+    storage_file_free(file);
+    return index;
+}
 
-            stream_write_format(stream,
-                                "Type: %s\n"
-                                "Flag: 0x%08lX\n",
-                                protocol->type == SubGhzProtocolTypeStatic ? "Static" : protocol->type == SubGhzProtocolTypeDynamic ? "Dynamic"
-                                                                                                                                    : "RAW",
-                                (uint32_t)protocol->flag);
+// Runs on the worker: decrypting the keystores takes seconds, so the build
+// reports progress and stops without saving when cancelled.
+static SubGhzToolkitKeyIndex *subghz_toolkit_build_key_index(SubGhzToolkitApp *app, Storage *storage, uint32_t stamp)
+{
+    subghz_toolkit_worker_report(app->worker, 0, 1, "Decrypting keystores");
+    SubGhzKeystore *keystore = subghz_keystore_alloc();
+    subghz_keystore_load(keystore, SUBGHZ_KEYSTORE_PATH);
+    subghz_keystore_load(keystore, SUBGHZ_KEYSTORE_USER_PATH);
 
-            if (protocol->decoder)
-            {
-                stream_write_format(stream,
-                                    "\nDecoder Functions:\n"
-                                    "  Alloc:       %p\n"
-                                    "  Free:        %p\n"
-                                    "  Reset:       %p\n"
-                                    "  Feed:        %p\n"
-                                    "  Get String:  %p\n"
-                                    "  Serialize:   %p\n"
-                                    "  Deserialize: %p\n"
-                                    "  Get Hash:    %p\n",
-                                    protocol->decoder->alloc,
-                                    protocol->decoder->free,
-                                    protocol->decoder->reset,
-                                    protocol->decoder->feed,
-                                    protocol->decoder->get_string,
-                                    protocol->decoder->serialize,
-                                    protocol->decoder->deserialize,
-                                    protocol->decoder->get_hash_data);
-            }
+    SubGhzKeyArray_t *keys = subghz_keystore_get_data(keystore);
+    size_t key_count = SubGhzKeyArray_size(*keys);
+    SubGhzToolkitKeyIndex *index = subghz_toolkit_key_index_alloc(key_count);
 
-            if (protocol->encoder)
-            {
-                stream_write_format(stream,
-                                    "\nEncoder Functions:\n"
-                                    "  Alloc:       %p\n"
-                                    "  Free:        %p\n"
-                                    "  Deserialize: %p\n"
-                                    "  Stop:        %p\n"
-                                    "  Yield:       %p\n",
-                                    protocol->encoder->alloc,
-                                    protocol->encoder->free,
-                                    protocol->encoder->deserialize,
-                                    protocol->encoder->stop,
-                                    protocol->encoder->yield);
-            }
+    for (size_t i = 0; i < key_count; i++)
+    {
+        if (subghz_toolkit_worker_is_cancelled(app->worker))
+        {
+            subghz_toolkit_key_index_free(index);
+            subghz_keystore_free(keystore);
+            return NULL;
         }
+        const SubGhzKey *key = SubGhzKeyArray_get(*keys, i);
+        subghz_toolkit_key_index_add(index, furi_string_get_cstr(key->name), key->key, key->type);
+        subghz_toolkit_worker_report(app->worker, i + 1, key_count, "Indexing keys");
+    }
+    subghz_keystore_free(keystore);
 
-        success = true;
-    } while (0);
+    subghz_toolkit_worker_report(app->worker, key_count, key_count, "Sorting and saving index");
+    subghz_toolkit_key_index_build(index, stamp);
 
-    stream_free(stream);
-    furi_record_close(RECORD_STORAGE);
+    size_t size;
+    const void *data = subghz_toolkit_key_index_get_data(index, &size);
+    File *file = storage_file_alloc(storage);
 
-    if (success)
+    storage_simply_mkdir(storage, EXT_PATH("subghz"));
+    storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+    if (!storage_file_open(file, SUBGHZ_KEY_INDEX_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS) ||
+        storage_file_write(file, data, size) != size)
     {
-        popup_set_header(app->popup, "Success!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Protocol info exported to:\n/ext/subghz/analysis/protocol_analysis.txt",
-                       64, 20, AlignCenter, AlignTop);
+        FURI_LOG_E(TAG, "Failed to save key index");
     }
-    else
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return index;
+}
+
+// Built on first use, so only call it from a worker job
+static SubGhzToolkitKeyIndex *subghz_toolkit_get_key_index(SubGhzToolkitApp *app)
+{
+    furi_mutex_acquire(app->resource_mutex, FuriWaitForever);
+    if (!app->key_index)
     {
-        popup_set_header(app->popup, "Error!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Failed to export protocol info", 64, 20, AlignCenter, AlignTop);
+        uint32_t start_tick = furi_get_tick();
+        size_t free_heap = memmgr_get_free_heap();
+        Storage *storage = furi_record_open(RECORD_STORAGE);
+        uint32_t stamp = subghz_toolkit_keystore_stamp(storage);
+
+        app->key_index = subghz_toolkit_load_key_index(storage, stamp);
+        if (!app->key_index)
+            app->key_index = subghz_toolkit_build_key_index(app, storage, stamp);
+
+        furi_record_close(RECORD_STORAGE);
+        subghz_toolkit_log_first_use("Key index", start_tick, free_heap);
     }
+    furi_mutex_release(app->resource_mutex);
 
-    popup_set_callback(app->popup, subghz_toolkit_popup_callback);
-    popup_set_context(app->popup, app);
-    popup_set_timeout(app->popup, 3000);
-    popup_enable_timeout(app->popup);
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewPopup);
+    return app->key_index;
 }
 
-static void subghz_toolkit_deep_protocol_analysis(Stream *stream, const SubGhzProtocol *protocol, SubGhzEnvironment *env)
-{
-    stream_write_format(stream, "\n  === DEEP ANALYSIS ===\n");
+// Firmware symbols, see helpers/subghz_toolkit_symbols.h and tools/symbolize.c.
+// The file is optional and only used when it was built from this firmware;
+// it stays open (with the storage record) while the app runs since lookups
+// seek into it.
 
-    stream_write_format(stream, "  Protocol Structure:\n");
-    stream_write_format(stream, "    Protocol Ptr: %p\n", protocol);
-    stream_write_format(stream, "    Name Ptr: %p -> \"%s\"\n", protocol->name, protocol->name);
-    stream_write_format(stream, "    Type Value: 0x%02X\n", protocol->type);
-    stream_write_format(stream, "    Flag Value: 0x%08lX\n", (uint32_t)protocol->flag);
+static size_t subghz_toolkit_symbols_file_read(void *context, uint32_t offset, void *data, size_t size)
+{
+    File *file = context;
+    if (!storage_file_seek(file, offset, true))
+        return 0;
+    return storage_file_read(file, data, size);
+}
 
-    if (protocol->decoder)
+static SubGhzToolkitSymbols *subghz_toolkit_get_symbols(SubGhzToolkitApp *app)
+{
+    furi_mutex_acquire(app->resource_mutex, FuriWaitForever);
+    if (!app->symbols_loaded)
     {
-        stream_write_format(stream, "\n  Decoder Structure Analysis:\n");
-        stream_write_format(stream, "    Decoder Ptr: %p\n", protocol->decoder);
-        stream_write_format(stream, "    Size: %zu bytes\n", sizeof(*protocol->decoder));
+        uint32_t start_tick = furi_get_tick();
+        size_t free_heap = memmgr_get_free_heap();
+        Storage *storage = furi_record_open(RECORD_STORAGE);
 
-        stream_write_format(stream, "\n    Function Entry Points:\n");
-        if (protocol->decoder->alloc)
+        app->symbols_loaded = true;
+        app->symbol_file = storage_file_alloc(storage);
+        if (storage_file_open(app->symbol_file, SUBGHZ_SYMBOLS_PATH, FSAM_READ, FSOM_OPEN_EXISTING))
         {
-            stream_write_format(stream, "      Alloc @ %p", protocol->decoder->alloc);
-            uint8_t *func_bytes = (uint8_t *)protocol->decoder->alloc;
-            stream_write_format(stream, " [");
-            for (int i = 0; i < 8; i++)
+            app->symbols = subghz_toolkit_symbols_open(subghz_toolkit_symbols_file_read, app->symbol_file);
+            if (!app->symbols)
             {
-                stream_write_format(stream, "%02X ", func_bytes[i]);
+                FURI_LOG_W(TAG, "Ignoring invalid symbol file");
             }
-            stream_write_format(stream, "...]\n");
-        }
+            else if (subghz_toolkit_symbols_anchor(app->symbols) != (uint32_t)(uintptr_t)&subghz_protocol_registry)
+            {
+                FURI_LOG_W(TAG, "Symbol file is from another firmware, ignoring it");
+                subghz_toolkit_symbols_free(app->symbols);
+                app->symbols = NULL;
+            }
+        }
 
-        if (protocol->decoder->alloc && env)
+        if (app->symbols)
         {
-            SubGhzProtocolDecoderBase *decoder = protocol->decoder->alloc(env);
-            if (decoder)
-            {
-                stream_write_format(stream, "\n    Decoder Instance Analysis:\n");
-                stream_write_format(stream, "      Instance Ptr: %p\n", decoder);
-                stream_write_format(stream, "      Protocol Ref: %p\n", decoder->protocol);
-                stream_write_format(stream, "      Callback: %p\n", decoder->callback);
+            subghz_toolkit_log_first_use("Symbols", start_tick, free_heap);
+        }
+        else
+        {
+            storage_file_close(app->symbol_file);
+            storage_file_free(app->symbol_file);
+            app->symbol_file = NULL;
+            furi_record_close(RECORD_STORAGE);
+        }
+    }
+    furi_mutex_release(app->resource_mutex);
 
-                if (decoder->protocol)
-                {
-                    stream_write_format(stream, "      Protocol Name: %s\n",
-                                        decoder->protocol->name ? decoder->protocol->name : "NULL");
-                }
+    return app->symbols;
+}
 
-                if (protocol->decoder->free)
-                {
-                    protocol->decoder->free(decoder);
-                }
-            }
-        }
+static void subghz_toolkit_show_text(SubGhzToolkitApp *app)
+{
+    text_box_set_text(app->text_box, furi_string_get_cstr(app->text_buffer));
+    text_box_set_focus(app->text_box, TextBoxFocusStart);
+    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewTextBox);
+}
+
+static bool subghz_toolkit_key_lookup_run(SubGhzToolkitApp *app)
+{
+    SubGhzToolkitKeyIndex *index = subghz_toolkit_get_key_index(app);
+    if (!index)
+        return false;
+
+    uint64_t key = 0;
+    for (size_t i = 0; i < sizeof(app->key_input); i++)
+        key = (key << 8) | app->key_input[i];
+
+    const SubGhzToolkitKeyfileRecord *found[SUBGHZ_TOOLKIT_LOOKUP_MAX_RESULTS];
+    size_t matches = subghz_toolkit_key_index_find_key(index, key, found, COUNT_OF(found));
+
+    furi_string_printf(app->text_buffer, "Key: %016llX\n\n", key);
+    if (!matches)
+        furi_string_cat_str(app->text_buffer, "No manufacturer found\n");
+
+    for (size_t i = 0; i < matches && i < COUNT_OF(found); i++)
+    {
+        furi_string_cat_printf(app->text_buffer, "Manufacturer: %s\nType: %hu\n\n", found[i]->name, found[i]->type);
     }
+    furi_string_cat_printf(app->text_buffer, "\n%lu keys indexed\n", subghz_toolkit_key_index_count(index));
+    return true;
+}
 
-    if (protocol->encoder)
+static void subghz_toolkit_key_lookup_callback(void *context)
+{
+    static const SubGhzToolkitJob job = {
+        .title = "Key Lookup",
+        .run = subghz_toolkit_key_lookup_run,
+        .error_text = "Failed to build key index",
+        .show_text = true,
+    };
+    subghz_toolkit_start_job(context, &job);
+}
+
+static bool subghz_toolkit_name_lookup_run(SubGhzToolkitApp *app)
+{
+    SubGhzToolkitKeyIndex *index = subghz_toolkit_get_key_index(app);
+    if (!index)
+        return false;
+
+    uint32_t first;
+    uint32_t matches = subghz_toolkit_key_index_find_prefix(index, app->name_input, &first);
+
+    furi_string_printf(app->text_buffer, "Manufacturers matching \"%s\": %lu\n\n", app->name_input, matches);
+    for (uint32_t i = 0; i < matches && i < SUBGHZ_TOOLKIT_LOOKUP_MAX_RESULTS; i++)
     {
-        stream_write_format(stream, "\n  Encoder Structure Analysis:\n");
-        stream_write_format(stream, "    Encoder Ptr: %p\n", protocol->encoder);
-        stream_write_format(stream, "    Size: %zu bytes\n", sizeof(*protocol->encoder));
+        const SubGhzToolkitKeyfileRecord *record = subghz_toolkit_key_index_get(index, first + i);
+        furi_string_cat_printf(
+            app->text_buffer, "%s\nKey: %016llX\nType: %hu\n\n", record->name, record->key, record->type);
+    }
+    if (matches > SUBGHZ_TOOLKIT_LOOKUP_MAX_RESULTS)
+        furi_string_cat_printf(app->text_buffer, "... %lu more\n", matches - SUBGHZ_TOOLKIT_LOOKUP_MAX_RESULTS);
+    if (strlen(app->name_input) == sizeof(app->name_input) - 1)
+        furi_string_cat_printf(app->text_buffer, "\nNames are indexed up to %zu characters,\nlonger ones match on those\n",
+                               sizeof(app->name_input) - 1);
+    return true;
+}
 
-        stream_write_format(stream, "\n    Function Entry Points:\n");
-        if (protocol->encoder->alloc)
+static void subghz_toolkit_name_lookup_callback(void *context)
+{
+    static const SubGhzToolkitJob job = {
+        .title = "Name Lookup",
+        .run = subghz_toolkit_name_lookup_run,
+        .error_text = "Failed to build key index",
+        .show_text = true,
+    };
+    subghz_toolkit_start_job(context, &job);
+}
+
+static void subghz_toolkit_show_key_lookup(SubGhzToolkitApp *app)
+{
+    byte_input_set_header_text(app->byte_input, "Keeloq key (hex)");
+    byte_input_set_result_callback(
+        app->byte_input,
+        subghz_toolkit_key_lookup_callback,
+        NULL,
+        app,
+        app->key_input,
+        sizeof(app->key_input));
+    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewByteInput);
+}
+
+static void subghz_toolkit_show_name_lookup(SubGhzToolkitApp *app)
+{
+    text_input_reset(app->text_input);
+    text_input_set_header_text(app->text_input, "Manufacturer name or prefix");
+    text_input_set_result_callback(
+        app->text_input,
+        subghz_toolkit_name_lookup_callback,
+        app,
+        app->name_input,
+        sizeof(app->name_input),
+        false);
+    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewTextInput);
+}
+
+// Name to registry index, built once at startup. Entry point for any name based lookup.
+static void subghz_toolkit_build_protocol_index(SubGhzToolkitApp *app)
+{
+    size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
+    app->protocol_index = subghz_toolkit_name_index_alloc(protocol_count);
+
+    for (size_t i = 0; i < protocol_count; i++)
+    {
+        const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
+        if (protocol && protocol->name && !subghz_toolkit_name_index_add(app->protocol_index, protocol->name, i))
         {
-            stream_write_format(stream, "      Alloc @ %p", protocol->encoder->alloc);
-            uint8_t *func_bytes = (uint8_t *)protocol->encoder->alloc;
-            stream_write_format(stream, " [");
-            for (int i = 0; i < 8; i++)
-            {
-                stream_write_format(stream, "%02X ", func_bytes[i]);
-            }
-            stream_write_format(stream, "...]\n");
+            FURI_LOG_W(TAG, "Duplicate protocol name: %s", protocol->name);
         }
     }
+}
+
+// For callers that only have a name; the menu already has the registry index.
+// Inline while no menu path calls it, so the build does not warn about it.
+static inline const SubGhzProtocol *subghz_toolkit_find_protocol(SubGhzToolkitApp *app, const char *name, size_t *index)
+{
+    size_t found;
+    if (!name || !subghz_toolkit_name_index_find(app->protocol_index, name, &found))
+        return NULL;
 
-    stream_write_format(stream, "\n  Memory Layout:\n");
-    stream_write_format(stream, "    Protocol @ %p\n", protocol);
-    stream_write_format(stream, "    +0x00: name     = %p\n", &protocol->name);
-    stream_write_format(stream, "    +0x04: type     = %p\n", &protocol->type);
-    stream_write_format(stream, "    +0x08: flag     = %p\n", &protocol->flag);
-    stream_write_format(stream, "    +0x0C: decoder  = %p\n", &protocol->decoder);
-    stream_write_format(stream, "    +0x10: encoder  = %p\n", &protocol->encoder);
+    if (index)
+        *index = found;
+    return subghz_protocol_registry_get_by_index(app->protocol_registry, found);
 }
 
-static void subghz_toolkit_advanced_analysis(SubGhzToolkitApp *app)
+static void subghz_toolkit_extract_protocol_details(SubGhzToolkitApp *app, size_t protocol_index)
 {
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewLoading);
+    const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, protocol_index);
 
-    bool success = false;
-    Storage *storage = furi_record_open(RECORD_STORAGE);
-    Stream *stream = file_stream_alloc(storage);
+    furi_string_reset(app->text_buffer);
+    if (!protocol || !protocol->name)
+    {
+        furi_string_cat_str(app->text_buffer, "Protocol not found!\n");
+        text_box_set_text(app->text_box, furi_string_get_cstr(app->text_buffer));
+        view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewTextBox);
+        return;
+    }
 
-    do
+    furi_string_cat_printf(app->text_buffer, "=== %s Protocol Analysis ===\n\n", protocol->name);
+    furi_string_cat_printf(app->text_buffer, "Protocol Name: %s\n", protocol->name);
+    furi_string_cat_printf(app->text_buffer, "Type: ");
+    switch (protocol->type)
     {
-        storage_simply_mkdir(storage, EXT_PATH("subghz"));
-        storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+    case SubGhzProtocolTypeStatic:
+        furi_string_cat_str(app->text_buffer, "Static\n");
+        break;
+    case SubGhzProtocolTypeDynamic:
+        furi_string_cat_str(app->text_buffer, "Dynamic\n");
+        break;
+    case SubGhzProtocolTypeRAW:
+        furi_string_cat_str(app->text_buffer, "RAW\n");
+        break;
+    default:
+        furi_string_cat_str(app->text_buffer, "Unknown\n");
+        break;
+    }
+
+    furi_string_cat_printf(app->text_buffer, "Flag: 0x%08lX\n", (uint32_t)protocol->flag);
+
+    if (protocol->decoder)
+    {
+        furi_string_cat_printf(app->text_buffer, "\nDecoder Functions:\n");
+        furi_string_cat_printf(app->text_buffer, "- Alloc: %p\n", protocol->decoder->alloc);
+        furi_string_cat_printf(app->text_buffer, "- Free: %p\n", protocol->decoder->free);
+        furi_string_cat_printf(app->text_buffer, "- Feed: %p\n", protocol->decoder->feed);
+        furi_string_cat_printf(app->text_buffer, "- Reset: %p\n", protocol->decoder->reset);
+        furi_string_cat_printf(app->text_buffer, "- Get String: %p\n", protocol->decoder->get_string);
+        furi_string_cat_printf(app->text_buffer, "- Serialize: %p\n", protocol->decoder->serialize);
+        furi_string_cat_printf(app->text_buffer, "- Deserialize: %p\n", protocol->decoder->deserialize);
+        furi_string_cat_printf(app->text_buffer, "- Get Hash: %p\n", protocol->decoder->get_hash_data);
+    }
+
+    if (protocol->encoder)
+    {
+        furi_string_cat_printf(app->text_buffer, "\nEncoder Functions:\n");
+        furi_string_cat_printf(app->text_buffer, "- Alloc: %p\n", protocol->encoder->alloc);
+        furi_string_cat_printf(app->text_buffer, "- Free: %p\n", protocol->encoder->free);
+        furi_string_cat_printf(app->text_buffer, "- Deserialize: %p\n", protocol->encoder->deserialize);
+        furi_string_cat_printf(app->text_buffer, "- Stop: %p\n", protocol->encoder->stop);
+        furi_string_cat_printf(app->text_buffer, "- Yield: %p\n", protocol->encoder->yield);
+    }
 
-        if (!file_stream_open(stream, SUBGHZ_ANALYSIS_DIR "/advanced_analysis.txt",
-                              FSAM_WRITE, FSOM_CREATE_ALWAYS))
+    SubGhzSetting *setting = subghz_toolkit_get_setting(app);
+    if (setting)
+    {
+        furi_string_cat_printf(app->text_buffer, "\nSupported Frequencies:\n");
+        for (size_t i = 0; i < subghz_setting_get_frequency_count(setting); i++)
         {
-            break;
+            uint32_t freq = subghz_setting_get_frequency(setting, i);
+            furi_string_cat_printf(app->text_buffer, "- %lu Hz\n", freq);
         }
+    }
+
+    text_box_set_text(app->text_box, furi_string_get_cstr(app->text_buffer));
+    text_box_set_focus(app->text_box, TextBoxFocusStart);
+    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewTextBox);
+}
 
-        stream_write_format(stream,
-                            "==============================================================\n"
-                            "        SubGhz Protocol ADVANCED Implementation Analysis\n"
-                            "                  Generated by SubGhz Toolkit\n"
-                            "                 RocketGod | betaskynet.com\n"
-                            "==============================================================\n\n");
-
-        const Version *ver = furi_hal_version_get_firmware_version();
-        stream_write_format(stream,
-                            "System Information:\n"
-                            "  Firmware Version: %s\n"
-                            "  Build Date: %s\n"
-                            "  Git Hash: %s\n"
-                            "  Target: %d\n"
-                            "  HW Version: %d\n"
-                            "  HW Target: %d\n"
-                            "  HW Body: %d\n"
-                            "  HW Connect: %d\n"
-                            "  HW Region: %d\n"
-                            "  HW Display: %d\n\n",
-                            version_get_version(ver),
-                            version_get_builddate(ver),
-                            version_get_githash(ver),
-                            version_get_target(ver),
-                            furi_hal_version_get_hw_version(),
-                            furi_hal_version_get_hw_target(),
-                            furi_hal_version_get_hw_body(),
-                            furi_hal_version_get_hw_connect(),
-                            furi_hal_version_get_hw_region(),
-                            furi_hal_version_get_hw_display());
-
-        stream_write_format(stream, "Protocol Registry Analysis:\n");
-        stream_write_format(stream, "  Registry Ptr: %p\n", app->protocol_registry);
-        stream_write_format(stream, "  Protocol Count: %zu\n", subghz_protocol_registry_count(app->protocol_registry));
-        stream_write_format(stream, "  Registry Symbol: subghz_protocol_registry @ %p\n\n", &subghz_protocol_registry);
-
-        stream_write_format(stream, "SubGhz Environment Analysis:\n");
-        stream_write_format(stream, "  Environment Ptr: %p\n", app->environment);
-        stream_write_format(stream, "  Receiver Ptr: %p\n", app->receiver);
-        stream_write_format(stream, "  Setting Ptr: %p\n\n", app->setting);
+// Firmware address as "0x%08lX <symbol+off>" on its own line, see subghz_toolkit_get_symbols()
+static void subghz_toolkit_write_pointer(SubGhzToolkitWriter *writer, SubGhzToolkitSymbols *symbols, const char *label, const void *pointer)
+{
+    subghz_toolkit_writer_cstr(writer, label);
+    subghz_toolkit_symbols_write_address(writer, symbols, (uint32_t)(uintptr_t)pointer);
+    subghz_toolkit_writer_cstr(writer, "\n");
+}
 
-        size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
+static void subghz_toolkit_protocol_info_begin(SubGhzToolkitPassContext *ctx)
+{
+    const Version *ver = furi_hal_version_get_firmware_version();
+    subghz_toolkit_writer_printf(ctx->writer,
+                                 "Firmware Info:\n"
+                                 "Version: %s\n"
+                                 "Build Date: %s\n"
+                                 "Git Hash: %s\n"
+                                 "Target: %d\n\n",
+                                 version_get_version(ver),
+                                 version_get_builddate(ver),
+                                 version_get_githash(ver),
+                                 version_get_target(ver));
+
+    subghz_toolkit_writer_printf(ctx->writer, "Total Protocols: %zu\n\n",
+                                 subghz_protocol_registry_count(ctx->app->protocol_registry));
+}
 
-        for (size_t i = 0; i < protocol_count; i++)
-        {
-            const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
-            if (!protocol || !protocol->name)
-                continue;
+static void subghz_toolkit_protocol_info_protocol(SubGhzToolkitPassContext *ctx, size_t index, const SubGhzProtocol *protocol)
+{
+    UNUSED(index);
+    SubGhzToolkitWriter *writer = ctx->writer;
+    SubGhzToolkitSymbols *symbols = subghz_toolkit_get_symbols(ctx->app);
 
-            stream_write_format(stream, "\n████████████████████████████████████████████████████████████\n");
-            stream_write_format(stream, "Protocol #%zu: %s\n", i, protocol->name);
-            stream_write_format(stream, "████████████████████████████████████████████████████████████\n");
-
-            stream_write_format(stream, "\nBasic Information:\n");
-            stream_write_format(stream, "  Name: %s\n", protocol->name);
-            stream_write_format(stream, "  Type: 0x%02X (%s)\n",
-                                protocol->type,
-                                protocol->type == SubGhzProtocolTypeStatic ? "Static" : protocol->type == SubGhzProtocolTypeDynamic ? "Dynamic"
-                                                                                                                                    : "RAW");
-            stream_write_format(stream, "  Flag: 0x%08lX\n", (uint32_t)protocol->flag);
-
-            stream_write_format(stream, "\n  Flag Breakdown:\n");
-            stream_write_format(stream, "    Decodable:       %s\n", (protocol->flag & SubGhzProtocolFlag_Decodable) ? "YES" : "NO");
-            stream_write_format(stream, "    Save:            %s\n", (protocol->flag & SubGhzProtocolFlag_Save) ? "YES" : "NO");
-            stream_write_format(stream, "    Load:            %s\n", (protocol->flag & SubGhzProtocolFlag_Load) ? "YES" : "NO");
-            stream_write_format(stream, "    Send:            %s\n", (protocol->flag & SubGhzProtocolFlag_Send) ? "YES" : "NO");
-            stream_write_format(stream, "    BinRAW:          %s\n", (protocol->flag & SubGhzProtocolFlag_BinRAW) ? "YES" : "NO");
-
-            if (protocol->decoder)
-            {
-                stream_write_format(stream, "\nDecoder Implementation:\n");
-                stream_write_format(stream, "  Structure Address: %p\n", protocol->decoder);
-                stream_write_format(stream, "\n  Function Pointers:\n");
-                stream_write_format(stream, "    alloc:          %p\n", protocol->decoder->alloc);
-                stream_write_format(stream, "    free:           %p\n", protocol->decoder->free);
-                stream_write_format(stream, "    reset:          %p\n", protocol->decoder->reset);
-                stream_write_format(stream, "    feed:           %p\n", protocol->decoder->feed);
-                stream_write_format(stream, "    get_string:     %p\n", protocol->decoder->get_string);
-                stream_write_format(stream, "    serialize:      %p\n", protocol->decoder->serialize);
-                stream_write_format(stream, "    deserialize:    %p\n", protocol->decoder->deserialize);
-                stream_write_format(stream, "    get_hash_data:  %p\n", protocol->decoder->get_hash_data);
-            }
+    subghz_toolkit_writer_printf(writer, "\n========== %s ==========\n", protocol->name);
 
-            if (protocol->encoder)
-            {
-                stream_write_format(stream, "\nEncoder Implementation:\n");
-                stream_write_format(stream, "  Structure Address: %p\n", protocol->encoder);
-                stream_write_format(stream, "\n  Function Pointers:\n");
-                stream_write_format(stream, "    alloc:          %p\n", protocol->encoder->alloc);
-                stream_write_format(stream, "    free:           %p\n", protocol->encoder->free);
-                stream_write_format(stream, "    deserialize:    %p\n", protocol->encoder->deserialize);
-                stream_write_format(stream, "    stop:           %p\n", protocol->encoder->stop);
-                stream_write_format(stream, "    yield:          %p\n", protocol->encoder->yield);
-            }
+    subghz_toolkit_writer_printf(writer,
+                                 "Type: %s\n"
+                                 "Flag: 0x%08lX\n",
+                                 protocol->type == SubGhzProtocolTypeStatic ? "Static" : protocol->type == SubGhzProtocolTypeDynamic ? "Dynamic"
+                                                                                                                                     : "RAW",
+                                 (uint32_t)protocol->flag);
 
-            subghz_toolkit_deep_protocol_analysis(stream, protocol, app->environment);
+    if (protocol->decoder)
+    {
+        subghz_toolkit_writer_cstr(writer, "\nDecoder Functions:\n");
+        subghz_toolkit_write_pointer(writer, symbols, "  Alloc:       ", protocol->decoder->alloc);
+        subghz_toolkit_write_pointer(writer, symbols, "  Free:        ", protocol->decoder->free);
+        subghz_toolkit_write_pointer(writer, symbols, "  Reset:       ", protocol->decoder->reset);
+        subghz_toolkit_write_pointer(writer, symbols, "  Feed:        ", protocol->decoder->feed);
+        subghz_toolkit_write_pointer(writer, symbols, "  Get String:  ", protocol->decoder->get_string);
+        subghz_toolkit_write_pointer(writer, symbols, "  Serialize:   ", protocol->decoder->serialize);
+        subghz_toolkit_write_pointer(writer, symbols, "  Deserialize: ", protocol->decoder->deserialize);
+        subghz_toolkit_write_pointer(writer, symbols, "  Get Hash:    ", protocol->decoder->get_hash_data);
+    }
 
-            stream_write_format(stream, "\n");
-        }
+    if (protocol->encoder)
+    {
+        subghz_toolkit_writer_cstr(writer, "\nEncoder Functions:\n");
+        subghz_toolkit_write_pointer(writer, symbols, "  Alloc:       ", protocol->encoder->alloc);
+        subghz_toolkit_write_pointer(writer, symbols, "  Free:        ", protocol->encoder->free);
+        subghz_toolkit_write_pointer(writer, symbols, "  Deserialize: ", protocol->encoder->deserialize);
+        subghz_toolkit_write_pointer(writer, symbols, "  Stop:        ", protocol->encoder->stop);
+        subghz_toolkit_write_pointer(writer, symbols, "  Yield:       ", protocol->encoder->yield);
+    }
+}
 
-        stream_write_format(stream, "\n████████████████████████████████████████████████████████████\n");
-        stream_write_format(stream, "Memory Map Summary\n");
-        stream_write_format(stream, "████████████████████████████████████████████████████████████\n\n");
+static void subghz_toolkit_deep_protocol_analysis(SubGhzToolkitWriter *writer, SubGhzToolkitSymbols *symbols, const SubGhzProtocol *protocol, SubGhzEnvironment *env)
+{
+    subghz_toolkit_writer_cstr(writer, "\n  === DEEP ANALYSIS ===\n");
 
-        void *min_addr = (void *)0xFFFFFFFF;
-        void *max_addr = (void *)0x00000000;
+    subghz_toolkit_writer_cstr(writer, "  Protocol Structure:\n");
+    subghz_toolkit_write_pointer(writer, symbols, "    Protocol Ptr: ", protocol);
+    subghz_toolkit_writer_cstr(writer, "    Name Ptr: ");
+    subghz_toolkit_symbols_write_address(writer, symbols, (uint32_t)(uintptr_t)protocol->name);
+    subghz_toolkit_writer_printf(writer, " -> \"%s\"\n", protocol->name);
+    subghz_toolkit_writer_printf(writer, "    Type Value: 0x%02X\n", protocol->type);
+    subghz_toolkit_writer_printf(writer, "    Flag Value: 0x%08lX\n", (uint32_t)protocol->flag);
 
-        for (size_t i = 0; i < protocol_count; i++)
-        {
-            const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
-            if (!protocol)
-                continue;
+    if (protocol->decoder)
+    {
+        subghz_toolkit_writer_cstr(writer, "\n  Decoder Structure Analysis:\n");
+        subghz_toolkit_write_pointer(writer, symbols, "    Decoder Ptr: ", protocol->decoder);
+        subghz_toolkit_writer_printf(writer, "    Size: %zu bytes\n", sizeof(*protocol->decoder));
 
-            if ((void *)protocol < min_addr)
-                min_addr = (void *)protocol;
-            if ((void *)protocol > max_addr)
-                max_addr = (void *)protocol;
+        subghz_toolkit_writer_cstr(writer, "\n    Function Entry Points:\n");
+        if (protocol->decoder->alloc)
+        {
+            subghz_toolkit_writer_cstr(writer, "      Alloc @ ");
+            subghz_toolkit_symbols_write_address(writer, symbols, (uint32_t)(uintptr_t)protocol->decoder->alloc);
+            const uint8_t *func_bytes = (const uint8_t *)(uintptr_t)subghz_toolkit_thumb_code_address((uintptr_t)protocol->decoder->alloc);
+            subghz_toolkit_writer_cstr(writer, " [");
+            subghz_toolkit_writer_hex(writer, func_bytes, 8);
+            subghz_toolkit_writer_cstr(writer, "...]\n");
+        }
 
-            if (protocol->decoder)
+        if (protocol->decoder->alloc && env)
+        {
+            SubGhzProtocolDecoderBase *decoder = protocol->decoder->alloc(env);
+            if (decoder)
             {
-                if ((void *)protocol->decoder->alloc < min_addr)
-                    min_addr = (void *)protocol->decoder->alloc;
-                if ((void *)protocol->decoder->get_hash_data > max_addr)
-                    max_addr = (void *)protocol->decoder->get_hash_data;
-            }
+                subghz_toolkit_writer_cstr(writer, "\n    Decoder Instance Analysis:\n");
+                subghz_toolkit_writer_printf(writer, "      Instance Ptr: %p\n", decoder);
+                subghz_toolkit_write_pointer(writer, symbols, "      Protocol Ref: ", decoder->protocol);
+                subghz_toolkit_write_pointer(writer, symbols, "      Callback: ", decoder->callback);
 
-            if (protocol->encoder)
-            {
-                if ((void *)protocol->encoder->alloc < min_addr)
-                    min_addr = (void *)protocol->encoder->alloc;
-                if ((void *)protocol->encoder->yield > max_addr)
-                    max_addr = (void *)protocol->encoder->yield;
+                if (decoder->protocol)
+                {
+                    subghz_toolkit_writer_printf(writer, "      Protocol Name: %s\n",
+                                                 decoder->protocol->name ? decoder->protocol->name : "NULL");
+                }
+
+                if (protocol->decoder->free)
+                {
+                    protocol->decoder->free(decoder);
+                }
             }
         }
+    }
 
-        stream_write_format(stream, "Address Range: %p - %p\n", min_addr, max_addr);
-        stream_write_format(stream, "Total Range: %lu bytes\n\n", (uint32_t)max_addr - (uint32_t)min_addr);
+    if (protocol->encoder)
+    {
+        subghz_toolkit_writer_cstr(writer, "\n  Encoder Structure Analysis:\n");
+        subghz_toolkit_write_pointer(writer, symbols, "    Encoder Ptr: ", protocol->encoder);
+        subghz_toolkit_writer_printf(writer, "    Size: %zu bytes\n", sizeof(*protocol->encoder));
 
-        success = true;
-    } while (0);
+        subghz_toolkit_writer_cstr(writer, "\n    Function Entry Points:\n");
+        if (protocol->encoder->alloc)
+        {
+            subghz_toolkit_writer_cstr(writer, "      Alloc @ ");
+            subghz_toolkit_symbols_write_address(writer, symbols, (uint32_t)(uintptr_t)protocol->encoder->alloc);
+            const uint8_t *func_bytes = (const uint8_t *)(uintptr_t)subghz_toolkit_thumb_code_address((uintptr_t)protocol->encoder->alloc);
+            subghz_toolkit_writer_cstr(writer, " [");
+            subghz_toolkit_writer_hex(writer, func_bytes, 8);
+            subghz_toolkit_writer_cstr(writer, "...]\n");
+        }
+    }
 
-    stream_free(stream);
-    furi_record_close(RECORD_STORAGE);
+    subghz_toolkit_writer_cstr(writer, "\n  Memory Layout:\n");
+    subghz_toolkit_write_pointer(writer, symbols, "    Protocol @ ", protocol);
+    subghz_toolkit_writer_printf(writer, "    +0x00: name     = %p\n", &protocol->name);
+    subghz_toolkit_writer_printf(writer, "    +0x04: type     = %p\n", &protocol->type);
+    subghz_toolkit_writer_printf(writer, "    +0x08: flag     = %p\n", &protocol->flag);
+    subghz_toolkit_writer_printf(writer, "    +0x0C: decoder  = %p\n", &protocol->decoder);
+    subghz_toolkit_writer_printf(writer, "    +0x10: encoder  = %p\n", &protocol->encoder);
+}
 
-    if (success)
+typedef struct
+{
+    void *min_addr;
+    void *max_addr;
+} SubGhzToolkitAdvancedState;
+
+static void subghz_toolkit_advanced_begin(SubGhzToolkitPassContext *ctx)
+{
+    SubGhzToolkitApp *app = ctx->app;
+    SubGhzToolkitWriter *writer = ctx->writer;
+    SubGhzToolkitAdvancedState *state = ctx->state;
+
+    state->min_addr = (void *)0xFFFFFFFF;
+    state->max_addr = (void *)0x00000000;
+
+    const Version *ver = furi_hal_version_get_firmware_version();
+    subghz_toolkit_writer_printf(writer,
+                                 "System Information:\n"
+                                 "  Firmware Version: %s\n"
+                                 "  Build Date: %s\n"
+                                 "  Git Hash: %s\n"
+                                 "  Target: %d\n"
+                                 "  HW Version: %d\n"
+                                 "  HW Target: %d\n"
+                                 "  HW Body: %d\n"
+                                 "  HW Connect: %d\n"
+                                 "  HW Region: %d\n"
+                                 "  HW Display: %d\n\n",
+                                 version_get_version(ver),
+                                 version_get_builddate(ver),
+                                 version_get_githash(ver),
+                                 version_get_target(ver),
+                                 furi_hal_version_get_hw_version(),
+                                 furi_hal_version_get_hw_target(),
+                                 furi_hal_version_get_hw_body(),
+                                 furi_hal_version_get_hw_connect(),
+                                 furi_hal_version_get_hw_region(),
+                                 furi_hal_version_get_hw_display());
+
+    subghz_toolkit_writer_cstr(writer, "Protocol Registry Analysis:\n");
+    subghz_toolkit_writer_printf(writer, "  Registry Ptr: %p\n", app->protocol_registry);
+    subghz_toolkit_writer_printf(writer, "  Protocol Count: %zu\n", subghz_protocol_registry_count(app->protocol_registry));
+    subghz_toolkit_writer_printf(writer, "  Registry Symbol: subghz_protocol_registry @ %p\n\n", &subghz_protocol_registry);
+
+    subghz_toolkit_writer_cstr(writer, "SubGhz Environment Analysis:\n");
+    // Receiver and settings are reported as-is rather than loaded just to print a pointer
+    subghz_toolkit_writer_printf(writer, "  Environment Ptr: %p\n", subghz_toolkit_get_environment(app));
+    subghz_toolkit_writer_printf(writer, "  Receiver Ptr: %p%s\n", app->receiver, app->receiver ? "" : " (not loaded)");
+    subghz_toolkit_writer_printf(writer, "  Setting Ptr: %p%s\n\n", app->setting, app->setting ? "" : " (not loaded)");
+}
+
+static void subghz_toolkit_advanced_protocol(SubGhzToolkitPassContext *ctx, size_t index, const SubGhzProtocol *protocol)
+{
+    SubGhzToolkitWriter *writer = ctx->writer;
+    SubGhzToolkitAdvancedState *state = ctx->state;
+    SubGhzToolkitSymbols *symbols = subghz_toolkit_get_symbols(ctx->app);
+
+    subghz_toolkit_writer_cstr(writer, "\n████████████████████████████████████████████████████████████\n");
+    subghz_toolkit_writer_printf(writer, "Protocol #%zu: %s\n", index, protocol->name);
+    subghz_toolkit_writer_cstr(writer, "████████████████████████████████████████████████████████████\n");
+
+    subghz_toolkit_writer_cstr(writer, "\nBasic Information:\n");
+    subghz_toolkit_writer_printf(writer, "  Name: %s\n", protocol->name);
+    subghz_toolkit_writer_printf(writer, "  Type: 0x%02X (%s)\n",
+                                 protocol->type,
+                                 protocol->type == SubGhzProtocolTypeStatic ? "Static" : protocol->type == SubGhzProtocolTypeDynamic ? "Dynamic"
+                                                                                                                                     : "RAW");
+    subghz_toolkit_writer_printf(writer, "  Flag: 0x%08lX\n", (uint32_t)protocol->flag);
+
+    subghz_toolkit_writer_cstr(writer, "\n  Flag Breakdown:\n");
+    subghz_toolkit_writer_printf(writer, "    Decodable:       %s\n", (protocol->flag & SubGhzProtocolFlag_Decodable) ? "YES" : "NO");
+    subghz_toolkit_writer_printf(writer, "    Save:            %s\n", (protocol->flag & SubGhzProtocolFlag_Save) ? "YES" : "NO");
+    subghz_toolkit_writer_printf(writer, "    Load:            %s\n", (protocol->flag & SubGhzProtocolFlag_Load) ? "YES" : "NO");
+    subghz_toolkit_writer_printf(writer, "    Send:            %s\n", (protocol->flag & SubGhzProtocolFlag_Send) ? "YES" : "NO");
+    subghz_toolkit_writer_printf(writer, "    BinRAW:          %s\n", (protocol->flag & SubGhzProtocolFlag_BinRAW) ? "YES" : "NO");
+
+    if (protocol->decoder)
     {
-        popup_set_header(app->popup, "Success!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Advanced analysis exported to:\n/ext/subghz/analysis/advanced_analysis.txt",
-                       64, 20, AlignCenter, AlignTop);
+        subghz_toolkit_writer_cstr(writer, "\nDecoder Implementation:\n");
+        subghz_toolkit_write_pointer(writer, symbols, "  Structure Address: ", protocol->decoder);
+        subghz_toolkit_writer_cstr(writer, "\n  Function Pointers:\n");
+        subghz_toolkit_write_pointer(writer, symbols, "    alloc:          ", protocol->decoder->alloc);
+        subghz_toolkit_write_pointer(writer, symbols, "    free:           ", protocol->decoder->free);
+        subghz_toolkit_write_pointer(writer, symbols, "    reset:          ", protocol->decoder->reset);
+        subghz_toolkit_write_pointer(writer, symbols, "    feed:           ", protocol->decoder->feed);
+        subghz_toolkit_write_pointer(writer, symbols, "    get_string:     ", protocol->decoder->get_string);
+        subghz_toolkit_write_pointer(writer, symbols, "    serialize:      ", protocol->decoder->serialize);
+        subghz_toolkit_write_pointer(writer, symbols, "    deserialize:    ", protocol->decoder->deserialize);
+        subghz_toolkit_write_pointer(writer, symbols, "    get_hash_data:  ", protocol->decoder->get_hash_data);
     }
-    else
+
+    if (protocol->encoder)
     {
-        popup_set_header(app->popup, "Error!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Failed to export analysis", 64, 20, AlignCenter, AlignTop);
+        subghz_toolkit_writer_cstr(writer, "\nEncoder Implementation:\n");
+        subghz_toolkit_write_pointer(writer, symbols, "  Structure Address: ", protocol->encoder);
+        subghz_toolkit_writer_cstr(writer, "\n  Function Pointers:\n");
+        subghz_toolkit_write_pointer(writer, symbols, "    alloc:          ", protocol->encoder->alloc);
+        subghz_toolkit_write_pointer(writer, symbols, "    free:           ", protocol->encoder->free);
+        subghz_toolkit_write_pointer(writer, symbols, "    deserialize:    ", protocol->encoder->deserialize);
+        subghz_toolkit_write_pointer(writer, symbols, "    stop:           ", protocol->encoder->stop);
+        subghz_toolkit_write_pointer(writer, symbols, "    yield:          ", protocol->encoder->yield);
     }
 
-    popup_set_callback(app->popup, subghz_toolkit_popup_callback);
-    popup_set_context(app->popup, app);
-    popup_set_timeout(app->popup, 3000);
-    popup_enable_timeout(app->popup);
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewPopup);
+    subghz_toolkit_deep_protocol_analysis(writer, symbols, protocol, subghz_toolkit_get_environment(ctx->app));
+
+    subghz_toolkit_writer_cstr(writer, "\n");
+
+    // Accumulate the memory map while we are here instead of walking the registry again
+    if ((void *)protocol < state->min_addr)
+        state->min_addr = (void *)protocol;
+    if ((void *)protocol > state->max_addr)
+        state->max_addr = (void *)protocol;
+
+    if (protocol->decoder)
+    {
+        if ((void *)protocol->decoder->alloc < state->min_addr)
+            state->min_addr = (void *)protocol->decoder->alloc;
+        if ((void *)protocol->decoder->get_hash_data > state->max_addr)
+            state->max_addr = (void *)protocol->decoder->get_hash_data;
+    }
+
+    if (protocol->encoder)
+    {
+        if ((void *)protocol->encoder->alloc < state->min_addr)
+            state->min_addr = (void *)protocol->encoder->alloc;
+        if ((void *)protocol->encoder->yield > state->max_addr)
+            state->max_addr = (void *)protocol->encoder->yield;
+    }
 }
 
-static void subghz_toolkit_show_protocols_list(SubGhzToolkitApp *app)
+static void subghz_toolkit_advanced_end(SubGhzToolkitPassContext *ctx)
 {
-    furi_string_reset(app->text_buffer);
-    furi_string_cat_printf(app->text_buffer, "SubGhz Protocols Found: %zu\n\n",
-                           subghz_protocol_registry_count(app->protocol_registry));
+    SubGhzToolkitWriter *writer = ctx->writer;
+    SubGhzToolkitAdvancedState *state = ctx->state;
 
-    submenu_reset(app->submenu);
+    subghz_toolkit_writer_cstr(writer, "\n████████████████████████████████████████████████████████████\n");
+    subghz_toolkit_writer_cstr(writer, "Memory Map Summary\n");
+    subghz_toolkit_writer_cstr(writer, "████████████████████████████████████████████████████████████\n\n");
+
+    subghz_toolkit_writer_printf(writer, "Address Range: %p - %p\n", state->min_addr, state->max_addr);
+    subghz_toolkit_writer_printf(writer, "Total Range: %lu bytes\n\n", (uint32_t)state->max_addr - (uint32_t)state->min_addr);
+}
 
+static void subghz_toolkit_add_main_menu_items(SubGhzToolkitApp *app)
+{
     submenu_add_item(
         app->submenu,
         "Decrypt Keeloq mfcodes",
@@ -745,71 +1353,145 @@ static void subghz_toolkit_show_protocols_list(SubGhzToolkitApp *app)
 
     submenu_add_item(
         app->submenu,
-        "List SubGhz Protocols",
-        SubGhzToolkitSubmenuIndexListProtocols,
+        "Export Keeloq CSV",
+        SubGhzToolkitSubmenuIndexExportKeeloqCsv,
         subghz_toolkit_submenu_callback,
         app);
 
     submenu_add_item(
         app->submenu,
-        "Export All Protocol Info",
-        SubGhzToolkitSubmenuIndexExportProtocolInfo,
+        "Export Keeloq Binary",
+        SubGhzToolkitSubmenuIndexExportKeeloqBinary,
         subghz_toolkit_submenu_callback,
         app);
 
     submenu_add_item(
         app->submenu,
-        "Advanced Analysis",
-        SubGhzToolkitSubmenuIndexAdvancedAnalysis,
+        "Keeloq Key Lookup",
+        SubGhzToolkitSubmenuIndexKeeloqKeyLookup,
         subghz_toolkit_submenu_callback,
         app);
 
     submenu_add_item(
         app->submenu,
-        "Function Disassembly",
-        SubGhzToolkitSubmenuIndexFunctionDisassembly,
+        "Keeloq Name Lookup",
+        SubGhzToolkitSubmenuIndexKeeloqNameLookup,
         subghz_toolkit_submenu_callback,
         app);
 
     submenu_add_item(
         app->submenu,
-        "Protocol State Analysis",
-        SubGhzToolkitSubmenuIndexProtocolStateAnalysis,
+        "List SubGhz Protocols",
+        SubGhzToolkitSubmenuIndexListProtocols,
         subghz_toolkit_submenu_callback,
         app);
 
     submenu_add_item(
         app->submenu,
-        "Signal Capture Analysis",
-        SubGhzToolkitSubmenuIndexSignalCapture,
+        "Export All Protocol Info",
+        SubGhzToolkitSubmenuIndexExportProtocolInfo,
         subghz_toolkit_submenu_callback,
         app);
 
     submenu_add_item(
         app->submenu,
-        "Timing Analysis",
-        SubGhzToolkitSubmenuIndexTimingAnalysis,
+        "Advanced Analysis",
+        SubGhzToolkitSubmenuIndexAdvancedAnalysis,
         subghz_toolkit_submenu_callback,
         app);
 
     submenu_add_item(
         app->submenu,
-        "Generate C Headers",
-        SubGhzToolkitSubmenuIndexCHeaderGeneration,
+        "Run All Analyses",
+        SubGhzToolkitSubmenuIndexRunAllAnalyses,
         subghz_toolkit_submenu_callback,
         app);
 
     submenu_add_item(
         app->submenu,
-        "About",
-        SubGhzToolkitSubmenuIndexAbout,
+        "Function Disassembly",
+        SubGhzToolkitSubmenuIndexFunctionDisassembly,
         subghz_toolkit_submenu_callback,
         app);
 
-    size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
-    for (size_t i = 0; i < protocol_count; i++)
-    {
-        const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
+    submenu_add_item(
+        app->submenu,
+        "Call Graph",
+        SubGhzToolkitSubmenuIndexCallGraph,
+        subghz_toolkit_submenu_callback,
+        app);
+
+    submenu_add_item(
+        app->submenu,
+        "Protocol State Analysis",
+        SubGhzToolkitSubmenuIndexProtocolStateAnalysis,
+        subghz_toolkit_submenu_callback,
+        app);
+
+    submenu_add_item(
+        app->submenu,
+        "Signal Capture Analysis",
+        SubGhzToolkitSubmenuIndexSignalCapture,
+        subghz_toolkit_submenu_callback,
+        app);
+
+    submenu_add_item(
+        app->submenu,
+        "Replay RAW Captures",
+        SubGhzToolkitSubmenuIndexReplayCaptures,
+        subghz_toolkit_submenu_callback,
+        app);
+
+    submenu_add_item(
+        app->submenu,
+        "Profile Decoders",
+        SubGhzToolkitSubmenuIndexProfileDecoders,
+        subghz_toolkit_submenu_callback,
+        app);
+
+    submenu_add_item(
+        app->submenu,
+        "Timing Analysis",
+        SubGhzToolkitSubmenuIndexTimingAnalysis,
+        subghz_toolkit_submenu_callback,
+        app);
+
+    submenu_add_item(
+        app->submenu,
+        "Generate C Headers",
+        SubGhzToolkitSubmenuIndexCHeaderGeneration,
+        subghz_toolkit_submenu_callback,
+        app);
+
+    submenu_add_item(
+        app->submenu,
+        "Compare Firmware",
+        SubGhzToolkitSubmenuIndexCompareFirmware,
+        subghz_toolkit_submenu_callback,
+        app);
+
+    submenu_add_item(
+        app->submenu,
+        "About",
+        SubGhzToolkitSubmenuIndexAbout,
+        subghz_toolkit_submenu_callback,
+        app);
+}
+
+static void subghz_toolkit_show_protocols_list(SubGhzToolkitApp *app)
+{
+    furi_string_reset(app->text_buffer);
+    furi_string_cat_printf(app->text_buffer, "SubGhz Protocols Found: %zu\n\n",
+                           subghz_protocol_registry_count(app->protocol_registry));
+
+    submenu_reset(app->submenu);
+
+    subghz_toolkit_add_main_menu_items(app);
+
+    size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
+    for (size_t i = 0; i < protocol_count; i++)
+    {
+        const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
         if (protocol && protocol->name)
         {
             furi_string_cat_printf(app->text_buffer, "%zu. %s", i + 1, protocol->name);
@@ -854,11 +1536,14 @@ static void subghz_toolkit_show_about(SubGhzToolkitApp *app)
                         "- List all protocols\n"
                         "- Export protocol info\n"
                         "- ADVANCED Analysis\n"
-                        "- Analyze implementations\n\n"
+                        "- Analyze implementations\n"
+                        "- Compare firmware versions\n\n"
                         "Files saved to:\n"
                         "/ext/subghz/analysis/\n\n"
-                        "Use this tool to compare\n"
-                        "different firmware versions!");
+                        "Run Compare Firmware on each\n"
+                        "firmware you flash: every run\n"
+                        "keeps a snapshot and diffs\n"
+                        "the others against it.");
 
     text_box_set_text(app->text_box, furi_string_get_cstr(app->text_buffer));
     text_box_set_focus(app->text_box, TextBoxFocusStart);
@@ -878,98 +1563,253 @@ static void subghz_toolkit_show_intro_popup(SubGhzToolkitApp *app)
 
 // Enhanced analysis functions for comprehensive protocol implementation data
 
-static void subghz_toolkit_analyze_function_bytes(Stream *stream, const char *func_name, void *func_ptr, size_t max_bytes)
+// Every function pointer of a protocol, in report order (see SubGhzToolkitFunctionSlot)
+static void subghz_toolkit_protocol_functions(const SubGhzProtocol *protocol, uint32_t functions[SubGhzToolkitFunctionSlotCount])
+{
+    memset(functions, 0, sizeof(uint32_t) * SubGhzToolkitFunctionSlotCount);
+
+    if (protocol->decoder)
+    {
+        functions[SubGhzToolkitFunctionSlotDecoderAlloc] = (uintptr_t)protocol->decoder->alloc;
+        functions[SubGhzToolkitFunctionSlotDecoderFree] = (uintptr_t)protocol->decoder->free;
+        functions[SubGhzToolkitFunctionSlotDecoderReset] = (uintptr_t)protocol->decoder->reset;
+        functions[SubGhzToolkitFunctionSlotDecoderFeed] = (uintptr_t)protocol->decoder->feed;
+        functions[SubGhzToolkitFunctionSlotDecoderGetString] = (uintptr_t)protocol->decoder->get_string;
+        functions[SubGhzToolkitFunctionSlotDecoderSerialize] = (uintptr_t)protocol->decoder->serialize;
+        functions[SubGhzToolkitFunctionSlotDecoderDeserialize] = (uintptr_t)protocol->decoder->deserialize;
+        functions[SubGhzToolkitFunctionSlotDecoderGetHashData] = (uintptr_t)protocol->decoder->get_hash_data;
+    }
+
+    if (protocol->encoder)
+    {
+        functions[SubGhzToolkitFunctionSlotEncoderAlloc] = (uintptr_t)protocol->encoder->alloc;
+        functions[SubGhzToolkitFunctionSlotEncoderFree] = (uintptr_t)protocol->encoder->free;
+        functions[SubGhzToolkitFunctionSlotEncoderDeserialize] = (uintptr_t)protocol->encoder->deserialize;
+        functions[SubGhzToolkitFunctionSlotEncoderStop] = (uintptr_t)protocol->encoder->stop;
+        functions[SubGhzToolkitFunctionSlotEncoderYield] = (uintptr_t)protocol->encoder->yield;
+    }
+}
+
+// Function bounds are analyzed once per address for the lifetime of the app:
+// many protocols share their free/reset helpers. Only the worker uses the cache.
+static SubGhzToolkitFunctionCache *subghz_toolkit_get_function_cache(SubGhzToolkitApp *app)
+{
+    furi_mutex_acquire(app->resource_mutex, FuriWaitForever);
+    if (!app->function_cache)
+        app->function_cache = subghz_toolkit_function_cache_alloc();
+    furi_mutex_release(app->resource_mutex);
+
+    return app->function_cache;
+}
+
+// Bounds of the firmware function behind a pointer. The first protocol and
+// slot to reach a function are recorded as its owner. NULL outside flash.
+static const SubGhzToolkitFunction *
+    subghz_toolkit_get_function(SubGhzToolkitApp *app, size_t index, SubGhzToolkitFunctionSlot slot, uint32_t pointer, bool *inserted)
+{
+    return subghz_toolkit_protocol_function(
+        subghz_toolkit_get_function_cache(app), subghz_toolkit_memory_code_at, &app->flash, pointer, (uint16_t)index, slot, inserted);
+}
+
+typedef struct
+{
+    uint32_t functions;
+    uint32_t shared;
+    uint32_t truncated;
+    uint32_t code_bytes;
+    uint32_t pool_bytes;
+} SubGhzToolkitDisassemblyState;
+
+static void subghz_toolkit_analyze_function_bytes(
+    SubGhzToolkitPassContext *ctx, size_t index, SubGhzToolkitFunctionSlot slot, uint32_t func_ptr)
 {
     if (!func_ptr) return;
-    
-    stream_write_format(stream, "\n  Function: %s @ %p\n", func_name, func_ptr);
-    stream_write_format(stream, "  Raw Bytes (first %zu bytes):\n", max_bytes);
-    
-    uint8_t *bytes = (uint8_t *)func_ptr;
-    stream_write_format(stream, "    ");
-    
-    for (size_t i = 0; i < max_bytes && i < 64; i++) // Limit to 64 bytes for readability
+
+    SubGhzToolkitWriter *writer = ctx->writer;
+    SubGhzToolkitDisassemblyState *state = ctx->state;
+    const SubGhzToolkitFunction *function = subghz_toolkit_get_function(ctx->app, index, slot, func_ptr, NULL);
+    if (!function)
     {
-        stream_write_format(stream, "%02X ", bytes[i]);
-        if ((i + 1) % 16 == 0)
-        {
-            stream_write_format(stream, "\n    ");
-        }
+        subghz_toolkit_writer_printf(writer, "\n  Function: %s @ 0x%08lX (outside flash, skipped)\n",
+                                     subghz_toolkit_function_slot_names[slot], func_ptr);
+        return;
     }
-    
-    // Basic ARM instruction pattern analysis
-    stream_write_format(stream, "\n  ARM Instruction Analysis:\n");
-    for (size_t i = 0; i < max_bytes - 3; i += 4)
+
+    subghz_toolkit_writer_printf(writer, "\n  Function: %s @ ", subghz_toolkit_function_slot_names[slot]);
+    subghz_toolkit_symbols_write_address(writer, subghz_toolkit_get_symbols(ctx->app), function->address);
+    subghz_toolkit_writer_cstr(writer, " (Thumb)\n");
+
+    if (function->owner != index || function->label != slot)
     {
-        uint32_t instruction = *(uint32_t *)(bytes + i);
-        
-        // Common ARM patterns
-        if ((instruction & 0xFF000000) == 0xE9000000) // STMDB
-        {
-            stream_write_format(stream, "    +%02zu: STMDB (stack push)\n", i);
-        }
-        else if ((instruction & 0xFF000000) == 0xE8B00000) // LDMIA
-        {
-            stream_write_format(stream, "    +%02zu: LDMIA (stack pop)\n", i);
-        }
-        else if ((instruction & 0xFF000000) == 0xE1A00000) // MOV
-        {
-            stream_write_format(stream, "    +%02zu: MOV (register move)\n", i);
-        }
-        else if ((instruction & 0xFF000000) == 0xE3A00000) // MOV immediate
-        {
-            stream_write_format(stream, "    +%02zu: MOV immediate\n", i);
-        }
-        else if ((instruction & 0xFF000000) == 0xE5900000) // LDR
-        {
-            stream_write_format(stream, "    +%02zu: LDR (load register)\n", i);
-        }
-        else if ((instruction & 0xFF000000) == 0xE5800000) // STR
-        {
-            stream_write_format(stream, "    +%02zu: STR (store register)\n", i);
-        }
-        else if ((instruction & 0xFF000000) == 0xEB000000) // BL
-        {
-            stream_write_format(stream, "    +%02zu: BL (branch and link)\n", i);
-        }
-        else if ((instruction & 0xFF000000) == 0xEA000000) // B
-        {
-            stream_write_format(stream, "    +%02zu: B (branch)\n", i);
-        }
-        else if ((instruction & 0xFF000000) == 0xE12FFF10) // BX
-        {
-            stream_write_format(stream, "    +%02zu: BX (branch exchange)\n", i);
-        }
-        else if ((instruction & 0xFF000000) == 0xE1A0F000) // MOV PC, LR
+        const SubGhzProtocol *owner = subghz_protocol_registry_get_by_index(ctx->app->protocol_registry, function->owner);
+        subghz_toolkit_writer_printf(writer, "  Size: %u bytes, shared with %s %s\n",
+                                     function->size,
+                                     owner ? owner->name : "?",
+                                     subghz_toolkit_function_slot_names[function->label]);
+        state->shared++;
+        return;
+    }
+
+    uint32_t pool_size = function->size - function->code_size;
+    subghz_toolkit_writer_printf(writer, "  Size: %u bytes (%u code + %lu literal pool), %u instructions%s%s%s\n",
+                                 function->size,
+                                 function->code_size,
+                                 pool_size,
+                                 function->insn_count,
+                                 (function->flags & SUBGHZ_TOOLKIT_FUNCTION_FLAG_LEAF) ? ", leaf" : "",
+                                 (function->flags & SUBGHZ_TOOLKIT_FUNCTION_FLAG_TAIL_CALL) ? ", tail call" : "",
+                                 (function->flags & SUBGHZ_TOOLKIT_FUNCTION_FLAG_TRUNCATED) ? ", TRUNCATED" : "");
+
+    state->functions++;
+    state->code_bytes += function->code_size;
+    state->pool_bytes += pool_size;
+    if (function->flags & SUBGHZ_TOOLKIT_FUNCTION_FLAG_TRUNCATED)
+        state->truncated++;
+
+    subghz_toolkit_function_write_listing(writer, (const uint8_t *)(uintptr_t)function->address, function);
+}
+
+// Protocol state analysis, see helpers/subghz_toolkit_state.h. Every decoder
+// is fed the start of the last capture while its instance is traced.
+
+#define SUBGHZ_TOOLKIT_STATE_PULSE_LEVEL 0x80000000u
+
+typedef struct
+{
+    uint32_t *pulses; // duration, level in the top bit
+    size_t count;
+} SubGhzToolkitStatePulses;
+
+static void subghz_toolkit_state_add_pulse(void *context, bool level, uint32_t duration)
+{
+    SubGhzToolkitStatePulses *state = context;
+    if (state->count == SUBGHZ_TOOLKIT_STATE_TRACE_PULSES)
+        return;
+    if (duration >= SUBGHZ_TOOLKIT_STATE_PULSE_LEVEL)
+        duration = SUBGHZ_TOOLKIT_STATE_PULSE_LEVEL - 1;
+    state->pulses[state->count++] = duration | (level ? SUBGHZ_TOOLKIT_STATE_PULSE_LEVEL : 0);
+}
+
+static void subghz_toolkit_state_begin(SubGhzToolkitPassContext *ctx)
+{
+    SubGhzToolkitStatePulses *state = ctx->state;
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *file = storage_file_alloc(storage);
+
+    state->pulses = malloc(SUBGHZ_TOOLKIT_STATE_TRACE_PULSES * sizeof(uint32_t));
+    if (storage_file_open(file, SUBGHZ_CAPTURE_PATH, FSAM_READ, FSOM_OPEN_EXISTING))
+    {
+        char *buffer = malloc(SUBGHZ_TOOLKIT_REPLAY_READ_SIZE);
+        SubGhzToolkitRawParser parser;
+        size_t size;
+
+        subghz_toolkit_raw_parser_init(&parser);
+        while (state->count < SUBGHZ_TOOLKIT_STATE_TRACE_PULSES &&
+               (size = storage_file_read(file, buffer, SUBGHZ_TOOLKIT_REPLAY_READ_SIZE)) > 0)
+            subghz_toolkit_raw_parser_feed(&parser, buffer, size, subghz_toolkit_state_add_pulse, state);
+        subghz_toolkit_raw_parser_finish(&parser, subghz_toolkit_state_add_pulse, state);
+        free(buffer);
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    FURI_LOG_I(TAG, "State trace: %zu pulses from " SUBGHZ_CAPTURE_PATH, state->count);
+}
+
+static void subghz_toolkit_state_end(SubGhzToolkitPassContext *ctx)
+{
+    SubGhzToolkitStatePulses *state = ctx->state;
+    free(state->pulses);
+    state->pulses = NULL;
+}
+
+// Heap free space taken by one alloc(), the median of three so another thread's
+// allocation in between does not count. The last instance is kept in `decoder`.
+static size_t subghz_toolkit_measure_decoder_alloc(const SubGhzProtocol *protocol, SubGhzEnvironment *env, void **decoder)
+{
+    size_t deltas[SUBGHZ_TOOLKIT_STATE_ALLOC_RUNS];
+
+    *decoder = NULL;
+    for (size_t run = 0; run < SUBGHZ_TOOLKIT_STATE_ALLOC_RUNS; run++)
+    {
+        if (*decoder && protocol->decoder->free)
+            protocol->decoder->free(*decoder);
+
+        size_t free_heap = memmgr_get_free_heap();
+        *decoder = protocol->decoder->alloc(env);
+        size_t free_heap_after = memmgr_get_free_heap();
+        if (!*decoder)
+            return 0;
+        deltas[run] = free_heap > free_heap_after ? free_heap - free_heap_after : 0;
+    }
+
+    for (size_t i = 1; i < SUBGHZ_TOOLKIT_STATE_ALLOC_RUNS; i++)
+    {
+        for (size_t j = i; j > 0 && deltas[j - 1] > deltas[j]; j--)
         {
-            stream_write_format(stream, "    +%02zu: MOV PC, LR (return)\n", i);
+            size_t swap = deltas[j];
+            deltas[j] = deltas[j - 1];
+            deltas[j - 1] = swap;
         }
     }
+    return deltas[SUBGHZ_TOOLKIT_STATE_ALLOC_RUNS / 2];
 }
 
-static void subghz_toolkit_analyze_protocol_state(Stream *stream, const SubGhzProtocol *protocol, SubGhzEnvironment *env)
+static void subghz_toolkit_analyze_protocol_state(
+    SubGhzToolkitWriter *writer, const SubGhzProtocol *protocol, SubGhzEnvironment *env, const SubGhzToolkitStatePulses *pulses)
 {
     if (!protocol->decoder || !env) return;
     
-    stream_write_format(stream, "\n  Protocol State Analysis:\n");
+    subghz_toolkit_writer_cstr(writer, "\n  Protocol State Analysis:\n");
     
-    SubGhzProtocolDecoderBase *decoder = protocol->decoder->alloc(env);
+    void *decoder;
+    size_t heap_cost = subghz_toolkit_measure_decoder_alloc(protocol, env, &decoder);
     if (decoder)
     {
-        stream_write_format(stream, "    Decoder Instance: %p\n", decoder);
-        stream_write_format(stream, "    Decoder Size: %zu bytes\n", sizeof(*decoder));
-        
+        // sizeof(SubGhzProtocolDecoderBase) is only the header every decoder starts with
+        size_t block_size = subghz_toolkit_state_block_size(decoder, heap_cost);
+        size_t size = block_size ? block_size : heap_cost;
+        if (size < sizeof(SubGhzProtocolDecoderBase))
+            size = sizeof(SubGhzProtocolDecoderBase);
+
+        subghz_toolkit_writer_printf(writer, "    Heap Cost: %zu bytes (alloc(), with its own buffers and allocator overhead)\n", heap_cost);
+        if (block_size)
+            subghz_toolkit_writer_printf(writer, "    Decoder Size: %zu bytes (allocator block)\n", block_size);
+        else
+            subghz_toolkit_writer_printf(writer, "    Decoder Size: %zu bytes (heap cost, block header unreadable)\n", size);
+        subghz_toolkit_writer_printf(writer, "    Base Header: %zu bytes\n", sizeof(SubGhzProtocolDecoderBase));
+
+        SubGhzToolkitStateTrace trace;
+        subghz_toolkit_state_trace_init(&trace, decoder, size);
+        if (trace.size < size)
+            subghz_toolkit_writer_printf(writer, "    Traced: first %zu bytes\n", trace.size);
+
         // Analyze decoder structure
-        stream_write_format(stream, "    Decoder Structure Dump:\n");
+        subghz_toolkit_writer_cstr(writer, "    Decoder Structure Dump:\n");
         uint8_t *decoder_bytes = (uint8_t *)decoder;
-        for (size_t i = 0; i < sizeof(*decoder); i += 4)
+        for (size_t i = 0; i < trace.size; i += 4)
+        {
+            uint32_t value = *(uint32_t *)(decoder_bytes + i);
+            subghz_toolkit_writer_printf(writer, "      +%03zu: 0x%08lX\n", i, (uint32_t)value);
+        }
+
+        if (!pulses->count)
+        {
+            subghz_toolkit_writer_cstr(writer, "    State Trace: no capture, run Signal Capture Analysis first\n");
+        }
+        else
         {
-            if (i + 3 < sizeof(*decoder))
+            for (size_t i = 0; i < pulses->count; i++)
             {
-                uint32_t value = *(uint32_t *)(decoder_bytes + i);
-                stream_write_format(stream, "      +%02zu: 0x%08lX\n", i, (uint32_t)value);
+                bool level = pulses->pulses[i] & SUBGHZ_TOOLKIT_STATE_PULSE_LEVEL;
+                uint32_t duration = pulses->pulses[i] & ~SUBGHZ_TOOLKIT_STATE_PULSE_LEVEL;
+                protocol->decoder->feed(decoder, level, duration);
+                subghz_toolkit_state_trace_sample(&trace, duration);
             }
+            subghz_toolkit_state_trace_write_report(writer, &trace);
         }
+        subghz_toolkit_state_trace_deinit(&trace);
         
         if (protocol->decoder->free)
         {
@@ -978,439 +1818,1792 @@ static void subghz_toolkit_analyze_protocol_state(Stream *stream, const SubGhzPr
     }
 }
 
-static void subghz_toolkit_capture_signal_samples(Stream *stream, SubGhzReceiver *receiver)
+static void subghz_toolkit_disassembly_protocol(SubGhzToolkitPassContext *ctx, size_t index, const SubGhzProtocol *protocol)
 {
-    stream_write_format(stream, "\n  Signal Capture Analysis:\n");
-    stream_write_format(stream, "    Receiver: %p\n", receiver);
-    
-    // Capture some signal samples for analysis
-    stream_write_format(stream, "    Capturing signal samples...\n");
-    
-    // This would need to be implemented with actual signal capture
-    // For now, we'll document the approach
-    stream_write_format(stream, "    Signal capture approach:\n");
-    stream_write_format(stream, "    1. Start receiver\n");
-    stream_write_format(stream, "    2. Capture raw signal data\n");
-    stream_write_format(stream, "    3. Analyze timing patterns\n");
-    stream_write_format(stream, "    4. Extract protocol parameters\n");
-}
+    SubGhzToolkitWriter *writer = ctx->writer;
 
-static void subghz_toolkit_analyze_timing_patterns(Stream *stream, const SubGhzProtocol *protocol)
-{
-    stream_write_format(stream, "\n  Timing Pattern Analysis:\n");
-    stream_write_format(stream, "    Protocol: %s\n", protocol->name);
-    
-    // Common timing patterns for different protocols
-    stream_write_format(stream, "    Common timing patterns:\n");
-    stream_write_format(stream, "    - Manchester: 50/50 duty cycle\n");
-    stream_write_format(stream, "    - PWM: Variable pulse width\n");
-    stream_write_format(stream, "    - PPM: Pulse position modulation\n");
-    stream_write_format(stream, "    - RAW: Custom timing patterns\n");
-    
-    // Analyze protocol type for timing hints
-    switch (protocol->type)
+    subghz_toolkit_writer_cstr(writer, "\n████████████████████████████████████████████████████████████\n");
+    subghz_toolkit_writer_printf(writer, "Protocol: %s - Function Disassembly\n", protocol->name);
+    subghz_toolkit_writer_cstr(writer, "████████████████████████████████████████████████████████████\n");
+
+    uint32_t functions[SubGhzToolkitFunctionSlotCount];
+    subghz_toolkit_protocol_functions(protocol, functions);
+
+    for (size_t slot = 0; slot < SubGhzToolkitFunctionSlotCount; slot++)
     {
-        case SubGhzProtocolTypeStatic:
-            stream_write_format(stream, "    Type: Static (fixed timing)\n");
-            break;
-        case SubGhzProtocolTypeDynamic:
-            stream_write_format(stream, "    Type: Dynamic (variable timing)\n");
-            break;
-        default:
-            stream_write_format(stream, "    Type: RAW (custom timing)\n");
-            break;
+        if (slot == SubGhzToolkitFunctionSlotDecoderAlloc && protocol->decoder)
+        {
+            subghz_toolkit_writer_cstr(writer, "\nDECODER FUNCTIONS:\n");
+            subghz_toolkit_writer_cstr(writer, "==================\n");
+        }
+        else if (slot == SubGhzToolkitFunctionSlotEncoderAlloc && protocol->encoder)
+        {
+            subghz_toolkit_writer_cstr(writer, "\nENCODER FUNCTIONS:\n");
+            subghz_toolkit_writer_cstr(writer, "==================\n");
+        }
+
+        subghz_toolkit_analyze_function_bytes(ctx, index, slot, functions[slot]);
     }
+
+    subghz_toolkit_writer_cstr(writer, "\n");
 }
 
-static void subghz_toolkit_generate_protocol_c_header(Stream *stream, const SubGhzProtocol *protocol)
+static void subghz_toolkit_disassembly_end(SubGhzToolkitPassContext *ctx)
 {
-    stream_write_format(stream, "\n// Generated C Header for Protocol: %s\n", protocol->name);
-    stream_write_format(stream, "#ifndef %s_PROTOCOL_H\n", protocol->name);
-    stream_write_format(stream, "#define %s_PROTOCOL_H\n\n", protocol->name);
-    
-    stream_write_format(stream, "#include <stdint.h>\n");
-    stream_write_format(stream, "#include <stddef.h>\n\n");
-    
-    stream_write_format(stream, "// Protocol Information\n");
-    stream_write_format(stream, "#define %s_PROTOCOL_NAME \"%s\"\n", protocol->name, protocol->name);
-    stream_write_format(stream, "#define %s_PROTOCOL_TYPE 0x%02X\n", protocol->name, protocol->type);
-    stream_write_format(stream, "#define %s_PROTOCOL_FLAG 0x%08lX\n\n", protocol->name, (uint32_t)protocol->flag);
-    
-    stream_write_format(stream, "// Function Pointer Types\n");
-    stream_write_format(stream, "typedef void* (*%s_alloc_func)(void* env);\n", protocol->name);
-    stream_write_format(stream, "typedef void (*%s_free_func)(void* decoder);\n", protocol->name);
-    stream_write_format(stream, "typedef void (*%s_reset_func)(void* decoder);\n", protocol->name);
-    stream_write_format(stream, "typedef void (*%s_feed_func)(void* decoder, bool level, uint32_t duration);\n", protocol->name);
-    stream_write_format(stream, "typedef void (*%s_get_string_func)(void* decoder, FuriString* output);\n", protocol->name);
-    
-    stream_write_format(stream, "\n// Protocol Structure\n");
-    stream_write_format(stream, "typedef struct {\n");
-    stream_write_format(stream, "    const char* name;\n");
-    stream_write_format(stream, "    uint8_t type;\n");
-    stream_write_format(stream, "    uint32_t flag;\n");
-    stream_write_format(stream, "    struct {\n");
-    stream_write_format(stream, "        %s_alloc_func alloc;\n", protocol->name);
-    stream_write_format(stream, "        %s_free_func free;\n", protocol->name);
-    stream_write_format(stream, "        %s_reset_func reset;\n", protocol->name);
-    stream_write_format(stream, "        %s_feed_func feed;\n", protocol->name);
-    stream_write_format(stream, "        %s_get_string_func get_string;\n", protocol->name);
-    stream_write_format(stream, "    } decoder;\n");
-    stream_write_format(stream, "} %s_Protocol;\n\n", protocol->name);
-    
-    stream_write_format(stream, "// Implementation Notes\n");
-    stream_write_format(stream, "// - Function pointers can be extracted from firmware\n");
-    stream_write_format(stream, "// - Timing patterns need to be analyzed from signals\n");
-    stream_write_format(stream, "// - Protocol state machine needs reverse engineering\n");
-    stream_write_format(stream, "// - Use signal capture to understand data encoding\n\n");
-    
-    stream_write_format(stream, "#endif // %s_PROTOCOL_H\n", protocol->name);
+    SubGhzToolkitDisassemblyState *state = ctx->state;
+
+    subghz_toolkit_writer_printf(ctx->writer,
+                                 "\n=== FUNCTION SIZE SUMMARY ===\n"
+                                 "Unique functions: %lu\n"
+                                 "Shared references: %lu\n"
+                                 "Total size: %lu bytes (%lu code + %lu literal pool)\n"
+                                 "Truncated at %u bytes: %lu\n",
+                                 state->functions,
+                                 state->shared,
+                                 state->code_bytes + state->pool_bytes,
+                                 state->code_bytes,
+                                 state->pool_bytes,
+                                 SUBGHZ_TOOLKIT_FUNCTION_MAX_SIZE,
+                                 state->truncated);
 }
 
-static void subghz_toolkit_function_disassembly(SubGhzToolkitApp *app)
-{
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewLoading);
+// Call graph over every decoder/encoder entry point. The graph lives only for
+// one export; function bounds come from the app wide cache.
 
-    bool success = false;
-    Storage *storage = furi_record_open(RECORD_STORAGE);
-    Stream *stream = file_stream_alloc(storage);
+typedef struct
+{
+    SubGhzToolkitCallGraph *graph;
+    size_t roots;
+} SubGhzToolkitCallGraphState;
 
-    do
-    {
-        storage_simply_mkdir(storage, EXT_PATH("subghz"));
-        storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+static void subghz_toolkit_call_node_name(
+    SubGhzToolkitApp *app, const SubGhzToolkitCallNode *node, char *name, size_t name_size)
+{
+    const SubGhzProtocol *owner = NULL;
+    if (node->owner != SUBGHZ_TOOLKIT_FUNCTION_NO_OWNER)
+        owner = subghz_protocol_registry_get_by_index(app->protocol_registry, node->owner);
+
+    const char *symbol;
+    uint32_t offset;
+    SubGhzToolkitSymbols *symbols = subghz_toolkit_get_symbols(app);
+
+    if (owner && node->label < SubGhzToolkitFunctionSlotCount)
+        snprintf(name, name_size, "%s %s", owner->name, subghz_toolkit_function_slot_names[node->label]);
+    else if (symbols && subghz_toolkit_symbols_lookup(symbols, node->address, &symbol, &offset) && !offset)
+        snprintf(name, name_size, "%s", symbol);
+    else
+        snprintf(name, name_size, "sub_%08lX", node->address);
+}
 
-        if (!file_stream_open(stream, SUBGHZ_ANALYSIS_DIR "/function_disassembly.txt",
-                              FSAM_WRITE, FSOM_CREATE_ALWAYS))
-        {
-            break;
-        }
+static void subghz_toolkit_call_graph_begin(SubGhzToolkitPassContext *ctx)
+{
+    SubGhzToolkitCallGraphState *state = ctx->state;
+    state->graph = subghz_toolkit_call_graph_alloc(
+        subghz_toolkit_get_function_cache(ctx->app), subghz_toolkit_memory_code_at, &ctx->app->flash, SUBGHZ_TOOLKIT_CALL_GRAPH_NODE_LIMIT);
+}
 
-        stream_write_format(stream,
-                            "==============================================================\n"
-                            "        SubGhz Protocol Function Disassembly Analysis\n"
-                            "                  Generated by SubGhz Toolkit\n"
-                            "                 RocketGod | betaskynet.com\n"
-                            "==============================================================\n\n");
+static void subghz_toolkit_call_graph_protocol(SubGhzToolkitPassContext *ctx, size_t index, const SubGhzProtocol *protocol)
+{
+    SubGhzToolkitCallGraphState *state = ctx->state;
 
-        size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
+    uint32_t functions[SubGhzToolkitFunctionSlotCount];
+    subghz_toolkit_protocol_functions(protocol, functions);
 
-        for (size_t i = 0; i < protocol_count; i++)
-        {
-            const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
-            if (!protocol || !protocol->name)
-                continue;
+    for (size_t slot = 0; slot < SubGhzToolkitFunctionSlotCount; slot++)
+    {
+        if (!functions[slot])
+            continue;
+        subghz_toolkit_call_graph_add_root(
+            state->graph, subghz_toolkit_thumb_code_address(functions[slot]), (uint16_t)index, (uint8_t)slot);
+        state->roots++;
+    }
+}
 
-            stream_write_format(stream, "\n████████████████████████████████████████████████████████████\n");
-            stream_write_format(stream, "Protocol: %s - Function Disassembly\n", protocol->name);
-            stream_write_format(stream, "████████████████████████████████████████████████████████████\n");
+static void subghz_toolkit_call_graph_write_dot(SubGhzToolkitPassContext *ctx)
+{
+    SubGhzToolkitCallGraphState *state = ctx->state;
+    SubGhzToolkitWriter *writer = ctx->writer;
+    char name[64];
 
-            if (protocol->decoder)
-            {
-                stream_write_format(stream, "\nDECODER FUNCTIONS:\n");
-                stream_write_format(stream, "==================\n");
-                
-                subghz_toolkit_analyze_function_bytes(stream, "decoder->alloc", protocol->decoder->alloc, 64);
-                subghz_toolkit_analyze_function_bytes(stream, "decoder->free", protocol->decoder->free, 64);
-                subghz_toolkit_analyze_function_bytes(stream, "decoder->reset", protocol->decoder->reset, 64);
-                subghz_toolkit_analyze_function_bytes(stream, "decoder->feed", protocol->decoder->feed, 64);
-                subghz_toolkit_analyze_function_bytes(stream, "decoder->get_string", protocol->decoder->get_string, 64);
-                subghz_toolkit_analyze_function_bytes(stream, "decoder->serialize", protocol->decoder->serialize, 64);
-                subghz_toolkit_analyze_function_bytes(stream, "decoder->deserialize", protocol->decoder->deserialize, 64);
-                subghz_toolkit_analyze_function_bytes(stream, "decoder->get_hash_data", protocol->decoder->get_hash_data, 64);
-            }
+    subghz_toolkit_writer_cstr(writer,
+                               "digraph subghz_calls {\n"
+                               "    rankdir=LR;\n"
+                               "    node [shape=box, fontname=\"monospace\", fontsize=10];\n");
 
-            if (protocol->encoder)
-            {
-                stream_write_format(stream, "\nENCODER FUNCTIONS:\n");
-                stream_write_format(stream, "==================\n");
-                
-                subghz_toolkit_analyze_function_bytes(stream, "encoder->alloc", protocol->encoder->alloc, 64);
-                subghz_toolkit_analyze_function_bytes(stream, "encoder->free", protocol->encoder->free, 64);
-                subghz_toolkit_analyze_function_bytes(stream, "encoder->deserialize", protocol->encoder->deserialize, 64);
-                subghz_toolkit_analyze_function_bytes(stream, "encoder->stop", protocol->encoder->stop, 64);
-                subghz_toolkit_analyze_function_bytes(stream, "encoder->yield", protocol->encoder->yield, 64);
-            }
+    for (size_t i = 0; i < subghz_toolkit_call_graph_node_count(state->graph); i++)
+    {
+        const SubGhzToolkitCallNode *node = subghz_toolkit_call_graph_node(state->graph, i);
+        subghz_toolkit_call_node_name(ctx->app, node, name, sizeof(name));
+
+        subghz_toolkit_writer_printf(writer, "    n%zu [label=\"%s\\n0x%08lX, %u B", i, name, node->address, node->size);
+        if (node->roots > 1)
+            subghz_toolkit_writer_printf(writer, "\\n%u entry points", node->roots);
+        if (node->fan_in > 1)
+            subghz_toolkit_writer_printf(writer, "\\nfan-in %u", node->fan_in);
+        subghz_toolkit_writer_cstr(writer, "\"");
+
+        if (node->flags & SUBGHZ_TOOLKIT_CALL_NODE_FLAG_ROOT)
+            subghz_toolkit_writer_cstr(writer, ", style=filled, fillcolor=\"#cde4ff\"");
+        else if (node->fan_in >= SUBGHZ_TOOLKIT_CALL_GRAPH_HOT_FAN_IN)
+            subghz_toolkit_writer_cstr(writer, ", style=filled, fillcolor=\"#ffd0c0\"");
+        else if (node->flags & SUBGHZ_TOOLKIT_CALL_NODE_FLAG_EXTERNAL)
+            subghz_toolkit_writer_cstr(writer, ", style=dotted");
+        subghz_toolkit_writer_cstr(writer, "];\n");
+    }
 
-            stream_write_format(stream, "\n");
-        }
+    for (size_t i = 0; i < subghz_toolkit_call_graph_edge_count(state->graph); i++)
+    {
+        const SubGhzToolkitCallEdge *edge = subghz_toolkit_call_graph_edge(state->graph, i);
+        subghz_toolkit_writer_printf(writer, "    n%u -> n%u%s;\n", edge->from, edge->to, edge->tail ? " [style=dashed]" : "");
+    }
 
-        success = true;
-    } while (0);
+    subghz_toolkit_writer_cstr(writer, "}\n");
+}
 
-    stream_free(stream);
-    furi_record_close(RECORD_STORAGE);
+static int subghz_toolkit_call_graph_compare_hot(const void *a, const void *b)
+{
+    uint32_t ka = *(const uint32_t *)a;
+    uint32_t kb = *(const uint32_t *)b;
+    return ka < kb ? 1 : ka > kb ? -1 : 0;
+}
 
-    if (success)
+// Compact edge list plus fan-in ranking, one line per entry for diffing and scripts
+static void subghz_toolkit_call_graph_write_edges(SubGhzToolkitPassContext *ctx, SubGhzToolkitWriter *writer)
+{
+    SubGhzToolkitCallGraphState *state = ctx->state;
+    SubGhzToolkitCallGraph *graph = state->graph;
+    size_t node_count = subghz_toolkit_call_graph_node_count(graph);
+    size_t edge_count = subghz_toolkit_call_graph_edge_count(graph);
+    size_t indirect = 0;
+    char name[64];
+
+    // fan-in << 16 | (0xFFFF - node): sorts hottest first, then in discovery order
+    uint32_t *hot = malloc(sizeof(uint32_t) * (node_count ? node_count : 1));
+    size_t hot_count = 0;
+    for (size_t i = 0; i < node_count; i++)
     {
-        popup_set_header(app->popup, "Success!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Function disassembly exported to:\n/ext/subghz/analysis/function_disassembly.txt",
-                       64, 20, AlignCenter, AlignTop);
+        const SubGhzToolkitCallNode *node = subghz_toolkit_call_graph_node(graph, i);
+        indirect += node->indirect;
+        if (node->fan_in > 1)
+            hot[hot_count++] = ((uint32_t)node->fan_in << 16) | (0xFFFF - i);
     }
-    else
+    qsort(hot, hot_count, sizeof(uint32_t), subghz_toolkit_call_graph_compare_hot);
+
+    subghz_toolkit_writer_printf(writer,
+                                 "# SubGhz call graph\n"
+                                 "# %zu functions, %zu edges, %zu entry points, %zu indirect calls not followed\n",
+                                 node_count,
+                                 edge_count,
+                                 state->roots,
+                                 indirect);
+    if (subghz_toolkit_call_graph_dropped(graph))
+        subghz_toolkit_writer_printf(writer, "# node limit %u reached, %zu call targets dropped\n",
+                                     SUBGHZ_TOOLKIT_CALL_GRAPH_NODE_LIMIT,
+                                     subghz_toolkit_call_graph_dropped(graph));
+
+    subghz_toolkit_writer_cstr(writer, "\n# caller callee kind\n");
+    for (size_t i = 0; i < edge_count; i++)
     {
-        popup_set_header(app->popup, "Error!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Failed to export disassembly", 64, 20, AlignCenter, AlignTop);
+        const SubGhzToolkitCallEdge *edge = subghz_toolkit_call_graph_edge(graph, i);
+        subghz_toolkit_writer_printf(writer, "%08lX %08lX %s\n",
+                                     subghz_toolkit_call_graph_node(graph, edge->from)->address,
+                                     subghz_toolkit_call_graph_node(graph, edge->to)->address,
+                                     edge->tail ? "tail" : "call");
     }
 
-    popup_set_callback(app->popup, subghz_toolkit_popup_callback);
-    popup_set_context(app->popup, app);
-    popup_set_timeout(app->popup, 3000);
-    popup_enable_timeout(app->popup);
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewPopup);
+    subghz_toolkit_writer_cstr(writer, "\n# function fan_in size name (shared routines, hottest first)\n");
+    for (size_t i = 0; i < hot_count; i++)
+    {
+        const SubGhzToolkitCallNode *node = subghz_toolkit_call_graph_node(graph, 0xFFFF - (hot[i] & 0xFFFF));
+        subghz_toolkit_call_node_name(ctx->app, node, name, sizeof(name));
+        subghz_toolkit_writer_printf(writer, "%08lX %u %u %s\n", node->address, node->fan_in, node->size, name);
+    }
+
+    free(hot);
 }
 
-static void subghz_toolkit_protocol_state_analysis(SubGhzToolkitApp *app)
+static void subghz_toolkit_call_graph_end(SubGhzToolkitPassContext *ctx)
 {
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewLoading);
+    SubGhzToolkitCallGraphState *state = ctx->state;
 
-    bool success = false;
+    subghz_toolkit_call_graph_write_dot(ctx);
+
+    // The edge list goes to a second file next to the DOT output
     Storage *storage = furi_record_open(RECORD_STORAGE);
     Stream *stream = file_stream_alloc(storage);
-
-    do
+    if (file_stream_open(stream, SUBGHZ_CALL_GRAPH_EDGES_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS))
     {
-        storage_simply_mkdir(storage, EXT_PATH("subghz"));
-        storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+        SubGhzToolkitWriter *writer = subghz_toolkit_writer_alloc(subghz_toolkit_stream_flush, stream);
+        subghz_toolkit_call_graph_write_edges(ctx, writer);
+        subghz_toolkit_writer_flush(writer);
+        if (subghz_toolkit_writer_get_stats(writer)->error)
+            FURI_LOG_E(TAG, "Failed to write %s", SUBGHZ_CALL_GRAPH_EDGES_PATH);
+        subghz_toolkit_writer_free(writer);
+    }
+    else
+    {
+        FURI_LOG_E(TAG, "Failed to open %s", SUBGHZ_CALL_GRAPH_EDGES_PATH);
+    }
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
 
-        if (!file_stream_open(stream, SUBGHZ_ANALYSIS_DIR "/protocol_state_analysis.txt",
-                              FSAM_WRITE, FSOM_CREATE_ALWAYS))
-        {
+    FURI_LOG_I(TAG, "Call graph: %zu functions, %zu edges",
+               subghz_toolkit_call_graph_node_count(state->graph),
+               subghz_toolkit_call_graph_edge_count(state->graph));
+
+    subghz_toolkit_call_graph_free(state->graph);
+    state->graph = NULL;
+}
+
+static void subghz_toolkit_state_protocol(SubGhzToolkitPassContext *ctx, size_t index, const SubGhzProtocol *protocol)
+{
+    UNUSED(index);
+    SubGhzToolkitWriter *writer = ctx->writer;
+
+    subghz_toolkit_writer_cstr(writer, "\n████████████████████████████████████████████████████████████\n");
+    subghz_toolkit_writer_printf(writer, "Protocol: %s - State Analysis\n", protocol->name);
+    subghz_toolkit_writer_cstr(writer, "████████████████████████████████████████████████████████████\n");
+
+    subghz_toolkit_analyze_protocol_state(writer, protocol, subghz_toolkit_get_environment(ctx->app), ctx->state);
+    subghz_toolkit_writer_cstr(writer, "\n");
+}
+
+// Signal capture, see helpers/subghz_toolkit_capture.h. The radio interrupt
+// pushes pulses into the ring, the worker thread drains them into blocks and
+// feeds the receiver, and a writer thread stores full blocks as a RAW .sub
+// file while the next one fills.
+
+typedef struct
+{
+    const SubGhzDevice *device;
+    uint32_t frequency;
+} SubGhzToolkitRadioSource;
+
+static void subghz_toolkit_radio_source_callback(bool level, uint32_t duration, void *context)
+{
+    subghz_toolkit_capture_push(context, level, duration);
+}
+
+static bool subghz_toolkit_radio_source_start(void *context, SubGhzToolkitCapture *capture)
+{
+    SubGhzToolkitRadioSource *radio = context;
+
+    subghz_devices_init();
+    radio->device = subghz_devices_get_by_name(SUBGHZ_DEVICE_CC1101_INT_NAME);
+    if (!radio->device || !subghz_devices_is_frequency_valid(radio->device, radio->frequency) ||
+        !subghz_devices_begin(radio->device))
+    {
+        FURI_LOG_E(TAG, "Radio unavailable for %lu Hz", radio->frequency);
+        subghz_devices_deinit();
+        radio->device = NULL;
+        return false;
+    }
+
+    subghz_devices_reset(radio->device);
+    subghz_devices_idle(radio->device);
+    subghz_devices_load_preset(radio->device, FuriHalSubGhzPresetOok650Async, NULL);
+    radio->frequency = subghz_devices_set_frequency(radio->device, radio->frequency);
+    subghz_devices_flush_rx(radio->device);
+    subghz_devices_set_rx(radio->device);
+    subghz_devices_start_async_rx(radio->device, subghz_toolkit_radio_source_callback, capture);
+    return true;
+}
+
+static void subghz_toolkit_radio_source_stop(void *context)
+{
+    SubGhzToolkitRadioSource *radio = context;
+    if (!radio->device)
+        return;
+
+    subghz_devices_stop_async_rx(radio->device);
+    subghz_devices_idle(radio->device);
+    subghz_devices_sleep(radio->device);
+    subghz_devices_end(radio->device);
+    subghz_devices_deinit();
+    radio->device = NULL;
+}
+
+typedef struct
+{
+    SubGhzToolkitCapture *capture;
+    Stream *stream;
+    bool error;
+} SubGhzToolkitCaptureWriter;
+
+static int32_t subghz_toolkit_capture_writer_thread(void *context)
+{
+    SubGhzToolkitCaptureWriter *writer = context;
+    const uint8_t *data;
+    size_t size;
+
+    while (!subghz_toolkit_capture_is_flushed(writer->capture))
+    {
+        if (!subghz_toolkit_capture_next_block(writer->capture, &data, &size))
+        {
+            furi_delay_ms(2);
+            continue;
+        }
+
+        uint32_t start_tick = furi_get_tick();
+        if (stream_write(writer->stream, data, size) != size)
+            writer->error = true;
+        subghz_toolkit_capture_block_done(writer->capture, furi_get_tick() - start_tick);
+    }
+    return 0;
+}
+
+typedef struct
+{
+    SubGhzToolkitWriter *report;
+    uint32_t decodes;
+    FuriString *text;
+} SubGhzToolkitCaptureDecodes;
+
+static void subghz_toolkit_capture_decode_callback(SubGhzReceiver *receiver, SubGhzProtocolDecoderBase *decoder, void *context)
+{
+    UNUSED(receiver);
+    SubGhzToolkitCaptureDecodes *decodes = context;
+
+    decodes->decodes++;
+    subghz_protocol_decoder_base_get_string(decoder, decodes->text);
+    subghz_toolkit_writer_printf(decodes->report, "\n--- Decode %lu ---\n%s\n", decodes->decodes, furi_string_get_cstr(decodes->text));
+}
+
+// Timing estimate and line coding of a stream of pulses
+typedef struct
+{
+    SubGhzToolkitClusters clusters;
+    SubGhzToolkitClassifier classifier;
+} SubGhzToolkitSignalShape;
+
+static void subghz_toolkit_signal_shape_init(SubGhzToolkitSignalShape *shape)
+{
+    subghz_toolkit_clusters_init(&shape->clusters);
+    subghz_toolkit_classify_init(&shape->classifier);
+}
+
+static void subghz_toolkit_signal_shape_add(void *context, bool level, uint32_t duration)
+{
+    SubGhzToolkitSignalShape *shape = context;
+    subghz_toolkit_clusters_add(&shape->clusters, level, duration);
+    subghz_toolkit_classify_add(&shape->classifier, level, duration);
+}
+
+// Clusters, te and the encoding classified at that te. False when te could not be estimated.
+static bool subghz_toolkit_signal_shape_write_report(
+    SubGhzToolkitWriter *writer, const SubGhzToolkitSignalShape *shape, SubGhzToolkitClustersEstimate *estimate)
+{
+    SubGhzToolkitClassification *classification = malloc(sizeof(SubGhzToolkitClassification));
+    bool estimated = subghz_toolkit_clusters_estimate(&shape->clusters, estimate);
+
+    subghz_toolkit_clusters_write_report(writer, &shape->clusters, estimate);
+    subghz_toolkit_classify(&shape->classifier, estimate->te, classification);
+    subghz_toolkit_classify_write_report(writer, classification);
+    free(classification);
+    return estimated;
+}
+
+// Every drained pulse goes to the receiver and the signal shape
+typedef struct
+{
+    SubGhzReceiver *receiver;
+    SubGhzToolkitSignalShape shape;
+} SubGhzToolkitCaptureTap;
+
+static void subghz_toolkit_capture_tap_pulse(void *context, bool level, uint32_t duration)
+{
+    SubGhzToolkitCaptureTap *tap = context;
+    subghz_receiver_decode(tap->receiver, level, duration);
+    subghz_toolkit_signal_shape_add(&tap->shape, level, duration);
+}
+
+// Runs `source` for SUBGHZ_TOOLKIT_CAPTURE_SECONDS (or until cancelled), RAW pulses go to `raw`.
+// `te` is the base element estimated from the pulses, 0 when there were too few.
+static bool subghz_toolkit_capture_signal_samples(
+    SubGhzToolkitApp *app, const SubGhzToolkitCaptureSource *source, Stream *raw, SubGhzToolkitWriter *report, uint32_t *te)
+{
+    SubGhzToolkitCapture *capture = subghz_toolkit_capture_alloc(SUBGHZ_TOOLKIT_CAPTURE_RING_SIZE, SUBGHZ_TOOLKIT_CAPTURE_BLOCK_SIZE);
+    SubGhzToolkitCaptureWriter writer = {.capture = capture, .stream = raw};
+    SubGhzToolkitCaptureDecodes decodes = {.report = report, .text = furi_string_alloc()};
+    SubGhzToolkitCaptureTap *tap = malloc(sizeof(SubGhzToolkitCaptureTap));
+    FuriString *item = furi_string_alloc();
+
+    tap->receiver = subghz_toolkit_get_receiver(app);
+    subghz_toolkit_signal_shape_init(&tap->shape);
+    subghz_receiver_reset(tap->receiver);
+    subghz_receiver_set_rx_callback(tap->receiver, subghz_toolkit_capture_decode_callback, &decodes);
+    subghz_toolkit_capture_set_tap(capture, subghz_toolkit_capture_tap_pulse, tap);
+
+    FuriThread *thread = furi_thread_alloc_ex("SubGhzToolkitCapture", 2048, subghz_toolkit_capture_writer_thread, &writer);
+    furi_thread_start(thread);
+
+    uint32_t start_tick = furi_get_tick();
+    bool started = source->start(source->context, capture);
+    if (started)
+    {
+        subghz_toolkit_writer_cstr(report, "Decoded while capturing:\n");
+
+        uint32_t elapsed_ms = 0;
+        while (elapsed_ms < SUBGHZ_TOOLKIT_CAPTURE_SECONDS * 1000 && !subghz_toolkit_worker_is_cancelled(app->worker))
+        {
+            if (source->is_done && source->is_done(source->context) && !subghz_toolkit_capture_pending(capture))
+                break;
+            if (!subghz_toolkit_capture_drain(capture))
+                furi_delay_ms(5);
+
+            elapsed_ms = furi_get_tick() - start_tick;
+            furi_string_printf(item, "%lu pulses", subghz_toolkit_capture_get_stats(capture)->pulses);
+            subghz_toolkit_worker_report(app->worker, elapsed_ms / 100, SUBGHZ_TOOLKIT_CAPTURE_SECONDS * 10, furi_string_get_cstr(item));
+        }
+        source->stop(source->context);
+
+        // Whatever the source pushed before it stopped, as long as the writer keeps up
+        while (subghz_toolkit_capture_pending(capture) && !subghz_toolkit_worker_is_cancelled(app->worker))
+        {
+            if (!subghz_toolkit_capture_drain(capture))
+                furi_delay_ms(2);
+        }
+        if (!decodes.decodes)
+            subghz_toolkit_writer_cstr(report, "  none\n");
+    }
+
+    subghz_toolkit_capture_finish(capture);
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+    subghz_receiver_set_rx_callback(tap->receiver, NULL, NULL);
+
+    uint32_t elapsed_ms = furi_get_tick() - start_tick;
+    const SubGhzToolkitCaptureStats *stats = subghz_toolkit_capture_get_stats(capture);
+    FURI_LOG_I(TAG, "Capture: %lu pulses, %lu dropped, %lu decodes in %lu ms",
+               stats->pulses, stats->overflows, decodes.decodes, elapsed_ms);
+
+    subghz_toolkit_writer_cstr(report, "\n");
+    subghz_toolkit_capture_write_report(report, capture, elapsed_ms);
+
+    SubGhzToolkitClustersEstimate estimate;
+    subghz_toolkit_writer_cstr(report, "\n");
+    subghz_toolkit_signal_shape_write_report(report, &tap->shape, &estimate);
+    *te = estimate.te;
+    furi_string_printf(app->result_text, "%lu pulses, %lu decodes\n%s", stats->pulses, decodes.decodes, SUBGHZ_CAPTURE_PATH);
+
+    subghz_toolkit_capture_free(capture);
+    free(tap);
+    furi_string_free(decodes.text);
+    furi_string_free(item);
+    return started && !writer.error;
+}
+
+// Repeated frame of the RAW capture at `path`, its pulses quantized to `te`
+static void subghz_toolkit_capture_write_frames(SubGhzToolkitApp *app, const char *path, uint32_t te, SubGhzToolkitWriter *report)
+{
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *file = storage_file_alloc(storage);
+    SubGhzToolkitFrames *frames = subghz_toolkit_frames_alloc(SUBGHZ_TOOLKIT_FRAMES_MAX_PERIOD);
+    SubGhzToolkitFramesResult result;
+
+    subghz_toolkit_frames_reset(frames, te);
+    if (te && storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING))
+    {
+        char *buffer = malloc(SUBGHZ_TOOLKIT_REPLAY_READ_SIZE);
+        size_t total = storage_file_size(file);
+        size_t done = 0;
+        SubGhzToolkitRawParser parser;
+        size_t size;
+
+        subghz_toolkit_raw_parser_init(&parser);
+        while (!subghz_toolkit_worker_is_cancelled(app->worker) &&
+               (size = storage_file_read(file, buffer, SUBGHZ_TOOLKIT_REPLAY_READ_SIZE)) > 0)
+        {
+            subghz_toolkit_raw_parser_feed(&parser, buffer, size, subghz_toolkit_frames_feed, frames);
+            done += size;
+            subghz_toolkit_worker_report(app->worker, done / 1024, total / 1024 + 1, "Finding frames");
+        }
+        subghz_toolkit_raw_parser_finish(&parser, subghz_toolkit_frames_feed, frames);
+        free(buffer);
+    }
+
+    subghz_toolkit_frames_analyze(frames, &result);
+    subghz_toolkit_writer_cstr(report, "\n");
+    subghz_toolkit_frames_write_report(report, frames, &result);
+
+    subghz_toolkit_frames_free(frames);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static bool subghz_toolkit_signal_capture_run(SubGhzToolkitApp *app)
+{
+    bool success = false;
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    Stream *stream = file_stream_alloc(storage);
+    Stream *raw = file_stream_alloc(storage);
+
+    do
+    {
+        storage_simply_mkdir(storage, EXT_PATH("subghz"));
+        storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+
+        if (!file_stream_open(stream, SUBGHZ_ANALYSIS_DIR "/signal_capture_analysis.txt",
+                              FSAM_WRITE, FSOM_CREATE_ALWAYS) ||
+            !file_stream_open(raw, SUBGHZ_CAPTURE_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+        {
             break;
         }
 
-        stream_write_format(stream,
-                            "==============================================================\n"
-                            "        SubGhz Protocol State Analysis\n"
-                            "                  Generated by SubGhz Toolkit\n"
-                            "                 RocketGod | betaskynet.com\n"
-                            "==============================================================\n\n");
+        SubGhzToolkitRadioSource radio = {
+            .frequency = subghz_setting_get_default_frequency(subghz_toolkit_get_setting(app)),
+        };
+        SubGhzToolkitCaptureSource source = {
+            .name = "CC1101 internal, AM650",
+            .start = subghz_toolkit_radio_source_start,
+            .stop = subghz_toolkit_radio_source_stop,
+            .context = &radio,
+        };
+
+        SubGhzToolkitWriter *header = subghz_toolkit_writer_alloc(subghz_toolkit_stream_flush, raw);
+        subghz_toolkit_raw_write_header(header, radio.frequency, SUBGHZ_TOOLKIT_RAW_DEFAULT_PRESET);
+        subghz_toolkit_writer_free(header);
+
+        SubGhzToolkitWriter *writer = subghz_toolkit_writer_alloc(subghz_toolkit_stream_flush, stream);
+
+        subghz_toolkit_writer_cstr(writer,
+                                   "==============================================================\n"
+                                   "        SubGhz Signal Capture Analysis\n"
+                                   "                  Generated by SubGhz Toolkit\n"
+                                   "                 RocketGod | betaskynet.com\n"
+                                   "==============================================================\n\n");
+        subghz_toolkit_writer_printf(writer,
+                                     "Source:    %s\n"
+                                     "Frequency: %lu.%02lu MHz\n"
+                                     "Duration:  %d s\n"
+                                     "RAW file:  %s\n\n",
+                                     source.name,
+                                     radio.frequency / 1000000,
+                                     (radio.frequency % 1000000) / 10000,
+                                     SUBGHZ_TOOLKIT_CAPTURE_SECONDS,
+                                     SUBGHZ_CAPTURE_PATH);
+
+        uint32_t te = 0;
+        success = subghz_toolkit_capture_signal_samples(app, &source, raw, writer, &te);
+
+        // The frame detector needs te up front, so it reads the capture back once it is closed
+        file_stream_close(raw);
+        if (success)
+            subghz_toolkit_capture_write_frames(app, SUBGHZ_CAPTURE_PATH, te, writer);
+
+        subghz_toolkit_writer_flush(writer);
+        success = success && !subghz_toolkit_writer_get_stats(writer)->error;
+        subghz_toolkit_writer_free(writer);
+    } while (0);
 
-        size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
+    stream_free(raw);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
 
-        for (size_t i = 0; i < protocol_count; i++)
+    return success;
+}
+
+static void subghz_toolkit_signal_capture_analysis(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitJob job = {
+        .title = "Signal Capture",
+        .run = subghz_toolkit_signal_capture_run,
+        .success_text = "Signal captured to:\n/ext/subghz/analysis/signal_capture.sub",
+        .error_text = "Failed to capture signal",
+    };
+    subghz_toolkit_start_job(app, &job);
+}
+
+// RAW replay, see helpers/subghz_toolkit_replay.h. Every .sub file in
+// /ext/subghz/analysis/replay/ (or the last signal capture when the folder is
+// empty) is parsed in chunks and each pulse goes to one decoder per protocol
+// in the registry, so a folder of captures is regression tested in one run.
+// The decoders are allocated here rather than taken from the receiver, whose
+// slots are private, so every decode is attributed to its protocol.
+// Profile Decoders runs the same replay with every feed() timed, see
+// helpers/subghz_toolkit_profile.h, and writes the cost per protocol instead
+// of the decodes.
+
+typedef struct
+{
+    SubGhzToolkitReplay *replay;
+    FuriString *text;
+} SubGhzToolkitReplayDecodes;
+
+typedef struct
+{
+    size_t files;
+    uint32_t pulses;
+    uint32_t decodes;
+    uint32_t elapsed_ms;
+} SubGhzToolkitReplayTotals;
+
+static void subghz_toolkit_replay_decode_callback(SubGhzProtocolDecoderBase *decoder, void *context)
+{
+    SubGhzToolkitReplayDecodes *decodes = context;
+
+    subghz_protocol_decoder_base_get_string(decoder, decodes->text);
+    subghz_toolkit_replay_decoded(decodes->replay, furi_string_get_cstr(decodes->text));
+}
+
+static void subghz_toolkit_replay_add_registry(SubGhzToolkitApp *app, SubGhzToolkitReplayDecodes *decodes)
+{
+    SubGhzEnvironment *environment = subghz_toolkit_get_environment(app);
+    size_t count = subghz_protocol_registry_count(app->protocol_registry);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
+        if (!protocol || !protocol->decoder || !protocol->decoder->alloc || !protocol->decoder->feed)
+            continue;
+
+        SubGhzProtocolDecoderBase *decoder = protocol->decoder->alloc(environment);
+        if (!decoder)
+            continue;
+        subghz_protocol_decoder_base_set_decoder_callback(decoder, subghz_toolkit_replay_decode_callback, decodes);
+        subghz_toolkit_replay_add(
+            decodes->replay, protocol->name, decoder, protocol->decoder->feed, protocol->decoder->reset, protocol->decoder->free);
+    }
+}
+
+static bool subghz_toolkit_replay_is_sub_file(const FileInfo *info, const char *name)
+{
+    size_t length = strlen(name);
+    return !file_info_is_dir(info) && length > 4 && strcmp(name + length - 4, ".sub") == 0;
+}
+
+static size_t subghz_toolkit_replay_count_files(Storage *storage)
+{
+    size_t count = 0;
+    File *dir = storage_file_alloc(storage);
+    FileInfo info;
+    char name[64];
+
+    if (storage_dir_open(dir, SUBGHZ_REPLAY_DIR))
+    {
+        while (storage_dir_read(dir, &info, name, sizeof(name)))
+            count += subghz_toolkit_replay_is_sub_file(&info, name);
+    }
+    storage_dir_close(dir);
+    storage_file_free(dir);
+    return count;
+}
+
+typedef struct
+{
+    SubGhzToolkitReplay *replay;
+    SubGhzToolkitSignalShape shape;
+} SubGhzToolkitReplayPulses;
+
+static void subghz_toolkit_replay_file_pulse(void *context, bool level, uint32_t duration)
+{
+    SubGhzToolkitReplayPulses *pulses = context;
+    subghz_toolkit_replay_feed(pulses->replay, level, duration);
+    subghz_toolkit_signal_shape_add(&pulses->shape, level, duration);
+}
+
+// Replays one file into `totals`, with the timing estimate and encoding of its pulses
+static void subghz_toolkit_replay_file(
+    SubGhzToolkitApp *app,
+    Storage *storage,
+    SubGhzToolkitReplay *replay,
+    const char *path,
+    SubGhzToolkitWriter *writer,
+    SubGhzToolkitReplayTotals *totals)
+{
+    File *file = storage_file_alloc(storage);
+    subghz_toolkit_writer_printf(writer, "=== %s ===\n", path);
+    if (storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING))
+    {
+        char *buffer = malloc(SUBGHZ_TOOLKIT_REPLAY_READ_SIZE);
+        SubGhzToolkitReplayPulses *pulses = malloc(sizeof(SubGhzToolkitReplayPulses));
+        SubGhzToolkitRawParser parser;
+        size_t size;
+
+        pulses->replay = replay;
+        subghz_toolkit_signal_shape_init(&pulses->shape);
+        subghz_toolkit_replay_reset(replay);
+        subghz_toolkit_raw_parser_init(&parser);
+
+        uint32_t start_tick = furi_get_tick();
+        while (!subghz_toolkit_worker_is_cancelled(app->worker) &&
+               (size = storage_file_read(file, buffer, SUBGHZ_TOOLKIT_REPLAY_READ_SIZE)) > 0)
+            subghz_toolkit_raw_parser_feed(&parser, buffer, size, subghz_toolkit_replay_file_pulse, pulses);
+        subghz_toolkit_raw_parser_finish(&parser, subghz_toolkit_replay_file_pulse, pulses);
+        uint32_t elapsed_ms = furi_get_tick() - start_tick;
+
+        const SubGhzToolkitReplayStats *stats = subghz_toolkit_replay_get_stats(replay);
+        if (!stats->pulses)
+            subghz_toolkit_writer_cstr(writer, "  no RAW_Data, not a RAW capture\n");
+        else if (!stats->decodes)
+            subghz_toolkit_writer_cstr(writer, "  no decodes\n");
+        subghz_toolkit_writer_cstr(writer, "\n");
+        subghz_toolkit_replay_write_summary(writer, replay, elapsed_ms);
+        if (stats->pulses)
         {
-            const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
-            if (!protocol || !protocol->name)
+            SubGhzToolkitClustersEstimate estimate;
+            subghz_toolkit_signal_shape_write_report(writer, &pulses->shape, &estimate);
+        }
+
+        totals->files++;
+        totals->pulses += stats->pulses;
+        totals->decodes += stats->decodes;
+        totals->elapsed_ms += elapsed_ms;
+        free(pulses);
+        free(buffer);
+    }
+    else
+    {
+        subghz_toolkit_writer_cstr(writer, "  failed to open\n");
+    }
+    subghz_toolkit_writer_cstr(writer, "\n");
+
+    storage_file_close(file);
+    storage_file_free(file);
+}
+
+static bool subghz_toolkit_replay_run(SubGhzToolkitApp *app, bool profile)
+{
+    const char *report_path = profile ? SUBGHZ_PROFILE_REPORT_PATH : SUBGHZ_REPLAY_REPORT_PATH;
+    bool success = false;
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    Stream *stream = file_stream_alloc(storage);
+
+    do
+    {
+        storage_simply_mkdir(storage, EXT_PATH("subghz"));
+        storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+        storage_simply_mkdir(storage, SUBGHZ_REPLAY_DIR);
+
+        if (!file_stream_open(stream, report_path, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+        {
+            break;
+        }
+
+        SubGhzToolkitWriter *writer = subghz_toolkit_writer_alloc(subghz_toolkit_stream_flush, stream);
+        SubGhzToolkitReplayDecodes decodes = {
+            .replay = subghz_toolkit_replay_alloc(subghz_protocol_registry_count(app->protocol_registry), profile ? NULL : writer),
+            .text = furi_string_alloc(),
+        };
+        subghz_toolkit_replay_add_registry(app, &decodes);
+
+        SubGhzToolkitProfile *feed_profile = NULL;
+        if (profile)
+        {
+            feed_profile = subghz_toolkit_profile_alloc(subghz_toolkit_replay_decoder_count(decodes.replay));
+            subghz_toolkit_replay_set_profile(decodes.replay, feed_profile);
+        }
+
+        subghz_toolkit_writer_printf(writer,
+                                     "==============================================================\n"
+                                     "        SubGhz %s\n"
+                                     "                  Generated by SubGhz Toolkit\n"
+                                     "                 RocketGod | betaskynet.com\n"
+                                     "==============================================================\n\n",
+                                     profile ? "Decoder Profile" : "RAW Replay");
+        subghz_toolkit_writer_printf(writer, "Decoders: %zu, every pulse goes to each of them\n\n",
+                                     subghz_toolkit_replay_decoder_count(decodes.replay));
+
+        SubGhzToolkitReplayTotals totals = {0};
+        size_t file_count = subghz_toolkit_replay_count_files(storage);
+
+        if (file_count)
+        {
+            File *dir = storage_file_alloc(storage);
+            FuriString *path = furi_string_alloc();
+            FileInfo info;
+            char name[64];
+
+            if (storage_dir_open(dir, SUBGHZ_REPLAY_DIR))
+            {
+                while (storage_dir_read(dir, &info, name, sizeof(name)) && !subghz_toolkit_worker_is_cancelled(app->worker))
+                {
+                    if (!subghz_toolkit_replay_is_sub_file(&info, name))
+                        continue;
+
+                    subghz_toolkit_worker_report(app->worker, totals.files, file_count, name);
+                    furi_string_printf(path, SUBGHZ_REPLAY_DIR "/%s", name);
+                    subghz_toolkit_replay_file(app, storage, decodes.replay, furi_string_get_cstr(path), writer, &totals);
+                }
+            }
+            storage_dir_close(dir);
+            storage_file_free(dir);
+            furi_string_free(path);
+        }
+        else
+        {
+            subghz_toolkit_writer_cstr(writer, "No .sub files in " SUBGHZ_REPLAY_DIR "/, replaying the last capture\n\n");
+            subghz_toolkit_worker_report(app->worker, 0, 1, "signal_capture.sub");
+            subghz_toolkit_replay_file(app, storage, decodes.replay, SUBGHZ_CAPTURE_PATH, writer, &totals);
+        }
+
+        subghz_toolkit_writer_printf(writer,
+                                     "=== TOTAL ===\n"
+                                     "Files:    %zu\n"
+                                     "Pulses:   %lu\n"
+                                     "Decodes:  %lu\n"
+                                     "Rate:     %lu pulses/s\n\n",
+                                     totals.files,
+                                     totals.pulses,
+                                     totals.decodes,
+                                     totals.elapsed_ms ? (uint32_t)((uint64_t)totals.pulses * 1000 / totals.elapsed_ms) : 0);
+        subghz_toolkit_replay_write_decoder_counts(writer, decodes.replay);
+        if (feed_profile)
+        {
+            subghz_toolkit_writer_cstr(writer, "\n=== BY CPU SHARE ===\n");
+            subghz_toolkit_profile_write_report(writer, feed_profile, SubGhzToolkitProfileSortShare, totals.pulses);
+            subghz_toolkit_writer_cstr(writer, "\n=== BY P99 ===\n");
+            subghz_toolkit_profile_write_report(writer, feed_profile, SubGhzToolkitProfileSortP99, totals.pulses);
+            subghz_toolkit_profile_free(feed_profile);
+        }
+        FURI_LOG_I(TAG, "Replay: %zu files, %lu pulses, %lu decodes in %lu ms",
+                   totals.files, totals.pulses, totals.decodes, totals.elapsed_ms);
+
+        subghz_toolkit_writer_flush(writer);
+        success = totals.files && !subghz_toolkit_writer_get_stats(writer)->error;
+        subghz_toolkit_writer_free(writer);
+        subghz_toolkit_replay_free(decodes.replay);
+        furi_string_free(decodes.text);
+
+        furi_string_printf(app->result_text, "%zu files, %lu decodes\n%s", totals.files, totals.decodes, report_path);
+    } while (0);
+
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+
+    return success;
+}
+
+static bool subghz_toolkit_replay_captures_run(SubGhzToolkitApp *app)
+{
+    return subghz_toolkit_replay_run(app, false);
+}
+
+static bool subghz_toolkit_profile_decoders_run(SubGhzToolkitApp *app)
+{
+    return subghz_toolkit_replay_run(app, true);
+}
+
+static void subghz_toolkit_replay_captures(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitJob job = {
+        .title = "Replay RAW Captures",
+        .run = subghz_toolkit_replay_captures_run,
+        .success_text = "Replay report exported to:\n/ext/subghz/analysis/replay_report.txt",
+        .error_text = "No RAW captures to replay",
+    };
+    subghz_toolkit_start_job(app, &job);
+}
+
+static void subghz_toolkit_profile_decoders(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitJob job = {
+        .title = "Profile Decoders",
+        .run = subghz_toolkit_profile_decoders_run,
+        .success_text = "Decoder profile exported to:\n/ext/subghz/analysis/decoder_profile.txt",
+        .error_text = "No RAW captures to replay",
+    };
+    subghz_toolkit_start_job(app, &job);
+}
+
+// Firmware comparison. Every run saves a snapshot of the running firmware
+// (see helpers/subghz_toolkit_snapshot.h) named after its git hash, then diffs
+// each other snapshot in the folder against it. Snapshots made by
+// tools/firmware_analyzer.c or on another Flipper can be copied in as well.
+
+static SubGhzToolkitSnapshot *subghz_toolkit_build_snapshot(SubGhzToolkitApp *app)
+{
+    const Version *ver = furi_hal_version_get_firmware_version();
+    SubGhzToolkitSnapshot *snapshot = subghz_toolkit_snapshot_alloc(version_get_githash(ver));
+    SubGhzToolkitFunctionCache *cache = subghz_toolkit_get_function_cache(app);
+    size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
+    size_t functions = 0;
+    uint32_t start_tick = furi_get_tick();
+
+    for (size_t i = 0; i < protocol_count; i++)
+    {
+        if (subghz_toolkit_worker_is_cancelled(app->worker))
+        {
+            subghz_toolkit_snapshot_free(snapshot);
+            return NULL;
+        }
+
+        const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
+        if (!protocol || !protocol->name)
+            continue;
+
+        uint32_t pointers[SubGhzToolkitFunctionSlotCount];
+        subghz_toolkit_protocol_functions(protocol, pointers);
+        functions += subghz_toolkit_snapshot_add_protocol(
+            snapshot, protocol->name, protocol->type, protocol->flag, pointers, cache, subghz_toolkit_memory_code_at, &app->flash, (uint16_t)i);
+
+        subghz_toolkit_worker_report(app->worker, i + 1, protocol_count, protocol->name);
+    }
+
+    FURI_LOG_I(TAG, "Snapshot: %zu protocols, %zu functions hashed in %lu ms",
+               subghz_toolkit_snapshot_protocol_count(snapshot), functions, furi_get_tick() - start_tick);
+    return snapshot;
+}
+
+static SubGhzToolkitSnapshot *subghz_toolkit_load_snapshot(Storage *storage, const char *path)
+{
+    SubGhzToolkitSnapshot *snapshot = NULL;
+    File *file = storage_file_alloc(storage);
+
+    if (storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING))
+    {
+        size_t size = storage_file_size(file);
+        uint8_t *data = malloc(size ? size : 1);
+
+        if (storage_file_read(file, data, size) == size)
+            snapshot = subghz_toolkit_snapshot_load(data, size);
+        free(data);
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    if (!snapshot)
+        FURI_LOG_W(TAG, "Ignoring invalid snapshot %s", path);
+    return snapshot;
+}
+
+static bool subghz_toolkit_save_snapshot(Storage *storage, const SubGhzToolkitSnapshot *snapshot, const char *path)
+{
+    bool success = false;
+    Stream *stream = file_stream_alloc(storage);
+
+    if (file_stream_open(stream, path, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+    {
+        SubGhzToolkitWriter *writer = subghz_toolkit_writer_alloc(subghz_toolkit_stream_flush, stream);
+        subghz_toolkit_snapshot_save(snapshot, writer);
+        subghz_toolkit_writer_flush(writer);
+        success = !subghz_toolkit_writer_get_stats(writer)->error;
+        subghz_toolkit_writer_free(writer);
+    }
+
+    stream_free(stream);
+    return success;
+}
+
+// Diff every other snapshot in SUBGHZ_SNAPSHOT_DIR against `current`, returns how many
+static size_t subghz_toolkit_diff_snapshots(Storage *storage, const SubGhzToolkitSnapshot *current, SubGhzToolkitWriter *writer)
+{
+    size_t compared = 0;
+    File *dir = storage_file_alloc(storage);
+    FuriString *path = furi_string_alloc();
+    FileInfo info;
+    char name[64];
+
+    if (storage_dir_open(dir, SUBGHZ_SNAPSHOT_DIR))
+    {
+        while (storage_dir_read(dir, &info, name, sizeof(name)))
+        {
+            size_t length = strlen(name);
+            if (file_info_is_dir(&info) || length < 5 || strcmp(name + length - 5, ".snap") != 0)
                 continue;
 
-            stream_write_format(stream, "\n████████████████████████████████████████████████████████████\n");
-            stream_write_format(stream, "Protocol: %s - State Analysis\n", protocol->name);
-            stream_write_format(stream, "████████████████████████████████████████████████████████████\n");
+            furi_string_printf(path, SUBGHZ_SNAPSHOT_DIR "/%s", name);
+            SubGhzToolkitSnapshot *old = subghz_toolkit_load_snapshot(storage, furi_string_get_cstr(path));
+            if (!old)
+                continue;
+
+            if (strcmp(subghz_toolkit_snapshot_githash(old), subghz_toolkit_snapshot_githash(current)) != 0)
+            {
+                SubGhzToolkitSnapshotDiff diff;
+                subghz_toolkit_writer_printf(writer, "=== %s ===\n", name);
+                subghz_toolkit_snapshot_diff(old, current, writer, &diff);
+                subghz_toolkit_writer_cstr(writer, "\n");
+                compared++;
+            }
+            subghz_toolkit_snapshot_free(old);
+        }
+    }
+
+    storage_dir_close(dir);
+    storage_file_free(dir);
+    furi_string_free(path);
+    return compared;
+}
+
+static bool subghz_toolkit_compare_firmware_run(SubGhzToolkitApp *app)
+{
+    SubGhzToolkitSnapshot *current = subghz_toolkit_build_snapshot(app);
+    if (!current)
+        return false;
+
+    bool success = false;
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    Stream *stream = file_stream_alloc(storage);
+    FuriString *path = furi_string_alloc();
+
+    do
+    {
+        storage_simply_mkdir(storage, EXT_PATH("subghz"));
+        storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+        storage_simply_mkdir(storage, SUBGHZ_SNAPSHOT_DIR);
 
-            subghz_toolkit_analyze_protocol_state(stream, protocol, app->environment);
-            stream_write_format(stream, "\n");
+        const char *githash = subghz_toolkit_snapshot_githash(current);
+        furi_string_printf(path, SUBGHZ_SNAPSHOT_DIR "/%s.snap", githash[0] ? githash : "unknown");
+        if (!subghz_toolkit_save_snapshot(storage, current, furi_string_get_cstr(path)))
+        {
+            FURI_LOG_E(TAG, "Failed to save %s", furi_string_get_cstr(path));
+            break;
+        }
+
+        if (!file_stream_open(stream, SUBGHZ_FIRMWARE_DIFF_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+        {
+            break;
         }
 
-        success = true;
+        SubGhzToolkitWriter *writer = subghz_toolkit_writer_alloc(subghz_toolkit_stream_flush, stream);
+
+        subghz_toolkit_writer_cstr(writer,
+                                   "==============================================================\n"
+                                   "        SubGhz Firmware Comparison\n"
+                                   "                  Generated by SubGhz Toolkit\n"
+                                   "                 RocketGod | betaskynet.com\n"
+                                   "==============================================================\n\n");
+        subghz_toolkit_writer_printf(writer, "Running firmware: %s, %zu protocols\n\n",
+                                     githash, subghz_toolkit_snapshot_protocol_count(current));
+
+        size_t compared = subghz_toolkit_diff_snapshots(storage, current, writer);
+        if (!compared)
+            subghz_toolkit_writer_cstr(writer,
+                                       "No snapshots of other firmware yet. Run this again after\n"
+                                       "flashing another build, or copy .snap files to\n"
+                                       "/ext/subghz/analysis/snapshots/.\n");
+
+        subghz_toolkit_writer_flush(writer);
+        success = !subghz_toolkit_writer_get_stats(writer)->error;
+        subghz_toolkit_writer_free(writer);
+
+        furi_string_printf(app->result_text, "Compared with %zu snapshots:\n/ext/subghz/analysis/firmware_diff.txt", compared);
     } while (0);
 
+    furi_string_free(path);
     stream_free(stream);
     furi_record_close(RECORD_STORAGE);
+    subghz_toolkit_snapshot_free(current);
 
-    if (success)
+    return success;
+}
+
+static void subghz_toolkit_compare_firmware(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitJob job = {
+        .title = "Compare Firmware",
+        .run = subghz_toolkit_compare_firmware_run,
+        .success_text = "Firmware diff exported to:\n/ext/subghz/analysis/firmware_diff.txt",
+        .error_text = "Failed to compare firmware",
+    };
+    subghz_toolkit_start_job(app, &job);
+}
+
+// Timing constants per protocol, collected for the summary table
+
+typedef struct
+{
+    uint16_t index;
+    bool found;
+    SubGhzToolkitTimingConst timing;
+} SubGhzToolkitTimingRow;
+
+typedef struct
+{
+    SubGhzToolkitTimingRow *rows;
+    size_t row_count;
+    size_t functions;
+    uint32_t insn_count;
+    uint32_t elapsed_ms;
+} SubGhzToolkitTimingState;
+
+static void subghz_toolkit_timing_begin(SubGhzToolkitPassContext *ctx)
+{
+    SubGhzToolkitTimingState *state = ctx->state;
+    state->rows = malloc(subghz_protocol_registry_count(ctx->app->protocol_registry) * sizeof(SubGhzToolkitTimingRow));
+}
+
+static void subghz_toolkit_timing_protocol(SubGhzToolkitPassContext *ctx, size_t index, const SubGhzProtocol *protocol)
+{
+    SubGhzToolkitTimingState *state = ctx->state;
+    SubGhzToolkitWriter *writer = ctx->writer;
+
+    subghz_toolkit_writer_cstr(writer, "\n████████████████████████████████████████████████████████████\n");
+    subghz_toolkit_writer_printf(writer, "Protocol: %s - Timing Analysis\n", protocol->name);
+    subghz_toolkit_writer_cstr(writer, "████████████████████████████████████████████████████████████\n");
+
+    uint32_t functions[SubGhzToolkitFunctionSlotCount];
+    subghz_toolkit_protocol_functions(protocol, functions);
+
+    SubGhzToolkitTimingScan scan;
+    uint32_t start_tick = furi_get_tick();
+    state->functions += subghz_toolkit_protocol_scan_timing(
+        functions, subghz_toolkit_get_function_cache(ctx->app), subghz_toolkit_memory_code_at, &ctx->app->flash, (uint16_t)index, &scan);
+    state->elapsed_ms += furi_get_tick() - start_tick;
+    state->insn_count += scan.insn_count;
+
+    state->rows[state->row_count++] = (SubGhzToolkitTimingRow){
+        .index = (uint16_t)index,
+        .found = scan.found,
+        .timing = scan.block,
+    };
+
+    subghz_toolkit_protocol_write_timing(writer, protocol->name, protocol->type, &scan);
+    subghz_toolkit_writer_cstr(writer, "\n");
+}
+
+// Signal shape of a RAW file's pulses, false if it could not be read
+static bool subghz_toolkit_estimate_file_timing(const char *path, SubGhzToolkitSignalShape *shape)
+{
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *file = storage_file_alloc(storage);
+    bool opened = storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING);
+
+    subghz_toolkit_signal_shape_init(shape);
+    if (opened)
     {
-        popup_set_header(app->popup, "Success!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Protocol state analysis exported to:\n/ext/subghz/analysis/protocol_state_analysis.txt",
-                       64, 20, AlignCenter, AlignTop);
+        char *buffer = malloc(SUBGHZ_TOOLKIT_REPLAY_READ_SIZE);
+        SubGhzToolkitRawParser parser;
+        size_t size;
+
+        subghz_toolkit_raw_parser_init(&parser);
+        while ((size = storage_file_read(file, buffer, SUBGHZ_TOOLKIT_REPLAY_READ_SIZE)) > 0)
+            subghz_toolkit_raw_parser_feed(&parser, buffer, size, subghz_toolkit_signal_shape_add, shape);
+        subghz_toolkit_raw_parser_finish(&parser, subghz_toolkit_signal_shape_add, shape);
+        free(buffer);
     }
-    else
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return opened;
+}
+
+// The last capture's measured timing and encoding, and the protocols of the table it fits
+static void subghz_toolkit_timing_write_capture(SubGhzToolkitPassContext *ctx)
+{
+    SubGhzToolkitTimingState *state = ctx->state;
+    SubGhzToolkitWriter *writer = ctx->writer;
+    SubGhzToolkitSignalShape *shape = malloc(sizeof(SubGhzToolkitSignalShape));
+    SubGhzToolkitClustersEstimate estimate;
+
+    subghz_toolkit_writer_cstr(writer, "\n=== LAST CAPTURE (" SUBGHZ_CAPTURE_PATH ") ===\n");
+    if (!subghz_toolkit_estimate_file_timing(SUBGHZ_CAPTURE_PATH, shape))
+    {
+        subghz_toolkit_writer_cstr(writer, "No capture yet, run Signal Capture Analysis first\n");
+        free(shape);
+        return;
+    }
+
+    bool estimated = subghz_toolkit_signal_shape_write_report(writer, shape, &estimate);
+    if (estimated)
+    {
+        size_t matches = 0;
+        subghz_toolkit_writer_cstr(writer, "Protocols within te_delta of te_short/te_long:\n");
+        for (size_t i = 0; i < state->row_count; i++)
+        {
+            const SubGhzToolkitTimingRow *row = &state->rows[i];
+            uint32_t delta = row->timing.te_delta;
+            if (!row->found ||
+                (uint32_t)abs((int32_t)row->timing.te_short - (int32_t)estimate.te_short) > delta ||
+                (estimate.te_long && (uint32_t)abs((int32_t)row->timing.te_long - (int32_t)estimate.te_long) > delta))
+                continue;
+
+            const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(ctx->app->protocol_registry, row->index);
+            subghz_toolkit_writer_printf(writer, "  %s (%u/%u +-%u us)\n",
+                                         protocol->name, row->timing.te_short, row->timing.te_long, row->timing.te_delta);
+            matches++;
+        }
+        if (!matches)
+            subghz_toolkit_writer_cstr(writer, "  none\n");
+    }
+    free(shape);
+}
+
+static void subghz_toolkit_timing_end(SubGhzToolkitPassContext *ctx)
+{
+    SubGhzToolkitTimingState *state = ctx->state;
+    SubGhzToolkitWriter *writer = ctx->writer;
+
+    subghz_toolkit_writer_cstr(writer, "\n=== TIMING TABLE ===\nname,te_short,te_long,te_delta,min_count_bit\n");
+    size_t found = 0;
+    for (size_t i = 0; i < state->row_count; i++)
+    {
+        const SubGhzToolkitTimingRow *row = &state->rows[i];
+        const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(ctx->app->protocol_registry, row->index);
+        if (!row->found)
+        {
+            subghz_toolkit_writer_printf(writer, "%s,,,,\n", protocol->name);
+            continue;
+        }
+        subghz_toolkit_writer_printf(writer, "%s,%u,%u,%u,%u\n",
+                                     protocol->name,
+                                     row->timing.te_short,
+                                     row->timing.te_long,
+                                     row->timing.te_delta,
+                                     row->timing.min_count_bit);
+        found++;
+    }
+
+    subghz_toolkit_writer_printf(writer,
+                                 "\nTiming blocks found: %zu of %zu protocols\n"
+                                 "Scanned %zu functions (%lu instructions) in %lu ms\n",
+                                 found,
+                                 state->row_count,
+                                 state->functions,
+                                 state->insn_count,
+                                 state->elapsed_ms);
+    FURI_LOG_I(TAG, "Timing scan: %zu blocks, %zu functions in %lu ms", found, state->functions, state->elapsed_ms);
+    subghz_toolkit_timing_write_capture(ctx);
+
+    free(state->rows);
+    state->rows = NULL;
+}
+
+static void subghz_toolkit_c_header_protocol(SubGhzToolkitPassContext *ctx, size_t index, const SubGhzProtocol *protocol)
+{
+    UNUSED(index);
+    subghz_toolkit_protocol_write_c_header(ctx->writer, protocol->name, protocol->type, protocol->flag);
+    subghz_toolkit_writer_cstr(ctx->writer, "\n");
+}
+
+// Analysis passes. Each one owns its output file and is fed every protocol by the pipeline.
+
+static const SubGhzToolkitAnalysisPass subghz_toolkit_pass_protocol_info = {
+    .file_name = SUBGHZ_ANALYSIS_DIR "/protocol_analysis.txt",
+    .banner = "==============================================\n"
+              "     SubGhz Protocol Implementation Analysis\n"
+              "           Generated by SubGhz Toolkit\n"
+              "           RocketGod | betaskynet.com\n"
+              "==============================================\n\n",
+    .success_text = "Protocol info exported to:\n/ext/subghz/analysis/protocol_analysis.txt",
+    .error_text = "Failed to export protocol info",
+    .begin = subghz_toolkit_protocol_info_begin,
+    .protocol = subghz_toolkit_protocol_info_protocol,
+};
+
+static const SubGhzToolkitAnalysisPass subghz_toolkit_pass_advanced = {
+    .file_name = SUBGHZ_ANALYSIS_DIR "/advanced_analysis.txt",
+    .banner = "==============================================================\n"
+              "        SubGhz Protocol ADVANCED Implementation Analysis\n"
+              "                  Generated by SubGhz Toolkit\n"
+              "                 RocketGod | betaskynet.com\n"
+              "==============================================================\n\n",
+    .success_text = "Advanced analysis exported to:\n/ext/subghz/analysis/advanced_analysis.txt",
+    .error_text = "Failed to export analysis",
+    .state_size = sizeof(SubGhzToolkitAdvancedState),
+    .begin = subghz_toolkit_advanced_begin,
+    .protocol = subghz_toolkit_advanced_protocol,
+    .end = subghz_toolkit_advanced_end,
+};
+
+static const SubGhzToolkitAnalysisPass subghz_toolkit_pass_disassembly = {
+    .file_name = SUBGHZ_ANALYSIS_DIR "/function_disassembly.txt",
+    .banner = "==============================================================\n"
+              "        SubGhz Protocol Function Disassembly Analysis\n"
+              "                  Generated by SubGhz Toolkit\n"
+              "                 RocketGod | betaskynet.com\n"
+              "==============================================================\n\n",
+    .success_text = "Function disassembly exported to:\n/ext/subghz/analysis/function_disassembly.txt",
+    .error_text = "Failed to export disassembly",
+    .state_size = sizeof(SubGhzToolkitDisassemblyState),
+    .protocol = subghz_toolkit_disassembly_protocol,
+    .end = subghz_toolkit_disassembly_end,
+};
+
+static const SubGhzToolkitAnalysisPass subghz_toolkit_pass_call_graph = {
+    .file_name = SUBGHZ_ANALYSIS_DIR "/call_graph.dot",
+    .banner = "// ==============================================================\n"
+              "//        SubGhz Protocol Call Graph (Graphviz DOT)\n"
+              "//                  Generated by SubGhz Toolkit\n"
+              "//                 RocketGod | betaskynet.com\n"
+              "// ==============================================================\n\n",
+    .success_text = "Call graph exported to:\n/ext/subghz/analysis/call_graph.dot\nand call_graph.txt",
+    .error_text = "Failed to export call graph",
+    .state_size = sizeof(SubGhzToolkitCallGraphState),
+    .begin = subghz_toolkit_call_graph_begin,
+    .protocol = subghz_toolkit_call_graph_protocol,
+    .end = subghz_toolkit_call_graph_end,
+};
+
+static const SubGhzToolkitAnalysisPass subghz_toolkit_pass_state = {
+    .file_name = SUBGHZ_ANALYSIS_DIR "/protocol_state_analysis.txt",
+    .banner = "==============================================================\n"
+              "        SubGhz Protocol State Analysis\n"
+              "                  Generated by SubGhz Toolkit\n"
+              "                 RocketGod | betaskynet.com\n"
+              "==============================================================\n\n",
+    .success_text = "Protocol state analysis exported to:\n/ext/subghz/analysis/protocol_state_analysis.txt",
+    .error_text = "Failed to export state analysis",
+    .state_size = sizeof(SubGhzToolkitStatePulses),
+    // Not `sections`: heap cost and instance contents are measured on the running
+    // firmware, and a protocol whose code did not change still moves in flash
+    .begin = subghz_toolkit_state_begin,
+    .protocol = subghz_toolkit_state_protocol,
+    .end = subghz_toolkit_state_end,
+};
+
+static const SubGhzToolkitAnalysisPass subghz_toolkit_pass_timing = {
+    .file_name = SUBGHZ_ANALYSIS_DIR "/timing_analysis.txt",
+    .banner = "==============================================================\n"
+              "        SubGhz Protocol Timing Analysis\n"
+              "                  Generated by SubGhz Toolkit\n"
+              "                 RocketGod | betaskynet.com\n"
+              "==============================================================\n\n",
+    .success_text = "Timing analysis exported to:\n/ext/subghz/analysis/timing_analysis.txt",
+    .error_text = "Failed to export timing analysis",
+    .state_size = sizeof(SubGhzToolkitTimingState),
+    .begin = subghz_toolkit_timing_begin,
+    .protocol = subghz_toolkit_timing_protocol,
+    .end = subghz_toolkit_timing_end,
+};
+
+static const SubGhzToolkitAnalysisPass subghz_toolkit_pass_c_headers = {
+    .file_name = SUBGHZ_ANALYSIS_DIR "/protocol_headers.h",
+    .banner = "// ==============================================================\n"
+              "//        SubGhz Protocol C Headers for Implementation\n"
+              "//                  Generated by SubGhz Toolkit\n"
+              "//                 RocketGod | betaskynet.com\n"
+              "// ==============================================================\n\n",
+    .success_text = "C headers generated to:\n/ext/subghz/analysis/protocol_headers.h",
+    .error_text = "Failed to generate C headers",
+    .sections = true,
+    .protocol = subghz_toolkit_c_header_protocol,
+};
+
+static const SubGhzToolkitAnalysisPass *const subghz_toolkit_all_passes[] = {
+    &subghz_toolkit_pass_protocol_info,
+    &subghz_toolkit_pass_advanced,
+    &subghz_toolkit_pass_disassembly,
+    &subghz_toolkit_pass_call_graph,
+    &subghz_toolkit_pass_state,
+    &subghz_toolkit_pass_timing,
+    &subghz_toolkit_pass_c_headers,
+};
+
+// Build manifest, see helpers/subghz_toolkit_manifest.h. Running again on the
+// same firmware skips the pipeline while its files are still on the SD card.
+// After a firmware update, passes marked `sections` copy the output of every
+// protocol whose code did not change from the previous file.
+
+static SubGhzToolkitManifest *subghz_toolkit_load_manifest(Storage *storage)
+{
+    SubGhzToolkitManifest *manifest = NULL;
+    File *file = storage_file_alloc(storage);
+
+    if (storage_file_open(file, SUBGHZ_MANIFEST_PATH, FSAM_READ, FSOM_OPEN_EXISTING))
+    {
+        size_t size = storage_file_size(file);
+        uint8_t *data = malloc(size ? size : 1);
+
+        if (storage_file_read(file, data, size) == size)
+            manifest = subghz_toolkit_manifest_load(data, size);
+        if (!manifest)
+            FURI_LOG_W(TAG, "Ignoring invalid manifest");
+        free(data);
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return manifest;
+}
+
+static bool subghz_toolkit_save_manifest(Storage *storage, const SubGhzToolkitManifest *manifest)
+{
+    bool success = false;
+    Stream *stream = file_stream_alloc(storage);
+
+    if (file_stream_open(stream, SUBGHZ_MANIFEST_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS))
     {
-        popup_set_header(app->popup, "Error!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Failed to export state analysis", 64, 20, AlignCenter, AlignTop);
+        SubGhzToolkitWriter *writer = subghz_toolkit_writer_alloc(subghz_toolkit_stream_flush, stream);
+        subghz_toolkit_manifest_save(manifest, writer);
+        subghz_toolkit_writer_flush(writer);
+        success = !subghz_toolkit_writer_get_stats(writer)->error;
+        subghz_toolkit_writer_free(writer);
     }
 
-    popup_set_callback(app->popup, subghz_toolkit_popup_callback);
-    popup_set_context(app->popup, app);
-    popup_set_timeout(app->popup, 3000);
-    popup_enable_timeout(app->popup);
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewPopup);
+    stream_free(stream);
+    return success;
 }
 
-static void subghz_toolkit_signal_capture_analysis(SubGhzToolkitApp *app)
+// Manifest of the running firmware. The protocol hashes are taken over from `old`
+// on the same build, otherwise every protocol is hashed. NULL when cancelled.
+static SubGhzToolkitManifest *subghz_toolkit_build_manifest(SubGhzToolkitApp *app, const SubGhzToolkitManifest *old)
 {
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewLoading);
+    const Version *ver = furi_hal_version_get_firmware_version();
+    SubGhzToolkitSymbols *symbols = subghz_toolkit_get_symbols(app);
+    uint32_t config = subghz_toolkit_name_hash(SUBGHZ_TOOLKIT_VERSION) ^ (symbols ? subghz_toolkit_symbols_anchor(symbols) : 0);
 
-    bool success = false;
+    // The timing pass ends with the estimate of the last capture and the state
+    // pass feeds it. Captures have a fixed length, so a new one of the same
+    // remote often has the same size: its modification time tells them apart.
     Storage *storage = furi_record_open(RECORD_STORAGE);
-    Stream *stream = file_stream_alloc(storage);
+    FileInfo capture;
+    uint32_t capture_time = 0;
+    if (storage_common_stat(storage, SUBGHZ_CAPTURE_PATH, &capture) == FSE_OK)
+    {
+        storage_common_timestamp(storage, SUBGHZ_CAPTURE_PATH, &capture_time);
+        config = config * 2654435761u + (uint32_t)capture.size;
+        config = config * 2654435761u + capture_time;
+    }
+    furi_record_close(RECORD_STORAGE);
+    size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
+    SubGhzToolkitManifest *manifest = subghz_toolkit_manifest_alloc(
+        version_get_githash(ver), version_get_builddate(ver), config, protocol_count);
 
-    do
+    if (old && subghz_toolkit_manifest_same_build(old, manifest))
     {
-        storage_simply_mkdir(storage, EXT_PATH("subghz"));
-        storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+        subghz_toolkit_manifest_copy_hashes(manifest, old);
+        subghz_toolkit_manifest_merge_passes(manifest, old);
+        return manifest;
+    }
 
-        if (!file_stream_open(stream, SUBGHZ_ANALYSIS_DIR "/signal_capture_analysis.txt",
-                              FSAM_WRITE, FSOM_CREATE_ALWAYS))
+    SubGhzToolkitFunctionCache *cache = subghz_toolkit_get_function_cache(app);
+    uint32_t start_tick = furi_get_tick();
+
+    for (size_t i = 0; i < protocol_count; i++)
+    {
+        if (subghz_toolkit_worker_is_cancelled(app->worker))
         {
-            break;
+            subghz_toolkit_manifest_free(manifest);
+            return NULL;
         }
 
-        stream_write_format(stream,
-                            "==============================================================\n"
-                            "        SubGhz Signal Capture Analysis\n"
-                            "                  Generated by SubGhz Toolkit\n"
-                            "                 RocketGod | betaskynet.com\n"
-                            "==============================================================\n\n");
+        const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
+        if (!protocol || !protocol->name)
+            continue;
+
+        uint32_t pointers[SubGhzToolkitFunctionSlotCount];
+        subghz_toolkit_protocol_functions(protocol, pointers);
+        subghz_toolkit_manifest_set_hash(
+            manifest,
+            i,
+            subghz_toolkit_snapshot_hash_protocol(
+                protocol->name, protocol->type, protocol->flag, pointers, cache, subghz_toolkit_memory_code_at, &app->flash, (uint16_t)i));
+
+        subghz_toolkit_worker_report(app->worker, i + 1, protocol_count, protocol->name);
+    }
 
-        subghz_toolkit_capture_signal_samples(stream, app->receiver);
+    FURI_LOG_I(TAG, "Manifest: %zu protocols hashed in %lu ms", protocol_count, furi_get_tick() - start_tick);
+    return manifest;
+}
 
-        success = true;
-    } while (0);
+// The output of `file` recorded in `old`, if the file on the SD card is still that one
+static const SubGhzToolkitManifestPass *subghz_toolkit_manifest_output(Storage *storage, const SubGhzToolkitManifest *old, const char *file)
+{
+    const SubGhzToolkitManifestPass *entry = old ? subghz_toolkit_manifest_find_pass(old, file) : NULL;
+    FileInfo info;
 
-    stream_free(stream);
-    furi_record_close(RECORD_STORAGE);
+    if (!entry || storage_common_stat(storage, file, &info) != FSE_OK || info.size != entry->size)
+        return NULL;
+    return entry;
+}
 
-    if (success)
+static bool subghz_toolkit_copy_section(Stream *from, uint32_t start, uint32_t end, SubGhzToolkitWriter *writer)
+{
+    uint8_t buffer[256];
+
+    if (!stream_seek(from, start, StreamOffsetFromStart))
+        return false;
+
+    while (start < end)
     {
-        popup_set_header(app->popup, "Success!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Signal capture analysis exported to:\n/ext/subghz/analysis/signal_capture_analysis.txt",
-                       64, 20, AlignCenter, AlignTop);
+        size_t chunk = MIN(end - start, sizeof(buffer));
+        if (stream_read(from, buffer, chunk) != chunk)
+            return false;
+        subghz_toolkit_writer_write(writer, buffer, chunk);
+        start += chunk;
     }
-    else
+    return true;
+}
+
+typedef struct
+{
+    Stream *stream;
+    Stream *previous; // last run's output, when its sections can be reused
+    const SubGhzToolkitManifestPass *previous_entry;
+    SubGhzToolkitManifestPass *entry;
+    FuriString *temp_path; // written instead of file_name while `previous` is read
+} SubGhzToolkitPassOutput;
+
+// Opens storage once, walks the registry once and hands every protocol to each pass
+static bool subghz_toolkit_run_pipeline(SubGhzToolkitApp *app, const SubGhzToolkitAnalysisPass *const *passes, size_t pass_count)
+{
+    bool success = true;
+    uint32_t start_tick = furi_get_tick();
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+
+    storage_simply_mkdir(storage, EXT_PATH("subghz"));
+    storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+
+    SubGhzToolkitManifest *old = subghz_toolkit_load_manifest(storage);
+    SubGhzToolkitManifest *manifest = subghz_toolkit_build_manifest(app, old);
+    if (!manifest)
     {
-        popup_set_header(app->popup, "Error!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Failed to export signal analysis", 64, 20, AlignCenter, AlignTop);
+        if (old)
+            subghz_toolkit_manifest_free(old);
+        furi_record_close(RECORD_STORAGE);
+        return false;
     }
 
-    popup_set_callback(app->popup, subghz_toolkit_popup_callback);
-    popup_set_context(app->popup, app);
-    popup_set_timeout(app->popup, 3000);
-    popup_enable_timeout(app->popup);
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewPopup);
-}
+    bool same_build = old && subghz_toolkit_manifest_same_build(old, manifest);
+    bool current = same_build;
+    for (size_t p = 0; p < pass_count && current; p++)
+        current = subghz_toolkit_manifest_output(storage, old, passes[p]->file_name) != NULL;
 
-static void subghz_toolkit_timing_analysis(SubGhzToolkitApp *app)
-{
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewLoading);
+    if (current)
+    {
+        FURI_LOG_I(TAG, "Pipeline: firmware unchanged, %zu files up to date", pass_count);
+        furi_string_printf(app->result_text, "Firmware unchanged,\n%zu files already up to date\nin /ext/subghz/analysis", pass_count);
+        subghz_toolkit_manifest_free(manifest);
+        subghz_toolkit_manifest_free(old);
+        furi_record_close(RECORD_STORAGE);
+        return true;
+    }
 
-    bool success = false;
-    Storage *storage = furi_record_open(RECORD_STORAGE);
-    Stream *stream = file_stream_alloc(storage);
+    bool reusable = old && !same_build && subghz_toolkit_manifest_config(old) == subghz_toolkit_manifest_config(manifest);
+    SubGhzToolkitPassContext *contexts = malloc(sizeof(SubGhzToolkitPassContext) * pass_count);
+    SubGhzToolkitPassOutput *outputs = malloc(sizeof(SubGhzToolkitPassOutput) * pass_count);
+    memset(outputs, 0, sizeof(SubGhzToolkitPassOutput) * pass_count);
 
-    do
+    for (size_t p = 0; p < pass_count; p++)
     {
-        storage_simply_mkdir(storage, EXT_PATH("subghz"));
-        storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+        SubGhzToolkitPassOutput *output = &outputs[p];
+        const char *file_name = passes[p]->file_name;
+
+        output->stream = file_stream_alloc(storage);
+        output->entry = subghz_toolkit_manifest_add_pass(manifest, file_name);
+        contexts[p].app = app;
+        contexts[p].writer = subghz_toolkit_writer_alloc(subghz_toolkit_stream_flush, output->stream);
+        contexts[p].state = NULL;
+        if (passes[p]->state_size)
+        {
+            contexts[p].state = malloc(passes[p]->state_size);
+            memset(contexts[p].state, 0, passes[p]->state_size);
+        }
 
-        if (!file_stream_open(stream, SUBGHZ_ANALYSIS_DIR "/timing_analysis.txt",
-                              FSAM_WRITE, FSOM_CREATE_ALWAYS))
+        if (reusable && passes[p]->sections)
+            output->previous_entry = subghz_toolkit_manifest_output(storage, old, file_name);
+        if (output->previous_entry)
         {
-            break;
+            output->previous = file_stream_alloc(storage);
+            output->temp_path = furi_string_alloc_printf("%s.tmp", file_name);
+            if (!file_stream_open(output->previous, file_name, FSAM_READ, FSOM_OPEN_EXISTING))
+            {
+                stream_free(output->previous);
+                output->previous = NULL;
+                output->previous_entry = NULL;
+            }
+            else
+            {
+                file_name = furi_string_get_cstr(output->temp_path);
+            }
+        }
+
+        if (!output->entry || !file_stream_open(output->stream, file_name, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+        {
+            FURI_LOG_E(TAG, "Failed to open %s", file_name);
+            success = false;
         }
+    }
+
+    uint32_t reused = 0;
+    uint32_t regenerated = 0;
 
-        stream_write_format(stream,
-                            "==============================================================\n"
-                            "        SubGhz Protocol Timing Analysis\n"
-                            "                  Generated by SubGhz Toolkit\n"
-                            "                 RocketGod | betaskynet.com\n"
-                            "==============================================================\n\n");
+    if (success)
+    {
+        for (size_t p = 0; p < pass_count; p++)
+        {
+            subghz_toolkit_writer_cstr(contexts[p].writer, passes[p]->banner);
+            if (passes[p]->begin)
+                passes[p]->begin(&contexts[p]);
+        }
 
         size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
 
         for (size_t i = 0; i < protocol_count; i++)
         {
+            if (subghz_toolkit_worker_is_cancelled(app->worker))
+            {
+                success = false;
+                break;
+            }
+
+            for (size_t p = 0; p < pass_count; p++)
+                outputs[p].entry->sections[i] = (uint32_t)subghz_toolkit_writer_get_stats(contexts[p].writer)->bytes;
+
             const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
             if (!protocol || !protocol->name)
                 continue;
 
-            stream_write_format(stream, "\n████████████████████████████████████████████████████████████\n");
-            stream_write_format(stream, "Protocol: %s - Timing Analysis\n", protocol->name);
-            stream_write_format(stream, "████████████████████████████████████████████████████████████\n");
+            uint32_t hash = subghz_toolkit_manifest_hash(manifest, i);
+            for (size_t p = 0; p < pass_count; p++)
+            {
+                uint32_t previous;
+                if (outputs[p].previous && subghz_toolkit_manifest_find_hash(old, hash, &previous))
+                {
+                    const uint32_t *sections = outputs[p].previous_entry->sections;
+                    if (!subghz_toolkit_copy_section(outputs[p].previous, sections[previous], sections[previous + 1], contexts[p].writer))
+                    {
+                        FURI_LOG_E(TAG, "Failed to copy %s from %s", protocol->name, passes[p]->file_name);
+                        success = false;
+                    }
+                    reused++;
+                }
+                else if (passes[p]->protocol)
+                {
+                    passes[p]->protocol(&contexts[p], i, protocol);
+                    regenerated++;
+                }
+            }
 
-            subghz_toolkit_analyze_timing_patterns(stream, protocol);
-            stream_write_format(stream, "\n");
+            subghz_toolkit_worker_report(app->worker, i + 1, protocol_count, protocol->name);
         }
 
-        success = true;
-    } while (0);
+        for (size_t p = 0; p < pass_count; p++)
+        {
+            outputs[p].entry->sections[protocol_count] = (uint32_t)subghz_toolkit_writer_get_stats(contexts[p].writer)->bytes;
+            if (passes[p]->end)
+                passes[p]->end(&contexts[p]);
+        }
+    }
 
-    stream_free(stream);
-    furi_record_close(RECORD_STORAGE);
+    uint64_t total_bytes = 0;
+    uint32_t total_flushes = 0;
 
-    if (success)
+    for (size_t p = 0; p < pass_count; p++)
     {
-        popup_set_header(app->popup, "Success!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Timing analysis exported to:\n/ext/subghz/analysis/timing_analysis.txt",
-                       64, 20, AlignCenter, AlignTop);
+        SubGhzToolkitPassOutput *output = &outputs[p];
+
+        subghz_toolkit_writer_flush(contexts[p].writer);
+        const SubGhzToolkitWriterStats *stats = subghz_toolkit_writer_get_stats(contexts[p].writer);
+        total_bytes += stats->bytes;
+        total_flushes += stats->flushes;
+        if (stats->error)
+            success = false;
+        if (output->entry)
+            output->entry->size = (uint32_t)stats->bytes;
+
+        subghz_toolkit_writer_free(contexts[p].writer);
+        stream_free(output->stream);
+        if (output->previous)
+            stream_free(output->previous);
+        free(contexts[p].state);
     }
-    else
+
+    // Temporary files replace the outputs they were copied from only once everything was written
+    for (size_t p = 0; p < pass_count; p++)
     {
-        popup_set_header(app->popup, "Error!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Failed to export timing analysis", 64, 20, AlignCenter, AlignTop);
+        SubGhzToolkitPassOutput *output = &outputs[p];
+        if (!output->temp_path)
+            continue;
+
+        const char *temp_path = furi_string_get_cstr(output->temp_path);
+        if (success && output->previous_entry)
+        {
+            storage_common_remove(storage, passes[p]->file_name);
+            if (storage_common_rename(storage, temp_path, passes[p]->file_name) != FSE_OK)
+            {
+                FURI_LOG_E(TAG, "Failed to replace %s", passes[p]->file_name);
+                success = false;
+            }
+        }
+        else
+        {
+            storage_common_remove(storage, temp_path);
+        }
+        furi_string_free(output->temp_path);
     }
 
-    popup_set_callback(app->popup, subghz_toolkit_popup_callback);
-    popup_set_context(app->popup, app);
-    popup_set_timeout(app->popup, 3000);
-    popup_enable_timeout(app->popup);
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewPopup);
-}
+    // A failed run may have left any output half written, so nothing is trusted next time
+    if (!success || !subghz_toolkit_save_manifest(storage, manifest))
+        storage_common_remove(storage, SUBGHZ_MANIFEST_PATH);
 
-static void subghz_toolkit_generate_c_headers(SubGhzToolkitApp *app)
-{
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewLoading);
+    free(outputs);
+    free(contexts);
+    subghz_toolkit_manifest_free(manifest);
+    if (old)
+        subghz_toolkit_manifest_free(old);
+    furi_record_close(RECORD_STORAGE);
 
-    bool success = false;
-    Storage *storage = furi_record_open(RECORD_STORAGE);
-    Stream *stream = file_stream_alloc(storage);
+    subghz_toolkit_log_throughput("Pipeline", total_bytes, total_flushes, furi_get_tick() - start_tick);
+    if (reused)
+        FURI_LOG_I(TAG, "Pipeline: %lu sections reused, %lu regenerated", reused, regenerated);
 
-    do
-    {
-        storage_simply_mkdir(storage, EXT_PATH("subghz"));
-        storage_simply_mkdir(storage, SUBGHZ_ANALYSIS_DIR);
+    return success;
+}
 
-        if (!file_stream_open(stream, SUBGHZ_ANALYSIS_DIR "/protocol_headers.h",
-                              FSAM_WRITE, FSOM_CREATE_ALWAYS))
-        {
-            break;
-        }
+static void subghz_toolkit_run_analysis(SubGhzToolkitApp *app, const char *title, const SubGhzToolkitAnalysisPass *const *pass)
+{
+    SubGhzToolkitJob job = {
+        .title = title,
+        .passes = pass,
+        .pass_count = 1,
+        .success_text = (*pass)->success_text,
+        .error_text = (*pass)->error_text,
+    };
+    subghz_toolkit_start_job(app, &job);
+}
 
-        stream_write_format(stream,
-                            "// ==============================================================\n"
-                            "//        SubGhz Protocol C Headers for Implementation\n"
-                            "//                  Generated by SubGhz Toolkit\n"
-                            "//                 RocketGod | betaskynet.com\n"
-                            "// ==============================================================\n\n");
+static void subghz_toolkit_export_all_protocol_info(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitAnalysisPass *const passes[] = {&subghz_toolkit_pass_protocol_info};
+    subghz_toolkit_run_analysis(app, "Protocol Info", passes);
+}
 
-        size_t protocol_count = subghz_protocol_registry_count(app->protocol_registry);
+static void subghz_toolkit_advanced_analysis(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitAnalysisPass *const passes[] = {&subghz_toolkit_pass_advanced};
+    subghz_toolkit_run_analysis(app, "Advanced Analysis", passes);
+}
 
-        for (size_t i = 0; i < protocol_count; i++)
-        {
-            const SubGhzProtocol *protocol = subghz_protocol_registry_get_by_index(app->protocol_registry, i);
-            if (!protocol || !protocol->name)
-                continue;
+static void subghz_toolkit_function_disassembly(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitAnalysisPass *const passes[] = {&subghz_toolkit_pass_disassembly};
+    subghz_toolkit_run_analysis(app, "Disassembly", passes);
+}
 
-            subghz_toolkit_generate_protocol_c_header(stream, protocol);
-            stream_write_format(stream, "\n");
-        }
+static void subghz_toolkit_call_graph(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitAnalysisPass *const passes[] = {&subghz_toolkit_pass_call_graph};
+    subghz_toolkit_run_analysis(app, "Call Graph", passes);
+}
 
-        success = true;
-    } while (0);
+static void subghz_toolkit_protocol_state_analysis(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitAnalysisPass *const passes[] = {&subghz_toolkit_pass_state};
+    subghz_toolkit_run_analysis(app, "State Analysis", passes);
+}
 
-    stream_free(stream);
-    furi_record_close(RECORD_STORAGE);
+static void subghz_toolkit_timing_analysis(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitAnalysisPass *const passes[] = {&subghz_toolkit_pass_timing};
+    subghz_toolkit_run_analysis(app, "Timing Analysis", passes);
+}
 
-    if (success)
-    {
-        popup_set_header(app->popup, "Success!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "C headers generated to:\n/ext/subghz/analysis/protocol_headers.h",
-                       64, 20, AlignCenter, AlignTop);
-    }
-    else
-    {
-        popup_set_header(app->popup, "Error!", 64, 10, AlignCenter, AlignTop);
-        popup_set_text(app->popup, "Failed to generate C headers", 64, 20, AlignCenter, AlignTop);
-    }
+static void subghz_toolkit_generate_c_headers(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitAnalysisPass *const passes[] = {&subghz_toolkit_pass_c_headers};
+    subghz_toolkit_run_analysis(app, "C Headers", passes);
+}
 
-    popup_set_callback(app->popup, subghz_toolkit_popup_callback);
-    popup_set_context(app->popup, app);
-    popup_set_timeout(app->popup, 3000);
-    popup_enable_timeout(app->popup);
-    view_dispatcher_switch_to_view(app->view_dispatcher, SubGhzToolkitViewPopup);
+static void subghz_toolkit_run_all_analyses(SubGhzToolkitApp *app)
+{
+    static const SubGhzToolkitJob job = {
+        .title = "All Analyses",
+        .passes = subghz_toolkit_all_passes,
+        .pass_count = COUNT_OF(subghz_toolkit_all_passes),
+        .success_text = "All analyses exported to:\n/ext/subghz/analysis/",
+        .error_text = "Failed to run all analyses",
+    };
+    subghz_toolkit_start_job(app, &job);
 }
 
 static SubGhzToolkitApp *subghz_toolkit_app_alloc()
 {
+    uint32_t start_tick = furi_get_tick();
     SubGhzToolkitApp *app = malloc(sizeof(SubGhzToolkitApp));
 
     app->view_dispatcher = view_dispatcher_alloc();
@@ -1422,20 +3615,35 @@ static SubGhzToolkitApp *subghz_toolkit_app_alloc()
     app->submenu = submenu_alloc();
     app->popup = popup_alloc();
     app->text_box = text_box_alloc();
-    app->loading = loading_alloc();
+    app->progress = popup_alloc();
+    app->byte_input = byte_input_alloc();
+    app->text_input = text_input_alloc();
 
     app->text_buffer = furi_string_alloc();
     furi_string_reserve(app->text_buffer, TEXT_BUFFER_SIZE);
-
-    app->environment = subghz_environment_alloc();
-    subghz_environment_load_keystore(app->environment, EXT_PATH("subghz/assets/keeloq_mfcodes"));
-    subghz_environment_load_keystore(app->environment, EXT_PATH("subghz/assets/keeloq_mfcodes_user"));
-    subghz_environment_set_protocol_registry(app->environment, (void *)&subghz_protocol_registry);
-
-    app->protocol_registry = subghz_environment_get_protocol_registry(app->environment);
-    app->receiver = subghz_receiver_alloc_init(app->environment);
-    app->setting = subghz_setting_alloc();
-    subghz_setting_load(app->setting, EXT_PATH("subghz/assets/setting_user"));
+    app->progress_text = furi_string_alloc();
+    app->result_text = furi_string_alloc();
+
+    app->worker = subghz_toolkit_worker_alloc(app->view_dispatcher);
+    view_dispatcher_set_event_callback_context(app->view_dispatcher, app);
+    view_dispatcher_set_custom_event_callback(app->view_dispatcher, subghz_toolkit_custom_event_callback);
+    view_dispatcher_set_navigation_event_callback(app->view_dispatcher, subghz_toolkit_navigation_event_callback);
+
+    app->resource_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    app->environment = NULL;
+    app->receiver = NULL;
+    app->setting = NULL;
+    app->key_index = NULL;
+    app->function_cache = NULL;
+    app->symbols = NULL;
+    app->symbol_file = NULL;
+    app->symbols_loaded = false;
+    subghz_toolkit_memory_init(&app->flash);
+    subghz_toolkit_memory_add_region(&app->flash, SUBGHZ_TOOLKIT_FLASH_START, (const uint8_t *)(uintptr_t)SUBGHZ_TOOLKIT_FLASH_START,
+                                     furi_hal_flash_get_free_start_address() - SUBGHZ_TOOLKIT_FLASH_START);
+
+    app->protocol_registry = &subghz_protocol_registry;
+    subghz_toolkit_build_protocol_index(app);
 
     view_set_previous_callback(
         submenu_get_view(app->submenu),
@@ -1450,83 +3658,27 @@ static SubGhzToolkitApp *subghz_toolkit_app_alloc()
         subghz_toolkit_exit_to_submenu_callback);
 
     view_set_previous_callback(
-        loading_get_view(app->loading),
+        popup_get_view(app->progress),
+        subghz_toolkit_exit_callback);
+
+    view_set_previous_callback(
+        byte_input_get_view(app->byte_input),
+        subghz_toolkit_exit_to_submenu_callback);
+
+    view_set_previous_callback(
+        text_input_get_view(app->text_input),
         subghz_toolkit_exit_to_submenu_callback);
 
     view_dispatcher_add_view(app->view_dispatcher, SubGhzToolkitViewSubmenu, submenu_get_view(app->submenu));
     view_dispatcher_add_view(app->view_dispatcher, SubGhzToolkitViewPopup, popup_get_view(app->popup));
     view_dispatcher_add_view(app->view_dispatcher, SubGhzToolkitViewTextBox, text_box_get_view(app->text_box));
-    view_dispatcher_add_view(app->view_dispatcher, SubGhzToolkitViewLoading, loading_get_view(app->loading));
-
-    submenu_add_item(
-        app->submenu,
-        "Decrypt Keeloq mfcodes",
-        SubGhzToolkitSubmenuIndexDecryptKeeloq,
-        subghz_toolkit_submenu_callback,
-        app);
-
-    submenu_add_item(
-        app->submenu,
-        "List SubGhz Protocols",
-        SubGhzToolkitSubmenuIndexListProtocols,
-        subghz_toolkit_submenu_callback,
-        app);
-
-    submenu_add_item(
-        app->submenu,
-        "Export All Protocol Info",
-        SubGhzToolkitSubmenuIndexExportProtocolInfo,
-        subghz_toolkit_submenu_callback,
-        app);
-
-    submenu_add_item(
-        app->submenu,
-        "Advanced Analysis",
-        SubGhzToolkitSubmenuIndexAdvancedAnalysis,
-        subghz_toolkit_submenu_callback,
-        app);
-
-    submenu_add_item(
-        app->submenu,
-        "Function Disassembly",
-        SubGhzToolkitSubmenuIndexFunctionDisassembly,
-        subghz_toolkit_submenu_callback,
-        app);
-
-    submenu_add_item(
-        app->submenu,
-        "Protocol State Analysis",
-        SubGhzToolkitSubmenuIndexProtocolStateAnalysis,
-        subghz_toolkit_submenu_callback,
-        app);
-
-    submenu_add_item(
-        app->submenu,
-        "Signal Capture Analysis",
-        SubGhzToolkitSubmenuIndexSignalCapture,
-        subghz_toolkit_submenu_callback,
-        app);
-
-    submenu_add_item(
-        app->submenu,
-        "Timing Analysis",
-        SubGhzToolkitSubmenuIndexTimingAnalysis,
-        subghz_toolkit_submenu_callback,
-        app);
+    view_dispatcher_add_view(app->view_dispatcher, SubGhzToolkitViewProgress, popup_get_view(app->progress));
+    view_dispatcher_add_view(app->view_dispatcher, SubGhzToolkitViewByteInput, byte_input_get_view(app->byte_input));
+    view_dispatcher_add_view(app->view_dispatcher, SubGhzToolkitViewTextInput, text_input_get_view(app->text_input));
 
-    submenu_add_item(
-        app->submenu,
-        "Generate C Headers",
-        SubGhzToolkitSubmenuIndexCHeaderGeneration,
-        subghz_toolkit_submenu_callback,
-        app);
+    subghz_toolkit_add_main_menu_items(app);
 
-    submenu_add_item(
-        app->submenu,
-        "About",
-        SubGhzToolkitSubmenuIndexAbout,
-        subghz_toolkit_submenu_callback,
-        app);
+    FURI_LOG_I(TAG, "Startup in %lu ms", furi_get_tick() - start_tick);
 
     return app;
 }
@@ -1536,18 +3688,41 @@ static void subghz_toolkit_app_free(SubGhzToolkitApp *app)
     view_dispatcher_remove_view(app->view_dispatcher, SubGhzToolkitViewSubmenu);
     view_dispatcher_remove_view(app->view_dispatcher, SubGhzToolkitViewPopup);
     view_dispatcher_remove_view(app->view_dispatcher, SubGhzToolkitViewTextBox);
-    view_dispatcher_remove_view(app->view_dispatcher, SubGhzToolkitViewLoading);
+    view_dispatcher_remove_view(app->view_dispatcher, SubGhzToolkitViewProgress);
+    view_dispatcher_remove_view(app->view_dispatcher, SubGhzToolkitViewByteInput);
+    view_dispatcher_remove_view(app->view_dispatcher, SubGhzToolkitViewTextInput);
 
     submenu_free(app->submenu);
     popup_free(app->popup);
     text_box_free(app->text_box);
-    loading_free(app->loading);
+    popup_free(app->progress);
+    byte_input_free(app->byte_input);
+    text_input_free(app->text_input);
 
-    subghz_receiver_free(app->receiver);
-    subghz_environment_free(app->environment);
-    subghz_setting_free(app->setting);
+    subghz_toolkit_worker_free(app->worker);
+
+    if (app->receiver)
+        subghz_receiver_free(app->receiver);
+    if (app->environment)
+        subghz_environment_free(app->environment);
+    if (app->setting)
+        subghz_setting_free(app->setting);
+    if (app->key_index)
+        subghz_toolkit_key_index_free(app->key_index);
+    subghz_toolkit_function_cache_free(app->function_cache);
+    if (app->symbols)
+    {
+        subghz_toolkit_symbols_free(app->symbols);
+        storage_file_close(app->symbol_file);
+        storage_file_free(app->symbol_file);
+        furi_record_close(RECORD_STORAGE);
+    }
+    furi_mutex_free(app->resource_mutex);
+    subghz_toolkit_name_index_free(app->protocol_index);
 
     furi_string_free(app->text_buffer);
+    furi_string_free(app->progress_text);
+    furi_string_free(app->result_text);
 
     view_dispatcher_free(app->view_dispatcher);
 
@@ -0,0 +1,152 @@
+#include "subghz_toolkit_worker.h"
+
+#define TAG "SubGhzToolkitWorker"
+#define SUBGHZ_TOOLKIT_WORKER_STACK_SIZE (4 * 1024)
+
+struct SubGhzToolkitWorker
+{
+    FuriThread *thread;
+    FuriMutex *mutex;
+    ViewDispatcher *view_dispatcher;
+
+    SubGhzToolkitWorkerCallback callback;
+    void *context;
+
+    volatile bool running;
+    volatile bool cancel;
+    bool result;
+
+    size_t done;
+    size_t total;
+    size_t last_sent;
+    FuriString *item;
+};
+
+static int32_t subghz_toolkit_worker_thread(void *context)
+{
+    SubGhzToolkitWorker *worker = context;
+    uint32_t start_tick = furi_get_tick();
+
+    worker->result = worker->callback(worker, worker->context);
+
+    FURI_LOG_I(TAG, "Job %s in %lu ms",
+               worker->cancel ? "cancelled" : (worker->result ? "done" : "failed"),
+               furi_get_tick() - start_tick);
+
+    view_dispatcher_send_custom_event(worker->view_dispatcher, SubGhzToolkitCustomEventWorkerDone);
+    return 0;
+}
+
+SubGhzToolkitWorker *subghz_toolkit_worker_alloc(ViewDispatcher *view_dispatcher)
+{
+    SubGhzToolkitWorker *worker = malloc(sizeof(SubGhzToolkitWorker));
+
+    worker->thread = furi_thread_alloc_ex(
+        "SubGhzToolkitWorker", SUBGHZ_TOOLKIT_WORKER_STACK_SIZE, subghz_toolkit_worker_thread, worker);
+    worker->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    worker->view_dispatcher = view_dispatcher;
+    worker->callback = NULL;
+    worker->context = NULL;
+    worker->running = false;
+    worker->cancel = false;
+    worker->result = false;
+    worker->done = 0;
+    worker->total = 0;
+    worker->last_sent = 0;
+    worker->item = furi_string_alloc();
+
+    return worker;
+}
+
+void subghz_toolkit_worker_free(SubGhzToolkitWorker *worker)
+{
+    if (worker->running)
+    {
+        subghz_toolkit_worker_cancel(worker);
+        subghz_toolkit_worker_stop(worker);
+    }
+
+    furi_thread_free(worker->thread);
+    furi_mutex_free(worker->mutex);
+    furi_string_free(worker->item);
+    free(worker);
+}
+
+bool subghz_toolkit_worker_start(SubGhzToolkitWorker *worker, SubGhzToolkitWorkerCallback callback, void *context)
+{
+    if (worker->running)
+        return false;
+
+    worker->callback = callback;
+    worker->context = context;
+    worker->cancel = false;
+    worker->result = false;
+
+    furi_mutex_acquire(worker->mutex, FuriWaitForever);
+    worker->done = 0;
+    worker->total = 0;
+    worker->last_sent = 0;
+    furi_string_reset(worker->item);
+    furi_mutex_release(worker->mutex);
+
+    worker->running = true;
+    furi_thread_start(worker->thread);
+    return true;
+}
+
+bool subghz_toolkit_worker_stop(SubGhzToolkitWorker *worker)
+{
+    if (!worker->running)
+        return worker->result;
+
+    furi_thread_join(worker->thread);
+    worker->running = false;
+    return worker->result;
+}
+
+bool subghz_toolkit_worker_is_running(SubGhzToolkitWorker *worker)
+{
+    return worker->running;
+}
+
+void subghz_toolkit_worker_cancel(SubGhzToolkitWorker *worker)
+{
+    worker->cancel = true;
+}
+
+bool subghz_toolkit_worker_is_cancelled(SubGhzToolkitWorker *worker)
+{
+    return worker->cancel;
+}
+
+void subghz_toolkit_worker_report(SubGhzToolkitWorker *worker, size_t done, size_t total, const char *item)
+{
+    bool send = false;
+
+    furi_mutex_acquire(worker->mutex, FuriWaitForever);
+    worker->done = done;
+    worker->total = total;
+    if (item)
+        furi_string_set_str(worker->item, item);
+
+    // Large jobs (thousands of keys) would flood the event queue otherwise
+    size_t step = total / 100;
+    if (done == 0 || done >= total || done - worker->last_sent > step)
+    {
+        worker->last_sent = done;
+        send = true;
+    }
+    furi_mutex_release(worker->mutex);
+
+    if (send)
+        view_dispatcher_send_custom_event(worker->view_dispatcher, SubGhzToolkitCustomEventWorkerProgress);
+}
+
+void subghz_toolkit_worker_get_progress(SubGhzToolkitWorker *worker, size_t *done, size_t *total, FuriString *item)
+{
+    furi_mutex_acquire(worker->mutex, FuriWaitForever);
+    *done = worker->done;
+    *total = worker->total;
+    furi_string_set(item, worker->item);
+    furi_mutex_release(worker->mutex);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/view_dispatcher.h>
+
+typedef struct SubGhzToolkitWorker SubGhzToolkitWorker;
+
+/** Custom events posted to the ViewDispatcher by the worker thread */
+typedef enum
+{
+    SubGhzToolkitCustomEventWorkerProgress = 0x100,
+    SubGhzToolkitCustomEventWorkerDone,
+} SubGhzToolkitCustomEvent;
+
+/** Job body, runs on the worker thread. Return true on success. */
+typedef bool (*SubGhzToolkitWorkerCallback)(SubGhzToolkitWorker *worker, void *context);
+
+SubGhzToolkitWorker *subghz_toolkit_worker_alloc(ViewDispatcher *view_dispatcher);
+
+void subghz_toolkit_worker_free(SubGhzToolkitWorker *worker);
+
+/** Start a job. Returns false if a job is already running. */
+bool subghz_toolkit_worker_start(SubGhzToolkitWorker *worker, SubGhzToolkitWorkerCallback callback, void *context);
+
+/** Join a finished job and return its result. Call after SubGhzToolkitCustomEventWorkerDone. */
+bool subghz_toolkit_worker_stop(SubGhzToolkitWorker *worker);
+
+bool subghz_toolkit_worker_is_running(SubGhzToolkitWorker *worker);
+
+/** Ask the running job to stop at the next item boundary */
+void subghz_toolkit_worker_cancel(SubGhzToolkitWorker *worker);
+
+/** Polled by jobs between items */
+bool subghz_toolkit_worker_is_cancelled(SubGhzToolkitWorker *worker);
+
+/** Called by jobs to publish progress. Events are rate limited to ~1% steps. */
+void subghz_toolkit_worker_report(SubGhzToolkitWorker *worker, size_t done, size_t total, const char *item);
+
+/** Snapshot the last reported progress, from the GUI thread */
+void subghz_toolkit_worker_get_progress(SubGhzToolkitWorker *worker, size_t *done, size_t *total, FuriString *item);
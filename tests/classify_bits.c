@@ -0,0 +1,52 @@
+// Host test for helpers/subghz_toolkit_classify.h decoded bits
+// A Princeton style PWM frame (0 = 1 te high 3 te low, 1 = 3 te high 1 te
+// low, then a 1 te sync high and a 31 te gap), repeated, must classify as PWM
+// and decode to its 24 key bits: the sync high adds no bit. Exits non-zero on
+// a failure.
+//
+// Build: cc -O2 -I. -o classify_bits tests/classify_bits.c helpers/subghz_toolkit_classify.c helpers/subghz_toolkit_writer.c
+// Usage: ./classify_bits
+
+#include <stdio.h>
+
+#include "helpers/subghz_toolkit_classify.h"
+
+#define CLASSIFY_BITS_TE 400
+#define CLASSIFY_BITS_KEY 0xA5C3F1u
+#define CLASSIFY_BITS_KEY_BITS 24
+#define CLASSIFY_BITS_REPEATS 8
+
+static void classify_bits_frame(SubGhzToolkitClassifier *classifier, uint32_t key, uint8_t bit_count)
+{
+    for (uint8_t i = bit_count; i-- > 0;)
+    {
+        bool bit = key >> i & 1;
+        subghz_toolkit_classify_add(classifier, true, CLASSIFY_BITS_TE * (bit ? 3 : 1));
+        subghz_toolkit_classify_add(classifier, false, CLASSIFY_BITS_TE * (bit ? 1 : 3));
+    }
+    subghz_toolkit_classify_add(classifier, true, CLASSIFY_BITS_TE);
+    subghz_toolkit_classify_add(classifier, false, CLASSIFY_BITS_TE * 31);
+}
+
+int main(void)
+{
+    static SubGhzToolkitClassifier classifier;
+    static SubGhzToolkitClassification result;
+    uint32_t key = 0;
+
+    subghz_toolkit_classify_init(&classifier);
+    subghz_toolkit_classify_add(&classifier, false, 20000);
+    for (uint8_t repeat = 0; repeat < CLASSIFY_BITS_REPEATS; repeat++)
+        classify_bits_frame(&classifier, CLASSIFY_BITS_KEY, CLASSIFY_BITS_KEY_BITS);
+    subghz_toolkit_classify(&classifier, CLASSIFY_BITS_TE, &result);
+
+    for (size_t i = 0; i < result.bit_count && i < 32; i++)
+        key = key << 1 | ((result.bits[i / 8] >> (7 - i % 8)) & 1);
+    bool pwm = result.encoding == SubGhzToolkitEncodingPwm;
+    bool bits = result.bit_count == CLASSIFY_BITS_KEY_BITS && key == CLASSIFY_BITS_KEY;
+
+    printf("encoding   %-10s (want PWM)  %s\n", subghz_toolkit_encoding_name(result.encoding), pwm ? "ok" : "FAIL");
+    printf("bits       %2u 0x%06lX (want %u 0x%06lX)  %s\n", (unsigned)result.bit_count, (unsigned long)key,
+           CLASSIFY_BITS_KEY_BITS, (unsigned long)CLASSIFY_BITS_KEY, bits ? "ok" : "FAIL");
+    return !(pwm && bits);
+}
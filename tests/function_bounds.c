@@ -0,0 +1,72 @@
+// Host test for helpers/subghz_toolkit_function.h function boundaries
+// Each case is Thumb code assembled with llvm-mc (thumbv7em), source in the
+// comment above it. Exits non-zero if any size is wrong.
+//
+// Build: cc -O2 -I. -o function_bounds tests/function_bounds.c helpers/subghz_toolkit_function.c helpers/subghz_toolkit_thumb.c helpers/subghz_toolkit_writer.c
+// Usage: ./function_bounds
+
+#include <stdio.h>
+
+#include "helpers/subghz_toolkit_function.h"
+
+typedef struct
+{
+    const char *name;
+    const uint8_t *code;
+    size_t size;
+    uint16_t code_size;
+    uint8_t flags;
+} FunctionBoundsCase;
+
+//   push {r4, lr}
+//   cbz r0, 1f
+//   bl g
+//   movs r0, #1
+//   pop {r4, pc}
+// 1: movs r0, #0
+//   pop {r4, pc}
+static const uint8_t early_return[] = {
+    0x10, 0xb5, 0x18, 0xb1, 0x00, 0xf0, 0x0a, 0xf8, 0x01, 0x20, 0x10, 0xbd,
+    0x00, 0x20, 0x10, 0xbd,
+    0x00, 0xbf, // next function
+};
+
+//   cbz r0, 1f
+//   ldr.w r0, [r1, #4]
+//   b.w g
+// 1: bx lr
+static const uint8_t tail_call_then_return[] = {
+    0x18, 0xb1, 0xd1, 0xf8, 0x04, 0x00, 0x00, 0xf0, 0x01, 0xb8, 0x70, 0x47,
+    0x00, 0xbf, // g: nop
+};
+
+//   movs r0, #0
+//   bx lr
+static const uint8_t leaf[] = {
+    0x00, 0x20, 0x70, 0x47,
+    0x00, 0xbf,
+};
+
+static const FunctionBoundsCase cases[] = {
+    {"early return", early_return, sizeof(early_return), 16, 0},
+    {"tail call then return", tail_call_then_return, sizeof(tail_call_then_return), 12, SUBGHZ_TOOLKIT_FUNCTION_FLAG_LEAF},
+    {"leaf", leaf, sizeof(leaf), 4, SUBGHZ_TOOLKIT_FUNCTION_FLAG_LEAF},
+};
+
+int main(void)
+{
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        const FunctionBoundsCase *test = &cases[i];
+        SubGhzToolkitFunction function;
+
+        subghz_toolkit_function_bounds(test->code, test->size, 0x08010000, &function);
+        bool ok = function.code_size == test->code_size && function.size == test->code_size && function.flags == test->flags;
+        printf("%-24s size %2u (want %2u) flags 0x%02X (want 0x%02X)  %s\n", test->name,
+               function.code_size, test->code_size, function.flags, test->flags, ok ? "ok" : "FAIL");
+        failed += !ok;
+    }
+    return failed != 0;
+}
@@ -0,0 +1,60 @@
+// Host test for helpers/subghz_toolkit_snapshot.h function hashes
+// The same function assembled with llvm-mc (thumbv7em) at a word aligned
+// address and one halfword later must hash the same: the LDR literal and ADR
+// offsets and the padding before the literal pool differ, the code does not.
+// A changed literal constant must change the hash. Exits non-zero on a failure.
+//
+// Build: cc -O2 -I. -o snapshot_hash tests/snapshot_hash.c helpers/subghz_toolkit_snapshot.c helpers/subghz_toolkit_function.c helpers/subghz_toolkit_thumb.c helpers/subghz_toolkit_protocol.c helpers/subghz_toolkit_timing.c helpers/subghz_toolkit_memory.c helpers/subghz_toolkit_name_index.c helpers/subghz_toolkit_writer.c
+// Usage: ./snapshot_hash
+
+#include <stdio.h>
+
+#include "helpers/subghz_toolkit_snapshot.h"
+
+//   .p2align 2
+//   (nop)            moved variant only
+// f:
+//   push {r4, lr}
+//   ldr r0, 1f
+//   ldr.w r1, 2f
+//   adr r2, 1f
+//   adds r0, r0, r1
+//   pop {r4, pc}
+//   .p2align 2
+// 1: .word 0x12345678
+// 2: .word 0x08001234
+static const uint8_t aligned[] = {
+    0x10, 0xb5, 0x03, 0x48, 0xdf, 0xf8, 0x0c, 0x10, 0x01, 0xa2, 0x40, 0x18,
+    0x10, 0xbd, 0x00, 0xbf, 0x78, 0x56, 0x34, 0x12, 0x34, 0x12, 0x00, 0x08,
+};
+static const uint8_t moved[] = {
+    0x00, 0xbf, 0x10, 0xb5, 0x02, 0x48, 0xdf, 0xf8, 0x0c, 0x10, 0x01, 0xa2,
+    0x40, 0x18, 0x10, 0xbd, 0x78, 0x56, 0x34, 0x12, 0x34, 0x12, 0x00, 0x08,
+};
+// aligned with 1: .word 0x12345679
+static const uint8_t changed[] = {
+    0x10, 0xb5, 0x03, 0x48, 0xdf, 0xf8, 0x0c, 0x10, 0x01, 0xa2, 0x40, 0x18,
+    0x10, 0xbd, 0x00, 0xbf, 0x79, 0x56, 0x34, 0x12, 0x34, 0x12, 0x00, 0x08,
+};
+
+#define SNAPSHOT_HASH_BASE 0x08020000u
+
+static uint32_t snapshot_hash(const uint8_t *code, size_t size, uint32_t address)
+{
+    SubGhzToolkitFunction function;
+    subghz_toolkit_function_bounds(code, size, address, &function);
+    return subghz_toolkit_snapshot_hash_function(code, &function);
+}
+
+int main(void)
+{
+    uint32_t base = snapshot_hash(aligned, sizeof(aligned), SNAPSHOT_HASH_BASE);
+    uint32_t shifted = snapshot_hash(moved + 2, sizeof(moved) - 2, SNAPSHOT_HASH_BASE + 0x102);
+    uint32_t other = snapshot_hash(changed, sizeof(changed), SNAPSHOT_HASH_BASE);
+    bool same = base == shifted;
+    bool differs = base != other;
+
+    printf("moved by a halfword   %08lX %08lX  %s\n", (unsigned long)base, (unsigned long)shifted, same ? "ok" : "FAIL");
+    printf("changed constant      %08lX %08lX  %s\n", (unsigned long)base, (unsigned long)other, differs ? "ok" : "FAIL");
+    return !(same && differs);
+}
@@ -0,0 +1,85 @@
+// Host benchmark for the buffered analysis writer
+// Compares one formatted write per byte (what the analysis code used to do
+// through stream_write_format) against SubGhzToolkitWriter hex dumps.
+//
+// Build: cc -O2 -I. -o bench_writer tools/bench_writer.c helpers/subghz_toolkit_writer.c
+// Usage: ./bench_writer [output_file] [megabytes]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "helpers/subghz_toolkit_writer.h"
+
+typedef struct
+{
+    FILE *file;
+    size_t calls;
+} BenchSink;
+
+static double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Unbuffered file, like file_stream on the SD card
+static size_t bench_sink_write(void *context, const uint8_t *data, size_t size)
+{
+    BenchSink *sink = context;
+    sink->calls++;
+    return fwrite(data, 1, size, sink->file);
+}
+
+static void bench_report(const char *name, size_t bytes, size_t calls, double seconds)
+{
+    printf("%-22s %10zu bytes %9zu writes %8.3f s %10.2f MB/s\n",
+           name, bytes, calls, seconds, seconds > 0 ? bytes / seconds / 1e6 : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : "/dev/null";
+    size_t megabytes = argc > 2 ? strtoul(argv[2], NULL, 10) : 4;
+    size_t input_size = megabytes * 1024 * 1024 / 3; // three output chars per byte
+
+    uint8_t *input = malloc(input_size);
+    for (size_t i = 0; i < input_size; i++)
+        input[i] = (uint8_t)(i * 2654435761u >> 13);
+
+    BenchSink sink = {.file = fopen(path, "wb")};
+    if (!sink.file)
+    {
+        perror(path);
+        return 1;
+    }
+    setvbuf(sink.file, NULL, _IONBF, 0);
+
+    // Baseline: one formatted write per byte, every 16 bytes a line break
+    double start = bench_now();
+    size_t bytes = 0;
+    char text[8];
+    for (size_t i = 0; i < input_size; i++)
+    {
+        int len = snprintf(text, sizeof(text), "%02X ", input[i]);
+        bytes += bench_sink_write(&sink, (const uint8_t *)text, len);
+        if ((i + 1) % 16 == 0)
+            bytes += bench_sink_write(&sink, (const uint8_t *)"\n    ", 5);
+    }
+    bench_report("per-byte format", bytes, sink.calls, bench_now() - start);
+
+    sink.calls = 0;
+    start = bench_now();
+    SubGhzToolkitWriter *writer = subghz_toolkit_writer_alloc(bench_sink_write, &sink);
+    subghz_toolkit_writer_hex_dump(writer, "    ", input, input_size, 16);
+    subghz_toolkit_writer_flush(writer);
+    const SubGhzToolkitWriterStats *stats = subghz_toolkit_writer_get_stats(writer);
+    bench_report("buffered hex writer", (size_t)stats->bytes, stats->flushes, bench_now() - start);
+    subghz_toolkit_writer_free(writer);
+
+    fclose(sink.file);
+    free(input);
+    return 0;
+}
@@ -0,0 +1,256 @@
+// Host driver for the signal capture pipeline
+// Replays a RAW .sub file as the pulse source of helpers/subghz_toolkit_capture.h:
+// a producer thread parses the file and pushes pulses into the ring, the main
+// thread drains it into blocks and a writer thread stores them, exactly as the
+// radio interrupt, worker and SD writer do in the app. The output is again a
+// RAW .sub file, followed by the capture statistics on stdout.
+//
+// Build: cc -O2 -pthread -I. -o capture_replay tools/capture_replay.c helpers/subghz_toolkit_capture.c helpers/subghz_toolkit_raw.c helpers/subghz_toolkit_writer.c
+// Usage: ./capture_replay [-r] [-n repeat] input.sub output.sub
+//
+// -r paces the replay to the pulse durations like a live radio would, and
+// pulses the consumer cannot keep up with are dropped. Without it the producer
+// waits for room in the ring and the run measures the pipeline's throughput.
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "helpers/subghz_toolkit_capture.h"
+#include "helpers/subghz_toolkit_raw.h"
+
+typedef struct
+{
+    const char *path;
+    unsigned repeat;
+    int realtime;
+    pthread_t thread;
+    atomic_bool done;
+    atomic_bool stop;
+    SubGhzToolkitCapture *capture;
+    double next_us; // realtime: when the next pulse is due
+} ReplaySource;
+
+static double replay_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void replay_source_pulse(void *context, bool level, uint32_t duration)
+{
+    ReplaySource *source = context;
+
+    if (source->realtime)
+    {
+        source->next_us += duration;
+        double wait = source->next_us - replay_now_us();
+        if (wait > 1000)
+            usleep((useconds_t)wait);
+        subghz_toolkit_capture_push(source->capture, level, duration);
+        return;
+    }
+
+    while (subghz_toolkit_capture_pending(source->capture) >= SUBGHZ_TOOLKIT_CAPTURE_RING_SIZE && !atomic_load(&source->stop))
+        sched_yield();
+    subghz_toolkit_capture_push(source->capture, level, duration);
+}
+
+static void *replay_source_thread(void *context)
+{
+    ReplaySource *source = context;
+    char buffer[4096];
+
+    source->next_us = replay_now_us();
+    for (unsigned pass = 0; pass < source->repeat && !atomic_load(&source->stop); pass++)
+    {
+        FILE *file = fopen(source->path, "rb");
+        if (!file)
+        {
+            perror(source->path);
+            break;
+        }
+
+        SubGhzToolkitRawParser parser;
+        subghz_toolkit_raw_parser_init(&parser);
+        size_t size;
+        while (!atomic_load(&source->stop) && (size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            subghz_toolkit_raw_parser_feed(&parser, buffer, size, replay_source_pulse, source);
+        subghz_toolkit_raw_parser_finish(&parser, replay_source_pulse, source);
+        fclose(file);
+    }
+
+    atomic_store(&source->done, true);
+    return NULL;
+}
+
+static bool replay_source_start(void *context, SubGhzToolkitCapture *capture)
+{
+    ReplaySource *source = context;
+    source->capture = capture;
+    return pthread_create(&source->thread, NULL, replay_source_thread, source) == 0;
+}
+
+static void replay_source_stop(void *context)
+{
+    ReplaySource *source = context;
+    atomic_store(&source->stop, true);
+    pthread_join(source->thread, NULL);
+}
+
+static bool replay_source_is_done(void *context)
+{
+    ReplaySource *source = context;
+    return atomic_load(&source->done);
+}
+
+typedef struct
+{
+    SubGhzToolkitCapture *capture;
+    FILE *file;
+    bool error;
+} ReplayWriter;
+
+static void *replay_writer_thread(void *context)
+{
+    ReplayWriter *writer = context;
+    const uint8_t *data;
+    size_t size;
+
+    for (;;)
+    {
+        if (subghz_toolkit_capture_next_block(writer->capture, &data, &size))
+        {
+            double start = replay_now_us();
+            if (fwrite(data, 1, size, writer->file) != size)
+                writer->error = true;
+            subghz_toolkit_capture_block_done(writer->capture, (uint32_t)((replay_now_us() - start) / 1000));
+        }
+        else if (subghz_toolkit_capture_is_flushed(writer->capture))
+        {
+            break;
+        }
+        else
+        {
+            usleep(200);
+        }
+    }
+    return NULL;
+}
+
+static void replay_ignore_pulse(void *context, bool level, uint32_t duration)
+{
+    (void)context;
+    (void)level;
+    (void)duration;
+}
+
+// Frequency from the input's header, which comes before any RAW_Data line
+static uint32_t replay_frequency(const char *path)
+{
+    char buffer[1024];
+    uint32_t frequency = SUBGHZ_TOOLKIT_RAW_DEFAULT_FREQUENCY;
+    FILE *file = fopen(path, "rb");
+
+    if (file)
+    {
+        SubGhzToolkitRawParser parser;
+        subghz_toolkit_raw_parser_init(&parser);
+        subghz_toolkit_raw_parser_feed(&parser, buffer, fread(buffer, 1, sizeof(buffer), file), replay_ignore_pulse, NULL);
+        if (parser.frequency)
+            frequency = parser.frequency;
+        fclose(file);
+    }
+    return frequency;
+}
+
+static size_t replay_file_write(void *context, const uint8_t *data, size_t size)
+{
+    return fwrite(data, 1, size, context);
+}
+
+int main(int argc, char **argv)
+{
+    ReplaySource replay = {.repeat = 1};
+    const char *paths[2];
+    int path_count = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0)
+            replay.realtime = 1;
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            replay.repeat = strtoul(argv[++i], NULL, 10);
+        else if (path_count < 2)
+            paths[path_count++] = argv[i];
+    }
+    if (path_count != 2)
+    {
+        fprintf(stderr, "Usage: capture_replay [-r] [-n repeat] input.sub output.sub\n");
+        return 1;
+    }
+    replay.path = paths[0];
+
+    FILE *file = fopen(paths[1], "wb");
+    if (!file)
+    {
+        perror(paths[1]);
+        return 1;
+    }
+
+    SubGhzToolkitWriter *header = subghz_toolkit_writer_alloc(replay_file_write, file);
+    subghz_toolkit_raw_write_header(header, replay_frequency(replay.path), SUBGHZ_TOOLKIT_RAW_DEFAULT_PRESET);
+    subghz_toolkit_writer_free(header);
+
+    SubGhzToolkitCapture *capture = subghz_toolkit_capture_alloc(SUBGHZ_TOOLKIT_CAPTURE_RING_SIZE, SUBGHZ_TOOLKIT_CAPTURE_BLOCK_SIZE);
+    SubGhzToolkitCaptureSource source = {
+        .name = "RAW replay",
+        .start = replay_source_start,
+        .stop = replay_source_stop,
+        .is_done = replay_source_is_done,
+        .context = &replay,
+    };
+    ReplayWriter writer = {.capture = capture, .file = file};
+    pthread_t writer_thread;
+
+    double start = replay_now_us();
+    pthread_create(&writer_thread, NULL, replay_writer_thread, &writer);
+    if (!source.start(source.context, capture))
+    {
+        fprintf(stderr, "Failed to start %s\n", source.name);
+        return 1;
+    }
+
+    for (;;)
+    {
+        size_t drained = subghz_toolkit_capture_drain(capture);
+        if (source.is_done(source.context) && !subghz_toolkit_capture_pending(capture))
+            break;
+        if (!drained)
+            usleep(100);
+    }
+
+    source.stop(source.context);
+    subghz_toolkit_capture_finish(capture);
+    pthread_join(writer_thread, NULL);
+    uint32_t elapsed_ms = (uint32_t)((replay_now_us() - start) / 1000);
+
+    SubGhzToolkitWriter *report = subghz_toolkit_writer_alloc(replay_file_write, stdout);
+    subghz_toolkit_writer_printf(report, "Source: %s, %s x%u%s\n", source.name, replay.path, replay.repeat, replay.realtime ? " (real time)" : "");
+    subghz_toolkit_capture_write_report(report, capture, elapsed_ms);
+    subghz_toolkit_writer_free(report);
+
+    subghz_toolkit_capture_free(capture);
+    if (fclose(file) != 0 || writer.error)
+    {
+        perror(paths[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,391 @@
+// Host firmware image analyzer
+// Memory maps firmware builds (firmware.elf or a raw .bin), finds
+// subghz_protocol_registry and runs the app's analyses on each image: the
+// registry walk, function bounds and disassembly, timing constant recovery
+// and C header generation. All target reads go through SubGhzToolkitMemory,
+// so the analysis code is the one the app runs against live flash.
+//
+// Build: cc -O2 -I. -o firmware_analyzer tools/firmware_analyzer.c helpers/subghz_toolkit_memory.c helpers/subghz_toolkit_elf.c helpers/subghz_toolkit_protocol.c helpers/subghz_toolkit_function.c helpers/subghz_toolkit_thumb.c helpers/subghz_toolkit_timing.c helpers/subghz_toolkit_snapshot.c helpers/subghz_toolkit_name_index.c helpers/subghz_toolkit_writer.c
+// Usage: ./firmware_analyzer [-o out_dir] [-b base] [-r registry] [-g githash] <firmware.elf|firmware.bin>...
+//
+// The registry comes from the ELF symbol table, or -r, or a scan of the image
+// for the largest {items, size} pair whose items all read as protocols.
+// A .bin is mapped at -b (default 0x08000000, the start of flash).
+// One summary line per image goes to stdout; with -o each image also gets
+// <out_dir>/<name>_analysis.txt, <out_dir>/<name>_headers.h and the snapshot
+// <out_dir>/<name>.snap for tools/firmware_diff.c, keyed by -g or the file name.
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "helpers/subghz_toolkit_elf.h"
+#include "helpers/subghz_toolkit_memory.h"
+#include "helpers/subghz_toolkit_protocol.h"
+#include "helpers/subghz_toolkit_snapshot.h"
+
+#define FIRMWARE_ANALYZER_FLASH_START 0x08000000u
+
+typedef struct
+{
+    const char *output_dir;
+    uint32_t base;
+    uint32_t registry;
+    const char *githash;
+} FirmwareAnalyzerOptions;
+
+typedef struct
+{
+    uint32_t registry;
+    uint32_t protocol_count;
+    size_t functions;
+    size_t timing_blocks;
+} FirmwareAnalyzerResult;
+
+static double firmware_analyzer_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static size_t firmware_analyzer_file_write(void *context, const uint8_t *data, size_t size)
+{
+    return fwrite(data, 1, size, context);
+}
+
+// Writer backed by a new file, or a writer that discards everything when `path` is NULL
+static SubGhzToolkitWriter *firmware_analyzer_writer_open(const char *path, FILE **file)
+{
+    *file = path ? fopen(path, "w") : fopen("/dev/null", "w");
+    if (!*file)
+    {
+        perror(path);
+        return NULL;
+    }
+    return subghz_toolkit_writer_alloc(firmware_analyzer_file_write, *file);
+}
+
+static bool firmware_analyzer_writer_close(SubGhzToolkitWriter *writer, FILE *file)
+{
+    subghz_toolkit_writer_flush(writer);
+    bool ok = !subghz_toolkit_writer_get_stats(writer)->error;
+    subghz_toolkit_writer_free(writer);
+    return fclose(file) == 0 && ok;
+}
+
+// Same layout as the app's function disassembly pass, one function at a time
+static void firmware_analyzer_write_function(
+    SubGhzToolkitWriter *writer,
+    const SubGhzToolkitMemory *memory,
+    SubGhzToolkitFunctionCache *cache,
+    const SubGhzToolkitProtocolInfo *protocols,
+    uint32_t index,
+    SubGhzToolkitFunctionSlot slot,
+    FirmwareAnalyzerResult *result)
+{
+    uint32_t pointer = protocols[index].functions[slot];
+    if (!pointer)
+        return;
+
+    const SubGhzToolkitFunction *function = subghz_toolkit_protocol_function(
+        cache, subghz_toolkit_memory_code_at, (void *)memory, pointer, (uint16_t)index, slot, NULL);
+    if (!function)
+    {
+        subghz_toolkit_writer_printf(writer, "\n  Function: %s @ 0x%08lX (unmapped, skipped)\n",
+                                     subghz_toolkit_function_slot_names[slot], (unsigned long)pointer);
+        return;
+    }
+
+    subghz_toolkit_writer_printf(writer, "\n  Function: %s @ 0x%08lX (Thumb)\n",
+                                 subghz_toolkit_function_slot_names[slot], (unsigned long)function->address);
+
+    if (function->owner != index || function->label != slot)
+    {
+        subghz_toolkit_writer_printf(writer, "  Size: %u bytes, shared with %s %s\n",
+                                     function->size,
+                                     protocols[function->owner].name,
+                                     subghz_toolkit_function_slot_names[function->label]);
+        return;
+    }
+
+    subghz_toolkit_writer_printf(writer, "  Size: %u bytes (%u code + %u literal pool), %u instructions%s%s%s\n",
+                                 function->size,
+                                 function->code_size,
+                                 function->size - function->code_size,
+                                 function->insn_count,
+                                 (function->flags & SUBGHZ_TOOLKIT_FUNCTION_FLAG_LEAF) ? ", leaf" : "",
+                                 (function->flags & SUBGHZ_TOOLKIT_FUNCTION_FLAG_TAIL_CALL) ? ", tail call" : "",
+                                 (function->flags & SUBGHZ_TOOLKIT_FUNCTION_FLAG_TRUNCATED) ? ", TRUNCATED" : "");
+
+    size_t size = 0;
+    subghz_toolkit_function_write_listing(writer, subghz_toolkit_memory_at(memory, function->address, &size), function);
+    result->functions++;
+}
+
+static void firmware_analyzer_write_report(
+    SubGhzToolkitWriter *report,
+    SubGhzToolkitWriter *headers,
+    const SubGhzToolkitMemory *memory,
+    const SubGhzToolkitProtocolInfo *protocols,
+    SubGhzToolkitSnapshot *snapshot,
+    FirmwareAnalyzerResult *result)
+{
+    SubGhzToolkitFunctionCache *cache = subghz_toolkit_function_cache_alloc();
+    SubGhzToolkitTimingScan *scans = malloc(result->protocol_count * sizeof(SubGhzToolkitTimingScan));
+
+    subghz_toolkit_writer_printf(report, "Protocol Registry: 0x%08lX, %lu protocols\n",
+                                 (unsigned long)result->registry, (unsigned long)result->protocol_count);
+
+    for (uint32_t i = 0; i < result->protocol_count; i++)
+    {
+        const SubGhzToolkitProtocolInfo *protocol = &protocols[i];
+
+        subghz_toolkit_writer_cstr(report, "\n████████████████████████████████████████████████████████████\n");
+        subghz_toolkit_writer_printf(report, "Protocol #%lu: %s\n", (unsigned long)i, protocol->name);
+        subghz_toolkit_writer_cstr(report, "████████████████████████████████████████████████████████████\n");
+        subghz_toolkit_writer_printf(report, "  Address: 0x%08lX\n  Type: 0x%02lX\n  Flag: 0x%08lX\n",
+                                     (unsigned long)protocol->address,
+                                     (unsigned long)protocol->type,
+                                     (unsigned long)protocol->flag);
+
+        for (size_t slot = 0; slot < SubGhzToolkitFunctionSlotCount; slot++)
+        {
+            if (slot == SubGhzToolkitFunctionSlotDecoderAlloc && protocol->decoder)
+                subghz_toolkit_writer_cstr(report, "\nDECODER FUNCTIONS:\n==================\n");
+            else if (slot == SubGhzToolkitFunctionSlotEncoderAlloc && protocol->encoder)
+                subghz_toolkit_writer_cstr(report, "\nENCODER FUNCTIONS:\n==================\n");
+            firmware_analyzer_write_function(report, memory, cache, protocols, i, slot, result);
+        }
+
+        subghz_toolkit_protocol_scan_timing(
+            protocol->functions, cache, subghz_toolkit_memory_code_at, (void *)memory, (uint16_t)i, &scans[i]);
+        subghz_toolkit_protocol_write_timing(report, protocol->name, protocol->type, &scans[i]);
+        if (scans[i].found)
+            result->timing_blocks++;
+
+        subghz_toolkit_protocol_write_c_header(headers, protocol->name, protocol->type, protocol->flag);
+        subghz_toolkit_writer_cstr(headers, "\n");
+
+        subghz_toolkit_snapshot_add_protocol(snapshot, protocol->name, protocol->type, protocol->flag, protocol->functions,
+                                             cache, subghz_toolkit_memory_code_at, (void *)memory, (uint16_t)i);
+    }
+
+    subghz_toolkit_writer_cstr(report, "\n=== TIMING TABLE ===\nname,te_short,te_long,te_delta,min_count_bit\n");
+    for (uint32_t i = 0; i < result->protocol_count; i++)
+    {
+        if (!scans[i].found)
+        {
+            subghz_toolkit_writer_printf(report, "%s,,,,\n", protocols[i].name);
+            continue;
+        }
+        subghz_toolkit_writer_printf(report, "%s,%u,%u,%u,%u\n",
+                                     protocols[i].name,
+                                     scans[i].block.te_short,
+                                     scans[i].block.te_long,
+                                     scans[i].block.te_delta,
+                                     scans[i].block.min_count_bit);
+    }
+
+    free(scans);
+    subghz_toolkit_function_cache_free(cache);
+}
+
+static bool firmware_analyzer_map_image(
+    const uint8_t *data, size_t size, const FirmwareAnalyzerOptions *options, SubGhzToolkitMemory *memory, uint32_t *registry)
+{
+    subghz_toolkit_memory_init(memory);
+    *registry = options->registry;
+
+    SubGhzToolkitElf elf;
+    if (subghz_toolkit_elf_open(&elf, data, size))
+    {
+        if (!subghz_toolkit_elf_map(&elf, memory))
+            return false;
+        if (!*registry)
+            subghz_toolkit_elf_find_symbol(&elf, "subghz_protocol_registry", registry);
+    }
+    else if (size > UINT32_MAX - options->base ||
+             !subghz_toolkit_memory_add_region(memory, options->base, data, (uint32_t)size))
+    {
+        return false;
+    }
+
+    if (!*registry)
+        *registry = subghz_toolkit_protocol_registry_locate(memory);
+    return *registry != 0;
+}
+
+// File name of `path` without directory and extension, `length` characters long
+static const char *firmware_analyzer_stem(const char *path, int *length)
+{
+    const char *name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+    const char *dot = strrchr(name, '.');
+    *length = dot && dot != name ? (int)(dot - name) : (int)strlen(name);
+    return name;
+}
+
+// Output file for `path` with its directory and extension replaced: <dir>/<stem><suffix>
+static void firmware_analyzer_output_path(char *out, size_t out_size, const char *dir, const char *path, const char *suffix)
+{
+    int length;
+    const char *stem = firmware_analyzer_stem(path, &length);
+    snprintf(out, out_size, "%s/%.*s%s", dir, length, stem, suffix);
+}
+
+static bool firmware_analyzer_analyze(const char *path, const FirmwareAnalyzerOptions *options)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        perror(path);
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+
+    // Read only and private: the analysis never writes, pages load as they are touched
+    size_t size = st.st_size;
+    const uint8_t *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        perror(path);
+        return false;
+    }
+
+    bool success = false;
+    double start = firmware_analyzer_now();
+    SubGhzToolkitMemory memory;
+    FirmwareAnalyzerResult result = {0};
+    uint32_t items = 0;
+    SubGhzToolkitProtocolInfo *protocols = NULL;
+
+    do
+    {
+        if (!firmware_analyzer_map_image(data, size, options, &memory, &result.registry) ||
+            !subghz_toolkit_protocol_registry_read(&memory, result.registry, &items, &result.protocol_count))
+        {
+            fprintf(stderr, "%s: no protocol registry found\n", path);
+            break;
+        }
+
+        protocols = malloc(result.protocol_count * sizeof(SubGhzToolkitProtocolInfo));
+        for (uint32_t i = 0; i < result.protocol_count; i++)
+        {
+            uint32_t protocol = 0;
+            subghz_toolkit_memory_read_u32(&memory, items + i * 4, &protocol);
+            subghz_toolkit_protocol_read(&memory, protocol, &protocols[i]);
+        }
+
+        char report_path[1024];
+        char headers_path[1024];
+        char snapshot_path[1024];
+        if (options->output_dir)
+        {
+            firmware_analyzer_output_path(report_path, sizeof(report_path), options->output_dir, path, "_analysis.txt");
+            firmware_analyzer_output_path(headers_path, sizeof(headers_path), options->output_dir, path, "_headers.h");
+            firmware_analyzer_output_path(snapshot_path, sizeof(snapshot_path), options->output_dir, path, ".snap");
+        }
+
+        FILE *report_file;
+        FILE *headers_file;
+        SubGhzToolkitWriter *report = firmware_analyzer_writer_open(options->output_dir ? report_path : NULL, &report_file);
+        if (!report)
+            break;
+        SubGhzToolkitWriter *headers = firmware_analyzer_writer_open(options->output_dir ? headers_path : NULL, &headers_file);
+        if (!headers)
+        {
+            firmware_analyzer_writer_close(report, report_file);
+            break;
+        }
+
+        // Without -g the snapshot is keyed by the image name, "firmware" from firmware.elf
+        char stem[SUBGHZ_TOOLKIT_SNAPSHOT_GITHASH_SIZE + 1];
+        int stem_length;
+        const char *name = firmware_analyzer_stem(path, &stem_length);
+        snprintf(stem, sizeof(stem), "%.*s", stem_length, name);
+        SubGhzToolkitSnapshot *snapshot = subghz_toolkit_snapshot_alloc(options->githash ? options->githash : stem);
+
+        subghz_toolkit_writer_printf(report, "Image: %s\n", path);
+        firmware_analyzer_write_report(report, headers, &memory, protocols, snapshot, &result);
+
+        success = firmware_analyzer_writer_close(report, report_file);
+        success = firmware_analyzer_writer_close(headers, headers_file) && success;
+
+        if (options->output_dir)
+        {
+            FILE *snapshot_file;
+            SubGhzToolkitWriter *writer = firmware_analyzer_writer_open(snapshot_path, &snapshot_file);
+            if (writer)
+            {
+                subghz_toolkit_snapshot_save(snapshot, writer);
+                success = firmware_analyzer_writer_close(writer, snapshot_file) && success;
+            }
+            else
+            {
+                success = false;
+            }
+        }
+        subghz_toolkit_snapshot_free(snapshot);
+        if (!success)
+            fprintf(stderr, "%s: failed to write output\n", path);
+    } while (0);
+
+    if (result.protocol_count)
+        printf("%s: registry 0x%08lX, %lu protocols, %zu functions, %zu timing blocks, %.1f ms\n",
+               path,
+               (unsigned long)result.registry,
+               (unsigned long)result.protocol_count,
+               result.functions,
+               result.timing_blocks,
+               (firmware_analyzer_now() - start) * 1e3);
+
+    free(protocols);
+    munmap((void *)data, size);
+    return success;
+}
+
+static void firmware_analyzer_usage(void)
+{
+    fprintf(stderr, "Usage: firmware_analyzer [-o out_dir] [-b base] [-r registry] [-g githash] <firmware.elf|firmware.bin>...\n");
+}
+
+int main(int argc, char **argv)
+{
+    FirmwareAnalyzerOptions options = {.base = FIRMWARE_ANALYZER_FLASH_START};
+    size_t images = 0;
+    size_t failed = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            options.output_dir = argv[++i];
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+            options.base = strtoul(argv[++i], NULL, 16);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            options.registry = strtoul(argv[++i], NULL, 16);
+        else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+            options.githash = argv[++i];
+        else
+        {
+            images++;
+            failed += !firmware_analyzer_analyze(argv[i], &options);
+        }
+    }
+
+    if (!images)
+    {
+        firmware_analyzer_usage();
+        return 1;
+    }
+
+    return failed ? 1 : 0;
+}
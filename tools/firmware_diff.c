@@ -0,0 +1,73 @@
+// Host firmware snapshot diff
+// Compares two protocol snapshots (see helpers/subghz_toolkit_snapshot.h): the
+// .snap files the app keeps in /ext/subghz/analysis/snapshots/ or the ones
+// tools/firmware_analyzer.c writes next to its reports. Prints the protocols
+// added, removed and changed from the first to the second, down to the
+// functions whose code changed.
+//
+// Build: cc -O2 -I. -o firmware_diff tools/firmware_diff.c helpers/subghz_toolkit_snapshot.c helpers/subghz_toolkit_protocol.c helpers/subghz_toolkit_function.c helpers/subghz_toolkit_thumb.c helpers/subghz_toolkit_timing.c helpers/subghz_toolkit_memory.c helpers/subghz_toolkit_name_index.c helpers/subghz_toolkit_writer.c
+// Usage: ./firmware_diff old.snap new.snap
+//
+// Exit status is 0 when the snapshots match, 1 when they differ, 2 on error.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "helpers/subghz_toolkit_snapshot.h"
+
+static size_t firmware_diff_file_write(void *context, const uint8_t *data, size_t size)
+{
+    return fwrite(data, 1, size, context);
+}
+
+static SubGhzToolkitSnapshot *firmware_diff_load(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    SubGhzToolkitSnapshot *snapshot = NULL;
+    uint8_t *data = malloc(size > 0 ? size : 1);
+    if (size > 0 && fread(data, 1, size, file) == (size_t)size)
+        snapshot = subghz_toolkit_snapshot_load(data, size);
+    free(data);
+    fclose(file);
+
+    if (!snapshot)
+        fprintf(stderr, "%s: not a snapshot file\n", path);
+    return snapshot;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: firmware_diff old.snap new.snap\n");
+        return 2;
+    }
+
+    SubGhzToolkitSnapshot *old = firmware_diff_load(argv[1]);
+    SubGhzToolkitSnapshot *new = old ? firmware_diff_load(argv[2]) : NULL;
+    if (!new)
+    {
+        if (old)
+            subghz_toolkit_snapshot_free(old);
+        return 2;
+    }
+
+    SubGhzToolkitSnapshotDiff diff;
+    SubGhzToolkitWriter *writer = subghz_toolkit_writer_alloc(firmware_diff_file_write, stdout);
+    subghz_toolkit_snapshot_diff(old, new, writer, &diff);
+    subghz_toolkit_writer_free(writer);
+
+    subghz_toolkit_snapshot_free(old);
+    subghz_toolkit_snapshot_free(new);
+    return diff.added || diff.removed || diff.changed ? 1 : 0;
+}
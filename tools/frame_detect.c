@@ -0,0 +1,163 @@
+// Host frame detector
+// Finds the repeated frame of RAW .sub captures with helpers/subghz_toolkit_frames.h:
+// te is estimated from a first pass over the pulses (helpers/subghz_toolkit_clusters.h),
+// a second pass quantizes them to te and reports the period, preamble, sync
+// and the canonical frame with its unstable bits, as the app does after a capture.
+//
+// Build: cc -O2 -I. -o frame_detect tools/frame_detect.c helpers/subghz_toolkit_frames.c helpers/subghz_toolkit_clusters.c helpers/subghz_toolkit_raw.c helpers/subghz_toolkit_writer.c
+// Usage: ./frame_detect capture.sub...
+//        ./frame_detect --bench [pulses]
+//
+// --bench feeds a synthetic PWM remote (te 400 us, preamble, 24 bit key with
+// a changing low nibble, +-10% jitter) and reports the time per pulse, which
+// stays flat as the pulse count grows.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "helpers/subghz_toolkit_clusters.h"
+#include "helpers/subghz_toolkit_frames.h"
+#include "helpers/subghz_toolkit_raw.h"
+
+#define FRAME_DETECT_BENCH_TE 400
+#define FRAME_DETECT_BENCH_PULSES 1000000u
+#define FRAME_DETECT_BENCH_KEY 0xA5C3E0u
+
+static double frame_detect_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static size_t frame_detect_file_write(void *context, const uint8_t *data, size_t size)
+{
+    return fwrite(data, 1, size, context);
+}
+
+static uint32_t frame_detect_jitter(uint32_t *state, uint32_t duration)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return duration - duration / 10 + (*state >> 16) % (duration / 5 + 1);
+}
+
+static int frame_detect_bench(uint32_t pulse_count)
+{
+    uint32_t *durations = malloc(pulse_count * sizeof(uint32_t));
+    uint32_t state = 0x12345678;
+    uint32_t pulses = 0;
+
+    // Frames of 8 preamble cycles, a 4 te sync low, 24 key bits, a stop pulse and a 30 te gap
+    for (uint32_t frame = 0; pulses < pulse_count; frame++)
+    {
+        uint32_t key = FRAME_DETECT_BENCH_KEY | (frame / 4 % 16);
+        uint32_t sequence[2 * (8 + 1 + 24 + 1)];
+        uint32_t count = 0;
+
+        for (int i = 0; i < 8; i++)
+        {
+            sequence[count++] = 1;
+            sequence[count++] = 1;
+        }
+        sequence[count++] = 1;
+        sequence[count++] = 4;
+        for (int bit = 23; bit >= 0; bit--)
+        {
+            sequence[count++] = (key >> bit) & 1 ? 3 : 1;
+            sequence[count++] = (key >> bit) & 1 ? 1 : 3;
+        }
+        sequence[count++] = 1;
+        sequence[count++] = 30;
+        for (uint32_t i = 0; i < count && pulses < pulse_count; i++)
+            durations[pulses++] = frame_detect_jitter(&state, sequence[i] * FRAME_DETECT_BENCH_TE);
+    }
+
+    SubGhzToolkitFrames *frames = subghz_toolkit_frames_alloc(SUBGHZ_TOOLKIT_FRAMES_MAX_PERIOD);
+    SubGhzToolkitFramesResult result;
+    subghz_toolkit_frames_reset(frames, FRAME_DETECT_BENCH_TE);
+    subghz_toolkit_frames_add_pulse(frames, false, 0x7FFF);
+
+    double start = frame_detect_now_ms();
+    for (uint32_t i = 0; i < pulse_count; i++)
+        subghz_toolkit_frames_add_pulse(frames, !(i & 1), durations[i]);
+    double add_ms = frame_detect_now_ms() - start;
+
+    start = frame_detect_now_ms();
+    subghz_toolkit_frames_analyze(frames, &result);
+    double analyze_ms = frame_detect_now_ms() - start;
+
+    printf("%u pulses, %llu bits: %.1f ns/pulse, analyze in %.3f ms\n",
+           pulse_count, (unsigned long long)subghz_toolkit_frames_bit_count(frames), add_ms * 1e6 / pulse_count, analyze_ms);
+    SubGhzToolkitWriter *out = subghz_toolkit_writer_alloc(frame_detect_file_write, stdout);
+    subghz_toolkit_frames_write_report(out, frames, &result);
+    subghz_toolkit_writer_free(out);
+
+    subghz_toolkit_frames_free(frames);
+    free(durations);
+    return result.period ? 0 : 1;
+}
+
+// Feeds every pulse of `path` to `callback`, false if it could not be opened
+static bool frame_detect_read(const char *path, SubGhzToolkitRawPulseCallback callback, void *context)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        perror(path);
+        return false;
+    }
+
+    SubGhzToolkitRawParser parser;
+    char buffer[4096];
+    size_t size;
+
+    subghz_toolkit_raw_parser_init(&parser);
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        subghz_toolkit_raw_parser_feed(&parser, buffer, size, callback, context);
+    subghz_toolkit_raw_parser_finish(&parser, callback, context);
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0)
+        return frame_detect_bench(argc >= 3 ? (uint32_t)strtoul(argv[2], NULL, 10) : FRAME_DETECT_BENCH_PULSES);
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: frame_detect capture.sub...\n       frame_detect --bench [pulses]\n");
+        return 1;
+    }
+
+    SubGhzToolkitWriter *out = subghz_toolkit_writer_alloc(frame_detect_file_write, stdout);
+    SubGhzToolkitFrames *frames = subghz_toolkit_frames_alloc(SUBGHZ_TOOLKIT_FRAMES_MAX_PERIOD);
+    int status = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        static SubGhzToolkitClusters clusters;
+        SubGhzToolkitClustersEstimate estimate;
+        SubGhzToolkitFramesResult result;
+
+        subghz_toolkit_clusters_init(&clusters);
+        if (!frame_detect_read(argv[i], subghz_toolkit_clusters_feed, &clusters))
+        {
+            status = 1;
+            continue;
+        }
+        subghz_toolkit_clusters_estimate(&clusters, &estimate);
+        subghz_toolkit_frames_reset(frames, estimate.te);
+        frame_detect_read(argv[i], subghz_toolkit_frames_feed, frames);
+        subghz_toolkit_frames_analyze(frames, &result);
+
+        subghz_toolkit_writer_printf(out, "=== %s === te %lu us\n", argv[i], (unsigned long)estimate.te);
+        subghz_toolkit_frames_write_report(out, frames, &result);
+        subghz_toolkit_writer_cstr(out, "\n");
+    }
+
+    subghz_toolkit_frames_free(frames);
+    subghz_toolkit_writer_free(out);
+    return status;
+}
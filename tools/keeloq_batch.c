@@ -0,0 +1,596 @@
+// Host KeeLoq batch triage
+// Searches many captured KeeLoq packets against a keystore export
+// (keeloq_keys.bin or keeloq_keys.csv) on every core and writes one CSV
+// result row per remote, joined to the manufacturer names of the export.
+//
+// Build: cc -O3 -march=native -pthread -I. -o keeloq_batch tools/keeloq_batch.c helpers/subghz_toolkit_keeloq.c helpers/subghz_toolkit_keyfile.c helpers/subghz_toolkit_writer.c
+// Usage: ./keeloq_batch <keys.bin|keys.csv> <capture.sub|captures.csv>... [-j threads] [--stored-type] [-o results.csv]
+//        ./keeloq_batch --bench [remotes] [keys] [max_threads]
+//
+// captures.csv lines are "label,key_hex[,seed_hex]" with the .sub "Key:" value.
+// Packets with the same serial are one remote: the extra packets confirm a
+// match, so a remote with several packets gets no false positives.
+//
+// Work is split into (remote, key chunk) tasks, each trying every learning
+// type. Each thread owns a range of tasks and steals half of another
+// thread's remaining range when its own runs dry. A remote stops at its
+// first match in key order: once a chunk finds one, later chunks of that
+// remote are skipped, and the result is the same for any thread count.
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "helpers/subghz_toolkit_keeloq.h"
+#include "helpers/subghz_toolkit_keyfile.h"
+
+#define KEELOQ_BATCH_CHUNK 1024
+#define KEELOQ_BATCH_MAX_PACKETS 8
+#define KEELOQ_BATCH_NO_MATCH UINT64_MAX
+
+typedef struct
+{
+    char label[64];
+    SubGhzToolkitKeeloqCapture packets[KEELOQ_BATCH_MAX_PACKETS];
+    size_t packet_count;
+    _Atomic uint64_t best; // key_index << 8 | learning of the first match, KEELOQ_BATCH_NO_MATCH if none
+} KeeloqBatchRemote;
+
+// Remaining tasks [lo, hi) of one thread, packed for a single CAS
+typedef struct
+{
+    _Atomic uint64_t range;
+    char pad[56]; // one cache line per thread
+} KeeloqBatchDeque;
+
+typedef struct
+{
+    const uint64_t *keys;
+    const uint16_t *types;
+    size_t key_count;
+    size_t chunk_count;
+    KeeloqBatchRemote *remotes;
+    size_t remote_count;
+    KeeloqBatchDeque *deques;
+    size_t thread_count;
+} KeeloqBatch;
+
+typedef struct
+{
+    KeeloqBatch *batch;
+    size_t id;
+    size_t tasks;
+    size_t skipped;
+    size_t steals;
+} KeeloqBatchWorker;
+
+typedef struct
+{
+    KeeloqBatch *batch;
+    KeeloqBatchRemote *remote;
+    size_t base;
+} KeeloqBatchMatch;
+
+static double keeloq_batch_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t keeloq_batch_pack(uint32_t lo, uint32_t hi)
+{
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static bool keeloq_batch_pop(KeeloqBatchDeque *deque, uint32_t *task)
+{
+    uint64_t range = atomic_load(&deque->range);
+    for (;;)
+    {
+        uint32_t lo = (uint32_t)range;
+        uint32_t hi = (uint32_t)(range >> 32);
+        if (lo >= hi)
+            return false;
+        if (atomic_compare_exchange_weak(&deque->range, &range, keeloq_batch_pack(lo + 1, hi)))
+        {
+            *task = lo;
+            return true;
+        }
+    }
+}
+
+// Take the upper half of the victim's range into our (empty) deque
+static bool keeloq_batch_steal(KeeloqBatchDeque *victim, KeeloqBatchDeque *self)
+{
+    uint64_t range = atomic_load(&victim->range);
+    for (;;)
+    {
+        uint32_t lo = (uint32_t)range;
+        uint32_t hi = (uint32_t)(range >> 32);
+        if (lo >= hi)
+            return false;
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (atomic_compare_exchange_weak(&victim->range, &range, keeloq_batch_pack(lo, mid)))
+        {
+            atomic_store(&self->range, keeloq_batch_pack(mid, hi));
+            return true;
+        }
+    }
+}
+
+static void keeloq_batch_match(void *context, size_t key_index, SubGhzToolkitKeeloqLearning learning, uint32_t decrypt)
+{
+    (void)decrypt;
+    KeeloqBatchMatch *match = context;
+    KeeloqBatchRemote *remote = match->remote;
+    size_t index = match->base + key_index;
+
+    for (size_t i = 1; i < remote->packet_count; i++)
+    {
+        const SubGhzToolkitKeeloqCapture *packet = &remote->packets[i];
+        uint64_t device_key = subghz_toolkit_keeloq_learn(learning, packet, match->batch->keys[index]);
+        if (!subghz_toolkit_keeloq_check(packet, subghz_toolkit_keeloq_decrypt(packet->hop, device_key)))
+            return;
+    }
+
+    uint64_t found = ((uint64_t)index << 8) | learning;
+    uint64_t best = atomic_load(&remote->best);
+    while (found < best && !atomic_compare_exchange_weak(&remote->best, &best, found))
+    {
+    }
+}
+
+static void keeloq_batch_run_task(KeeloqBatchWorker *worker, uint32_t task)
+{
+    KeeloqBatch *batch = worker->batch;
+    KeeloqBatchRemote *remote = &batch->remotes[task / batch->chunk_count];
+    size_t base = (size_t)(task % batch->chunk_count) * KEELOQ_BATCH_CHUNK;
+
+    // Early stop: a match below this chunk already wins
+    if ((atomic_load(&remote->best) >> 8) < base)
+    {
+        worker->skipped++;
+        return;
+    }
+
+    size_t count = batch->key_count - base < KEELOQ_BATCH_CHUNK ? batch->key_count - base : KEELOQ_BATCH_CHUNK;
+    KeeloqBatchMatch match = {.batch = batch, .remote = remote, .base = base};
+    subghz_toolkit_keeloq_search(
+        &remote->packets[0],
+        batch->keys + base,
+        batch->types ? batch->types + base : NULL,
+        count,
+        SUBGHZ_TOOLKIT_KEELOQ_LEARNING_ALL,
+        keeloq_batch_match,
+        &match);
+    worker->tasks++;
+}
+
+static void *keeloq_batch_thread(void *context)
+{
+    KeeloqBatchWorker *worker = context;
+    KeeloqBatch *batch = worker->batch;
+    KeeloqBatchDeque *self = &batch->deques[worker->id];
+    uint32_t task;
+
+    for (;;)
+    {
+        while (keeloq_batch_pop(self, &task))
+            keeloq_batch_run_task(worker, task);
+
+        // Own range is empty: try every other thread once, starting with the next one
+        bool stolen = false;
+        for (size_t i = 1; i < batch->thread_count && !stolen; i++)
+            stolen = keeloq_batch_steal(&batch->deques[(worker->id + i) % batch->thread_count], self);
+        if (!stolen)
+            break;
+        worker->steals++;
+    }
+    return NULL;
+}
+
+static double keeloq_batch_run(KeeloqBatch *batch, size_t thread_count, bool verbose)
+{
+    size_t task_count = batch->remote_count * batch->chunk_count;
+    KeeloqBatchWorker *workers = calloc(thread_count, sizeof(KeeloqBatchWorker));
+    pthread_t *threads = calloc(thread_count, sizeof(pthread_t));
+
+    batch->thread_count = thread_count;
+    batch->deques = aligned_alloc(64, thread_count * sizeof(KeeloqBatchDeque));
+    for (size_t i = 0; i < batch->remote_count; i++)
+        atomic_store(&batch->remotes[i].best, KEELOQ_BATCH_NO_MATCH);
+
+    // Remote major order: a thread's own range covers whole remotes, so its
+    // early stops save its own work, and steals take the tail of a remote
+    for (size_t i = 0; i < thread_count; i++)
+    {
+        uint32_t lo = (uint32_t)(task_count * i / thread_count);
+        uint32_t hi = (uint32_t)(task_count * (i + 1) / thread_count);
+        atomic_store(&batch->deques[i].range, keeloq_batch_pack(lo, hi));
+        workers[i] = (KeeloqBatchWorker){.batch = batch, .id = i};
+    }
+
+    double start = keeloq_batch_now();
+    for (size_t i = 0; i < thread_count; i++)
+        pthread_create(&threads[i], NULL, keeloq_batch_thread, &workers[i]);
+    for (size_t i = 0; i < thread_count; i++)
+        pthread_join(threads[i], NULL);
+    double seconds = keeloq_batch_now() - start;
+
+    if (verbose)
+    {
+        for (size_t i = 0; i < thread_count; i++)
+            fprintf(stderr, "thread %2zu: %6zu tasks %6zu skipped %4zu steals\n",
+                    i, workers[i].tasks, workers[i].skipped, workers[i].steals);
+    }
+
+    free(batch->deques);
+    free(threads);
+    free(workers);
+    return seconds;
+}
+
+static void *keeloq_batch_read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *data = malloc(length > 0 ? length + 1 : 1);
+    *size = fread(data, 1, length > 0 ? length : 0, file);
+    data[*size] = '\0';
+    fclose(file);
+    return data;
+}
+
+// "AA BB CC" hex bytes, as flipper_format writes them
+static uint64_t keeloq_batch_parse_bytes(const char *text)
+{
+    uint64_t value = 0;
+    for (char *end; *text && *text != '\n';)
+    {
+        unsigned long byte = strtoul(text, &end, 16);
+        if (end == text)
+            break;
+        value = (value << 8) | (byte & 0xFF);
+        text = end;
+    }
+    return value;
+}
+
+static KeeloqBatchRemote *keeloq_batch_add_packet(
+    KeeloqBatchRemote **remotes, size_t *count, const char *label, uint64_t data, const uint32_t *seed)
+{
+    SubGhzToolkitKeeloqCapture packet = {0};
+    subghz_toolkit_keeloq_capture_from_data(&packet, data);
+    if (seed)
+    {
+        packet.seed = *seed;
+        packet.has_seed = true;
+    }
+
+    for (size_t i = 0; i < *count; i++)
+    {
+        KeeloqBatchRemote *remote = &(*remotes)[i];
+        if ((remote->packets[0].fix & 0x0FFFFFFF) == (packet.fix & 0x0FFFFFFF))
+        {
+            if (remote->packet_count < KEELOQ_BATCH_MAX_PACKETS)
+                remote->packets[remote->packet_count++] = packet;
+            return remote;
+        }
+    }
+
+    *remotes = realloc(*remotes, (*count + 1) * sizeof(KeeloqBatchRemote));
+    KeeloqBatchRemote *remote = &(*remotes)[(*count)++];
+    memset(remote, 0, sizeof(*remote));
+    snprintf(remote->label, sizeof(remote->label), "%s", label);
+    remote->packets[0] = packet;
+    remote->packet_count = 1;
+    return remote;
+}
+
+static bool keeloq_batch_load_captures(const char *path, KeeloqBatchRemote **remotes, size_t *count)
+{
+    size_t size;
+    char *text = keeloq_batch_read_file(path, &size);
+    if (!text)
+        return false;
+
+    bool loaded = false;
+    const char *extension = strrchr(path, '.');
+
+    if (extension && strcmp(extension, ".sub") == 0)
+    {
+        const char *protocol = strstr(text, "Protocol: ");
+        const char *key = strstr(text, "\nKey: ");
+        const char *seed_line = strstr(text, "\nSeed: ");
+
+        if (protocol && strncmp(protocol + 10, "KeeLoq", 6) == 0 && key)
+        {
+            uint32_t seed = seed_line ? (uint32_t)keeloq_batch_parse_bytes(seed_line + 7) : 0;
+            const char *name = strrchr(path, '/');
+            keeloq_batch_add_packet(
+                remotes, count, name ? name + 1 : path, keeloq_batch_parse_bytes(key + 6), seed_line ? &seed : NULL);
+            loaded = true;
+        }
+        else
+        {
+            fprintf(stderr, "%s: not a KeeLoq key file\n", path);
+        }
+    }
+    else
+    {
+        for (char *line = strtok(text, "\n"); line; line = strtok(NULL, "\n"))
+        {
+            char *comma = strchr(line, ',');
+            if (!comma || line[0] == '#')
+                continue;
+            *comma = '\0';
+
+            char *end;
+            uint64_t data = strtoull(comma + 1, &end, 16);
+            if (end == comma + 1)
+                continue; // header
+
+            uint32_t seed = 0;
+            bool has_seed = *end == ',';
+            if (has_seed)
+                seed = strtoul(end + 1, NULL, 16);
+            keeloq_batch_add_packet(remotes, count, line, data, has_seed ? &seed : NULL);
+            loaded = true;
+        }
+    }
+
+    free(text);
+    return loaded;
+}
+
+static void keeloq_batch_csv_field(FILE *out, const char *text)
+{
+    if (!strpbrk(text, ",\"\n"))
+    {
+        fputs(text, out);
+        return;
+    }
+
+    fputc('"', out);
+    for (; *text; text++)
+    {
+        if (*text == '"')
+            fputc('"', out);
+        fputc(*text, out);
+    }
+    fputc('"', out);
+}
+
+static void keeloq_batch_write_results(FILE *out, const KeeloqBatch *batch, const SubGhzToolkitKeyfileRecord *records)
+{
+    fprintf(out, "label,serial,button,packets,status,manufacturer,learning,key_hex,counter\n");
+
+    for (size_t i = 0; i < batch->remote_count; i++)
+    {
+        const KeeloqBatchRemote *remote = &batch->remotes[i];
+        const SubGhzToolkitKeeloqCapture *packet = &remote->packets[0];
+        uint64_t best = atomic_load(&remote->best);
+
+        keeloq_batch_csv_field(out, remote->label);
+        fprintf(out, ",%07X,%X,%zu,", packet->fix & 0x0FFFFFFF, packet->fix >> 28, remote->packet_count);
+        if (best == KEELOQ_BATCH_NO_MATCH)
+        {
+            fprintf(out, "not_found,,,,\n");
+            continue;
+        }
+
+        size_t index = (size_t)(best >> 8);
+        SubGhzToolkitKeeloqLearning learning = (SubGhzToolkitKeeloqLearning)(best & 0xFF);
+        uint64_t device_key = subghz_toolkit_keeloq_learn(learning, packet, batch->keys[index]);
+        uint32_t decrypt = subghz_toolkit_keeloq_decrypt(packet->hop, device_key);
+
+        fprintf(out, "%s,", remote->packet_count > 1 ? "confirmed" : "single_packet");
+        keeloq_batch_csv_field(out, records ? records[index].name : "");
+        fprintf(out, ",%s,%016llX,%u\n",
+                subghz_toolkit_keeloq_learning_name(learning),
+                (unsigned long long)batch->keys[index],
+                decrypt & 0xFFFF);
+    }
+}
+
+static uint64_t keeloq_batch_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Synthetic triage: every other remote has a planted key somewhere in the
+// keystore, the rest search everything. Runs 1, 2, 4 ... max_threads.
+static int keeloq_batch_bench(size_t remote_count, size_t key_count, size_t max_threads)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uint64_t *keys = malloc(key_count * sizeof(uint64_t));
+    for (size_t i = 0; i < key_count; i++)
+        keys[i] = keeloq_batch_random(&state);
+
+    KeeloqBatchRemote *remotes = calloc(remote_count, sizeof(KeeloqBatchRemote));
+    for (size_t i = 0; i < remote_count; i++)
+    {
+        KeeloqBatchRemote *remote = &remotes[i];
+        snprintf(remote->label, sizeof(remote->label), "remote_%zu", i);
+        uint32_t fix = (uint32_t)keeloq_batch_random(&state);
+        uint64_t man = keeloq_batch_random(&state);
+        if (i % 2 == 0)
+        {
+            SubGhzToolkitKeeloqCapture learn = {.fix = fix};
+            man = subghz_toolkit_keeloq_learn(
+                SubGhzToolkitKeeloqLearningNormal, &learn, keys[keeloq_batch_random(&state) % key_count]);
+        }
+        for (size_t p = 0; p < 2; p++)
+        {
+            uint32_t plain = (fix & 0xF0000000) | ((fix & 0xFF) << 16) | (uint32_t)(100 + p);
+            remote->packets[p] = (SubGhzToolkitKeeloqCapture){
+                .fix = fix,
+                .hop = subghz_toolkit_keeloq_encrypt(plain, man),
+            };
+        }
+        remote->packet_count = 2;
+    }
+
+    KeeloqBatch batch = {
+        .keys = keys,
+        .key_count = key_count,
+        .chunk_count = (key_count + KEELOQ_BATCH_CHUNK - 1) / KEELOQ_BATCH_CHUNK,
+        .remotes = remotes,
+        .remote_count = remote_count,
+    };
+
+    uint64_t *reference = malloc(remote_count * sizeof(uint64_t));
+    double base_seconds = 0;
+    bool same = true;
+
+    fprintf(stderr, "%zu remotes x %zu keys, %zu lanes, %ld cores\n",
+            remote_count, key_count, subghz_toolkit_keeloq_lanes(), sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(stderr, "threads  seconds  speedup  efficiency\n");
+
+    for (size_t threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads)
+    {
+        double seconds = keeloq_batch_run(&batch, threads, false);
+        if (threads == 1)
+            base_seconds = seconds;
+
+        for (size_t i = 0; i < remote_count; i++)
+        {
+            uint64_t best = atomic_load(&remotes[i].best);
+            if (threads == 1)
+                reference[i] = best;
+            same &= reference[i] == best;
+        }
+
+        fprintf(stderr, "%7zu %8.3f %8.2f %10.0f%%\n",
+                threads, seconds, base_seconds / seconds, 100.0 * base_seconds / seconds / threads);
+        if (threads >= max_threads)
+            break;
+    }
+
+    size_t found = 0;
+    for (size_t i = 0; i < remote_count; i++)
+        found += reference[i] != KEELOQ_BATCH_NO_MATCH;
+    fprintf(stderr, "%zu / %zu remotes matched, results %s across thread counts\n",
+            found, remote_count, same ? "identical" : "DIFFER");
+
+    free(reference);
+    free(remotes);
+    free(keys);
+    return same ? 0 : 1;
+}
+
+static void keeloq_batch_usage(void)
+{
+    fprintf(stderr,
+            "Usage: keeloq_batch <keys.bin|keys.csv> <capture.sub|captures.csv>... [-j threads] [--stored-type] [-o results.csv]\n"
+            "       keeloq_batch --bench [remotes] [keys] [max_threads]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        return keeloq_batch_bench(
+            argc > 2 ? strtoul(argv[2], NULL, 0) : 64,
+            argc > 3 ? strtoul(argv[3], NULL, 0) : 16384,
+            argc > 4 ? strtoul(argv[4], NULL, 0) : (size_t)sysconf(_SC_NPROCESSORS_ONLN));
+
+    if (argc < 3)
+    {
+        keeloq_batch_usage();
+        return 1;
+    }
+
+    size_t thread_count = (size_t)sysconf(_SC_NPROCESSORS_ONLN);
+    bool stored_type = false;
+    const char *output = NULL;
+    KeeloqBatchRemote *remotes = NULL;
+    size_t remote_count = 0;
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+            thread_count = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (strcmp(argv[i], "--stored-type") == 0)
+            stored_type = true;
+        else if (!keeloq_batch_load_captures(argv[i], &remotes, &remote_count))
+            fprintf(stderr, "%s: skipped\n", argv[i]);
+    }
+
+    if (!remote_count || !thread_count)
+    {
+        keeloq_batch_usage();
+        return 1;
+    }
+
+    size_t size = 0;
+    void *data = keeloq_batch_read_file(argv[1], &size);
+    SubGhzToolkitKeyfileRecord *records = NULL;
+    uint32_t count = 0;
+    if (!data || !subghz_toolkit_keyfile_load(data, size, &records, &count))
+    {
+        fprintf(stderr, "%s: not a key export\n", argv[1]);
+        free(data);
+        return 1;
+    }
+    free(data);
+
+    uint64_t *keys = malloc(count * sizeof(uint64_t));
+    uint16_t *types = malloc(count * sizeof(uint16_t));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        keys[i] = records[i].key;
+        types[i] = records[i].type;
+    }
+
+    KeeloqBatch batch = {
+        .keys = keys,
+        .types = stored_type ? types : NULL,
+        .key_count = count,
+        .chunk_count = (count + KEELOQ_BATCH_CHUNK - 1) / KEELOQ_BATCH_CHUNK,
+        .remotes = remotes,
+        .remote_count = remote_count,
+    };
+
+    double seconds = keeloq_batch_run(&batch, thread_count, true);
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (!out)
+    {
+        perror(output);
+        return 1;
+    }
+    keeloq_batch_write_results(out, &batch, records);
+    if (output)
+        fclose(out);
+
+    size_t found = 0;
+    for (size_t i = 0; i < remote_count; i++)
+        found += atomic_load(&remotes[i].best) != KEELOQ_BATCH_NO_MATCH;
+    fprintf(stderr, "%zu remotes x %u keys on %zu threads: %zu matched in %.1f ms\n",
+            remote_count, count, thread_count, found, seconds * 1e3);
+
+    free(keys);
+    free(types);
+    free(records);
+    free(remotes);
+    return 0;
+}
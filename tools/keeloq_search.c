@@ -0,0 +1,300 @@
+// Host KeeLoq manufacturer key search
+// Tries every key of an exported keystore (keeloq_keys.bin or keeloq_keys.csv
+// from "Export Keeloq Binary/CSV") under each learning type against a captured
+// packet and prints the manufacturers whose key decrypts it.
+//
+// Build:   cc -O3 -march=native -I. -o keeloq_search tools/keeloq_search.c helpers/subghz_toolkit_keeloq.c helpers/subghz_toolkit_keyfile.c helpers/subghz_toolkit_writer.c
+//          (-march=native picks the 256 lane AVX2 core where available, otherwise 64 lanes)
+// Usage:   ./keeloq_search <keys.bin|keys.csv> --key <hex> [--key <hex> ...] [--seed <hex>] [--stored-type] [--scalar]
+//          ./keeloq_search <keys.bin|keys.csv> --fix <hex> --hop <hex> [...]
+//          ./keeloq_search --bench [keys]
+//
+// --key takes the "Key:" value of a .sub file. Extra --key packets from the
+// same remote must also decrypt under a match, which weeds out the 1 in 2^11
+// false positives a single packet allows.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "helpers/subghz_toolkit_keeloq.h"
+#include "helpers/subghz_toolkit_keyfile.h"
+
+#define KEELOQ_SEARCH_MAX_CAPTURES 8
+
+typedef struct
+{
+    const SubGhzToolkitKeyfileRecord *records;
+    const uint64_t *keys;
+    const SubGhzToolkitKeeloqCapture *captures;
+    size_t capture_count;
+    size_t matches;
+} KeeloqSearch;
+
+static double keeloq_search_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *keeloq_search_read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    void *data = malloc(length > 0 ? length : 1);
+    *size = fread(data, 1, length > 0 ? length : 0, file);
+    fclose(file);
+    return data;
+}
+
+// Decrypts passing the check for the first packet are confirmed on the others
+static void keeloq_search_match(void *context, size_t key_index, SubGhzToolkitKeeloqLearning learning, uint32_t decrypt)
+{
+    KeeloqSearch *search = context;
+
+    for (size_t i = 1; i < search->capture_count; i++)
+    {
+        const SubGhzToolkitKeeloqCapture *capture = &search->captures[i];
+        uint64_t device_key = subghz_toolkit_keeloq_learn(learning, capture, search->keys[key_index]);
+        if (!subghz_toolkit_keeloq_check(capture, subghz_toolkit_keeloq_decrypt(capture->hop, device_key)))
+            return;
+    }
+
+    const SubGhzToolkitKeyfileRecord *record = &search->records[key_index];
+    if (search->matches++ == 0)
+        printf("%-22s %-20s %-16s %-8s %s\n", "Manufacturer", "Learning", "Key", "Decrypt", "Counter");
+    printf("%-22s %-20s %016llX %08X %u\n",
+           record->name,
+           subghz_toolkit_keeloq_learning_name(learning),
+           (unsigned long long)record->key,
+           decrypt,
+           decrypt & 0xFFFF);
+}
+
+// Cipher runs needed per key under a learning type: the hop decrypt plus learning
+static size_t keeloq_search_ciphers(uint32_t learning_mask)
+{
+    size_t ciphers = 0;
+    for (uint32_t l = 1; l < SubGhzToolkitKeeloqLearningCount; l++)
+    {
+        if (!(learning_mask & SUBGHZ_TOOLKIT_KEELOQ_LEARNING_BIT(l)))
+            continue;
+        bool derived = l == SubGhzToolkitKeeloqLearningNormal || l == SubGhzToolkitKeeloqLearningSecure ||
+                       l == SubGhzToolkitKeeloqLearningFaac;
+        ciphers += derived ? 3 : 1;
+    }
+    return ciphers;
+}
+
+static void keeloq_search_report(const char *name, size_t decrypts, double seconds, double baseline)
+{
+    double rate = seconds > 0 ? decrypts / seconds : 0.0;
+    printf("%-28s %10zu decrypts %8.3f s %12.0f decrypts/s", name, decrypts, seconds, rate);
+    if (baseline > 0)
+        printf(" %6.1fx", rate / baseline);
+    printf("\n");
+}
+
+static int keeloq_search_bench(size_t count)
+{
+    uint64_t *keys = malloc(count * sizeof(uint64_t));
+    uint32_t *out = malloc(count * sizeof(uint32_t));
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < count; i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        keys[i] = state;
+    }
+
+    printf("%zu keys, bitsliced core: %zu lanes\n", count, subghz_toolkit_keeloq_lanes());
+
+    double start = keeloq_search_now();
+    uint32_t scalar_sum = 0;
+    for (size_t i = 0; i < count; i++)
+        scalar_sum += subghz_toolkit_keeloq_decrypt(0x12345678, keys[i]);
+    double scalar_seconds = keeloq_search_now() - start;
+    double scalar_rate = count / scalar_seconds;
+    keeloq_search_report("scalar decrypt", count, scalar_seconds, 0);
+
+    start = keeloq_search_now();
+    subghz_toolkit_keeloq_decrypt_batch(0x12345678, keys, count, out);
+    keeloq_search_report("bitsliced decrypt", count, keeloq_search_now() - start, scalar_rate);
+
+    uint32_t batch_sum = 0;
+    for (size_t i = 0; i < count; i++)
+        batch_sum += out[i];
+
+    // Full search without a seed: Simple, Normal, Magic XOR and the Magic Serial types
+    SubGhzToolkitKeeloqCapture capture = {.fix = 0x2ABCDEF1, .hop = 0x87654321};
+    uint32_t learning = subghz_toolkit_keeloq_learning_usable(&capture, SUBGHZ_TOOLKIT_KEELOQ_LEARNING_ALL);
+    size_t ciphers = count * keeloq_search_ciphers(learning);
+
+    start = keeloq_search_now();
+    size_t scalar_matches =
+        subghz_toolkit_keeloq_search_scalar(&capture, keys, NULL, count, learning, NULL, NULL);
+    double search_seconds = keeloq_search_now() - start;
+    keeloq_search_report("scalar search", ciphers, search_seconds, 0);
+
+    start = keeloq_search_now();
+    size_t matches = subghz_toolkit_keeloq_search(&capture, keys, NULL, count, learning, NULL, NULL);
+    keeloq_search_report("bitsliced search", ciphers, keeloq_search_now() - start, ciphers / search_seconds);
+
+    bool same = batch_sum == scalar_sum && matches == scalar_matches;
+    printf("matches %zu / %zu, results %s\n", matches, scalar_matches, same ? "identical" : "DIFFER");
+
+    free(keys);
+    free(out);
+    return same ? 0 : 1;
+}
+
+static void keeloq_search_usage(void)
+{
+    fprintf(stderr,
+            "Usage: keeloq_search <keys.bin|keys.csv> --key <hex> [--key <hex> ...] [--seed <hex>] [--stored-type] [--scalar]\n"
+            "       keeloq_search <keys.bin|keys.csv> --fix <hex> --hop <hex> [--seed <hex>] [--stored-type] [--scalar]\n"
+            "       keeloq_search --bench [keys]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        return keeloq_search_bench(argc > 2 ? strtoul(argv[2], NULL, 0) : 1u << 16);
+
+    if (argc < 3)
+    {
+        keeloq_search_usage();
+        return 1;
+    }
+
+    SubGhzToolkitKeeloqCapture captures[KEELOQ_SEARCH_MAX_CAPTURES] = {0};
+    size_t capture_count = 0;
+    bool has_fix = false;
+    bool has_hop = false;
+    bool stored_type = false;
+    bool scalar = false;
+    uint32_t seed = 0;
+    bool has_seed = false;
+
+    for (int i = 2; i < argc; i++)
+    {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "--key") == 0 && value && capture_count < KEELOQ_SEARCH_MAX_CAPTURES)
+        {
+            subghz_toolkit_keeloq_capture_from_data(&captures[capture_count++], strtoull(value, NULL, 16));
+            i++;
+        }
+        else if (strcmp(argv[i], "--fix") == 0 && value)
+        {
+            captures[0].fix = strtoul(value, NULL, 16);
+            has_fix = true;
+            i++;
+        }
+        else if (strcmp(argv[i], "--hop") == 0 && value)
+        {
+            captures[0].hop = strtoul(value, NULL, 16);
+            capture_count = capture_count ? capture_count : 1;
+            has_hop = true;
+            i++;
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && value)
+        {
+            seed = strtoul(value, NULL, 16);
+            has_seed = true;
+            i++;
+        }
+        else if (strcmp(argv[i], "--stored-type") == 0)
+        {
+            stored_type = true;
+        }
+        else if (strcmp(argv[i], "--scalar") == 0)
+        {
+            scalar = true;
+        }
+        else
+        {
+            keeloq_search_usage();
+            return 1;
+        }
+    }
+
+    if (!capture_count || has_hop != has_fix)
+    {
+        keeloq_search_usage();
+        return 1;
+    }
+
+    for (size_t i = 0; i < capture_count; i++)
+    {
+        captures[i].seed = seed;
+        captures[i].has_seed = has_seed;
+    }
+
+    size_t size = 0;
+    void *data = keeloq_search_read_file(argv[1], &size);
+    SubGhzToolkitKeyfileRecord *records = NULL;
+    uint32_t count = 0;
+    if (!data || !subghz_toolkit_keyfile_load(data, size, &records, &count))
+    {
+        fprintf(stderr, "%s: not a key export\n", argv[1]);
+        free(data);
+        return 1;
+    }
+    free(data);
+
+    uint64_t *keys = malloc(count * sizeof(uint64_t));
+    uint16_t *types = malloc(count * sizeof(uint16_t));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        keys[i] = records[i].key;
+        types[i] = records[i].type;
+    }
+
+    KeeloqSearch search = {
+        .records = records,
+        .keys = keys,
+        .captures = captures,
+        .capture_count = capture_count,
+    };
+    uint32_t learning = subghz_toolkit_keeloq_learning_usable(&captures[0], SUBGHZ_TOOLKIT_KEELOQ_LEARNING_ALL);
+
+    printf("Fix %08X  Hop %08X  Serial %07X  Button %X%s\n\n",
+           captures[0].fix,
+           captures[0].hop,
+           captures[0].fix & 0x0FFFFFFF,
+           captures[0].fix >> 28,
+           has_seed ? "" : "  (no seed: Secure and FAAC skipped)");
+
+    double start = keeloq_search_now();
+    size_t candidates = (scalar ? subghz_toolkit_keeloq_search_scalar : subghz_toolkit_keeloq_search)(
+        &captures[0], keys, stored_type ? types : NULL, count, learning, keeloq_search_match, &search);
+    double seconds = keeloq_search_now() - start;
+
+    if (!search.matches)
+        printf("No manufacturer key matches\n");
+    printf("\n%u keys, %zu candidates on the first packet, %zu confirmed, %.1f ms (%s, %zu lanes)\n",
+           count,
+           candidates,
+           search.matches,
+           seconds * 1e3,
+           scalar ? "scalar" : "bitsliced",
+           scalar ? (size_t)1 : subghz_toolkit_keeloq_lanes());
+
+    free(keys);
+    free(types);
+    free(records);
+    return search.matches ? 0 : 2;
+}
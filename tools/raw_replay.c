@@ -0,0 +1,353 @@
+// Host RAW replay
+// Replays RAW .sub captures through a set of decoders with the engine the app
+// uses (helpers/subghz_toolkit_replay.h): every pulse goes to every decoder,
+// and each decode is listed with its pulse offset and signal time.
+//
+// Build: cc -O2 -I. -o raw_replay tools/raw_replay.c helpers/subghz_toolkit_replay.c helpers/subghz_toolkit_router.c helpers/subghz_toolkit_profile.c helpers/subghz_toolkit_raw.c helpers/subghz_toolkit_name_index.c helpers/subghz_toolkit_writer.c
+// Usage: ./raw_replay [-t timing.txt] [-c decodes.csv] [-p share|p50|p99|max|name] [-r] capture.sub...
+//
+// The firmware decoders do not run on the host, so each protocol of a timing
+// table gets a generic PWM decoder instead. The table is the "TIMING TABLE"
+// section of timing_analysis.txt from the app or tools/firmware_analyzer.c
+// (lines of name,te_short,te_long,te_delta,min_count_bit); without -t only a
+// Princeton decoder is used. -c writes one "file,pulse,time_ms,decoder,hash"
+// line per decode, so two runs over the same captures can be diffed.
+// -p times every feed() and ends with the per-decoder cost table in that order.
+// -r also replays each file through the preamble router (helpers/subghz_toolkit_router.h),
+// compares its time and feed() calls per pulse with feeding every decoder, and
+// checks the decodes are identical; the exit status is 1 when they are not.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "helpers/subghz_toolkit_raw.h"
+#include "helpers/subghz_toolkit_replay.h"
+
+#define RAW_REPLAY_MAX_DECODERS 256
+#define RAW_REPLAY_NAME_SIZE 32
+#define RAW_REPLAY_ROUTE_RUNS 5 // timed passes per file and mode, the fastest counts
+
+typedef struct
+{
+    char name[RAW_REPLAY_NAME_SIZE];
+    SubGhzToolkitTimingConst timing;
+} RawReplayTiming;
+
+static double raw_replay_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static size_t raw_replay_file_write(void *context, const uint8_t *data, size_t size)
+{
+    return fwrite(data, 1, size, context);
+}
+
+// Rows of a timing table, other lines (and protocols without timings) are skipped
+static size_t raw_replay_load_timings(const char *path, RawReplayTiming *timings, size_t capacity)
+{
+    FILE *file = fopen(path, "r");
+    char line[256];
+    size_t count = 0;
+
+    if (!file)
+    {
+        perror(path);
+        return 0;
+    }
+    while (count < capacity && fgets(line, sizeof(line), file))
+    {
+        RawReplayTiming *timing = &timings[count];
+        unsigned te_short, te_long, te_delta, min_count_bit;
+
+        if (sscanf(line, "%31[^,],%u,%u,%u,%u", timing->name, &te_short, &te_long, &te_delta, &min_count_bit) != 5)
+            continue;
+        timing->timing = (SubGhzToolkitTimingConst){
+            .te_short = (uint16_t)te_short,
+            .te_long = (uint16_t)te_long,
+            .te_delta = (uint16_t)te_delta,
+            .min_count_bit = (uint8_t)min_count_bit,
+        };
+        count++;
+    }
+    fclose(file);
+    return count;
+}
+
+typedef struct
+{
+    uint32_t *durations; // level in the top bit
+    size_t count;
+    size_t capacity;
+} RawReplayPulses;
+
+static void raw_replay_store_pulse(void *context, bool level, uint32_t duration)
+{
+    RawReplayPulses *pulses = context;
+    if (pulses->count == pulses->capacity)
+    {
+        pulses->capacity = pulses->capacity ? pulses->capacity * 2 : 4096;
+        pulses->durations = realloc(pulses->durations, pulses->capacity * sizeof(uint32_t));
+    }
+    pulses->durations[pulses->count++] = (duration & 0x7FFFFFFF) | (uint32_t)level << 31;
+}
+
+// Best of RAW_REPLAY_ROUTE_RUNS passes over `pulses`, in ms; the decodes of the last pass are kept
+static double raw_replay_time_pulses(SubGhzToolkitReplay *replay, const RawReplayPulses *pulses, size_t *decodes_before)
+{
+    double best = 0;
+    for (int run = 0; run < RAW_REPLAY_ROUTE_RUNS; run++)
+    {
+        subghz_toolkit_replay_get_decodes(replay, decodes_before);
+        subghz_toolkit_replay_reset(replay);
+
+        double start = raw_replay_now_ms();
+        for (size_t i = 0; i < pulses->count; i++)
+            subghz_toolkit_replay_feed(replay, pulses->durations[i] >> 31, pulses->durations[i] & 0x7FFFFFFF);
+        double elapsed_ms = raw_replay_now_ms() - start;
+        if (!run || elapsed_ms < best)
+            best = elapsed_ms;
+    }
+    return best;
+}
+
+// The decodes of `routed` since `routed_before` are those of `replay` since `before`
+static bool raw_replay_same_decodes(
+    const SubGhzToolkitReplay *replay, size_t before, const SubGhzToolkitReplay *routed, size_t routed_before)
+{
+    size_t count, routed_count;
+    const SubGhzToolkitReplayDecode *decodes = subghz_toolkit_replay_get_decodes(replay, &count);
+    const SubGhzToolkitReplayDecode *routed_decodes = subghz_toolkit_replay_get_decodes(routed, &routed_count);
+
+    if (count - before != routed_count - routed_before)
+        return false;
+    for (size_t i = 0; i < count - before; i++)
+    {
+        const SubGhzToolkitReplayDecode *a = &decodes[before + i];
+        const SubGhzToolkitReplayDecode *b = &routed_decodes[routed_before + i];
+        if (a->pulse != b->pulse || a->decoder != b->decoder || a->hash != b->hash)
+            return false;
+    }
+    return true;
+}
+
+// Replays the pulses of `path` through every decoder and through the router, timing both
+static bool raw_replay_route_file(SubGhzToolkitReplay *fan_out, SubGhzToolkitReplay *routed, const char *path, SubGhzToolkitWriter *out)
+{
+    FILE *file = fopen(path, "rb");
+    RawReplayPulses pulses = {0};
+    char buffer[4096];
+    size_t size;
+
+    if (!file)
+    {
+        perror(path);
+        return false;
+    }
+    SubGhzToolkitRawParser parser;
+    subghz_toolkit_raw_parser_init(&parser);
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        subghz_toolkit_raw_parser_feed(&parser, buffer, size, raw_replay_store_pulse, &pulses);
+    subghz_toolkit_raw_parser_finish(&parser, raw_replay_store_pulse, &pulses);
+    fclose(file);
+
+    size_t before, routed_before;
+    double fan_out_ms = raw_replay_time_pulses(fan_out, &pulses, &before);
+    double routed_ms = raw_replay_time_pulses(routed, &pulses, &routed_before);
+    const SubGhzToolkitRouterStats *stats = subghz_toolkit_replay_get_routing(routed);
+    bool same = raw_replay_same_decodes(fan_out, before, routed, routed_before);
+    double count = pulses.count ? (double)pulses.count : 1;
+
+    subghz_toolkit_writer_printf(out,
+                                 "Routing:\n"
+                                 "  Fan-out:          %.1f ns/pulse, %.2f feeds/pulse\n"
+                                 "  Routed:           %.1f ns/pulse, %.2f feeds/pulse, %llu frames started\n"
+                                 "  Decodes:          %s\n",
+                                 fan_out_ms * 1e6 / count,
+                                 (double)subghz_toolkit_replay_decoder_count(fan_out),
+                                 routed_ms * 1e6 / count,
+                                 stats->feeds / count,
+                                 (unsigned long long)stats->activations,
+                                 same ? "identical" : "DIFFERENT");
+    free(pulses.durations);
+    return same;
+}
+
+static bool raw_replay_file(SubGhzToolkitReplay *replay, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    char buffer[4096];
+    size_t size;
+
+    if (!file)
+    {
+        perror(path);
+        return false;
+    }
+
+    SubGhzToolkitRawParser parser;
+    subghz_toolkit_raw_parser_init(&parser);
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        subghz_toolkit_raw_parser_feed(&parser, buffer, size, subghz_toolkit_replay_feed, replay);
+    subghz_toolkit_raw_parser_finish(&parser, subghz_toolkit_replay_feed, replay);
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    static RawReplayTiming timings[RAW_REPLAY_MAX_DECODERS] = {
+        {"Princeton", {.te_short = 390, .te_long = 1170, .te_delta = 300, .min_count_bit = 24}},
+    };
+    size_t timing_count = 1;
+    const char *csv_path = NULL;
+    SubGhzToolkitProfileSort sort = SubGhzToolkitProfileSortShare;
+    bool profile = false;
+    bool route = false;
+    int first_path = argc;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            timing_count = raw_replay_load_timings(argv[++i], timings, RAW_REPLAY_MAX_DECODERS);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            csv_path = argv[++i];
+        else if (strcmp(argv[i], "-r") == 0)
+            route = true;
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+        {
+            profile = true;
+            if (!subghz_toolkit_profile_parse_sort(argv[++i], &sort))
+            {
+                fprintf(stderr, "Unknown sort order %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else
+        {
+            first_path = i;
+            break;
+        }
+    }
+    if (first_path == argc || !timing_count)
+    {
+        fprintf(stderr, "Usage: raw_replay [-t timing.txt] [-c decodes.csv] [-p share|p50|p99|max|name] [-r] capture.sub...\n");
+        return 1;
+    }
+
+    SubGhzToolkitWriter *out = subghz_toolkit_writer_alloc(raw_replay_file_write, stdout);
+    SubGhzToolkitReplay *replay = subghz_toolkit_replay_alloc(timing_count, out);
+    for (size_t i = 0; i < timing_count; i++)
+    {
+        if (subghz_toolkit_replay_add_timing_decoder(replay, timings[i].name, &timings[i].timing) < 0)
+            fprintf(stderr, "Skipping %s: implausible timing\n", timings[i].name);
+    }
+
+    // Quiet copies for -r, replayed several times per file without touching the listed decodes
+    SubGhzToolkitReplay *fan_out = NULL;
+    SubGhzToolkitReplay *routed = NULL;
+    if (route)
+    {
+        fan_out = subghz_toolkit_replay_alloc(timing_count, NULL);
+        routed = subghz_toolkit_replay_alloc(timing_count, NULL);
+        for (size_t i = 0; i < timing_count; i++)
+        {
+            subghz_toolkit_replay_add_timing_decoder(fan_out, timings[i].name, &timings[i].timing);
+            subghz_toolkit_replay_add_timing_decoder(routed, timings[i].name, &timings[i].timing);
+        }
+        subghz_toolkit_replay_set_routing(routed, true);
+    }
+
+    SubGhzToolkitProfile *feed_profile = NULL;
+    if (profile)
+    {
+        feed_profile = subghz_toolkit_profile_alloc(subghz_toolkit_replay_decoder_count(replay));
+        subghz_toolkit_replay_set_profile(replay, feed_profile);
+    }
+
+    FILE *csv = NULL;
+    if (csv_path && !(csv = fopen(csv_path, "w")))
+    {
+        perror(csv_path);
+        return 1;
+    }
+
+    uint64_t total_pulses = 0;
+    double total_ms = 0;
+    int status = 0;
+
+    for (int i = first_path; i < argc; i++)
+    {
+        size_t decodes_before;
+        subghz_toolkit_replay_get_decodes(replay, &decodes_before);
+
+        subghz_toolkit_writer_printf(out, "=== %s ===\n", argv[i]);
+        subghz_toolkit_replay_reset(replay);
+
+        double start = raw_replay_now_ms();
+        bool read = raw_replay_file(replay, argv[i]);
+        double elapsed_ms = raw_replay_now_ms() - start;
+
+        if (!read)
+        {
+            status = 1;
+            continue;
+        }
+
+        const SubGhzToolkitReplayStats *stats = subghz_toolkit_replay_get_stats(replay);
+        total_pulses += stats->pulses;
+        total_ms += elapsed_ms;
+        subghz_toolkit_writer_cstr(out, "\n");
+        subghz_toolkit_replay_write_summary(out, replay, (uint32_t)(elapsed_ms + 0.5));
+        subghz_toolkit_writer_cstr(out, "\n");
+        if (routed)
+        {
+            if (!raw_replay_route_file(fan_out, routed, argv[i], out))
+                status = 1;
+            subghz_toolkit_writer_cstr(out, "\n");
+        }
+
+        if (csv)
+        {
+            size_t count;
+            const SubGhzToolkitReplayDecode *decodes = subghz_toolkit_replay_get_decodes(replay, &count);
+            for (size_t d = decodes_before; d < count; d++)
+                fprintf(csv, "%s,%u,%u,%s,%08X\n", argv[i], decodes[d].pulse, decodes[d].time_ms,
+                        subghz_toolkit_replay_decoder_name(replay, decodes[d].decoder), decodes[d].hash);
+        }
+    }
+
+    size_t decode_count;
+    subghz_toolkit_replay_get_decodes(replay, &decode_count);
+    subghz_toolkit_writer_printf(out, "=== TOTAL ===\n%d files, %zu decoders, %llu pulses, %zu decodes, %.0f pulses/s\n\n",
+                                 argc - first_path,
+                                 subghz_toolkit_replay_decoder_count(replay),
+                                 (unsigned long long)total_pulses,
+                                 decode_count,
+                                 total_ms > 0 ? total_pulses * 1000.0 / total_ms : 0.0);
+    subghz_toolkit_replay_write_decoder_counts(out, replay);
+    if (feed_profile)
+    {
+        subghz_toolkit_writer_cstr(out, "\n");
+        subghz_toolkit_profile_write_report(out, feed_profile, sort, total_pulses);
+        subghz_toolkit_profile_free(feed_profile);
+    }
+
+    if (routed)
+    {
+        subghz_toolkit_replay_free(fan_out);
+        subghz_toolkit_replay_free(routed);
+    }
+    subghz_toolkit_replay_free(replay);
+    subghz_toolkit_writer_free(out);
+    if (csv && fclose(csv) != 0)
+    {
+        perror(csv_path);
+        return 1;
+    }
+    return status;
+}
@@ -0,0 +1,210 @@
+// Host symbolizer for analysis reports
+// Builds the symbol file the app reads from SD (see helpers/subghz_toolkit_symbols.h)
+// and annotates the firmware addresses in exported text reports as <symbol+offset>.
+//
+// Build: cc -O2 -I. -o symbolize tools/symbolize.c helpers/subghz_toolkit_symbols.c helpers/subghz_toolkit_elf.c helpers/subghz_toolkit_memory.c helpers/subghz_toolkit_writer.c
+// Usage: ./symbolize firmware.elf -w symbols.bin
+//        ./symbolize <firmware.elf|symbols.bin> [report.txt ...]
+//
+// Copy symbols.bin to /ext/subghz/analysis/symbols.bin and the app annotates
+// its own reports, as long as the file was built from the running firmware.
+// Annotating reads the reports (or stdin) and writes them to stdout with every
+// 0x-prefixed 8 digit address that falls in a symbol followed by its name.
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "helpers/subghz_toolkit_elf.h"
+#include "helpers/subghz_toolkit_symbols.h"
+
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+} SymbolizeBuffer;
+
+static size_t symbolize_buffer_append(void *context, const uint8_t *data, size_t size)
+{
+    SymbolizeBuffer *buffer = context;
+    if (buffer->size + size > buffer->capacity)
+    {
+        buffer->capacity = (buffer->size + size) * 2;
+        buffer->data = realloc(buffer->data, buffer->capacity);
+    }
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+    return size;
+}
+
+static size_t symbolize_buffer_read(void *context, uint32_t offset, void *data, size_t size)
+{
+    const SymbolizeBuffer *buffer = context;
+    if (offset >= buffer->size)
+        return 0;
+    if (size > buffer->size - offset)
+        size = buffer->size - offset;
+    memcpy(data, buffer->data + offset, size);
+    return size;
+}
+
+static size_t symbolize_file_write(void *context, const uint8_t *data, size_t size)
+{
+    return fwrite(data, 1, size, context);
+}
+
+// The symbol file of `path`: built from it if it is an ELF, otherwise read as is
+static bool symbolize_load(const char *path, SymbolizeBuffer *symbols, size_t *count)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        perror(path);
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+
+    size_t size = st.st_size;
+    const uint8_t *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        perror(path);
+        return false;
+    }
+
+    SubGhzToolkitElf elf;
+    if (subghz_toolkit_elf_open(&elf, data, size))
+    {
+        uint32_t anchor = 0;
+        if (!subghz_toolkit_elf_find_symbol(&elf, "subghz_protocol_registry", &anchor))
+            fprintf(stderr, "%s: no subghz_protocol_registry, the app will not accept this symbol file\n", path);
+
+        SubGhzToolkitWriter *writer = subghz_toolkit_writer_alloc(symbolize_buffer_append, symbols);
+        *count = subghz_toolkit_symbols_build(&elf, anchor, writer);
+        subghz_toolkit_writer_free(writer);
+    }
+    else
+    {
+        symbolize_buffer_append(symbols, data, size);
+        *count = 0;
+    }
+
+    munmap((void *)data, size);
+    return true;
+}
+
+static bool symbolize_is_hex(int c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// Copy `in` to `out`, following every exact "0x" + 8 hex digit token that is not already annotated with its symbol
+static void symbolize_stream(FILE *in, SubGhzToolkitWriter *out, SubGhzToolkitSymbols *symbols)
+{
+    char *line = NULL;
+    size_t line_capacity = 0;
+    ssize_t length;
+
+    while ((length = getline(&line, &line_capacity, in)) > 0)
+    {
+        ssize_t start = 0;
+        for (ssize_t i = 0; i + 10 <= length; i++)
+        {
+            if (line[i] != '0' || (line[i + 1] != 'x' && line[i + 1] != 'X') || (i && symbolize_is_hex(line[i - 1])))
+                continue;
+
+            ssize_t digits = 0;
+            while (i + 2 + digits < length && symbolize_is_hex(line[i + 2 + digits]))
+                digits++;
+            ssize_t end = i + 2 + digits;
+            if (digits != 8 || (end + 1 < length && line[end] == ' ' && line[end + 1] == '<'))
+            {
+                i = end - 1;
+                continue;
+            }
+
+            subghz_toolkit_writer_write(out, line + start, i - start);
+            subghz_toolkit_symbols_write_address(out, symbols, (uint32_t)strtoul(line + i + 2, NULL, 16));
+            start = end;
+            i = end - 1;
+        }
+        subghz_toolkit_writer_write(out, line + start, length - start);
+    }
+
+    free(line);
+}
+
+static void symbolize_usage(void)
+{
+    fprintf(stderr,
+            "Usage: symbolize firmware.elf -w symbols.bin\n"
+            "       symbolize <firmware.elf|symbols.bin> [report.txt ...]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        symbolize_usage();
+        return 1;
+    }
+
+    SymbolizeBuffer buffer = {0};
+    size_t built = 0;
+    if (!symbolize_load(argv[1], &buffer, &built))
+        return 1;
+
+    if (argc == 4 && strcmp(argv[2], "-w") == 0)
+    {
+        FILE *file = fopen(argv[3], "wb");
+        if (!file || fwrite(buffer.data, 1, buffer.size, file) != buffer.size || fclose(file) != 0)
+        {
+            perror(argv[3]);
+            return 1;
+        }
+        fprintf(stderr, "%zu symbols, %zu bytes written to %s\n", built, buffer.size, argv[3]);
+        free(buffer.data);
+        return 0;
+    }
+
+    SubGhzToolkitSymbols *symbols = subghz_toolkit_symbols_open(symbolize_buffer_read, &buffer);
+    if (!symbols)
+    {
+        fprintf(stderr, "%s: not a firmware ELF or symbol file\n", argv[1]);
+        free(buffer.data);
+        return 1;
+    }
+
+    SubGhzToolkitWriter *out = subghz_toolkit_writer_alloc(symbolize_file_write, stdout);
+    if (argc == 2)
+        symbolize_stream(stdin, out, symbols);
+    for (int i = 2; i < argc; i++)
+    {
+        FILE *in = fopen(argv[i], "r");
+        if (!in)
+        {
+            perror(argv[i]);
+            continue;
+        }
+        symbolize_stream(in, out, symbols);
+        fclose(in);
+    }
+    subghz_toolkit_writer_free(out);
+
+    uint32_t hits, misses;
+    subghz_toolkit_symbols_get_stats(symbols, &hits, &misses);
+    fprintf(stderr, "%lu symbols, %lu lookups, %lu cache hits\n",
+            (unsigned long)subghz_toolkit_symbols_count(symbols), (unsigned long)(hits + misses), (unsigned long)hits);
+
+    subghz_toolkit_symbols_free(symbols);
+    free(buffer.data);
+    return 0;
+}
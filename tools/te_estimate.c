@@ -0,0 +1,135 @@
+// Host timing estimator
+// Runs the streaming pulse clustering of helpers/subghz_toolkit_clusters.h
+// over RAW .sub captures and prints te, te_short/te_long, the clusters and
+// their jitter, then the line coding from helpers/subghz_toolkit_classify.h,
+// exactly as the app reports them for its own captures.
+//
+// Build: cc -O2 -I. -o te_estimate tools/te_estimate.c helpers/subghz_toolkit_clusters.c helpers/subghz_toolkit_classify.c helpers/subghz_toolkit_raw.c helpers/subghz_toolkit_writer.c
+// Usage: ./te_estimate capture.sub...
+//        ./te_estimate --bench [pulses]
+//
+// --bench feeds a synthetic PWM signal (te 400 us, 1x/3x, +-10% jitter,
+// frame gaps) and reports samples/s for add() and the time of estimate().
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "helpers/subghz_toolkit_classify.h"
+#include "helpers/subghz_toolkit_clusters.h"
+#include "helpers/subghz_toolkit_raw.h"
+
+#define TE_ESTIMATE_BENCH_TE 400
+#define TE_ESTIMATE_BENCH_PULSES 10000000u
+
+static double te_estimate_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+typedef struct
+{
+    SubGhzToolkitClusters clusters;
+    SubGhzToolkitClassifier classifier;
+} TeEstimatePulses;
+
+static void te_estimate_pulse(void *context, bool level, uint32_t duration)
+{
+    TeEstimatePulses *pulses = context;
+    subghz_toolkit_clusters_add(&pulses->clusters, level, duration);
+    subghz_toolkit_classify_add(&pulses->classifier, level, duration);
+}
+
+static size_t te_estimate_file_write(void *context, const uint8_t *data, size_t size)
+{
+    return fwrite(data, 1, size, context);
+}
+
+static int te_estimate_bench(uint32_t pulses)
+{
+    uint32_t *durations = malloc(pulses * sizeof(uint32_t));
+    uint32_t state = 0x12345678;
+
+    for (uint32_t i = 0; i < pulses; i++)
+    {
+        state = state * 1664525u + 1013904223u;
+        uint32_t multiple = (i % 50 == 49) ? 30 : ((state >> 8) & 1) ? 3 : 1;
+        uint32_t te = multiple * TE_ESTIMATE_BENCH_TE;
+        durations[i] = te - te / 10 + (state >> 16) % (te / 5 + 1);
+    }
+
+    SubGhzToolkitClusters clusters;
+    SubGhzToolkitClustersEstimate estimate;
+    subghz_toolkit_clusters_init(&clusters);
+
+    double start = te_estimate_now_ms();
+    for (uint32_t i = 0; i < pulses; i++)
+        subghz_toolkit_clusters_add(&clusters, !(i & 1), durations[i]);
+    double add_ms = te_estimate_now_ms() - start;
+
+    start = te_estimate_now_ms();
+    subghz_toolkit_clusters_estimate(&clusters, &estimate);
+    double estimate_ms = te_estimate_now_ms() - start;
+
+    printf("%u pulses: %.1f M samples/s, estimate in %.3f ms, %zu bytes of state\n",
+           pulses, pulses / add_ms / 1e3, estimate_ms, sizeof(clusters));
+    SubGhzToolkitWriter *out = subghz_toolkit_writer_alloc(te_estimate_file_write, stdout);
+    subghz_toolkit_clusters_write_report(out, &clusters, &estimate);
+    subghz_toolkit_writer_free(out);
+
+    free(durations);
+    return estimate.te ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0)
+        return te_estimate_bench(argc >= 3 ? (uint32_t)strtoul(argv[2], NULL, 10) : TE_ESTIMATE_BENCH_PULSES);
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: te_estimate capture.sub...\n       te_estimate --bench [pulses]\n");
+        return 1;
+    }
+
+    SubGhzToolkitWriter *out = subghz_toolkit_writer_alloc(te_estimate_file_write, stdout);
+    int status = 0;
+    char buffer[4096];
+
+    for (int i = 1; i < argc; i++)
+    {
+        FILE *file = fopen(argv[i], "rb");
+        if (!file)
+        {
+            perror(argv[i]);
+            status = 1;
+            continue;
+        }
+
+        static TeEstimatePulses pulses;
+        SubGhzToolkitClustersEstimate estimate;
+        SubGhzToolkitClassification classification;
+        SubGhzToolkitRawParser parser;
+        size_t size;
+
+        subghz_toolkit_clusters_init(&pulses.clusters);
+        subghz_toolkit_classify_init(&pulses.classifier);
+        subghz_toolkit_raw_parser_init(&parser);
+        while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            subghz_toolkit_raw_parser_feed(&parser, buffer, size, te_estimate_pulse, &pulses);
+        subghz_toolkit_raw_parser_finish(&parser, te_estimate_pulse, &pulses);
+        fclose(file);
+
+        subghz_toolkit_clusters_estimate(&pulses.clusters, &estimate);
+        subghz_toolkit_classify(&pulses.classifier, estimate.te, &classification);
+        subghz_toolkit_writer_printf(out, "=== %s ===\n", argv[i]);
+        subghz_toolkit_clusters_write_report(out, &pulses.clusters, &estimate);
+        subghz_toolkit_classify_write_report(out, &classification);
+        subghz_toolkit_writer_cstr(out, "\n");
+    }
+
+    subghz_toolkit_writer_free(out);
+    return status;
+}